@@ -0,0 +1,519 @@
+/**
+ * @file UDP_benchmark.c
+ * @brief Open-loop load generator and latency benchmark for the password generation server.
+ * @details Every thread sends requests on a fixed schedule, whatever the server does, spreading
+ * them round-robin over its own sockets. Latency is measured from the time a request was
+ * scheduled, not from the time it was actually sent, so a server that falls behind shows up in
+ * the tail instead of silently slowing the load down. At the end of the run the per-thread
+ * histograms are merged and the results are printed as text, CSV or JSON.
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#if defined WIN32
+#include <winsock2.h>       /**< Include Winsock 2 library for Windows */
+#include <ws2tcpip.h>       /**< Include getaddrinfo() and struct sockaddr_storage */
+#include <windows.h>        /**< Include QueryPerformanceCounter() */
+#else
+#include <unistd.h>         /**< Include UNIX standard header for close() */
+#include <sys/socket.h>     /**< Include socket library for UNIX systems */
+#include <sys/select.h>     /**< Include select() */
+#include <arpa/inet.h>      /**< Include ARP and Internet address family libraries */
+#include <netinet/in.h>     /**< Include for internet address family structures */
+#include <netdb.h>          /**< Include for host and network database functions */
+#include <time.h>           /**< Include clock_gettime() */
+#define closesocket close   /**< Define closesocket as close for UNIX systems */
+#endif
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../../UDP_core/src/libs/protocol/protocol.h" /**< Communication protocol definitions */
+#include "../../UDP_core/src/libs/seal/seal.h"         /**< Pre-shared key of the sealed responses */
+#include "../../UDP_core/src/libs/transport/transport.h" /**< Request/response transport */
+
+#include "libs/histogram/histogram.h"                  /**< Latency histogram */
+
+#define MAX_THREADS 64                  /**< Maximum number of sending threads */
+#define MAX_SOCKETS_PER_THREAD 64       /**< Maximum number of sockets owned by one thread */
+#define THREAD_ID_SHIFT 24              /**< The thread index lives in the high byte of request_id */
+#define MAX_REQUESTS_PER_THREAD (1u << THREAD_ID_SHIFT)
+#define DRAIN_TIME_NS 1000000000ULL     /**< How long late responses are awaited after the last send */
+
+/**
+ * @enum OutputFormat
+ * @brief Formats the results can be printed in.
+ */
+typedef enum {
+    FORMAT_TEXT,    /**< Human-readable report */
+    FORMAT_CSV,     /**< Header line and one line of values */
+    FORMAT_JSON     /**< Single JSON object */
+} OutputFormat;
+
+/**
+ * @struct BenchmarkOptions
+ * @brief Command-line options of the benchmark.
+ */
+typedef struct {
+    const char *host;           /**< Server hostname or address */
+    unsigned short port;        /**< Server port */
+    double rate;                /**< Total target rate, in requests per second */
+    double duration;            /**< Length of the sending phase, in seconds */
+    unsigned int threads;       /**< Number of sending threads */
+    unsigned int sockets;       /**< Number of sockets per thread */
+    char type;                  /**< Password type requested */
+    uint8_t length;             /**< Password length requested */
+    OutputFormat format;        /**< Output format of the results */
+} BenchmarkOptions;
+
+/**
+ * @struct LoadThread
+ * @brief State owned by one sending thread.
+ */
+typedef struct {
+    pthread_t thread;                           /**< Thread handle */
+    unsigned int index;                         /**< Thread index, stored in the request ids */
+    const BenchmarkOptions *options;            /**< Shared options */
+    int sockets[MAX_SOCKETS_PER_THREAD];        /**< Connected sockets the requests are spread over */
+    uint64_t *scheduled;                        /**< Scheduled send time of every request, 0 once answered */
+    uint64_t planned;                           /**< Number of requests this thread will send */
+    uint64_t sent;                              /**< Requests actually sent */
+    uint64_t send_errors;                       /**< Requests that could not be sent */
+    uint64_t received;                          /**< Valid responses matched to a request */
+    uint64_t rejected;                          /**< Responses with a status other than STATUS_OK */
+    Histogram latency;                          /**< Response latency, in nanoseconds */
+} LoadThread;
+
+/**
+ * @brief Clean up Winsock resources (Windows only).
+ */
+void clear_winsock() {
+#if defined WIN32
+    WSACleanup();  /**< Free resources allocated by Winsock */
+#endif
+}
+
+/**
+ * @brief Print error messages on the standard error stream.
+ * @param[in] error_message The error message to display.
+ */
+void error_handler(const char *error_message) {
+    fputs(error_message, stderr);
+}
+
+/**
+ * @brief Returns a monotonic timestamp in nanoseconds.
+ */
+uint64_t monotonic_ns() {
+#if defined WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Parse the command-line options.
+ * @param[in] argc Number of arguments.
+ * @param[in] argv Arguments.
+ * @param[out] options Pointer to the BenchmarkOptions structure to fill.
+ * @return `false` if an option is unknown or out of range; the usage is printed.
+ */
+bool parse_arguments(int argc, char *argv[], BenchmarkOptions *options) {
+    options->host = "127.0.0.1";
+    options->port = DEFAULT_PORT;
+    options->rate = 10000;
+    options->duration = 10;
+    options->threads = 4;
+    options->sockets = 1;
+    options->type = 's';
+    options->length = 16;
+    options->format = FORMAT_TEXT;
+
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--host") == 0 && has_value) {
+            options->host = argv[++i];
+        } else if (strcmp(argv[i], "--port") == 0 && has_value) {
+            int port = atoi(argv[++i]);
+            if (port < 1 || port > 65535) {
+                error_handler("Invalid port.\n");
+                return false;
+            }
+            options->port = (unsigned short)port;
+        } else if (strcmp(argv[i], "--rate") == 0 && has_value) {
+            options->rate = atof(argv[++i]);
+            if (options->rate <= 0) {
+                error_handler("Invalid rate.\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--duration") == 0 && has_value) {
+            options->duration = atof(argv[++i]);
+            if (options->duration <= 0) {
+                error_handler("Invalid duration.\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0 && has_value) {
+            int threads = atoi(argv[++i]);
+            if (threads < 1 || threads > MAX_THREADS) {
+                error_handler("Invalid number of threads.\n");
+                return false;
+            }
+            options->threads = (unsigned int)threads;
+        } else if (strcmp(argv[i], "--sockets") == 0 && has_value) {
+            int sockets = atoi(argv[++i]);
+            if (sockets < 1 || sockets > MAX_SOCKETS_PER_THREAD) {
+                error_handler("Invalid number of sockets.\n");
+                return false;
+            }
+            options->sockets = (unsigned int)sockets;
+        } else if (strcmp(argv[i], "--type") == 0 && has_value) {
+            options->type = argv[++i][0];
+            if (strchr("namsu", options->type) == NULL || options->type == '\0') {
+                error_handler("Invalid password type.\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--length") == 0 && has_value) {
+            int length = atoi(argv[++i]);
+            if (length < MIN_PASSWORD_LENGTH || length > MAX_PASSWORD_LENGTH) {
+                error_handler("Invalid password length.\n");
+                return false;
+            }
+            options->length = (uint8_t)length;
+        } else if (strcmp(argv[i], "--psk-file") == 0 && has_value) {
+            if (!seal_self_test()) {
+                error_handler("The ChaCha20-Poly1305 self-test failed.\n");
+                return false;
+            }
+            SealKey key;
+            if (!load_seal_key(argv[++i], &key)) {
+                error_handler("Invalid pre-shared key file.\n");
+                return false;
+            }
+            enable_sealing(&key); /**< Measures the sealed responses */
+            memset(&key, 0, sizeof(key));
+        } else if (strcmp(argv[i], "--format") == 0 && has_value) {
+            const char *format = argv[++i];
+            if (strcmp(format, "text") == 0) {
+                options->format = FORMAT_TEXT;
+            } else if (strcmp(format, "csv") == 0) {
+                options->format = FORMAT_CSV;
+            } else if (strcmp(format, "json") == 0) {
+                options->format = FORMAT_JSON;
+            } else {
+                error_handler("Invalid output format.\n");
+                return false;
+            }
+        } else {
+            error_handler("Usage: UDP_benchmark [--host HOST] [--port N] [--rate REQ/S] [--duration S]\n"
+                          "                     [--threads N] [--sockets N] [--type namsu] [--length N]\n"
+                          "                     [--psk-file PATH] [--format text|csv|json]\n");
+            return false;
+        }
+    }
+
+    double per_thread = options->rate * options->duration / options->threads;
+    if (per_thread >= MAX_REQUESTS_PER_THREAD) {
+        error_handler("Too many requests per thread: raise --threads or lower --rate/--duration.\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Resolve the server hostname to an IPv4 or IPv6 address.
+ * @details The first address returned by `getaddrinfo` is used: a benchmark must load one
+ * well-defined endpoint, so there is no racing between families as in the interactive client.
+ * @param[in] options Pointer to the BenchmarkOptions structure.
+ * @param[out] server_address A pointer to the structure that receives the resolved address.
+ * @return true if the hostname is resolved successfully.
+ */
+bool resolve_server_address(const BenchmarkOptions *options, struct sockaddr_storage *server_address) {
+    struct addrinfo hints;
+    struct addrinfo *results;
+    char port[8];
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_protocol = IPPROTO_UDP;
+    hints.ai_flags = AI_ADDRCONFIG | AI_NUMERICSERV;
+    snprintf(port, sizeof(port), "%u", options->port);
+    if (getaddrinfo(options->host, port, &hints, &results) != 0) {
+        error_handler("Error resolving host\n");
+        return false;
+    }
+    memset(server_address, 0, sizeof(*server_address));
+    memcpy(server_address, results->ai_addr, results->ai_addrlen);
+    freeaddrinfo(results);
+    return true;
+}
+
+/**
+ * @brief Match a response to its request and record its latency.
+ * @param[in,out] load Pointer to the LoadThread that owns the socket.
+ * @param[in] client_socket A socket with a datagram ready to be read.
+ */
+void collect_response(LoadThread *load, int client_socket) {
+    PasswordResponse response;
+    if (!receive_response(client_socket, &response)) {
+        return;
+    }
+
+    uint64_t now = monotonic_ns();
+    uint32_t sequence = response.request_id & (MAX_REQUESTS_PER_THREAD - 1);
+    if (response.request_id >> THREAD_ID_SHIFT != load->index ||
+        sequence >= load->sent || load->scheduled[sequence] == 0) {
+        return; /**< Unknown or duplicated response */
+    }
+
+    histogram_record(&load->latency, now - load->scheduled[sequence]);
+    load->scheduled[sequence] = 0;
+    load->received++;
+    if (response.status != STATUS_OK) {
+        load->rejected++;
+    }
+}
+
+/**
+ * @brief Wait until `deadline` for responses on every socket of the thread.
+ * @param[in,out] load Pointer to the LoadThread.
+ * @param[in] deadline Monotonic time, in nanoseconds, at which the function returns.
+ */
+void collect_until(LoadThread *load, uint64_t deadline) {
+    for (uint64_t now = monotonic_ns(); now < deadline; now = monotonic_ns()) {
+        fd_set readable;
+        int highest = -1;
+        FD_ZERO(&readable);
+        for (unsigned int i = 0; i < load->options->sockets; i++) {
+            FD_SET(load->sockets[i], &readable);
+            if (load->sockets[i] > highest) {
+                highest = load->sockets[i];
+            }
+        }
+
+        uint64_t wait = deadline - now;
+        struct timeval timeout = { (long)(wait / 1000000000ULL), (long)(wait % 1000000000ULL / 1000) };
+        int ready = select(highest + 1, &readable, NULL, NULL, &timeout);
+        if (ready <= 0) {
+            continue; /**< Timeout (the loop condition ends it) or interrupted call */
+        }
+        for (unsigned int i = 0; i < load->options->sockets; i++) {
+            if (FD_ISSET(load->sockets[i], &readable)) {
+                collect_response(load, load->sockets[i]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Thread entry point: sends the planned requests on schedule, then drains late responses.
+ * @param[in] argument Pointer to the LoadThread of the thread.
+ * @return Always NULL.
+ */
+void *run_load_thread(void *argument) {
+    LoadThread *load = argument;
+    const BenchmarkOptions *options = load->options;
+    uint64_t interval = (uint64_t)(1e9 * options->threads / options->rate);
+    /* Threads start at staggered offsets so that their sends do not line up */
+    uint64_t next_send = monotonic_ns() + interval * load->index / options->threads;
+
+    PasswordRequest request;
+    request.type = options->type;
+    request.length = options->length;
+    request.flags = 0;
+    request.count = 1;
+
+    while (load->sent < load->planned) {
+        collect_until(load, next_send);
+
+        /* Send everything that is due: a late thread catches up instead of lowering the rate */
+        for (uint64_t now = monotonic_ns(); load->sent < load->planned && next_send <= now; next_send += interval) {
+            uint64_t sequence = load->sent++;
+            request.request_id = (load->index << THREAD_ID_SHIFT) | (uint32_t)sequence;
+            load->scheduled[sequence] = next_send;
+            if (!send_request(load->sockets[sequence % options->sockets], &request)) {
+                load->scheduled[sequence] = 0;
+                load->send_errors++;
+            }
+        }
+    }
+
+    collect_until(load, monotonic_ns() + DRAIN_TIME_NS);
+    return NULL;
+}
+
+/**
+ * @brief Print the merged results in the selected format.
+ * @param[in] options Pointer to the BenchmarkOptions structure.
+ * @param[in] loads The LoadThread array.
+ * @param[in] elapsed Length of the sending phase actually observed, in seconds.
+ */
+void print_results(const BenchmarkOptions *options, const LoadThread *loads, double elapsed) {
+    static Histogram latency;
+    uint64_t sent = 0, send_errors = 0, received = 0, rejected = 0;
+
+    histogram_reset(&latency);
+    for (unsigned int i = 0; i < options->threads; i++) {
+        sent += loads[i].sent;
+        send_errors += loads[i].send_errors;
+        received += loads[i].received;
+        rejected += loads[i].rejected;
+        histogram_merge(&latency, &loads[i].latency);
+    }
+
+    uint64_t lost = sent - received;
+    double loss_rate = sent == 0 ? 0.0 : (double)lost / (double)sent;
+    double throughput = elapsed > 0 ? (double)received / elapsed : 0.0;
+    double mean_us = histogram_mean(&latency) / 1e3;
+    double p50_us = (double)histogram_percentile(&latency, 50.0) / 1e3;
+    double p99_us = (double)histogram_percentile(&latency, 99.0) / 1e3;
+    double p999_us = (double)histogram_percentile(&latency, 99.9) / 1e3;
+    double max_us = (double)latency.max / 1e3;
+
+    switch (options->format) {
+        case FORMAT_CSV:
+            printf("target_rps,duration_s,threads,sockets,sent,send_errors,received,rejected,lost,loss_rate,"
+                   "throughput_rps,mean_us,p50_us,p99_us,p999_us,max_us\n");
+            printf("%.0f,%.3f,%u,%u,%llu,%llu,%llu,%llu,%llu,%.6f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n",
+                   options->rate, elapsed, options->threads, options->sockets,
+                   (unsigned long long)sent, (unsigned long long)send_errors, (unsigned long long)received,
+                   (unsigned long long)rejected, (unsigned long long)lost, loss_rate, throughput,
+                   mean_us, p50_us, p99_us, p999_us, max_us);
+            break;
+        case FORMAT_JSON:
+            printf("{\"target_rps\": %.0f, \"duration_s\": %.3f, \"threads\": %u, \"sockets\": %u, "
+                   "\"sent\": %llu, \"send_errors\": %llu, \"received\": %llu, \"rejected\": %llu, "
+                   "\"lost\": %llu, \"loss_rate\": %.6f, \"throughput_rps\": %.1f, "
+                   "\"latency_us\": {\"mean\": %.1f, \"p50\": %.1f, \"p99\": %.1f, \"p999\": %.1f, \"max\": %.1f}}\n",
+                   options->rate, elapsed, options->threads, options->sockets,
+                   (unsigned long long)sent, (unsigned long long)send_errors, (unsigned long long)received,
+                   (unsigned long long)rejected, (unsigned long long)lost, loss_rate, throughput,
+                   mean_us, p50_us, p99_us, p999_us, max_us);
+            break;
+        case FORMAT_TEXT:
+        default:
+            printf("Target rate:   %.0f req/s over %.3f s (%u threads x %u sockets)\n",
+                   options->rate, elapsed, options->threads, options->sockets);
+            printf("Sent:          %llu (%llu send errors)\n",
+                   (unsigned long long)sent, (unsigned long long)send_errors);
+            printf("Received:      %llu (%llu rejected)\n",
+                   (unsigned long long)received, (unsigned long long)rejected);
+            printf("Lost:          %llu (%.3f%%)\n", (unsigned long long)lost, loss_rate * 100.0);
+            printf("Throughput:    %.1f resp/s\n", throughput);
+            printf("Latency (us):  mean %.1f  p50 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n",
+                   mean_us, p50_us, p99_us, p999_us, max_us);
+            break;
+    }
+}
+
+/**
+ * @brief Release the sockets and buffers of the threads that were set up.
+ * @param[in,out] loads The LoadThread array.
+ * @param[in] count Number of threads to release.
+ * @param[in] sockets Number of sockets per thread.
+ */
+void release_loads(LoadThread *loads, unsigned int count, unsigned int sockets) {
+    for (unsigned int i = 0; i < count; i++) {
+        for (unsigned int j = 0; j < sockets; j++) {
+            if (loads[i].sockets[j] >= 0) {
+                closesocket(loads[i].sockets[j]);
+            }
+        }
+        free(loads[i].scheduled);
+    }
+    free(loads);
+}
+
+/**
+ * @brief Main function of the benchmark.
+ * @return EXIT_SUCCESS if the run completed.
+ * @return EXIT_FAILURE if the options are invalid or the run could not be set up.
+ */
+int main(int argc, char *argv[]) {
+    BenchmarkOptions options;
+    if (!parse_arguments(argc, argv, &options)) {
+        return EXIT_FAILURE;
+    }
+
+#if defined WIN32
+    WSADATA wsa_data;
+    WORD version_requested = MAKEWORD(2,2);
+    int result = WSAStartup(version_requested, &wsa_data);
+    if (result != NO_ERROR) {
+        error_handler("Error initializing Winsock.\n");
+        return EXIT_FAILURE;
+    }
+#endif
+
+    struct sockaddr_storage server_address;
+    if (!resolve_server_address(&options, &server_address)) {
+        clear_winsock();
+        return EXIT_FAILURE;
+    }
+
+    LoadThread *loads = calloc(options.threads, sizeof(LoadThread));
+    if (loads == NULL) {
+        error_handler("Error allocating the threads.\n");
+        clear_winsock();
+        return EXIT_FAILURE;
+    }
+
+    uint64_t total = (uint64_t)(options.rate * options.duration);
+    unsigned int prepared = 0;
+    for (; prepared < options.threads; prepared++) {
+        LoadThread *load = &loads[prepared];
+        load->index = prepared;
+        load->options = &options;
+        load->planned = total / options.threads + (prepared < total % options.threads ? 1 : 0);
+        histogram_reset(&load->latency);
+        for (unsigned int j = 0; j < options.sockets; j++) {
+            load->sockets[j] = connect_server_socket(&server_address);
+        }
+        load->scheduled = calloc(load->planned + 1, sizeof(uint64_t));
+
+        bool ready = load->scheduled != NULL;
+        for (unsigned int j = 0; j < options.sockets; j++) {
+            ready = ready && load->sockets[j] >= 0;
+        }
+        if (!ready) {
+            error_handler("Error creating the sockets of a thread.\n");
+            release_loads(loads, prepared + 1, options.sockets);
+            clear_winsock();
+            return EXIT_FAILURE;
+        }
+    }
+
+    uint64_t start = monotonic_ns();
+    unsigned int started = 0;
+    for (; started < options.threads; started++) {
+        if (pthread_create(&loads[started].thread, NULL, run_load_thread, &loads[started]) != 0) {
+            error_handler("Error starting a load thread.\n");
+            break;
+        }
+    }
+    for (unsigned int i = 0; i < started; i++) {
+        pthread_join(loads[i].thread, NULL);
+    }
+    double elapsed = (double)(monotonic_ns() - start - DRAIN_TIME_NS) / 1e9;
+
+    if (started == options.threads) {
+        print_results(&options, loads, elapsed);
+    }
+
+    release_loads(loads, prepared, options.sockets);
+    clear_winsock();
+    return started == options.threads ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file histogram.c
+ * @brief Implementation of the log-linear latency histogram.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#include <string.h>
+#include "histogram.h"
+
+/* - - - - - - - - - - - - - - - - - - - HISTOGRAM - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Position of the highest set bit of a non-zero value.
+ */
+static unsigned int highest_bit(uint64_t value) {
+#if defined __GNUC__
+    return 63u - (unsigned int)__builtin_clzll(value);
+#else
+    unsigned int bit = 0;
+    while (value >>= 1) {
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+/**
+ * @brief Bucket that holds `value`.
+ */
+static unsigned int bucket_index(uint64_t value) {
+    if (value < HISTOGRAM_SUB_BUCKETS) {
+        return (unsigned int)value;
+    }
+    unsigned int shift = highest_bit(value) - HISTOGRAM_SUB_BITS;
+    return (shift + 1) * HISTOGRAM_SUB_BUCKETS + (unsigned int)((value >> shift) & (HISTOGRAM_SUB_BUCKETS - 1));
+}
+
+/**
+ * @brief Largest value that falls in bucket `index`.
+ */
+static uint64_t bucket_upper_bound(unsigned int index) {
+    if (index < HISTOGRAM_SUB_BUCKETS) {
+        return index;
+    }
+    unsigned int shift = index / HISTOGRAM_SUB_BUCKETS - 1;
+    uint64_t base = (uint64_t)(HISTOGRAM_SUB_BUCKETS + index % HISTOGRAM_SUB_BUCKETS) << shift;
+    return base + (((uint64_t)1 << shift) - 1);
+}
+
+/**
+ * @brief Empties a histogram.
+ */
+void histogram_reset(Histogram *histogram) {
+    memset(histogram, 0, sizeof(*histogram));
+    histogram->min = UINT64_MAX;
+}
+
+/**
+ * @brief Records one value.
+ */
+void histogram_record(Histogram *histogram, uint64_t value) {
+    histogram->buckets[bucket_index(value)]++;
+    histogram->count++;
+    histogram->sum += value;
+    if (value < histogram->min) {
+        histogram->min = value;
+    }
+    if (value > histogram->max) {
+        histogram->max = value;
+    }
+}
+
+/**
+ * @brief Adds every value of `source` to `destination`.
+ */
+void histogram_merge(Histogram *destination, const Histogram *source) {
+    for (unsigned int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        destination->buckets[i] += source->buckets[i];
+    }
+    destination->count += source->count;
+    destination->sum += source->sum;
+    if (source->min < destination->min) {
+        destination->min = source->min;
+    }
+    if (source->max > destination->max) {
+        destination->max = source->max;
+    }
+}
+
+/**
+ * @brief Returns the value below which `percentile` percent of the recorded values fall.
+ */
+uint64_t histogram_percentile(const Histogram *histogram, double percentile) {
+    if (histogram->count == 0) {
+        return 0;
+    }
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)histogram->count + 0.5);
+    if (rank == 0) {
+        rank = 1;
+    }
+    if (rank > histogram->count) {
+        rank = histogram->count;
+    }
+
+    uint64_t seen = 0;
+    for (unsigned int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += histogram->buckets[i];
+        if (seen >= rank) {
+            uint64_t bound = bucket_upper_bound(i);
+            return bound < histogram->max ? bound : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+/**
+ * @brief Returns the arithmetic mean of the recorded values.
+ */
+double histogram_mean(const Histogram *histogram) {
+    return histogram->count == 0 ? 0.0 : (double)histogram->sum / (double)histogram->count;
+}
+
+/* - - - - - - - - - - - - - - - - - - END HISTOGRAM - - - - - - - - - - - - - - - - - - */
@@ -0,0 +1,85 @@
+/**
+ * @file histogram.h
+ * @brief Header file declaring a fixed-size log-linear latency histogram.
+ *
+ * Values below 32 get one bucket each; above that every power of two is split into 32
+ * linear sub-buckets, so a recorded value is never reported with more than ~3% error.
+ * Recording is a few integer operations and never allocates, which keeps it off the
+ * critical path of the load generator. Histograms of different threads are merged at
+ * the end of a run.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef HISTOGRAM_H_
+#define HISTOGRAM_H_
+
+#include <stdint.h>
+
+/* - - - - - - - - - - - - - - - - - - - HISTOGRAM - - - - - - - - - - - - - - - - - - - */
+
+#define HISTOGRAM_SUB_BITS 5                          /**< log2 of the sub-buckets per power of two */
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_BUCKETS ((64 - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+/**
+ * @struct Histogram
+ * @brief Counts of recorded values, plus their exact count, sum, minimum and maximum.
+ */
+typedef struct {
+    uint64_t buckets[HISTOGRAM_BUCKETS];  /**< Number of values in every bucket */
+    uint64_t count;                       /**< Number of recorded values */
+    uint64_t sum;                         /**< Sum of the recorded values */
+    uint64_t min;                         /**< Smallest recorded value */
+    uint64_t max;                         /**< Largest recorded value */
+} Histogram;
+
+/**
+ * @brief Empties a histogram.
+ *
+ * @param[out] histogram The histogram to reset.
+ */
+void histogram_reset(Histogram *histogram);
+
+/**
+ * @brief Records one value.
+ *
+ * @param[in,out] histogram The histogram to update.
+ * @param[in] value The value to record.
+ */
+void histogram_record(Histogram *histogram, uint64_t value);
+
+/**
+ * @brief Adds every value of `source` to `destination`.
+ *
+ * @param[in,out] destination The histogram that receives the values.
+ * @param[in] source The histogram to add.
+ */
+void histogram_merge(Histogram *destination, const Histogram *source);
+
+/**
+ * @brief Returns the value below which `percentile` percent of the recorded values fall.
+ *
+ * The upper bound of the matching bucket is returned, clamped to the recorded maximum.
+ *
+ * @param[in] histogram The histogram to query.
+ * @param[in] percentile A percentile in [0, 100].
+ *
+ * @return The percentile, or 0 if the histogram is empty.
+ */
+uint64_t histogram_percentile(const Histogram *histogram, double percentile);
+
+/**
+ * @brief Returns the arithmetic mean of the recorded values.
+ *
+ * @param[in] histogram The histogram to query.
+ *
+ * @return The mean, or 0 if the histogram is empty.
+ */
+double histogram_mean(const Histogram *histogram);
+
+/* - - - - - - - - - - - - - - - - - - END HISTOGRAM - - - - - - - - - - - - - - - - - - */
+
+#endif /* HISTOGRAM_H_ */
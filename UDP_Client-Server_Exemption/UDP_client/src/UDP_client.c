@@ -9,7 +9,8 @@
  */
 
 #if defined WIN32
-#include <winsock.h>        /**< Include Winsock library for Windows */
+#include <winsock2.h>       /**< Include Winsock 2 library for Windows */
+#include <ws2tcpip.h>       /**< Include getaddrinfo() and struct sockaddr_storage */
 #else
 #include <unistd.h>         /**< Include UNIX standard header for close() */
 #include <sys/socket.h>     /**< Include socket library for UNIX systems */
@@ -25,10 +26,20 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 
-#include "libs/password/password.h"  /**< Password handling functions */
-#include "libs/protocol/protocol.h"  /**< Communication protocol definitions */
-#include "libs/utils/utils.h"        /**< Utility functions library */
+#include "../../UDP_core/src/libs/checks/checks.h"     /**< Password handling functions */
+#include "../../UDP_core/src/libs/protocol/protocol.h" /**< Communication protocol definitions */
+#include "../../UDP_core/src/libs/seal/seal.h"         /**< Pre-shared key of the sealed responses */
+#include "../../UDP_core/src/libs/utils/utils.h"       /**< Utility functions library */
+
+#include "libs/transport/transport.h"                  /**< Request/response transport */
+#include "libs/pipeline/pipeline.h"                    /**< Pipelined non-interactive mode */
+#include "libs/reliability/reliability.h"              /**< Timeouts and retransmissions */
+#include "libs/resolver/resolver.h"                    /**< Name resolution and address racing */
+#include "libs/balancer/balancer.h"                    /**< Load balancing over a pool of servers */
+#include "libs/menu/menu.h"                            /**< Menus of the interactive mode */
+#include "libs/stash/stash.h"                          /**< Prefetched passwords of the interactive mode */
 
 
 /**
@@ -53,41 +64,221 @@ void error_handler(const char *error_message) {
 #endif
 }
 
+#define DEFINITION_REQUEST_ID UINT32_MAX /**< Identifier of the policy definitions, never used by a request */
+
+/**
+ * @struct PasswordPolicy
+ * @brief The `--policy` of the command line, and the ID it is served under.
+ */
+typedef struct {
+    bool enabled;           /**< Whether a policy was given */
+    bool defined;           /**< Whether it is defined by the client, rather than configured on the servers */
+    PolicySpec spec;        /**< The definition, when `defined` */
+    uint8_t id;             /**< ID of the policy on the servers */
+} PasswordPolicy;
+
+static PasswordPolicy password_policy;  /**< Policy requested with the type letter `p` */
+
+/**
+ * @brief Parse the argument of `--policy`: the ID of a policy configured on the servers, or a
+ * policy definition such as `"classes=lower,upper,digit require=upper,digit exclude=0O1l"`.
+ * @param[in] text The argument.
+ * @return false if it is neither a valid ID nor a valid definition.
+ */
+bool parse_password_policy(const char *text) {
+    char *end;
+    long id = strtol(text, &end, 10);
+    password_policy.enabled = true;
+    password_policy.defined = end == text || *end != '\0';
+    if (!password_policy.defined) {
+        password_policy.id = (uint8_t)id;
+        return id >= 0 && id < MAX_POLICIES;
+    }
+    return parse_policy_spec(text, &password_policy.spec);
+}
+
+/**
+ * @brief Define the `--policy` on one server.
+ * @param[in] client_socket The socket descriptor, connected to the server.
+ * @param[in,out] rtt The estimator of the server.
+ * @param[out] id Receives the ID the server gave to the policy.
+ * @return false if the server did not answer or rejected the policy; the error is printed.
+ */
+bool define_policy_on(int client_socket, RttEstimator *rtt, uint8_t *id) {
+    PasswordResponse response_msg;
+    if (!exchange_policy_definition(client_socket, &password_policy.spec, DEFINITION_REQUEST_ID, &response_msg, rtt)) {
+        error_handler("No response to the policy definition.\n");
+        return false;
+    }
+    if (response_msg.status != STATUS_OK || response_msg.length != 1) {
+        error_handler("The server rejected the policy.\n");
+        return false;
+    }
+    *id = (uint8_t)response_msg.password[0];
+    return true;
+}
+
 /**
- * @brief Initialize a UDP socket.
- * @details Creates and initializes a socket for UDP communication.
- * @return >=0 The socket descriptor on success.
- * @return -1 If an error occurs while creating the socket.
+ * @brief Define the `--policy` on the server of the session, or on every server of the pool.
+ * @details The servers derive the ID from the policy, so they agree unless their own policies
+ * collide; requests could then not be spread over them, and the definition fails.
+ * @param[in,out] session The open session, used without `--balance`.
+ * @param[in,out] balancer The pool of servers, used with `--balance`.
+ * @param[in] balance Whether the requests are spread over the pool.
+ * @param[in,out] rtt The estimator of the session.
+ * @return true if the policy has an ID on every server, or if it was given as an ID.
  */
-int initialize_socket() {
-    int created_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-    if (created_socket < 0) {
-        error_handler("Error creating socket.\n");
+bool setup_password_policy(ServerSession *session, Balancer *balancer, bool balance, RttEstimator *rtt) {
+    if (!password_policy.defined) {
+        return true;
+    }
+    if (!balance) {
+        return define_policy_on(session->socket, rtt, &password_policy.id);
+    }
+    for (unsigned int i = 0; i < balancer->count; i++) {
+        uint8_t id;
+        if (!define_policy_on(balancer->backends[i].socket, &balancer->backends[i].rtt, &id)) {
+            return false;
+        }
+        if (i > 0 && id != password_policy.id) {
+            error_handler("The servers gave the policy different IDs.\n");
+            return false;
+        }
+        password_policy.id = id;
     }
-    return created_socket;
+    return true;
 }
 
 /**
- * @brief Resolve the server hostname to an IP address.
- * @details Uses `gethostbyname` to resolve the server hostname and populate a sockaddr_in structure.
- * @param[in] server_name The hostname of the server.
- * @param[out] server_address A pointer to a sockaddr_in structure to store the resolved address.
- * @return true if the hostname is resolved successfully.
- * @return false if an error occurs during resolution.
+ * @brief Turn the type letter `p` of a request into a request for the `--policy`.
+ * @param[in,out] password_request The request, with its type and flags set.
+ * @return false if the type is `p` and no policy was given; the error is printed.
  */
-bool resolve_server_address(const char *server_name, struct sockaddr_in *server_address) {
-    struct hostent *host = gethostbyname(server_name);
-    if (host == NULL) {
-        error_handler("Error resolving host\n");
+bool apply_password_policy(PasswordRequest *password_request) {
+    if (tolower(password_request->type) != 'p') {
+        return true;
+    }
+    if (!password_policy.enabled) {
+        error_handler("No policy given with --policy.\n");
         return false;
     }
-    memset(server_address, 0, sizeof(struct sockaddr_in)); /**< Clear the structure */
-    server_address->sin_family = AF_INET;                  /**< Use IPv4 */
-    server_address->sin_addr = *((struct in_addr *)host->h_addr); /**< Copy server IP address */
-    server_address->sin_port = htons(DEFAULT_PORT);        /**< Convert port to network byte order */
+    password_request->type = (char)password_policy.id;
+    password_request->flags |= REQUEST_FLAG_POLICY;
     return true;
 }
 
+/**
+ * @brief Send a request, failing over to the next server endpoints while it gets no answer.
+ * @details Each endpoint tried gets the full retransmission budget; the RTT estimator is reset
+ * when the session moves, since the measurements of the previous server no longer apply.
+ * @param[in,out] session The open session.
+ * @param[in] policy Timeouts and retransmissions.
+ * @param[in] password_request The request, with its `request_id` set.
+ * @param[out] response_msg Receives the response.
+ * @param[in,out] rtt The estimator of the current endpoint.
+ * @return true if an endpoint answered.
+ */
+bool exchange_with_failover(ServerSession *session, const RetryPolicy *policy,
+                            const PasswordRequest *password_request, PasswordResponse *response_msg, RttEstimator *rtt) {
+    for (unsigned int tried = 0; tried < session->endpoint_count; tried++) {
+        if (exchange_request(session->socket, password_request, response_msg, rtt)) {
+            return true;
+        }
+        if (!failover_session(session, policy)) {
+            return false;
+        }
+        rtt_init(rtt, policy);
+    }
+    return false;
+}
+
+/**
+ * @brief Send a request to the servers of the pool until one of them answers.
+ * @details Each backend tried gets the full retransmission budget; a backend that exhausts it
+ * is ejected, so the next choice falls on another one.
+ * @param[in,out] balancer The pool of servers.
+ * @param[in] password_request The request, with its `request_id` set.
+ * @param[out] response_msg Receives the response.
+ * @return true if a backend answered.
+ */
+bool exchange_balanced(Balancer *balancer, const PasswordRequest *password_request, PasswordResponse *response_msg) {
+    for (unsigned int tried = 0; tried < balancer->count; tried++) {
+        Backend *backend = pick_backend(balancer);
+        backend->outstanding++;
+        if (exchange_request(backend->socket, password_request, response_msg, &backend->rtt)) {
+            backend_answered(backend, 0); /**< exchange_request has already sampled the RTT */
+            return true;
+        }
+        backend->outstanding--;
+        eject_backend(balancer, backend);
+    }
+    return false;
+}
+
+/**
+ * @brief Connect every server endpoint and add it to the pool.
+ * @details The endpoints are not probed: one that does not answer is ejected by the first
+ * requests that time out on it.
+ * @param[in,out] session The session owning the endpoints and the resolution cache.
+ * @param[out] balancer The pool, initialized by this function.
+ * @param[in] policy Timeouts and retransmissions.
+ * @return true if at least one endpoint could be connected.
+ */
+bool open_balancer(ServerSession *session, Balancer *balancer, const RetryPolicy *policy) {
+    init_balancer(balancer, policy);
+    for (unsigned int i = 0; i < session->endpoint_count; i++) {
+        struct sockaddr_storage address;
+        bool answered;
+        int backend_socket = connect_endpoint(session, i, policy, false, &address, &answered);
+        if (backend_socket < 0) {
+            char message[RESOLVER_HOST_SIZE + 32];
+            snprintf(message, sizeof(message), "Cannot connect to %s.\n", session->endpoints[i]);
+            error_handler(message);
+            continue;
+        }
+        add_backend(balancer, backend_socket);
+    }
+    return balancer->count > 0;
+}
+
+/**
+ * @brief Parse a bulk command of the form `b TYPE LENGTH COUNT`.
+ * @param[in] input The line typed by the user.
+ * @param[out] password_request A pointer to a PasswordRequest structure to store the bulk request.
+ * @return true if the type, length and count are valid.
+ * @return false otherwise.
+ */
+bool parse_bulk_input(const char *input, PasswordRequest *password_request) {
+    char length[BUFFER_SIZE];
+    char count[BUFFER_SIZE];
+    char extra[BUFFER_SIZE];
+
+    if (sscanf(input, " %*c %c %s %s %s", &password_request->type, length, count, extra) != 3) {
+        print_with_color("Invalid input. Usage: b TYPE LENGTH COUNT\n", RED);
+        return false;
+    }
+
+    if (!control_type("namsup", password_request->type)) {
+        print_with_color("Invalid type. Please choose a valid option.\n", RED);
+        return false;
+    }
+
+    if (!control_length(length, MIN_PASSWORD_LENGTH, MAX_PASSWORD_LENGTH)) {
+        print_with_color("Invalid length. Please choose a valid range.\n", RED);
+        return false;
+    }
+
+    if (!control_length(count, 1, MAX_BULK_COUNT)) {
+        print_with_color("Invalid count. Please choose a valid range.\n", RED);
+        return false;
+    }
+
+    password_request->length = (uint8_t)atoi(length);
+    password_request->count = (uint16_t)atoi(count);
+    password_request->flags = REQUEST_FLAG_BULK;
+    return apply_password_policy(password_request);
+}
+
 /**
  * @brief Prompt user for password type and length.
  * @details Displays a menu to the user and validates the input for password generation parameters.
@@ -97,6 +288,8 @@ bool resolve_server_address(const char *server_name, struct sockaddr_in *server_
  */
 bool handle_user_input(PasswordRequest *password_request) {
     char input[BUFFER_SIZE];
+    char length[BUFFER_SIZE];
+    char extra[BUFFER_SIZE];
     int arguments;
 
     do {
@@ -104,79 +297,406 @@ bool handle_user_input(PasswordRequest *password_request) {
         fgets(input, sizeof(input), stdin); /**< Get user input */
         input[BUFFER_SIZE - 1] = '\0';      /**< Ensure null termination */
 
-        arguments = sscanf(input, " %c %s %s", &password_request->type, password_request->length, input);
-        password_request->length[BUFFER_SIZE - 1] = '\0';
+        arguments = sscanf(input, " %c %s %s", &password_request->type, length, extra);
+        length[BUFFER_SIZE - 1] = '\0';
 
         if (tolower(password_request->type) == 'h') {
             show_help_menu(); /**< Show help menu */
         }
     } while (tolower(password_request->type) == 'h');
 
+    if (tolower(password_request->type) == 'b') {
+        return parse_bulk_input(input, password_request);
+    }
+
     if (arguments == 1) {
-        strcpy(password_request->length, "8"); /**< Default to length 8 */
+        strcpy(length, "8"); /**< Default to length 8 */
     } else if (arguments != 2) {
         print_with_color("Invalid input. Please provide a valid type and length.\n", RED);
         return false;
     }
 
-    if (!control_type("namsuq", password_request->type)) {
+    if (!control_type("namsupq", password_request->type)) {
         print_with_color("Invalid type. Please choose a valid option.\n", RED);
         return false;
     }
 
-    if (!control_length(password_request->length, MIN_PASSWORD_LENGTH, MAX_PASSWORD_LENGTH)) {
+    if (!control_length(length, MIN_PASSWORD_LENGTH, MAX_PASSWORD_LENGTH)) {
         print_with_color("Invalid length. Please choose a valid range.\n", RED);
         return false;
     }
 
+    password_request->length = (uint8_t)atoi(length);
+    password_request->count = 1;
+    password_request->flags = 0;
+
+    return apply_password_policy(password_request);
+}
+
+/**
+ * @brief Send a bulk request, then receive and print its passwords.
+ * @details The server answers with `total` numbered datagrams, each packing several passwords.
+ * Datagrams belonging to other requests, already received, or failing their authentication, are ignored. A cookie
+ * challenge is kept for the socket and answered at once the first time. If no datagram arrives
+ * before the timeout, the request is sent again and the missing datagrams are taken from the new
+ * answer.
+ * @param[in] client_socket The socket descriptor, connected to the server.
+ * @param[in] password_request Pointer to the bulk PasswordRequest to send.
+ * @param[in,out] rtt The estimator that sets the timeouts.
+ * @return true if every datagram of the response is received.
+ * @return false if the request cannot be sent or every retransmission timed out.
+ */
+bool exchange_bulk_request(int client_socket, const PasswordRequest *password_request, RttEstimator *rtt) {
+    uint8_t datagram[MAX_DATAGRAM_SIZE];
+    char password[MAX_PASSWORD_LENGTH + 1];
+    bool seen[MAX_BULK_COUNT] = { false };
+    unsigned int received = 0;
+    unsigned int total = 1;
+    unsigned int retries = 0;
+    bool challenged = false;
+
+    if (!send_request(client_socket, password_request)) {
+        return false;
+    }
+    uint64_t deadline = monotonic_us() + rtt_timeout(rtt, retries);
+
+    while (received < total) {
+        uint64_t now = monotonic_us();
+        int ready = now < deadline ? wait_for_datagram(client_socket, deadline - now) : 0;
+        if (ready < 0) {
+            return false;
+        }
+        if (ready == 0) {
+            if (retries == rtt->policy->max_retries ||
+                !send_request(client_socket, password_request)) {
+                return false;
+            }
+            retries++;
+            deadline = monotonic_us() + rtt_timeout(rtt, retries);
+            continue;
+        }
+
+        BulkResponseHeader header;
+        int rcv_msg_size = recv(client_socket, (char *)datagram, sizeof(datagram), 0);
+        if (rcv_msg_size < 0 || !decode_bulk_header(datagram, rcv_msg_size, &header) ||
+            header.request_id != password_request->request_id ||
+            header.sequence >= MAX_BULK_COUNT || seen[header.sequence] || !open_bulk_datagram(datagram, &header)) {
+            continue; /**< Not a new, authentic part of this response */
+        }
+        if (header.status == STATUS_COOKIE_REQUIRED && header.items == 1 && header.length == COOKIE_SIZE) {
+            store_cookie(client_socket, datagram + BULK_HEADER_SIZE);
+            if (!challenged) {
+                challenged = true;  /**< Later challenges wait for the retransmission */
+                if (!send_request(client_socket, password_request)) {
+                    return false;
+                }
+                deadline = monotonic_us() + rtt_timeout(rtt, retries);
+            }
+            continue;
+        }
+        if (header.status != STATUS_OK) {
+            print_with_color("The server rejected the request.\n\n", RED);
+            return true;
+        }
+
+        seen[header.sequence] = true;
+        total = header.total;
+        received++;
+        deadline = monotonic_us() + rtt_timeout(rtt, retries); /**< The response is still arriving */
+        for (unsigned int i = 0; i < header.items; i++) {
+            memcpy(password, datagram + BULK_HEADER_SIZE + (size_t)i * header.length, header.length);
+            password[header.length] = '\0';
+            print_with_color("Password generated: ", GREEN);
+            print_with_color(password, GREEN);
+            printf("\n");
+        }
+    }
+    printf("\n");
     return true;
 }
 
 /**
- * @brief Send a password request to the server.
- * @details Sends a PasswordRequest structure to the server address specified.
- * @param[in] client_socket The socket descriptor.
- * @param[in] password_request Pointer to the PasswordRequest structure.
- * @param[in] server_address Pointer to the server's sockaddr_in structure.
- * @return true if the request is sent successfully.
- * @return false if an error occurs during sending.
+ * @struct ScriptOptions
+ * @brief Jobs and settings of the non-interactive mode.
+ */
+typedef struct {
+    const char *endpoints[MAX_ENDPOINTS]; /**< Server endpoints, in order of preference */
+    unsigned int endpoint_count; /**< Number of `--host` options */
+    unsigned short port;    /**< Port of the endpoints that do not name one */
+    unsigned int dns_ttl;   /**< Seconds a resolved name is reused */
+    unsigned int window;    /**< Maximum number of requests in flight */
+    bool balance;           /**< Whether requests are spread over every endpoint */
+    unsigned int stash_size; /**< Passwords prefetched by the interactive mode, 0 for none */
+    unsigned int stash_low; /**< Low-water mark of the stash */
+    RetryPolicy policy;     /**< Timeouts and retransmissions */
+    PipelineJob *jobs;      /**< Requests to run, in output order */
+    size_t count;           /**< Number of jobs */
+    size_t capacity;        /**< Allocated jobs */
+} ScriptOptions;
+
+/**
+ * @brief Parse a `TYPE [LENGTH]` tuple such as `s 16`.
+ * @details The length defaults to 8 as in the interactive mode. The type `p` stands for the
+ * `--policy`, whose ID is only known once it is defined: `apply_password_policy` is called on
+ * the jobs after the connection.
+ * @param[in] text The tuple.
+ * @param[out] password_request A pointer to a PasswordRequest structure to fill.
+ * @return true if the type and length are valid.
+ * @return false otherwise; the error is printed.
  */
-bool send_request(int client_socket, const PasswordRequest *password_request, const struct sockaddr_in *server_address) {
-    if (sendto(client_socket, password_request, sizeof(*password_request), 0,
-               (struct sockaddr *)server_address, sizeof(*server_address)) != sizeof(*password_request)) {
-        error_handler("Error sending password request.\n");
+bool parse_tuple(const char *text, PasswordRequest *password_request) {
+    char length[BUFFER_SIZE] = "8";
+    char extra[BUFFER_SIZE];
+    int arguments = sscanf(text, " %c %1023s %1023s", &password_request->type, length, extra);
+
+    if (arguments < 1 || arguments > 2 || !control_type("namsup", password_request->type) ||
+        !control_length(length, MIN_PASSWORD_LENGTH, MAX_PASSWORD_LENGTH)) {
+        char message[BUFFER_SIZE + 32];
+        snprintf(message, sizeof(message), "Invalid request: %s\n", text);
+        error_handler(message);
         return false;
     }
+
+    password_request->length = (uint8_t)atoi(length);
+    password_request->count = 1;
+    password_request->flags = 0;
     return true;
 }
 
 /**
- * @brief Receive the password response from the server.
- * @param[in] client_socket The socket descriptor.
- * @param[out] response_msg Pointer to the PasswordResponse structure to store the response.
- * @param[in] server_address Pointer to the sockaddr_in structure of the server.
- * @return true if the response is received successfully.
- * @return false if an error occurs during reception.
+ * @brief Append the job described by a tuple.
+ * @param[in,out] options Pointer to the ScriptOptions structure.
+ * @param[in] tuple The `TYPE [LENGTH]` tuple.
+ * @return false if the tuple is invalid or the job list cannot grow.
  */
-bool receive_response(int client_socket, PasswordResponse *response_msg, struct sockaddr_in *server_address) {
-    unsigned int server_address_size = sizeof(*server_address);
-    int rcv_msg_size = recvfrom(client_socket, response_msg, sizeof(*response_msg), 0,
-                                (struct sockaddr *)server_address, &server_address_size);
-    if (rcv_msg_size < 0) {
-        error_handler("Error receiving password response.\n");
+bool append_job(ScriptOptions *options, const char *tuple) {
+    if (options->count == options->capacity) {
+        size_t capacity = options->capacity == 0 ? 64 : options->capacity * 2;
+        PipelineJob *jobs = realloc(options->jobs, capacity * sizeof(PipelineJob));
+        if (jobs == NULL) {
+            error_handler("Error allocating the requests.\n");
+            return false;
+        }
+        options->jobs = jobs;
+        options->capacity = capacity;
+    }
+    if (!parse_tuple(tuple, &options->jobs[options->count].request)) {
         return false;
     }
+    options->count++;
     return true;
 }
 
+/**
+ * @brief Append one job per line of a file; blank lines and lines starting with `#` are skipped.
+ * @param[in,out] options Pointer to the ScriptOptions structure.
+ * @param[in] path Path of the file, or `-` for the standard input.
+ * @return false if the file cannot be read or a line is invalid.
+ */
+bool read_job_file(ScriptOptions *options, const char *path) {
+    FILE *file = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (file == NULL) {
+        error_handler("Error opening the request file.\n");
+        return false;
+    }
+
+    char line[BUFFER_SIZE];
+    bool valid = true;
+    while (valid && fgets(line, sizeof(line), file) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+        const char *start = line + strspn(line, " \t");
+        if (*start != '\0' && *start != '#') {
+            valid = append_job(options, start);
+        }
+    }
+
+    if (file != stdin) {
+        fclose(file);
+    }
+    return valid;
+}
+
+/**
+ * @brief Parse the command line of the non-interactive mode.
+ * @details Every argument that is not an option is a tuple, either quoted (`"s 16"`) or split
+ * over two arguments (`s 16`).
+ * @param[in] argc Number of arguments.
+ * @param[in] argv Arguments.
+ * @param[out] options Pointer to the ScriptOptions structure to fill.
+ * @return false if an option or a tuple is invalid; the usage is printed.
+ */
+bool parse_script_arguments(int argc, char *argv[], ScriptOptions *options) {
+    memset(options, 0, sizeof(*options));
+    options->port = DEFAULT_PORT;
+    options->dns_ttl = DEFAULT_RESOLVER_TTL_S;
+    options->window = DEFAULT_WINDOW;
+    options->stash_size = DEFAULT_STASH_SIZE;
+    options->stash_low = DEFAULT_STASH_LOW;
+    default_retry_policy(&options->policy);
+
+    for (int i = 1; i < argc; i++) {
+        char tuple[BUFFER_SIZE];
+        if (strcmp(argv[i], "--host") == 0 && i + 1 < argc) {
+            if (options->endpoint_count == MAX_ENDPOINTS) {
+                error_handler("Too many servers.\n");
+                return false;
+            }
+            options->endpoints[options->endpoint_count++] = argv[++i];
+        } else if (strcmp(argv[i], "--balance") == 0) {
+            options->balance = true;
+        } else if (strcmp(argv[i], "--dns-ttl") == 0 && i + 1 < argc) {
+            int dns_ttl = atoi(argv[++i]);
+            if (dns_ttl < 0) {
+                error_handler("Invalid DNS cache lifetime.\n");
+                return false;
+            }
+            options->dns_ttl = (unsigned int)dns_ttl;
+        } else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            int port = atoi(argv[++i]);
+            if (port < 1 || port > 65535) {
+                error_handler("Invalid port.\n");
+                return false;
+            }
+            options->port = (unsigned short)port;
+        } else if (strcmp(argv[i], "--window") == 0 && i + 1 < argc) {
+            int window = atoi(argv[++i]);
+            if (window < 1 || window > MAX_WINDOW) {
+                error_handler("Invalid window.\n");
+                return false;
+            }
+            options->window = (unsigned int)window;
+        } else if (strcmp(argv[i], "--stash") == 0 && i + 1 < argc) {
+            int stash_size = atoi(argv[++i]);
+            if (stash_size < 0 || stash_size > MAX_STASH_SIZE) {
+                error_handler("Invalid stash size.\n");
+                return false;
+            }
+            options->stash_size = (unsigned int)stash_size;
+        } else if (strcmp(argv[i], "--stash-low") == 0 && i + 1 < argc) {
+            int stash_low = atoi(argv[++i]);
+            if (stash_low < 0 || stash_low >= MAX_STASH_SIZE) {
+                error_handler("Invalid stash low-water mark.\n");
+                return false;
+            }
+            options->stash_low = (unsigned int)stash_low;
+        } else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc) {
+            int timeout = atoi(argv[++i]);
+            if (timeout < 1) {
+                error_handler("Invalid timeout.\n");
+                return false;
+            }
+            options->policy.initial_rto_ms = (uint32_t)timeout;
+        } else if (strcmp(argv[i], "--max-rto") == 0 && i + 1 < argc) {
+            int max_rto = atoi(argv[++i]);
+            if (max_rto < 1) {
+                error_handler("Invalid maximum timeout.\n");
+                return false;
+            }
+            options->policy.max_rto_ms = (uint32_t)max_rto;
+        } else if (strcmp(argv[i], "--retries") == 0 && i + 1 < argc) {
+            int retries = atoi(argv[++i]);
+            if (retries < 0 || retries > 16) {
+                error_handler("Invalid number of retries.\n");
+                return false;
+            }
+            options->policy.max_retries = (unsigned int)retries;
+        } else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc) {
+            if (!parse_password_policy(argv[++i])) {
+                error_handler("Invalid policy.\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--psk-file") == 0 && i + 1 < argc) {
+            if (!seal_self_test()) {
+                error_handler("The ChaCha20-Poly1305 self-test failed.\n");
+                return false;
+            }
+            SealKey key;
+            if (!load_seal_key(argv[++i], &key)) {
+                error_handler("Invalid pre-shared key file.\n");
+                return false;
+            }
+            enable_sealing(&key); /**< Every request asks for a sealed response */
+            memset(&key, 0, sizeof(key));
+        } else if (strcmp(argv[i], "--file") == 0 && i + 1 < argc) {
+            if (!read_job_file(options, argv[++i])) {
+                return false;
+            }
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            error_handler("Usage: UDP_client [--host HOST[:PORT]]... [--port N] [--dns-ttl S] [--balance]\n"
+                          "                  [--window N] [--timeout MS] [--max-rto MS] [--retries N]\n"
+                          "                  [--stash N] [--stash-low N]\n"
+                          "                  [--policy ID|SPEC] [--psk-file PATH] [--file PATH|-] [TYPE [LENGTH]]...\n");
+            return false;
+        } else {
+            if (strlen(argv[i]) == 1 && i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) {
+                snprintf(tuple, sizeof(tuple), "%s %s", argv[i], argv[i + 1]);
+                i++;
+            } else {
+                snprintf(tuple, sizeof(tuple), "%s", argv[i]);
+            }
+            if (!append_job(options, tuple)) {
+                return false;
+            }
+        }
+    }
+    if (options->endpoint_count == 0) {
+        options->endpoints[options->endpoint_count++] = DEFAULT_HOST;
+    }
+    if (options->policy.min_rto_ms > options->policy.max_rto_ms) {
+        options->policy.min_rto_ms = options->policy.max_rto_ms;
+    }
+    if (options->stash_low >= options->stash_size) {
+        options->stash_low = options->stash_size / 4;
+    }
+    return true;
+}
+
+/**
+ * @brief Print the password of a completed job, one per line.
+ * @param[in] job The completed job.
+ * @param[in,out] context Pointer to the number of rejected or expired requests.
+ */
+void print_job(const PipelineJob *job, void *context) {
+    if (job->expired) {
+        (*(size_t *)context)++;
+        error_handler("No response from the server.\n");
+        printf("\n");
+        return;
+    }
+    if (job->response.status != STATUS_OK) {
+        (*(size_t *)context)++;
+        error_handler("The server rejected the request.\n");
+        printf("\n"); /**< Keep one output line per request */
+        return;
+    }
+    printf("%s\n", job->response.password);
+}
+
 /**
  * @brief Main function of the UDP client.
  * @details Initializes the socket, resolves the server address, and communicates with the password generation server.
- * The client continues until the user decides to quit.
+ * The client continues until the user decides to quit; a request without an answer is retransmitted
+ * and, once the retries run out, sent to the next `--host` endpoint, or reported without ending the session. With `--balance`
+ * the requests are spread over every endpoint instead (see balancer.h). A `--policy` definition is sent to
+ * every server in use before the first request, and sent again if a server no longer knows it. When request tuples are given,
+ * the client runs them as a pipelined batch instead (see parse_script_arguments) and prints one password per line.
+ * The interactive mode serves a request repeating the previous one from a stash of prefetched passwords (see stash.h),
+ * sized with `--stash` (0 disables it) and refilled below `--stash-low`.
+ * @param[in] argc Number of arguments.
+ * @param[in] argv Arguments; only options (or none) for the interactive mode.
  * @return EXIT_SUCCESS on successful completion.
  * @return EXIT_FAILURE if an error occurs during execution.
  */
-int main() {
+int main(int argc, char *argv[]) {
+
+    ScriptOptions script;
+    if (!parse_script_arguments(argc, argv, &script)) {
+        free(script.jobs);
+        return EXIT_FAILURE;
+    }
+    bool scripted = script.count > 0;
+    RttEstimator rtt;
+    rtt_init(&rtt, &script.policy);
 
 #if defined WIN32
     WSADATA wsa_data;
@@ -188,21 +708,62 @@ int main() {
     }
 #endif
 
-    struct sockaddr_in server_address;
-
-    if (!resolve_server_address("passwdgen.uniba.it", &server_address)) {
+    ServerSession session;
+    init_session(&session, script.endpoints, script.endpoint_count, script.port, script.dns_ttl);
+    Balancer balancer;
+    if (script.balance) {
+        if (!open_balancer(&session, &balancer, &script.policy)) {
+            error_handler("Error connecting to the servers.\n");
+            free(script.jobs);
+            clear_winsock();
+            return EXIT_FAILURE;
+        }
+    } else if (!open_session(&session, &script.policy)) {
+        error_handler("Error connecting to the server.\n");
+        free(script.jobs);
         clear_winsock();
         return EXIT_FAILURE;
     }
-
-    int client_socket = initialize_socket();
-    if (client_socket < 0) {
+    bool ready = setup_password_policy(&session, &balancer, script.balance, &rtt);
+    for (size_t i = 0; ready && i < script.count; i++) {
+        ready = apply_password_policy(&script.jobs[i].request);
+    }
+    if (!ready) {
+        free(script.jobs);
+        if (script.balance) {
+            close_balancer(&balancer);
+        }
+        close_session(&session);
         clear_winsock();
         return EXIT_FAILURE;
     }
 
+    if (scripted) {
+        if (!script.balance) {
+            init_balancer(&balancer, &script.policy);  /**< A pool of the single server chosen */
+            add_backend(&balancer, session.socket);
+            session.socket = -1;
+        }
+        size_t rejected = 0;
+        bool completed = run_pipeline(&balancer, script.jobs, script.count,
+                                      script.window, print_job, &rejected);
+        if (!completed) {
+            error_handler("Error exchanging the requests with the server.\n");
+        }
+        free(script.jobs);
+        close_balancer(&balancer);
+        clear_winsock();
+        return completed && rejected == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     PasswordRequest password_request;
     PasswordResponse response_msg;
+    uint32_t next_request_id = 0;
+    char stashed[MAX_PASSWORD_LENGTH + 1];
+    Stash stash;
+    if (!init_stash(&stash, script.stash_size, script.stash_low, &script.policy)) {
+        error_handler("Error initializing the password stash; it is disabled.\n");
+    }
 
     while (true) {
         if (!handle_user_input(&password_request)) {
@@ -213,24 +774,67 @@ int main() {
             break;
         }
 
-        if (!send_request(client_socket, &password_request, &server_address)) {
-            closesocket(client_socket);
-            clear_winsock();
-            return EXIT_FAILURE;
+        password_request.request_id = next_request_id++;
+
+        if (password_request.flags & REQUEST_FLAG_BULK && script.balance) {
+            Backend *backend = pick_backend(&balancer);
+            if (!exchange_bulk_request(backend->socket, &password_request, &backend->rtt)) {
+                error_handler("No response from the server.\n\n");
+                eject_backend(&balancer, backend); /**< Not retried: part of it may be printed */
+            }
+            continue;
         }
 
-        if (!receive_response(client_socket, &response_msg, &server_address)) {
-            closesocket(client_socket);
-            clear_winsock();
-            return EXIT_FAILURE;
+        if (password_request.flags & REQUEST_FLAG_BULK) {
+            if (!exchange_bulk_request(session.socket, &password_request, &rtt)) {
+                error_handler("No response from the server.\n\n");
+                if (failover_session(&session, &script.policy)) {
+                    rtt_init(&rtt, &script.policy); /**< Not retried: part of it may be printed */
+                }
+            }
+            continue;
+        }
+
+        if (take_stashed(&stash, &password_request, stashed)) {
+            print_with_color("Password generated: ", GREEN);
+            print_with_color(stashed, GREEN);
+            printf("\n\n");
+            memset(stashed, 0, sizeof(stashed));
+            refill_stash(&stash, &password_request, script.balance ? pick_backend(&balancer)->socket : session.socket);
+            continue;
+        }
+
+        bool answered = script.balance ?
+                        exchange_balanced(&balancer, &password_request, &response_msg) :
+                        exchange_with_failover(&session, &script.policy, &password_request, &response_msg, &rtt);
+        if (answered && response_msg.status == STATUS_UNKNOWN_POLICY && password_policy.defined &&
+            setup_password_policy(&session, &balancer, script.balance, &rtt)) {
+            password_request.type = (char)password_policy.id; /**< The server restarted or the session failed over */
+            answered = script.balance ?
+                       exchange_balanced(&balancer, &password_request, &response_msg) :
+                       exchange_with_failover(&session, &script.policy, &password_request, &response_msg, &rtt);
+        }
+        if (!answered) {
+            error_handler("No response from the server.\n\n");
+            continue;
+        }
+
+        if (response_msg.status != STATUS_OK) {
+            print_with_color("The server rejected the request.\n\n", RED);
+            continue;
         }
 
         print_with_color("Password generated: ", GREEN);
         print_with_color(response_msg.password, GREEN);
         printf("\n\n");
+        refill_stash(&stash, &password_request, script.balance ? pick_backend(&balancer)->socket : session.socket);
     }
 
-    closesocket(client_socket);
+    close_stash(&stash);
+    if (script.balance) {
+        close_balancer(&balancer);
+    }
+    close_session(&session);
     clear_winsock();
 #if defined WIN32
     Sleep(3000);
@@ -0,0 +1,240 @@
+/**
+ * @file balancer.c
+ * @brief Implementation of the client-side load balancer over a pool of servers.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#if defined WIN32
+#include <winsock2.h>       /**< Include select() */
+#else
+#include <unistd.h>         /**< Include close() */
+#include <sys/select.h>     /**< Include select() */
+#define closesocket close   /**< Define closesocket as close for UNIX systems */
+#endif
+
+#include <string.h>
+#include "balancer.h"
+
+/* - - - - - - - - - - - - - - - - - - - BALANCER - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Initializes an empty pool.
+ */
+void init_balancer(Balancer *balancer, const RetryPolicy *policy) {
+    memset(balancer, 0, sizeof(*balancer));
+    balancer->policy = policy;
+    balancer->random_state = monotonic_us() | 1;
+}
+
+/**
+ * @brief Adds a server to the pool.
+ */
+bool add_backend(Balancer *balancer, int backend_socket) {
+    if (balancer->count == MAX_ENDPOINTS) {
+        return false;
+    }
+    Backend *backend = &balancer->backends[balancer->count++];
+    memset(backend, 0, sizeof(*backend));
+    backend->socket = backend_socket;
+    backend->ejection_ms = BALANCER_MIN_EJECTION_MS;
+    rtt_init(&backend->rtt, balancer->policy);
+    return true;
+}
+
+/**
+ * @brief Draws a random index below `bound` (xorshift64*).
+ */
+static unsigned int random_below(Balancer *balancer, unsigned int bound) {
+    balancer->random_state ^= balancer->random_state >> 12;
+    balancer->random_state ^= balancer->random_state << 25;
+    balancer->random_state ^= balancer->random_state >> 27;
+    return (unsigned int)(((balancer->random_state * 0x2545F4914F6CDD1DULL) >> 32) % bound);
+}
+
+/**
+ * @brief Expected cost of one more request: smoothed RTT times outstanding requests plus one.
+ * @details A backend without a sample counts as instant, so that it is measured soon instead of
+ *          being starved by the pessimistic initial RTO.
+ */
+static uint64_t backend_cost(const Backend *backend) {
+    uint64_t rtt_us = backend->rtt.has_sample ? backend->rtt.srtt_us : 0;
+    return (rtt_us + 1) * (backend->outstanding + 1);
+}
+
+/**
+ * @brief Puts a backend back into rotation after it answered.
+ */
+static void readmit_backend(Backend *backend) {
+    backend->ejected = false;
+    backend->failures = 0;
+    backend->ejection_ms = BALANCER_MIN_EJECTION_MS;
+    rtt_init(&backend->rtt, backend->rtt.policy);  /**< The old measurements are stale */
+}
+
+/**
+ * @brief Ejects a backend at once, e.g. after a request exhausted its retransmissions on it.
+ * @details A pool of one server never ejects it: there would be nothing to fall back to.
+ */
+void eject_backend(Balancer *balancer, Backend *backend) {
+    if (balancer->count < 2 || backend->ejected) {
+        return;
+    }
+    backend->ejected = true;
+    backend->probe_at_us = monotonic_us() + (uint64_t)backend->ejection_ms * 1000;
+}
+
+/**
+ * @brief Sends a probe to every ejected backend whose pause has elapsed, then doubles the pause.
+ */
+static void send_due_probes(Balancer *balancer, uint64_t now) {
+    for (unsigned int i = 0; i < balancer->count; i++) {
+        Backend *backend = &balancer->backends[i];
+        if (!backend->ejected || now < backend->probe_at_us) {
+            continue;
+        }
+        PasswordRequest probe = { 'n', MIN_PASSWORD_LENGTH, 0, BALANCER_PROBE_ID + i, 1, { 0 } };
+        send_request(backend->socket, &probe);  /**< A lost probe is just tried again later */
+        backend->ejection_ms = backend->ejection_ms * 2 < BALANCER_MAX_EJECTION_MS ?
+                               backend->ejection_ms * 2 : BALANCER_MAX_EJECTION_MS;
+        backend->probe_at_us = now + (uint64_t)backend->ejection_ms * 1000;
+    }
+}
+
+/**
+ * @brief Reads one datagram from a readable backend.
+ * @return 1 for a response to a session request, 0 for anything else.
+ */
+static int read_backend(Balancer *balancer, Backend *backend, PasswordResponse *response) {
+    if (!receive_response(backend->socket, response)) {
+        if (connection_refused() && ++backend->failures >= BALANCER_EJECT_AFTER) {
+            eject_backend(balancer, backend);  /**< Nothing listens on the server port */
+        }
+        return 0;
+    }
+    if (response->request_id >= BALANCER_PROBE_ID && response->request_id < BALANCER_PROBE_ID + MAX_ENDPOINTS) {
+        if (backend->ejected) {
+            readmit_backend(backend);
+        }
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Waits for the sockets of the backends selected by `ejected_only`.
+ * @return The number of sockets set in `readable`, or -1 on error.
+ */
+static int wait_for_backends(const Balancer *balancer, bool ejected_only, uint64_t timeout_us, fd_set *readable) {
+    int highest = -1;
+    FD_ZERO(readable);
+    for (unsigned int i = 0; i < balancer->count; i++) {
+        const Backend *backend = &balancer->backends[i];
+        if (!ejected_only || backend->ejected) {
+            FD_SET(backend->socket, readable);
+            highest = backend->socket > highest ? backend->socket : highest;
+        }
+    }
+    if (highest < 0) {
+        return 0;
+    }
+    struct timeval timeout = { (long)(timeout_us / 1000000), (long)(timeout_us % 1000000) };
+    int ready = select(highest + 1, readable, NULL, NULL, &timeout);
+    return ready < 0 ? -1 : ready;
+}
+
+/**
+ * @brief Chooses the backend of the next transmission (power of two choices).
+ */
+Backend *pick_backend(Balancer *balancer) {
+    fd_set readable;
+    send_due_probes(balancer, monotonic_us());
+    if (wait_for_backends(balancer, true, 0, &readable) > 0) {
+        for (unsigned int i = 0; i < balancer->count; i++) {
+            PasswordResponse response;
+            if (balancer->backends[i].ejected && FD_ISSET(balancer->backends[i].socket, &readable)) {
+                read_backend(balancer, &balancer->backends[i], &response); /**< Late answers are dropped too */
+            }
+        }
+    }
+
+    Backend *admitted[MAX_ENDPOINTS];
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < balancer->count; i++) {
+        if (!balancer->backends[i].ejected) {
+            admitted[count++] = &balancer->backends[i];
+        }
+    }
+    if (count == 0) {
+        for (unsigned int i = 0; i < balancer->count; i++) {
+            admitted[count++] = &balancer->backends[i];  /**< Everything is ejected: use them all */
+        }
+    }
+    if (count == 1) {
+        return admitted[0];
+    }
+
+    unsigned int first = random_below(balancer, count);
+    unsigned int second = random_below(balancer, count - 1);
+    second += second >= first ? 1 : 0;  /**< Two distinct backends */
+    return backend_cost(admitted[second]) < backend_cost(admitted[first]) ? admitted[second] : admitted[first];
+}
+
+/**
+ * @brief Records the response to a request sent to `backend`.
+ */
+void backend_answered(Backend *backend, uint64_t sample_us) {
+    if (backend->outstanding > 0) {
+        backend->outstanding--;
+    }
+    if (backend->ejected) {
+        readmit_backend(backend);
+    }
+    backend->failures = 0;
+    if (sample_us != 0) {
+        rtt_sample(&backend->rtt, sample_us);
+    }
+}
+
+/**
+ * @brief Records a transmission to `backend` that timed out.
+ */
+void backend_timed_out(Balancer *balancer, Backend *backend) {
+    if (backend->outstanding > 0) {
+        backend->outstanding--;
+    }
+    if (++backend->failures >= BALANCER_EJECT_AFTER) {
+        eject_backend(balancer, backend);
+    }
+}
+
+/**
+ * @brief Waits for a response on any backend.
+ */
+int receive_from_backends(Balancer *balancer, uint64_t timeout_us, PasswordResponse *response, Backend **sender) {
+    fd_set readable;
+    send_due_probes(balancer, monotonic_us());
+    int ready = wait_for_backends(balancer, false, timeout_us, &readable);
+    for (unsigned int i = 0; ready > 0 && i < balancer->count; i++) {
+        Backend *backend = &balancer->backends[i];
+        if (FD_ISSET(backend->socket, &readable) && read_backend(balancer, backend, response)) {
+            *sender = backend;
+            return 1;  /**< The other ready sockets are read by the next call */
+        }
+    }
+    return ready < 0 ? -1 : 0;
+}
+
+/**
+ * @brief Closes the sockets of the pool.
+ */
+void close_balancer(Balancer *balancer) {
+    for (unsigned int i = 0; i < balancer->count; i++) {
+        closesocket(balancer->backends[i].socket);
+    }
+    balancer->count = 0;
+}
+
+/* - - - - - - - - - - - - - - - - - - END BALANCER - - - - - - - - - - - - - - - - - - */
@@ -0,0 +1,138 @@
+/**
+ * @file balancer.h
+ * @brief Header file declaring the client-side load balancer over a pool of servers.
+ *
+ * Every server of the pool is a Backend with its own connected socket, RTT estimator and
+ * count of outstanding requests. A request goes to the better of two backends drawn at random
+ * ("power of two choices"), the cost of a backend being its smoothed RTT times its outstanding
+ * requests plus one: a slow or busy server gets less traffic without the herd behavior of
+ * always choosing the best one.
+ *
+ * The timeout/retry layer reports every expired transmission. After `BALANCER_EJECT_AFTER`
+ * consecutive timeouts a backend is ejected and stops receiving requests; it is then probed
+ * with a short numeric request, first after `BALANCER_MIN_EJECTION_MS` and then with a doubling
+ * pause, and re-admitted with a fresh RTT estimator as soon as a probe is answered. If every
+ * backend is ejected, requests are still spread over all of them rather than dropped.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef BALANCER_H_
+#define BALANCER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../reliability/reliability.h"
+#include "../resolver/resolver.h"
+
+/* - - - - - - - - - - - - - - - - - - - BALANCER - - - - - - - - - - - - - - - - - - - */
+
+#define BALANCER_EJECT_AFTER 3          /**< Consecutive timeouts that eject a backend */
+#define BALANCER_MIN_EJECTION_MS 1000   /**< Pause before the first probe of an ejected backend */
+#define BALANCER_MAX_EJECTION_MS 30000  /**< Longest pause between two probes */
+#define BALANCER_PROBE_ID 0xFFFFFE00u   /**< Base identifier of the re-admission probes */
+
+/**
+ * @struct Backend
+ * @brief One server of the pool.
+ */
+typedef struct {
+    int socket;                 /**< Socket connected to the server, owned by the balancer */
+    RttEstimator rtt;           /**< RTT and RTO of the server */
+    unsigned int outstanding;   /**< Requests sent and not yet answered or timed out */
+    unsigned int failures;      /**< Consecutive timeouts */
+    bool ejected;               /**< Whether the backend only receives probes */
+    uint64_t probe_at_us;       /**< When an ejected backend is probed next, in microseconds */
+    uint32_t ejection_ms;       /**< Pause before the next probe */
+} Backend;
+
+/**
+ * @struct Balancer
+ * @brief Pool of backends.
+ */
+typedef struct {
+    Backend backends[MAX_ENDPOINTS]; /**< Backends, in the order of the endpoints */
+    unsigned int count;         /**< Number of backends */
+    const RetryPolicy *policy;  /**< Limits of the RTT estimators */
+    uint64_t random_state;      /**< State of the generator drawing the two choices */
+} Balancer;
+
+/**
+ * @brief Initializes an empty pool.
+ *
+ * @param[out] balancer The pool.
+ * @param[in] policy Timeouts and retransmissions; it must outlive the pool.
+ */
+void init_balancer(Balancer *balancer, const RetryPolicy *policy);
+
+/**
+ * @brief Adds a server to the pool.
+ *
+ * @param[in,out] balancer The pool.
+ * @param[in] backend_socket Socket connected to the server; the pool takes ownership.
+ *
+ * @return false if the pool is full; the socket is then left to the caller.
+ */
+bool add_backend(Balancer *balancer, int backend_socket);
+
+/**
+ * @brief Chooses the backend of the next transmission.
+ *
+ * Probes the ejected backends that are due and collects their pending answers first.
+ *
+ * @param[in,out] balancer A pool with at least one backend.
+ *
+ * @return The chosen backend, never NULL.
+ */
+Backend *pick_backend(Balancer *balancer);
+
+/**
+ * @brief Records the response to a request sent to `backend`.
+ *
+ * @param[in,out] backend The backend the request was sent to.
+ * @param[in] sample_us RTT to feed the estimator, or 0 if the request was retransmitted (Karn).
+ */
+void backend_answered(Backend *backend, uint64_t sample_us);
+
+/**
+ * @brief Records a transmission to `backend` that timed out.
+ *
+ * @param[in,out] balancer The pool.
+ * @param[in,out] backend The backend the request was sent to.
+ */
+void backend_timed_out(Balancer *balancer, Backend *backend);
+
+/**
+ * @brief Ejects a backend at once, e.g. after a request exhausted its retransmissions on it.
+ *
+ * @param[in,out] balancer The pool.
+ * @param[in,out] backend The backend to eject.
+ */
+void eject_backend(Balancer *balancer, Backend *backend);
+
+/**
+ * @brief Waits for a response on any backend.
+ *
+ * Probe answers are consumed and re-admit their backend; they are not returned.
+ *
+ * @param[in,out] balancer The pool.
+ * @param[in] timeout_us Maximum waiting time.
+ * @param[out] response Receives the response.
+ * @param[out] sender Receives the backend that sent it.
+ *
+ * @return 1 if a response was read, 0 on timeout or if the datagram was not a response, -1 on error.
+ */
+int receive_from_backends(Balancer *balancer, uint64_t timeout_us, PasswordResponse *response, Backend **sender);
+
+/**
+ * @brief Closes the sockets of the pool.
+ *
+ * @param[in,out] balancer The pool.
+ */
+void close_balancer(Balancer *balancer);
+
+/* - - - - - - - - - - - - - - - - - - END BALANCER - - - - - - - - - - - - - - - - - - */
+
+#endif /* BALANCER_H_ */
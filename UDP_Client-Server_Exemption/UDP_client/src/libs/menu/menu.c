@@ -0,0 +1,72 @@
+/**
+ * @file menu.c
+ * @brief Implementazione dei menu per la generazione di password.
+ *
+ * Questo file fornisce la visualizzazione dei menu di generazione password e delle
+ * informazioni di aiuto.
+ *
+ * @version 1.1.0
+ * @date 2024-12-20
+ * @author Michele Camassa
+ */
+
+#include <stdio.h>
+#include "menu.h"
+#include "../../../../UDP_core/src/libs/utils/utils.h"
+
+/* - - - - - - - - - - - - - - - - - MENU DI AIUTO PER LA PASSWORD - - - - - - - - - - - - */
+
+/**
+ * @brief Visualizza il menu di aiuto per il generatore di password.
+ *
+ * Questo menu fornisce una guida dettagliata sui comandi disponibili per la generazione della password,
+ * inclusi le opzioni di lunghezza e tipo.
+ */
+void show_help_menu() {
+	const char *help_text =
+		"\nMenu di Aiuto del Generatore di Password\n"
+		"Comandi:\n"
+		" h        : mostra questo menu di aiuto\n"
+		" n LENGTH : genera password numerica (solo numeri)\n"
+		" a LENGTH : genera password alfabetica (solo lettere minuscole)\n"
+		" m LENGTH : genera password mista (lettere minuscole e numeri)\n"
+		" s LENGTH : genera password sicura (lettere maiuscole, lettere minuscole, numeri, simboli)\n"
+		" u LENGTH : genera password sicura senza ambiguità (senza caratteri simili)\n"
+		" p LENGTH : genera password secondo la policy indicata con --policy\n"
+		" b TYPE LENGTH COUNT : genera COUNT password del tipo TYPE con una sola richiesta\n"
+		" q        : esci dall'applicazione\n\n"
+		" La lunghezza (LENGTH) deve essere tra 6 e 32 caratteri\n"
+		" Il numero di password (COUNT) deve essere tra 1 e 1024\n\n"
+		" Caratteri ambigui esclusi nell'opzione 'u':\n"
+		" 0 O o (zero e lettera O)\n"
+		" 1 l I i (uno e lettere l, I)\n"
+		" 2 Z z (due e lettera Z)\n"
+		" 5 S s (cinque e lettera S)\n"
+		" 8 B (otto e lettera B)\n"
+		"\nSe la lunghezza non è presente, viene utilizzato un valore predefinito: 8\n\n";
+	print_with_color(help_text,CYAN);
+}
+
+/**
+ * @brief Visualizza il menu principale del generatore di password.
+ *
+ * Questo menu invita l'utente a scegliere il tipo e la lunghezza della password
+ * da generare, con spiegazioni per ogni tipo.
+ */
+void show_password_menu() {
+	const char *menu_text =
+		"Inserisci il tipo di password e la sua lunghezza (tra 6 e 32):\n"
+		"  n: password numerica (solo numeri)\n"
+		"  a: password alfabetica (solo lettere minuscole)\n"
+		"  m: password mista (lettere minuscole e numeri)\n"
+		"  s: password sicura (lettere maiuscole, lettere minuscole, numeri e simboli)\n"
+		"  u: password sicura senza ambiguità (senza caratteri simili)\n"
+		"  p: password della policy indicata con --policy\n"
+		"  b: più password in una sola richiesta (es. b s 16 100)\n"
+		"  h: menu di aiuto\n"
+		"  q: esci dall'applicazione\n"
+		"? ";
+	print_with_color(menu_text, YELLOW);
+}
+
+/* - - - - - - - - - - - FINE MENU DI AIUTO PER LA PASSWORD - - - - - - - - - - - - */
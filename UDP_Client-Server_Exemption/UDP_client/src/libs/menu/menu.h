@@ -0,0 +1,39 @@
+/**
+ * @file menu.h
+ * @brief Declaration of the menus displayed by the interactive client.
+ *
+ * The colored output they rely on is provided by `utils.h` of the core library.
+ *
+ * @date 2024-12-20
+ * @author Michele Camassa
+ * @version 1.1.0
+ */
+
+#ifndef MENU_H_
+#define MENU_H_
+
+/* - - - - - - - - - - - - - - - - - - - - MENUS - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Displays the help menu for the password generator.
+ *
+ * This function prints a detailed help menu that explains the available options and commands
+ * for password generation.
+ *
+ * @post The help menu is displayed in the terminal.
+ */
+void show_help_menu();
+
+/**
+ * @brief Displays the password type and length selection menu.
+ *
+ * This function prints a menu that prompts the user to choose the type of password
+ * and specify its length. The menu provides detailed descriptions for each option.
+ *
+ * @post The password selection menu is displayed in the terminal.
+ */
+void show_password_menu();
+
+/* - - - - - - - - - - - - - - - - - - - END MENUS - - - - - - - - - - - - - - - - - - - */
+
+#endif /* MENU_H_ */
@@ -0,0 +1,127 @@
+/**
+ * @file pipeline.c
+ * @brief Implementation of the pipelined request engine.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#include "pipeline.h"
+
+/* - - - - - - - - - - - - - - - - - - - PIPELINE - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Whether a job has been sent and is still waiting for its response.
+ */
+static bool is_outstanding(const PipelineJob *job) {
+    return !job->answered && !job->expired;
+}
+
+/**
+ * @brief Sends a job to the backend chosen by the balancer.
+ */
+static bool transmit_job(Balancer *balancer, PipelineJob *job, uint64_t now) {
+    job->backend = pick_backend(balancer);
+    job->backend->outstanding++;
+    job->sent_at = now;
+    return send_request(job->backend->socket, &job->request);
+}
+
+/**
+ * @brief Retransmits or expires the outstanding jobs whose timeout has passed.
+ * @param[in] now Current time, in microseconds.
+ * @return The earliest deadline of the jobs still outstanding, or `UINT64_MAX` if none is.
+ */
+static uint64_t handle_timeouts(Balancer *balancer, PipelineJob *jobs,
+                                size_t first, size_t sent, size_t *done, uint64_t now) {
+    uint64_t earliest = UINT64_MAX;
+
+    for (size_t i = first; i < sent; i++) {
+        PipelineJob *job = &jobs[i];
+        if (!is_outstanding(job)) {
+            continue;
+        }
+        uint64_t deadline = job->sent_at + rtt_timeout(&job->backend->rtt, job->retries);
+        if (deadline <= now) {
+            backend_timed_out(balancer, job->backend);
+            if (job->retries == balancer->policy->max_retries) {
+                job->expired = true;
+                (*done)++;
+                continue;
+            }
+            job->retries++;
+            transmit_job(balancer, job, now); /**< A lost send is retried like a lost packet */
+            deadline = now + rtt_timeout(&job->backend->rtt, job->retries);
+        }
+        if (deadline < earliest) {
+            earliest = deadline;
+        }
+    }
+    return earliest;
+}
+
+/**
+ * @brief Sends every job keeping at most `window` requests in flight.
+ * @details `sent - done` is the number of outstanding requests. Jobs are reported from
+ *          `reported` onwards as soon as the oldest outstanding one is answered or expires.
+ *          A response is accepted from any backend, since a retransmission may have moved
+ *          the job after the first backend had already answered. A cookie challenge from the
+ *          backend of the job is answered at once, the first time only.
+ */
+bool run_pipeline(Balancer *balancer, PipelineJob *jobs, size_t count,
+                  unsigned int window, PipelineCallback on_complete, void *context) {
+    size_t sent = 0;
+    size_t done = 0;
+    size_t reported = 0;
+
+    while (reported < count) {
+        while (sent < count && sent - done < window) {
+            PipelineJob *job = &jobs[sent];
+            job->request.request_id = (uint32_t)sent;
+            job->answered = false;
+            job->expired = false;
+            job->retries = 0;
+            job->challenged = false;
+            if (!transmit_job(balancer, job, monotonic_us())) {
+                return false;
+            }
+            sent++;
+        }
+
+        uint64_t now = monotonic_us();
+        uint64_t deadline = handle_timeouts(balancer, jobs, reported, sent, &done, now);
+        if (deadline != UINT64_MAX) {
+            PasswordResponse response;
+            Backend *sender;
+            int ready = receive_from_backends(balancer, deadline > now ? deadline - now : 0, &response, &sender);
+            if (ready < 0) {
+                return false;
+            }
+
+            if (ready > 0 && response.request_id < sent && is_outstanding(&jobs[response.request_id]) &&
+                response.status == STATUS_COOKIE_REQUIRED) {
+                PipelineJob *job = &jobs[response.request_id];
+                if (!job->challenged && sender == job->backend) {
+                    job->challenged = true;  /**< Later challenges wait for the retransmission */
+                    job->sent_at = monotonic_us();
+                    send_request(sender->socket, &job->request);  /**< A lost send is retried on timeout */
+                }
+            } else if (ready > 0 && response.request_id < sent && is_outstanding(&jobs[response.request_id])) {
+                PipelineJob *job = &jobs[response.request_id];
+                job->response = response;
+                job->answered = true;
+                done++;
+                /** Karn: skip ambiguous samples */
+                backend_answered(job->backend, job->retries == 0 ? monotonic_us() - job->sent_at : 0);
+            }
+        }
+
+        while (reported < sent && !is_outstanding(&jobs[reported])) {
+            on_complete(&jobs[reported++], context);
+        }
+    }
+    return true;
+}
+
+/* - - - - - - - - - - - - - - - - - - END PIPELINE - - - - - - - - - - - - - - - - - - */
@@ -0,0 +1,76 @@
+/**
+ * @file pipeline.h
+ * @brief Header file declaring the pipelined request engine of the non-interactive client.
+ *
+ * Instead of waiting for every response before sending the next request, the pipeline keeps
+ * up to `window` requests in flight. Requests are numbered by their position in the job list,
+ * which is also their `request_id`, so responses can arrive in any order; they are still
+ * reported to the caller in job order. Unanswered requests are retransmitted with the
+ * timeouts of `reliability.h`, and a request that runs out of retries is reported as expired
+ * without stopping the others.
+ *
+ * Every transmission, retransmissions included, goes to the backend chosen by the balancer,
+ * and its outcome is reported back to it: the timeouts are those of that backend.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef PIPELINE_H_
+#define PIPELINE_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "../balancer/balancer.h"
+
+/* - - - - - - - - - - - - - - - - - - - PIPELINE - - - - - - - - - - - - - - - - - - - */
+
+#define DEFAULT_WINDOW 16   /**< Requests in flight when no window is given */
+#define MAX_WINDOW 1024     /**< Largest accepted window */
+
+/**
+ * @struct PipelineJob
+ * @brief One request of the pipeline and, once it arrives, its response.
+ */
+typedef struct {
+    PasswordRequest request;    /**< Request to send; `request_id` is assigned by the pipeline */
+    PasswordResponse response;  /**< Response received for the request */
+    bool answered;              /**< Whether `response` is valid */
+    bool expired;               /**< Whether the request was abandoned after `max_retries` retransmissions */
+    uint64_t sent_at;           /**< Time of the last transmission, in microseconds */
+    unsigned int retries;       /**< Retransmissions so far */
+    bool challenged;            /**< Whether a cookie challenge was already answered at once */
+    Backend *backend;           /**< Backend of the last transmission */
+} PipelineJob;
+
+/**
+ * @brief Function called once per job, in job order, when it is answered or expired.
+ *
+ * @param[in] job The answered job.
+ * @param[in] context The pointer given to `run_pipeline`.
+ */
+typedef void (*PipelineCallback)(const PipelineJob *job, void *context);
+
+/**
+ * @brief Sends every job keeping at most `window` requests in flight.
+ *
+ * Responses that do not match an outstanding request (unknown id, duplicate or late response
+ * to an expired request) are ignored.
+ *
+ * @param[in,out] balancer The pool of servers, updated with the outcome of every transmission.
+ * @param[in,out] jobs The jobs to run; `request_id` and the responses are filled in.
+ * @param[in] count Number of jobs.
+ * @param[in] window Maximum number of outstanding requests, at least 1.
+ * @param[in] on_complete Called in job order for every answered or expired job.
+ * @param[in] context Passed unchanged to `on_complete`.
+ *
+ * @return true if every job was answered or expired.
+ * @return false if a request could not be sent or the socket failed.
+ */
+bool run_pipeline(Balancer *balancer, PipelineJob *jobs, size_t count,
+                  unsigned int window, PipelineCallback on_complete, void *context);
+
+/* - - - - - - - - - - - - - - - - - - END PIPELINE - - - - - - - - - - - - - - - - - - */
+
+#endif /* PIPELINE_H_ */
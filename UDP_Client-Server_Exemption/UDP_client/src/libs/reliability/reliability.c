@@ -0,0 +1,188 @@
+/**
+ * @file reliability.c
+ * @brief Implementation of the timeout and retransmission layer of the client.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#if defined WIN32
+#include <winsock2.h>       /**< Included before windows.h, which would pull in Winsock 1 */
+#include <windows.h>        /**< Include QueryPerformanceCounter() */
+#else
+#include <sys/select.h>     /**< Include select() */
+#include <time.h>           /**< Include clock_gettime() */
+#endif
+
+#include "reliability.h"
+
+/* - - - - - - - - - - - - - - - - - - RETRY POLICY - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Fills a RetryPolicy with the default limits.
+ */
+void default_retry_policy(RetryPolicy *policy) {
+    policy->initial_rto_ms = DEFAULT_INITIAL_RTO_MS;
+    policy->min_rto_ms = DEFAULT_MIN_RTO_MS;
+    policy->max_rto_ms = DEFAULT_MAX_RTO_MS;
+    policy->max_retries = DEFAULT_MAX_RETRIES;
+}
+
+/* - - - - - - - - - - - - - - - - - END RETRY POLICY - - - - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - - - - RTT ESTIMATION - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Clamps an RTO to the limits of the policy.
+ */
+static uint64_t clamp_rto(const RetryPolicy *policy, uint64_t rto_us) {
+    uint64_t min_us = (uint64_t)policy->min_rto_ms * 1000;
+    uint64_t max_us = (uint64_t)policy->max_rto_ms * 1000;
+    return rto_us < min_us ? min_us : rto_us > max_us ? max_us : rto_us;
+}
+
+/**
+ * @brief Initializes an estimator with the initial RTO of `policy`.
+ */
+void rtt_init(RttEstimator *rtt, const RetryPolicy *policy) {
+    rtt->policy = policy;
+    rtt->srtt_us = 0;
+    rtt->rttvar_us = 0;
+    rtt->rto_us = clamp_rto(policy, (uint64_t)policy->initial_rto_ms * 1000);
+    rtt->has_sample = false;
+}
+
+/**
+ * @brief Updates the estimator with a new RTT measurement (RFC 6298, section 2).
+ */
+void rtt_sample(RttEstimator *rtt, uint64_t sample_us) {
+    if (!rtt->has_sample) {
+        rtt->srtt_us = sample_us;
+        rtt->rttvar_us = sample_us / 2;
+        rtt->has_sample = true;
+    } else {
+        uint64_t deviation = rtt->srtt_us > sample_us ? rtt->srtt_us - sample_us : sample_us - rtt->srtt_us;
+        rtt->rttvar_us = (3 * rtt->rttvar_us + deviation) / 4;
+        rtt->srtt_us = (7 * rtt->srtt_us + sample_us) / 8;
+    }
+    rtt->rto_us = clamp_rto(rtt->policy, rtt->srtt_us + 4 * rtt->rttvar_us);
+}
+
+/**
+ * @brief Timeout of a request that has already been retransmitted `retries` times.
+ */
+uint64_t rtt_timeout(const RttEstimator *rtt, unsigned int retries) {
+    uint64_t max_us = (uint64_t)rtt->policy->max_rto_ms * 1000;
+    uint64_t timeout = rtt->rto_us;
+    for (unsigned int i = 0; i < retries && timeout < max_us; i++) {
+        timeout *= 2;
+    }
+    return timeout < max_us ? timeout : max_us;
+}
+
+/* - - - - - - - - - - - - - - - - - END RTT ESTIMATION - - - - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - - - - - - WAITING - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Returns a monotonic timestamp in microseconds.
+ */
+uint64_t monotonic_us(void) {
+#if defined WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * 1e6 / (double)frequency.QuadPart);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000ULL + (uint64_t)now.tv_nsec / 1000;
+#endif
+}
+
+/**
+ * @brief Waits until a datagram can be read from the socket or the timeout expires.
+ * @details `select` is used because it is available both on Winsock and on POSIX systems.
+ */
+int wait_for_datagram(int client_socket, uint64_t timeout_us) {
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(client_socket, &readable);
+    struct timeval timeout = { (long)(timeout_us / 1000000), (long)(timeout_us % 1000000) };
+    int ready = select(client_socket + 1, &readable, NULL, NULL, &timeout);
+    return ready < 0 ? -1 : ready > 0 ? 1 : 0;
+}
+
+/**
+ * @brief Sends an encoded datagram and waits for the response with its `request_id`,
+ *        retransmitting the datagram on timeout.
+ * @details The first cookie challenge is answered at once, with the cookie it carries; a later
+ *          one is only kept for the retransmission, so a server that keeps challenging costs
+ *          no more datagrams than a lossy one.
+ */
+static bool exchange_datagram(int client_socket, const uint8_t *datagram, size_t datagram_size, uint32_t request_id,
+                              PasswordResponse *response_msg, RttEstimator *rtt) {
+    bool challenged = false;
+    for (unsigned int retries = 0; retries <= rtt->policy->max_retries; retries++) {
+        uint64_t sent_at = monotonic_us();
+        uint64_t deadline = sent_at + rtt_timeout(rtt, retries);
+        if (!send_datagram(client_socket, datagram, datagram_size)) {
+            return false;
+        }
+
+        for (uint64_t now = sent_at; now < deadline; now = monotonic_us()) {
+            int ready = wait_for_datagram(client_socket, deadline - now);
+            if (ready < 0) {
+                return false;
+            }
+            if (ready == 0 || !receive_response(client_socket, response_msg) ||
+                response_msg->request_id != request_id) {
+                continue; /**< Timeout, unreadable datagram or response to an older request */
+            }
+            if (response_msg->status == STATUS_COOKIE_REQUIRED) {
+                if (!challenged) {
+                    challenged = true;
+                    sent_at = monotonic_us();
+                    deadline = sent_at + rtt_timeout(rtt, retries);
+                    if (!send_datagram(client_socket, datagram, datagram_size)) {
+                        return false;
+                    }
+                }
+                continue;
+            }
+            if (retries == 0) {
+                rtt_sample(rtt, monotonic_us() - sent_at); /**< Karn: skip ambiguous samples */
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Sends a request and waits for its response, retransmitting it on timeout.
+ */
+bool exchange_request(int client_socket, const PasswordRequest *password_request,
+                      PasswordResponse *response_msg, RttEstimator *rtt) {
+    uint8_t datagram[BULK_REQUEST_SIZE];
+    size_t datagram_size = encode_request(password_request, datagram, sizeof(datagram));
+    return datagram_size != 0 &&
+           exchange_datagram(client_socket, datagram, datagram_size, password_request->request_id, response_msg, rtt);
+}
+
+/**
+ * @brief Defines a password policy on the server, retransmitting the definition on timeout.
+ */
+bool exchange_policy_definition(int client_socket, const PolicySpec *spec, uint32_t request_id,
+                                PasswordResponse *response_msg, RttEstimator *rtt) {
+    uint8_t datagram[MAX_POLICY_DEFINITION_SIZE];
+    size_t datagram_size = encode_policy_definition(spec, request_id, datagram, sizeof(datagram));
+    return datagram_size != 0 &&
+           exchange_datagram(client_socket, datagram, datagram_size, request_id, response_msg, rtt);
+}
+
+/* - - - - - - - - - - - - - - - - - - - END WAITING - - - - - - - - - - - - - - - - - - - */
@@ -0,0 +1,149 @@
+/**
+ * @file reliability.h
+ * @brief Header file declaring the timeout and retransmission layer of the client.
+ *
+ * UDP gives no delivery guarantee, so every request is guarded by a retransmission timeout
+ * (RTO) computed from the measured round-trip time as in Jacobson/Karels (RFC 6298):
+ * - `SRTT` and `RTTVAR` are exponentially weighted averages of the RTT and of its deviation;
+ * - `RTO = SRTT + 4 * RTTVAR`, clamped to `[min_rto_ms, max_rto_ms]`;
+ * - every retransmission of the same request doubles its timeout (exponential backoff);
+ * - as in Karn's algorithm, responses to retransmitted requests are not used as RTT samples.
+ *
+ * A request is abandoned after `max_retries` retransmissions, so the time spent on one request
+ * never exceeds `(max_retries + 1) * max_rto_ms`. Late and duplicated responses are recognized
+ * by their `request_id` and dropped by the callers.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef RELIABILITY_H_
+#define RELIABILITY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../transport/transport.h"
+
+/* - - - - - - - - - - - - - - - - - - RETRY POLICY - - - - - - - - - - - - - - - - - - */
+
+#define DEFAULT_INITIAL_RTO_MS 1000     /**< RTO before the first RTT sample (RFC 6298) */
+#define DEFAULT_MIN_RTO_MS 50           /**< Lower bound of the RTO */
+#define DEFAULT_MAX_RTO_MS 4000         /**< Upper bound of the RTO, backoff included */
+#define DEFAULT_MAX_RETRIES 4           /**< Retransmissions before a request is abandoned */
+
+/**
+ * @struct RetryPolicy
+ * @brief Tunable limits of the retransmission layer.
+ */
+typedef struct {
+    uint32_t initial_rto_ms;    /**< RTO used until the first RTT sample */
+    uint32_t min_rto_ms;        /**< Smallest RTO */
+    uint32_t max_rto_ms;        /**< Largest RTO, also after backoff */
+    unsigned int max_retries;   /**< Retransmissions allowed per request */
+} RetryPolicy;
+
+/**
+ * @brief Fills a RetryPolicy with the default limits.
+ *
+ * @param[out] policy The policy to initialize.
+ */
+void default_retry_policy(RetryPolicy *policy);
+
+/* - - - - - - - - - - - - - - - - - END RETRY POLICY - - - - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - - - - RTT ESTIMATION - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @struct RttEstimator
+ * @brief Smoothed round-trip time and current RTO, in microseconds.
+ */
+typedef struct {
+    const RetryPolicy *policy;  /**< Limits applied to the RTO */
+    uint64_t srtt_us;           /**< Smoothed RTT */
+    uint64_t rttvar_us;         /**< Smoothed mean deviation of the RTT */
+    uint64_t rto_us;            /**< Current retransmission timeout */
+    bool has_sample;            /**< Whether an RTT has been measured yet */
+} RttEstimator;
+
+/**
+ * @brief Initializes an estimator with the initial RTO of `policy`.
+ *
+ * @param[out] rtt The estimator.
+ * @param[in] policy The limits to apply; it must outlive `rtt`.
+ */
+void rtt_init(RttEstimator *rtt, const RetryPolicy *policy);
+
+/**
+ * @brief Updates the estimator with a new RTT measurement.
+ *
+ * @param[in,out] rtt The estimator.
+ * @param[in] sample_us RTT of a request that was answered without being retransmitted.
+ */
+void rtt_sample(RttEstimator *rtt, uint64_t sample_us);
+
+/**
+ * @brief Timeout of a request that has already been retransmitted `retries` times.
+ *
+ * @param[in] rtt The estimator.
+ * @param[in] retries Number of retransmissions so far.
+ *
+ * @return `rto_us * 2^retries`, capped at `max_rto_ms`.
+ */
+uint64_t rtt_timeout(const RttEstimator *rtt, unsigned int retries);
+
+/* - - - - - - - - - - - - - - - - - END RTT ESTIMATION - - - - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - - - - - - WAITING - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Returns a monotonic timestamp in microseconds.
+ *
+ * @return The current time.
+ */
+uint64_t monotonic_us(void);
+
+/**
+ * @brief Waits until a datagram can be read from the socket or the timeout expires.
+ *
+ * @param[in] client_socket The socket descriptor.
+ * @param[in] timeout_us Maximum waiting time.
+ *
+ * @return 1 if a datagram is ready, 0 on timeout, -1 on error.
+ */
+int wait_for_datagram(int client_socket, uint64_t timeout_us);
+
+/**
+ * @brief Sends a request and waits for its response, retransmitting it on timeout.
+ *
+ * Responses with another `request_id` are ignored.
+ *
+ * @param[in] client_socket The socket descriptor, connected to the server.
+ * @param[in] password_request The request, with its `request_id` set.
+ * @param[out] response_msg Pointer to the PasswordResponse structure to store the response.
+ * @param[in,out] rtt The estimator, updated with the measured RTT.
+ *
+ * @return true if the response was received.
+ * @return false if the request could not be sent or every retransmission timed out.
+ */
+bool exchange_request(int client_socket, const PasswordRequest *password_request,
+                      PasswordResponse *response_msg, RttEstimator *rtt);
+
+/**
+ * @brief Defines a password policy on the server, retransmitting the definition on timeout.
+ *
+ * @param[in] client_socket The socket descriptor, connected to the server.
+ * @param[in] spec The policy to define.
+ * @param[in] request_id Identifier of the definition.
+ * @param[out] response_msg Receives the response; its single password byte is the policy ID.
+ * @param[in,out] rtt The estimator, updated with the measured RTT.
+ *
+ * @return true if the response was received.
+ * @return false if the definition could not be sent or every retransmission timed out.
+ */
+bool exchange_policy_definition(int client_socket, const PolicySpec *spec, uint32_t request_id,
+                                PasswordResponse *response_msg, RttEstimator *rtt);
+
+/* - - - - - - - - - - - - - - - - - - - END WAITING - - - - - - - - - - - - - - - - - - - */
+
+#endif /* RELIABILITY_H_ */
@@ -0,0 +1,397 @@
+/**
+ * @file resolver.c
+ * @brief Implementation of the name resolution, address selection and failover of the client.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#if defined WIN32
+#include <winsock2.h>       /**< Include select() */
+#include <ws2tcpip.h>       /**< Include getaddrinfo() */
+#else
+#include <unistd.h>         /**< Include close() */
+#include <sys/select.h>     /**< Include select() */
+#include <netdb.h>          /**< Include getaddrinfo() */
+#define closesocket close   /**< Define closesocket as close for UNIX systems */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "resolver.h"
+
+/* - - - - - - - - - - - - - - - - - - - RESOLVER - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Resolves a server name into candidate addresses, interleaved by family.
+ * @details The order of `getaddrinfo` is kept within each family; the families then
+ *          alternate, starting with the family of the first result.
+ * @return The number of candidates, 0 if the name does not resolve.
+ */
+static unsigned int resolve_server(const char *host, unsigned short port,
+                            struct sockaddr_storage *addresses, unsigned int capacity) {
+    struct addrinfo hints;
+    struct addrinfo *results;
+    char port_text[8];
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_protocol = IPPROTO_UDP;
+    hints.ai_flags = AI_ADDRCONFIG | AI_NUMERICSERV;
+    snprintf(port_text, sizeof(port_text), "%u", port);
+    if (getaddrinfo(host, port_text, &hints, &results) != 0) {
+        return 0;
+    }
+
+    const struct addrinfo *families[2][RESOLVER_MAX_ADDRESSES];
+    unsigned int family_count[2] = { 0, 0 };
+    int first_family = 0;
+    for (const struct addrinfo *result = results; result != NULL; result = result->ai_next) {
+        if ((result->ai_family != AF_INET && result->ai_family != AF_INET6) ||
+            result->ai_addrlen > sizeof(struct sockaddr_storage)) {
+            continue;
+        }
+        if (first_family == 0) {
+            first_family = result->ai_family;
+        }
+        int group = result->ai_family == first_family ? 0 : 1;
+        if (family_count[group] < RESOLVER_MAX_ADDRESSES) {
+            families[group][family_count[group]++] = result;
+        }
+    }
+
+    unsigned int count = 0;
+    for (unsigned int i = 0; count < capacity && (i < family_count[0] || i < family_count[1]); i++) {
+        for (int group = 0; group < 2 && count < capacity; group++) {
+            if (i < family_count[group]) {
+                memset(&addresses[count], 0, sizeof(addresses[count]));
+                memcpy(&addresses[count], families[group][i]->ai_addr, families[group][i]->ai_addrlen);
+                count++;
+            }
+        }
+    }
+    freeaddrinfo(results);
+    return count;
+}
+
+/**
+ * @brief Resolves a name through the cache.
+ * @details An expired entry is resolved again; if the name no longer resolves, the stale
+ *          addresses are returned rather than none.
+ * @return The number of candidates copied to `addresses`, 0 if the name is unknown.
+ */
+static unsigned int resolve_cached(ResolverCache *cache, const char *host, unsigned short port,
+                                   struct sockaddr_storage *addresses) {
+    uint64_t now = monotonic_us();
+    CachedName *found = NULL;
+    CachedName *oldest = &cache->entries[0];
+    for (unsigned int i = 0; i < RESOLVER_CACHE_SIZE; i++) {
+        CachedName *entry = &cache->entries[i];
+        if (entry->count != 0 && entry->port == port && strcmp(entry->host, host) == 0) {
+            found = entry;
+        }
+        if (entry->expires_us < oldest->expires_us) {
+            oldest = entry;
+        }
+    }
+
+    if (found == NULL || now >= found->expires_us) {
+        struct sockaddr_storage resolved[RESOLVER_MAX_ADDRESSES];
+        unsigned int count = resolve_server(host, port, resolved, RESOLVER_MAX_ADDRESSES);
+        if (count != 0) {
+            found = found != NULL ? found : oldest;
+            snprintf(found->host, sizeof(found->host), "%s", host);
+            found->port = port;
+            memcpy(found->addresses, resolved, count * sizeof(resolved[0]));
+            found->count = count;
+            found->expires_us = now + cache->ttl_us;
+        } else if (found == NULL) {
+            return 0;
+        }
+    }
+    memcpy(addresses, found->addresses, found->count * sizeof(found->addresses[0]));
+    return found->count;
+}
+
+/**
+ * @brief Splits an endpoint into its host and its port.
+ * @details Accepts `HOST`, `HOST:PORT`, `[IPV6]:PORT` and a bare IPv6 address.
+ * @return `false` if the endpoint is malformed.
+ */
+static bool split_endpoint(const char *endpoint, unsigned short default_port,
+                           char host[RESOLVER_HOST_SIZE], unsigned short *port) {
+    const char *host_start = endpoint;
+    const char *host_end = endpoint + strlen(endpoint);
+    const char *port_text = NULL;
+
+    if (*endpoint == '[') {
+        host_start = endpoint + 1;
+        host_end = strchr(host_start, ']');
+        if (host_end == NULL || (host_end[1] != '\0' && host_end[1] != ':')) {
+            return false;
+        }
+        port_text = host_end[1] == ':' ? host_end + 2 : NULL;
+    } else {
+        const char *colon = strchr(endpoint, ':');
+        if (colon != NULL && strchr(colon + 1, ':') == NULL) {
+            host_end = colon;
+            port_text = colon + 1;
+        }
+    }
+
+    size_t host_length = (size_t)(host_end - host_start);
+    if (host_length == 0 || host_length >= RESOLVER_HOST_SIZE) {
+        return false;
+    }
+    memcpy(host, host_start, host_length);
+    host[host_length] = '\0';
+
+    *port = default_port;
+    if (port_text != NULL) {
+        char *end;
+        long value = strtol(port_text, &end, 10);
+        if (*end != '\0' || value < 1 || value > 65535) {
+            return false;
+        }
+        *port = (unsigned short)value;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads the datagram waiting on a candidate socket.
+ * @return 1 if it answers the probe of `candidate`, -1 if the candidate refused it, 0 otherwise.
+ */
+static int read_probe_answer(int candidate_socket, unsigned int candidate) {
+    uint8_t datagram[MAX_RESPONSE_SIZE];
+    PasswordResponse response;
+    int size = recv(candidate_socket, (char *)datagram, sizeof(datagram), 0);
+    if (size < 0) {
+        return connection_refused() ? -1 : 0;
+    }
+    if (!decode_response(datagram, (size_t)size, &response) || response.request_id != RESOLVER_PROBE_ID + candidate) {
+        return 0;
+    }
+    if (response.status == STATUS_COOKIE_REQUIRED && response.length == COOKIE_SIZE) {
+        store_cookie(candidate_socket, (const uint8_t *)response.password); /**< For the session, if it wins */
+    }
+    return 1;
+}
+
+/**
+ * @brief Races the candidates of one endpoint.
+ * @details Attempt `k` goes to candidate `k % count`. Inside a round the attempts are
+ *          `RESOLVER_ATTEMPT_DELAY_MS` apart; a candidate that cannot be connected, or
+ *          refuses a probe, is dropped and the next attempt starts at once. The next round
+ *          starts `initial_rto_ms` after the last attempt of the previous one.
+ * @param[out] answered Whether the returned candidate answered its probe.
+ * @return The connected socket of the winner, of the preferred candidate if nobody answered,
+ *         or -1 if no candidate could be connected.
+ */
+static int race_candidates(const struct sockaddr_storage *addresses, unsigned int count, const RetryPolicy *policy,
+                           struct sockaddr_storage *selected, bool *answered) {
+    int sockets[RESOLVER_MAX_ADDRESSES];
+    bool dropped[RESOLVER_MAX_ADDRESSES];
+    unsigned int alive = count;
+    unsigned int attempts = count * (policy->max_retries + 1);
+    unsigned int attempt = 0;
+    int winner = -1;
+    uint64_t round_pause_us = (uint64_t)policy->initial_rto_ms * 1000;
+    uint64_t next_attempt = monotonic_us();
+
+    for (unsigned int i = 0; i < count; i++) {
+        sockets[i] = -1;
+        dropped[i] = false;
+    }
+
+    while (winner < 0 && alive > 0) {
+        uint64_t now = monotonic_us();
+        if (attempt < attempts && now >= next_attempt) {
+            unsigned int candidate = attempt++ % count;
+            if (dropped[candidate]) {
+                continue;
+            }
+            if (sockets[candidate] < 0) {
+                sockets[candidate] = connect_server_socket(&addresses[candidate]);
+            }
+            PasswordRequest probe = { 'n', MIN_PASSWORD_LENGTH, 0, RESOLVER_PROBE_ID + candidate, 1, { 0 } };
+            if (sockets[candidate] < 0 || !send_request(sockets[candidate], &probe)) {
+                dropped[candidate] = true;  /**< E.g. no IPv6 route on this host */
+                alive--;
+                continue;
+            }
+            next_attempt = attempt % count == 0 ? now + round_pause_us :
+                           now + (uint64_t)RESOLVER_ATTEMPT_DELAY_MS * 1000;
+            continue;
+        }
+        if (attempt == attempts && now >= next_attempt) {
+            break;  /**< The last round has timed out */
+        }
+
+        fd_set readable;
+        int highest = -1;
+        FD_ZERO(&readable);
+        for (unsigned int i = 0; i < count; i++) {
+            if (sockets[i] >= 0 && !dropped[i]) {
+                FD_SET(sockets[i], &readable);
+                highest = sockets[i] > highest ? sockets[i] : highest;
+            }
+        }
+        uint64_t wait_us = next_attempt > now ? next_attempt - now : 0;
+        struct timeval timeout = { (long)(wait_us / 1000000), (long)(wait_us % 1000000) };
+        int ready = highest < 0 ? 0 : select(highest + 1, &readable, NULL, NULL, &timeout);
+        if (ready < 0) {
+            break;
+        }
+        for (unsigned int i = 0; ready > 0 && i < count && winner < 0; i++) {
+            if (sockets[i] < 0 || dropped[i] || !FD_ISSET(sockets[i], &readable)) {
+                continue;
+            }
+            int outcome = read_probe_answer(sockets[i], i);
+            if (outcome > 0) {
+                winner = (int)i;
+            } else if (outcome < 0) {
+                dropped[i] = true;  /**< Nothing listens there: try the next one now */
+                alive--;
+                next_attempt = monotonic_us();
+            }
+        }
+    }
+
+    *answered = winner >= 0;
+    for (unsigned int i = 0; winner < 0 && i < count; i++) {
+        if (sockets[i] >= 0 && !dropped[i]) {
+            winner = (int)i;  /**< Nobody answered: keep the preferred candidate */
+        }
+    }
+    for (unsigned int i = 0; winner < 0 && i < count; i++) {
+        if (sockets[i] >= 0) {
+            winner = (int)i;
+        }
+    }
+    for (unsigned int i = 0; i < count; i++) {
+        if (sockets[i] >= 0 && (int)i != winner) {
+            closesocket(sockets[i]);
+        }
+    }
+    if (winner < 0) {
+        return -1;
+    }
+    *selected = addresses[winner];
+    return sockets[winner];
+}
+
+/**
+ * @brief Prepares a session; no name is resolved yet.
+ */
+void init_session(ServerSession *session, const char *const *endpoints, unsigned int count,
+                  unsigned short default_port, unsigned int ttl_s) {
+    memset(session, 0, sizeof(*session));
+    for (unsigned int i = 0; i < count && i < MAX_ENDPOINTS; i++) {
+        session->endpoints[session->endpoint_count++] = endpoints[i];
+    }
+    session->default_port = default_port;
+    session->socket = -1;
+    session->cache.ttl_us = (uint64_t)ttl_s * 1000000;
+}
+
+/**
+ * @brief Resolves one endpoint of the session and races its addresses.
+ */
+int connect_endpoint(ServerSession *session, unsigned int endpoint, const RetryPolicy *policy,
+                     bool probe, struct sockaddr_storage *address, bool *answered) {
+    char host[RESOLVER_HOST_SIZE];
+    unsigned short port;
+    struct sockaddr_storage candidates[RESOLVER_MAX_ADDRESSES];
+    unsigned int count = 0;
+
+    *answered = false;
+    if (split_endpoint(session->endpoints[endpoint], session->default_port, host, &port)) {
+        count = resolve_cached(&session->cache, host, port, candidates);
+    }
+    if (count == 0) {
+        return -1;
+    }
+    if (count == 1 && !probe) {
+        *address = candidates[0];
+        return connect_server_socket(address);  /**< Nothing to choose */
+    }
+    return race_candidates(candidates, count, policy, address, answered);
+}
+
+/**
+ * @brief Connects to the first of `tried` endpoints, from `first` onwards, that answers.
+ * @param[in] require_answer Whether a candidate that did not answer may be kept.
+ * @return false if no endpoint was selected; the session is then unchanged.
+ */
+static bool connect_endpoints(ServerSession *session, const RetryPolicy *policy,
+                              unsigned int first, unsigned int tried, bool require_answer) {
+    int fallback_socket = -1;
+    unsigned int fallback_endpoint = 0;
+    struct sockaddr_storage fallback_address;
+    bool probe = session->endpoint_count > 1;  /**< A single endpoint is used as it is */
+
+    for (unsigned int i = 0; i < tried; i++) {
+        unsigned int endpoint = (first + i) % session->endpoint_count;
+        struct sockaddr_storage address;
+        bool answered;
+        int candidate_socket = connect_endpoint(session, endpoint, policy, probe, &address, &answered);
+        if (candidate_socket < 0) {
+            continue;
+        }
+        if (answered || !probe) {
+            if (fallback_socket >= 0) {
+                closesocket(fallback_socket);
+            }
+            fallback_socket = candidate_socket;
+            fallback_endpoint = endpoint;
+            fallback_address = address;
+            break;
+        }
+        if (fallback_socket < 0 && !require_answer) {
+            fallback_socket = candidate_socket;
+            fallback_endpoint = endpoint;
+            fallback_address = address;
+        } else {
+            closesocket(candidate_socket);
+        }
+    }
+
+    if (fallback_socket < 0) {
+        return false;
+    }
+    close_session(session);
+    session->socket = fallback_socket;
+    session->current = fallback_endpoint;
+    session->address = fallback_address;
+    return true;
+}
+
+/**
+ * @brief Connects the session to the first endpoint, from `current` onwards, that answers.
+ */
+bool open_session(ServerSession *session, const RetryPolicy *policy) {
+    return connect_endpoints(session, policy, session->current, session->endpoint_count, false);
+}
+
+/**
+ * @brief Moves the session to the next endpoint after the current one stopped answering.
+ */
+bool failover_session(ServerSession *session, const RetryPolicy *policy) {
+    return session->endpoint_count > 1 &&
+           connect_endpoints(session, policy, session->current + 1, session->endpoint_count - 1, true);
+}
+
+/**
+ * @brief Closes the socket of the session.
+ */
+void close_session(ServerSession *session) {
+    if (session->socket >= 0) {
+        closesocket(session->socket);
+        session->socket = -1;
+    }
+}
+
+/* - - - - - - - - - - - - - - - - - - END RESOLVER - - - - - - - - - - - - - - - - - - */
@@ -0,0 +1,142 @@
+/**
+ * @file resolver.h
+ * @brief Header file declaring the name resolution, address selection and failover of the client.
+ *
+ * A session talks to one of a list of server endpoints over a connected UDP socket. Every
+ * endpoint name is resolved with `getaddrinfo`, so it may yield IPv6 and IPv4 addresses, and
+ * its addresses are kept in a small cache for `ttl_s` seconds: `getaddrinfo` does not report
+ * the DNS TTL, so the lifetime is a fixed setting. A stale entry is still used if the name
+ * stops resolving.
+ *
+ * The addresses of an endpoint are raced in the spirit of Happy Eyeballs (RFC 8305): the
+ * families are interleaved starting with the first one returned (IPv6 on a dual-stack host,
+ * as RFC 6724 sorts it), a probe request is sent to the first candidate and, while no answer
+ * has arrived, to the next one every `RESOLVER_ATTEMPT_DELAY_MS`. A candidate that cannot be
+ * connected or answers with an ICMP port unreachable is skipped at once. The first candidate
+ * that answers is kept for the session; the sockets of the others are closed.
+ *
+ * When the session fails over, the next endpoint of the list is raced in the same way.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef RESOLVER_H_
+#define RESOLVER_H_
+
+#include <stdbool.h>
+#include "../reliability/reliability.h"
+
+/* - - - - - - - - - - - - - - - - - - - RESOLVER - - - - - - - - - - - - - - - - - - - */
+
+#define DEFAULT_HOST "passwdgen.uniba.it" /**< Server name used when no `--host` is given */
+#define RESOLVER_MAX_ADDRESSES 8        /**< Candidates kept from one resolution */
+#define RESOLVER_ATTEMPT_DELAY_MS 250   /**< Delay before the next candidate is tried (RFC 8305) */
+#define RESOLVER_PROBE_ID 0xFFFFFF00u   /**< Base identifier of the probes, never used by sessions */
+#define RESOLVER_CACHE_SIZE 8           /**< Names kept by the cache */
+#define RESOLVER_HOST_SIZE 256          /**< Longest host name, terminator included */
+#define DEFAULT_RESOLVER_TTL_S 60       /**< Lifetime of a cached resolution */
+#define MAX_ENDPOINTS 8                 /**< Server endpoints of a session */
+
+/**
+ * @struct CachedName
+ * @brief Addresses of one `host:port` pair.
+ */
+typedef struct {
+    char host[RESOLVER_HOST_SIZE];      /**< Resolved name */
+    unsigned short port;                /**< Port of the addresses */
+    struct sockaddr_storage addresses[RESOLVER_MAX_ADDRESSES]; /**< Candidates, in racing order */
+    unsigned int count;                 /**< Number of candidates, 0 for a free entry */
+    uint64_t expires_us;                /**< Monotonic time after which the name is resolved again */
+} CachedName;
+
+/**
+ * @struct ResolverCache
+ * @brief Fixed-size cache of resolutions, the entry closest to expiry being replaced first.
+ */
+typedef struct {
+    CachedName entries[RESOLVER_CACHE_SIZE]; /**< Cached names */
+    uint64_t ttl_us;                    /**< Lifetime of an entry */
+} ResolverCache;
+
+/**
+ * @struct ServerSession
+ * @brief Endpoints of the servers and the connected socket of the one in use.
+ */
+typedef struct {
+    const char *endpoints[MAX_ENDPOINTS]; /**< `HOST`, `HOST:PORT` or `[IPV6]:PORT` texts */
+    unsigned int endpoint_count;        /**< Number of endpoints */
+    unsigned short default_port;        /**< Port of the endpoints that do not name one */
+    unsigned int current;               /**< Index of the endpoint in use */
+    int socket;                         /**< Socket connected to the endpoint in use, -1 if closed */
+    struct sockaddr_storage address;    /**< Address the socket is connected to */
+    ResolverCache cache;                /**< Resolutions of the endpoints */
+} ServerSession;
+
+/**
+ * @brief Prepares a session; no name is resolved yet.
+ *
+ * @param[out] session The session to initialize.
+ * @param[in] endpoints The endpoints, in order of preference; the strings must outlive the session.
+ * @param[in] count Number of endpoints, from 1 to `MAX_ENDPOINTS`.
+ * @param[in] default_port Port of the endpoints that do not name one.
+ * @param[in] ttl_s Lifetime of a cached resolution, in seconds.
+ */
+void init_session(ServerSession *session, const char *const *endpoints, unsigned int count,
+                  unsigned short default_port, unsigned int ttl_s);
+
+/**
+ * @brief Resolves one endpoint of the session and races its addresses.
+ *
+ * The session itself is not changed, apart from its resolution cache.
+ *
+ * @param[in,out] session The session owning the endpoint and the cache.
+ * @param[in] endpoint Index of the endpoint.
+ * @param[in] policy Timeouts of the probes.
+ * @param[in] probe Whether an endpoint with a single address must be probed too.
+ * @param[out] address Receives the address the socket is connected to.
+ * @param[out] answered Whether that address answered a probe.
+ *
+ * @return The connected socket, owned by the caller, or -1 if the endpoint cannot be used.
+ */
+int connect_endpoint(ServerSession *session, unsigned int endpoint, const RetryPolicy *policy,
+                     bool probe, struct sockaddr_storage *address, bool *answered);
+
+/**
+ * @brief Connects the session to the first endpoint, from `current` onwards, that answers.
+ *
+ * The addresses of every endpoint are raced. With a single endpoint that resolves to a single
+ * address there is nothing to choose and no probe is sent. If no endpoint answers, the session
+ * keeps the first address that could be connected, so that the requests report the missing
+ * responses as usual.
+ *
+ * @param[in,out] session The session.
+ * @param[in] policy Timeouts of the probes: each round waits `initial_rto_ms`, and
+ *                   `max_retries + 1` rounds are sent per endpoint.
+ *
+ * @return false if no endpoint resolves or no socket can be connected.
+ */
+bool open_session(ServerSession *session, const RetryPolicy *policy);
+
+/**
+ * @brief Moves the session to the next endpoint after the current one stopped answering.
+ *
+ * @param[in,out] session An open session.
+ * @param[in] policy Timeouts of the probes.
+ *
+ * @return false if the session has a single endpoint or no other endpoint answers; the
+ *         session then stays connected to the previous endpoint.
+ */
+bool failover_session(ServerSession *session, const RetryPolicy *policy);
+
+/**
+ * @brief Closes the socket of the session.
+ *
+ * @param[in,out] session The session.
+ */
+void close_session(ServerSession *session);
+
+/* - - - - - - - - - - - - - - - - - - END RESOLVER - - - - - - - - - - - - - - - - - - */
+
+#endif /* RESOLVER_H_ */
@@ -0,0 +1,296 @@
+/**
+ * @file stash.c
+ * @brief Implementation of the local stash of prefetched passwords.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#if defined WIN32
+#include <winsock2.h>       /**< Include recv() and getpeername() */
+#else
+#include <unistd.h>         /**< Include close() */
+#include <sys/socket.h>     /**< Include recv() and getpeername() */
+#define closesocket close   /**< Define closesocket as close for UNIX systems */
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include "stash.h"
+#include "../transport/transport.h"
+#include "../../../../UDP_core/src/libs/random/random.h"
+
+/* - - - - - - - - - - - - - - - - - - - - STASH - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Overwrites memory with zeros in a way the compiler cannot drop.
+ */
+static void wipe(void *memory, size_t size) {
+    volatile unsigned char *bytes = memory;
+    while (size-- > 0) {
+        *bytes++ = 0;
+    }
+}
+
+/**
+ * @brief Initializes a stash, or a disabled one.
+ * @return false if the entries cannot be allocated or the key cannot be drawn.
+ */
+bool init_stash(Stash *stash, unsigned int capacity, unsigned int low_water, const RetryPolicy *policy) {
+    memset(stash, 0, sizeof(*stash));
+    stash->socket = -1;
+    rtt_init(&stash->rtt, policy);
+    if (capacity == 0) {
+        return true;
+    }
+
+    stash->entries = calloc(capacity, sizeof(StashEntry));
+    if (stash->entries == NULL || !system_random_bytes((uint8_t *)stash->key.words, sizeof(stash->key.words))) {
+        free(stash->entries);
+        stash->entries = NULL;
+        return false;
+    }
+    stash->capacity = capacity;
+    stash->low_water = low_water;
+    return true;
+}
+
+/**
+ * @brief Tells whether the stashed passwords answer a request.
+ */
+static bool stash_matches(const Stash *stash, const PasswordRequest *password_request) {
+    return stash->keyed && password_request->count == 1 && !(password_request->flags & REQUEST_FLAG_BULK) &&
+           password_request->type == stash->type && password_request->length == stash->length &&
+           password_request->flags == stash->flags;
+}
+
+/**
+ * @brief Header authenticated with every entry: the passwords of another request never open.
+ */
+static void entry_header(const Stash *stash, uint8_t header[3]) {
+    header[0] = (uint8_t)stash->type;
+    header[1] = stash->length;
+    header[2] = stash->flags;
+}
+
+/**
+ * @brief Seals a received password into the next free entry, if there is one.
+ */
+static void push_entry(Stash *stash, const uint8_t *password) {
+    if (stash->count == stash->capacity) {
+        return;
+    }
+    StashEntry *entry = &stash->entries[(stash->head + stash->count) % stash->capacity];
+    uint8_t *trailer = entry->sealed + stash->length;
+    uint8_t header[3];
+    entry_header(stash, header);
+
+    memcpy(entry->sealed, password, stash->length);
+    memset(trailer, 0, SEAL_NONCE_SIZE);
+    for (unsigned int i = 0; i < 8; i++) {
+        trailer[i] = (uint8_t)(stash->nonce >> (8 * i)); /**< A counter: never repeats under the key */
+    }
+    stash->nonce++;
+    seal_payload(&stash->key, header, sizeof(header), entry->sealed, stash->length, trailer);
+    stash->count++;
+}
+
+/**
+ * @brief Wipes every entry and forgets the request they answer; a refill in flight is dropped.
+ */
+static void empty_stash(Stash *stash) {
+    wipe(stash->entries, (size_t)stash->capacity * sizeof(StashEntry));
+    stash->head = 0;
+    stash->count = 0;
+    stash->keyed = false;
+    stash->refilling = false;
+}
+
+/**
+ * @brief Receives one datagram of the refill and stashes its passwords.
+ * @details Datagrams of another refill, already received, or failing their authentication, are
+ *          ignored. The first cookie challenge is answered at once, as in `exchange_bulk_request`.
+ */
+static void receive_refill(Stash *stash) {
+    uint8_t datagram[MAX_DATAGRAM_SIZE];
+    BulkResponseHeader header;
+    int rcv_msg_size = recv(stash->socket, (char *)datagram, sizeof(datagram), 0);
+    if (rcv_msg_size < 0 || !decode_bulk_header(datagram, rcv_msg_size, &header) ||
+        header.request_id != stash->refill.request_id ||
+        header.sequence >= MAX_STASH_SIZE || stash->seen[header.sequence] || !open_bulk_datagram(datagram, &header)) {
+        return; /**< Not a new, authentic part of the refill */
+    }
+    if (header.status == STATUS_COOKIE_REQUIRED && header.items == 1 && header.length == COOKIE_SIZE) {
+        store_cookie(stash->socket, datagram + BULK_HEADER_SIZE);
+        if (!stash->challenged) {
+            stash->challenged = true;
+            if (!send_request(stash->socket, &stash->refill)) {
+                stash->refilling = false;
+            }
+            stash->deadline = monotonic_us() + rtt_timeout(&stash->rtt, stash->retries);
+        }
+        return;
+    }
+    if (header.status != STATUS_OK || header.length != stash->length) {
+        stash->refilling = false; /**< E.g. a policy the server no longer knows: the requests redefine it */
+        return;
+    }
+
+    uint64_t now = monotonic_us();
+    if (stash->received == 0 && stash->retries == 0 && !stash->challenged) {
+        rtt_sample(&stash->rtt, now - stash->sent_at);
+    }
+    stash->seen[header.sequence] = true;
+    stash->total = header.total;
+    stash->received++;
+    stash->refilling = stash->received < stash->total;
+    stash->deadline = now + rtt_timeout(&stash->rtt, stash->retries); /**< The response is still arriving */
+    for (unsigned int i = 0; i < header.items; i++) {
+        push_entry(stash, datagram + BULK_HEADER_SIZE + (size_t)i * header.length);
+    }
+    wipe(datagram, sizeof(datagram));
+}
+
+/**
+ * @brief Collects the datagrams of the refill and retransmits it once its timeout expires.
+ * @param[in,out] stash The stash.
+ * @param[in] wait Whether to wait until a password is stashed or the refill is abandoned,
+ *                 rather than only take what is already received.
+ */
+static void collect_refill(Stash *stash, bool wait) {
+    while (stash->refilling && !(wait && stash->count > 0)) {
+        uint64_t now = monotonic_us();
+        if (now >= stash->deadline) {
+            if (stash->retries == stash->rtt.policy->max_retries || !send_request(stash->socket, &stash->refill)) {
+                stash->refilling = false; /**< Sent again by the next refill_stash */
+                return;
+            }
+            stash->retries++;
+            stash->deadline = now + rtt_timeout(&stash->rtt, stash->retries);
+            continue;
+        }
+
+        int ready = wait_for_datagram(stash->socket, wait ? stash->deadline - now : 0);
+        if (ready < 0) {
+            stash->refilling = false;
+            return;
+        }
+        if (ready == 0 && !wait) {
+            return;
+        }
+        if (ready > 0) {
+            receive_refill(stash);
+        }
+    }
+}
+
+/**
+ * @brief Serves a request from the stash, waiting for the refill only if the stash is empty.
+ * @return true if a password was taken.
+ */
+bool take_stashed(Stash *stash, const PasswordRequest *password_request, char *password) {
+    if (!stash_matches(stash, password_request)) {
+        return false;
+    }
+    collect_refill(stash, false);
+    if (stash->count == 0) {
+        collect_refill(stash, true);
+    }
+    if (stash->count == 0) {
+        return false;
+    }
+
+    StashEntry *entry = &stash->entries[stash->head];
+    uint8_t header[3];
+    entry_header(stash, header);
+    bool opened = open_payload(&stash->key, header, sizeof(header), entry->sealed, stash->length,
+                               entry->sealed + stash->length);
+    if (opened) {
+        memcpy(password, entry->sealed, stash->length);
+        password[stash->length] = '\0';
+    }
+    wipe(entry, sizeof(*entry)); /**< Single use */
+    stash->head = (stash->head + 1) % stash->capacity;
+    stash->count--;
+    return opened;
+}
+
+/**
+ * @brief Moves the socket of the refills to the server of `server_socket`, if it changed.
+ * @return false if the address of the server cannot be read or no socket can be connected to it.
+ */
+static bool follow_server(Stash *stash, int server_socket) {
+    struct sockaddr_storage address;
+    socklen_t size = sizeof(address);
+    memset(&address, 0, sizeof(address));
+    if (getpeername(server_socket, (struct sockaddr *)&address, &size) < 0) {
+        return false;
+    }
+    if (stash->socket >= 0 && memcmp(&address, &stash->address, address_size(&address)) == 0) {
+        return true;
+    }
+
+    if (stash->socket >= 0) {
+        closesocket(stash->socket);
+    }
+    stash->socket = connect_server_socket(&address);
+    stash->address = address;
+    rtt_init(&stash->rtt, stash->rtt.policy); /**< The measurements of the previous server no longer apply */
+    return stash->socket >= 0;
+}
+
+/**
+ * @brief Follows the request just served and sends a refill once the stash is low.
+ */
+void refill_stash(Stash *stash, const PasswordRequest *password_request, int server_socket) {
+    if (stash->capacity == 0 || password_request->count != 1 || (password_request->flags & REQUEST_FLAG_BULK)) {
+        return;
+    }
+    if (!stash_matches(stash, password_request)) {
+        empty_stash(stash);
+        stash->keyed = true;
+        stash->type = password_request->type;
+        stash->length = password_request->length;
+        stash->flags = password_request->flags;
+    }
+    collect_refill(stash, false);
+    if (stash->refilling || stash->count > stash->low_water || !follow_server(stash, server_socket)) {
+        return;
+    }
+
+    stash->refill = *password_request;
+    stash->refill.flags |= REQUEST_FLAG_BULK;
+    stash->refill.count = (uint16_t)(stash->capacity - stash->count);
+    stash->refill.request_id = STASH_REQUEST_ID | (stash->next_id++ & 0xFFFFu);
+    memset(stash->seen, 0, sizeof(stash->seen));
+    stash->received = 0;
+    stash->total = 1;
+    stash->retries = 0;
+    stash->challenged = false;
+    if (!send_request(stash->socket, &stash->refill)) {
+        return;
+    }
+    stash->refilling = true;
+    stash->sent_at = monotonic_us();
+    stash->deadline = stash->sent_at + rtt_timeout(&stash->rtt, 0);
+}
+
+/**
+ * @brief Wipes the stash and closes the socket of the refills.
+ */
+void close_stash(Stash *stash) {
+    if (stash->entries != NULL) {
+        empty_stash(stash);
+        free(stash->entries);
+        stash->entries = NULL;
+    }
+    wipe(&stash->key, sizeof(stash->key));
+    stash->capacity = 0;
+    if (stash->socket >= 0) {
+        closesocket(stash->socket);
+        stash->socket = -1;
+    }
+}
+
+/* - - - - - - - - - - - - - - - - - - - END STASH - - - - - - - - - - - - - - - - - - - */
@@ -0,0 +1,130 @@
+/**
+ * @file stash.h
+ * @brief Header file declaring the local stash of prefetched passwords of the interactive client.
+ *
+ * The stash keeps a few passwords of the last single request served (same type, length and
+ * flags), fetched ahead of time with one bulk request, so that the next identical request is
+ * answered at once instead of after a round trip. A different request empties the stash and
+ * makes it follow the new one.
+ *
+ * Once the stash falls to its low-water mark, a refill asks the server for enough passwords to
+ * fill it again. The refill goes out on a socket of its own, connected to the same server as
+ * the requests, and its datagrams wait in the kernel buffer of that socket while the user types:
+ * they are collected, without waiting, the next time the stash is consulted. Only a request
+ * finding the stash empty while a refill of the same passwords is in flight waits for it, which
+ * is never longer than a new request would take. A lost refill is retransmitted with the
+ * timeouts of `reliability.h`, when the stash is next consulted.
+ *
+ * The passwords are kept sealed (ChaCha20-Poly1305, see `seal.h`) under a key drawn at startup,
+ * never in clear. Each one is served once: it is opened, copied out and wiped from the stash.
+ * The stash is wiped when the client exits.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef STASH_H_
+#define STASH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../reliability/reliability.h"
+#include "../../../../UDP_core/src/libs/protocol/protocol.h"
+#include "../../../../UDP_core/src/libs/seal/seal.h"
+
+/* - - - - - - - - - - - - - - - - - - - - STASH - - - - - - - - - - - - - - - - - - - - */
+
+#define DEFAULT_STASH_SIZE 16           /**< Passwords stashed when no `--stash` is given */
+#define DEFAULT_STASH_LOW 4             /**< Low-water mark when no `--stash-low` is given */
+#define MAX_STASH_SIZE 256              /**< Largest accepted stash */
+#define STASH_REQUEST_ID 0xFFFE0000u    /**< Base identifier of the refills, never used by requests */
+
+/**
+ * @struct StashEntry
+ * @brief One sealed password: its characters, then the nonce and the tag.
+ */
+typedef struct {
+    uint8_t sealed[MAX_PASSWORD_LENGTH + SEAL_OVERHEAD]; /**< `length` bytes, then the trailer */
+} StashEntry;
+
+/**
+ * @struct Stash
+ * @brief The stashed passwords and the refill in flight.
+ */
+typedef struct {
+    StashEntry *entries;        /**< Ring of `capacity` entries, NULL when disabled */
+    unsigned int capacity;      /**< Passwords kept at most, 0 when disabled */
+    unsigned int low_water;     /**< A refill is sent once `count` falls to it */
+    unsigned int head;          /**< Index of the oldest entry */
+    unsigned int count;         /**< Stashed passwords */
+    SealKey key;                /**< Key sealing the entries, drawn at startup */
+    uint64_t nonce;             /**< Nonce of the next entry sealed */
+    bool keyed;                 /**< Whether the fields below describe the stashed passwords */
+    char type;                  /**< Type of the stashed passwords */
+    uint8_t length;             /**< Length of the stashed passwords */
+    uint8_t flags;              /**< Flags of the request they answer */
+    int socket;                 /**< Socket of the refills, -1 until the first one */
+    struct sockaddr_storage address; /**< Server it is connected to */
+    RttEstimator rtt;           /**< Timeouts of the refills */
+    bool refilling;             /**< Whether a refill is in flight */
+    PasswordRequest refill;     /**< The bulk request of the refill */
+    bool seen[MAX_STASH_SIZE];  /**< Datagrams of the refill already received */
+    unsigned int received;      /**< Number of them */
+    unsigned int total;         /**< Datagrams of the refill, 1 until the first arrives */
+    unsigned int retries;       /**< Retransmissions of the refill */
+    bool challenged;            /**< Whether a cookie challenge was already answered at once */
+    uint64_t sent_at;           /**< Time of the first transmission, in microseconds */
+    uint64_t deadline;          /**< Time of the next retransmission, in microseconds */
+    uint32_t next_id;           /**< Number of the next refill */
+} Stash;
+
+/**
+ * @brief Initializes a stash, or a disabled one.
+ *
+ * @param[out] stash The stash.
+ * @param[in] capacity Passwords kept at most, in [0, MAX_STASH_SIZE]; 0 disables the stash.
+ * @param[in] low_water Low-water mark, below `capacity`.
+ * @param[in] policy Timeouts and retransmissions of the refills; it must outlive the stash.
+ *
+ * @return false if the entries cannot be allocated or the key cannot be drawn; the stash is
+ *         then disabled.
+ */
+bool init_stash(Stash *stash, unsigned int capacity, unsigned int low_water, const RetryPolicy *policy);
+
+/**
+ * @brief Serves a request from the stash.
+ *
+ * Collects the datagrams of the refill received so far, and waits for the refill if the stash
+ * is empty and the refill brings passwords for this request.
+ *
+ * @param[in,out] stash The stash.
+ * @param[in] password_request The request; only single requests are served.
+ * @param[out] password Receives the null-terminated password, `MAX_PASSWORD_LENGTH + 1` bytes.
+ *
+ * @return true if the stash held a password for the request; it is no longer stashed.
+ */
+bool take_stashed(Stash *stash, const PasswordRequest *password_request, char *password);
+
+/**
+ * @brief Makes the stash follow a request just served, and refills it if it is low.
+ *
+ * A request different from the stashed passwords wipes them. Bulk requests are ignored.
+ *
+ * @param[in,out] stash The stash.
+ * @param[in] password_request The request served.
+ * @param[in] server_socket A socket connected to the server to ask; the refill is sent on a
+ *                          socket of the stash connected to the same address.
+ */
+void refill_stash(Stash *stash, const PasswordRequest *password_request, int server_socket);
+
+/**
+ * @brief Wipes the stashed passwords and the key, and closes the socket of the refills.
+ *
+ * @param[in,out] stash The stash.
+ */
+void close_stash(Stash *stash);
+
+/* - - - - - - - - - - - - - - - - - - - END STASH - - - - - - - - - - - - - - - - - - - */
+
+#endif /* STASH_H_ */
@@ -0,0 +1,44 @@
+/**
+ * @file transport.c
+ * @brief Implementation of the transport functions that only the interactive client needs.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#include <string.h>
+#include "transport.h"
+
+/* - - - - - - - - - - - - - - - - - - CLIENT TRANSPORT - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Send an encoded datagram to the server.
+ * @details Only requests and policy definitions not already carrying a cookie are marked; any
+ *          other datagram is sent as it is.
+ * @return false if the datagram is not fully sent.
+ */
+bool send_datagram(int client_socket, const uint8_t *datagram, size_t datagram_size) {
+    uint8_t marked_request[MAX_REQUEST_SIZE];
+    if (datagram_size >= REQUEST_HEADER_SIZE && datagram_size <= MAX_POLICY_DEFINITION_SIZE &&
+        !(datagram[3] & REQUEST_FLAG_COOKIE)) {
+        memcpy(marked_request, datagram, datagram_size);
+        datagram_size = mark_datagram(client_socket, marked_request, datagram_size, sizeof(marked_request));
+        datagram = marked_request;
+    }
+    return send_connected(client_socket, datagram, datagram_size);
+}
+
+/**
+ * @brief Checks the sealing of a bulk response datagram and decrypts its passwords in place.
+ */
+bool open_bulk_datagram(uint8_t *datagram, const BulkResponseHeader *header) {
+    size_t payload_size = (size_t)header->items * header->length;
+    if (!check_sealing(header->flags, header->status, payload_size)) {
+        return false;
+    }
+    return !(header->flags & REQUEST_FLAG_SEALED) ||
+           open_response(datagram, BULK_HEADER_SIZE, datagram + BULK_HEADER_SIZE, payload_size);
+}
+
+/* - - - - - - - - - - - - - - - - - END CLIENT TRANSPORT - - - - - - - - - - - - - - - - - */
@@ -0,0 +1,53 @@
+/**
+ * @file transport.h
+ * @brief Header file declaring the transport functions that only the interactive client needs.
+ *
+ * The functions shared with the benchmark client (connected sockets, sealing, cookies, single
+ * requests and responses) live in the core transport library, included here. The client adds
+ * the sending of datagrams it encodes itself, such as the policy definitions, and the opening of
+ * the bulk responses.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef CLIENT_TRANSPORT_H_
+#define CLIENT_TRANSPORT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../../../UDP_core/src/libs/transport/transport.h"
+
+/* - - - - - - - - - - - - - - - - - - CLIENT TRANSPORT - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Send an encoded datagram to the server.
+ *
+ * A pending "connection refused" error is consumed and the send is attempted once more.
+ * `REQUEST_FLAG_SEALED` is set on a copy of the datagram when the sealing is enabled, and the
+ * cookie of the socket is appended to it when one is kept.
+ *
+ * @param[in] client_socket The connected socket descriptor.
+ * @param[in] datagram The encoded datagram.
+ * @param[in] datagram_size Number of bytes of `datagram`.
+ *
+ * @return true if the datagram is fully sent.
+ */
+bool send_datagram(int client_socket, const uint8_t *datagram, size_t datagram_size);
+
+/**
+ * @brief Checks the sealing of a bulk response datagram and decrypts its passwords in place.
+ *
+ * @param[in,out] datagram The received datagram.
+ * @param[in] header Its header, decoded by `decode_bulk_header`.
+ *
+ * @return true if the datagram is sealed as requested and authentic, or may be read in clear
+ *         (an error without passwords, or a cookie challenge, whose cookie is left to the caller).
+ */
+bool open_bulk_datagram(uint8_t *datagram, const BulkResponseHeader *header);
+
+/* - - - - - - - - - - - - - - - - - END CLIENT TRANSPORT - - - - - - - - - - - - - - - - - */
+
+#endif /* CLIENT_TRANSPORT_H_ */
@@ -0,0 +1,94 @@
+/**
+ * @file chacha20.c
+ * @brief Implementation of the ChaCha20 block function of RFC 8439.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#include <string.h>
+
+#include "chacha20.h"
+
+/* - - - - - - - - - - - - - - - - - - - - - CHACHA20 - - - - - - - - - - - - - - - - - - - - - */
+
+#define ROTATE_LEFT(value, bits) (((value) << (bits)) | ((value) >> (32 - (bits))))
+
+#define QUARTER_ROUND(a, b, c, d)                          \
+    do {                                                   \
+        a += b; d ^= a; d = ROTATE_LEFT(d, 16);            \
+        c += d; b ^= c; b = ROTATE_LEFT(b, 12);            \
+        a += b; d ^= a; d = ROTATE_LEFT(d, 8);             \
+        c += d; b ^= c; b = ROTATE_LEFT(b, 7);             \
+    } while (0)
+
+/**
+ * @brief Loads a 32-bit word stored in little-endian order.
+ */
+uint32_t load_le32(const uint8_t *bytes) {
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) |
+           ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+/**
+ * @brief Stores a 32-bit word in little-endian order.
+ */
+void store_le32(uint8_t *bytes, uint32_t word) {
+    bytes[0] = (uint8_t)word;
+    bytes[1] = (uint8_t)(word >> 8);
+    bytes[2] = (uint8_t)(word >> 16);
+    bytes[3] = (uint8_t)(word >> 24);
+}
+
+/**
+ * @brief Computes one 64-byte ChaCha20 block.
+ */
+void chacha20_block(const uint32_t key[8], uint32_t counter, const uint32_t nonce[3],
+                    uint8_t block[CHACHA20_BLOCK_SIZE]) {
+    const uint32_t input[16] = {
+        0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,  /**< "expand 32-byte k" */
+        key[0], key[1], key[2], key[3], key[4], key[5], key[6], key[7],
+        counter, nonce[0], nonce[1], nonce[2]
+    };
+    uint32_t x[16];
+    memcpy(x, input, sizeof(x));
+
+    for (int round = 0; round < 20; round += 2) {
+        QUARTER_ROUND(x[0], x[4], x[8],  x[12]);  /**< Column rounds */
+        QUARTER_ROUND(x[1], x[5], x[9],  x[13]);
+        QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+        QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+        QUARTER_ROUND(x[0], x[5], x[10], x[15]);  /**< Diagonal rounds */
+        QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+        QUARTER_ROUND(x[2], x[7], x[8],  x[13]);
+        QUARTER_ROUND(x[3], x[4], x[9],  x[14]);
+    }
+    for (int i = 0; i < 16; i++) {
+        store_le32(block + 4 * i, x[i] + input[i]);
+    }
+}
+
+/**
+ * @brief Runs the block function test vector of RFC 8439, section 2.3.2.
+ */
+bool chacha20_self_test(void) {
+    static const uint32_t nonce[3] = { 0x09000000, 0x4a000000, 0x00000000 };
+    static const uint8_t expected[CHACHA20_BLOCK_SIZE] = {
+        0x10, 0xf1, 0xe7, 0xe4, 0xd1, 0x3b, 0x59, 0x15, 0x50, 0x0f, 0xdd, 0x1f, 0xa3, 0x20, 0x71, 0xc4,
+        0xc7, 0xd1, 0xf4, 0xc7, 0x33, 0xc0, 0x68, 0x03, 0x04, 0x22, 0xaa, 0x9a, 0xc3, 0xd4, 0x6c, 0x4e,
+        0xd2, 0x82, 0x64, 0x46, 0x07, 0x9f, 0xaa, 0x09, 0x14, 0xc2, 0xd7, 0x05, 0xd9, 0x8b, 0x02, 0xa2,
+        0xb5, 0x12, 0x9c, 0xd1, 0xde, 0x16, 0x4e, 0xb9, 0xcb, 0xd0, 0x83, 0xe8, 0xa2, 0x50, 0x3c, 0x4e
+    };
+    uint32_t key[8];
+    for (int i = 0; i < 8; i++) {
+        uint8_t bytes[4] = { (uint8_t)(4 * i), (uint8_t)(4 * i + 1), (uint8_t)(4 * i + 2), (uint8_t)(4 * i + 3) };
+        key[i] = load_le32(bytes);   /**< The key bytes 00 01 02 ... 1f */
+    }
+
+    uint8_t block[CHACHA20_BLOCK_SIZE];
+    chacha20_block(key, 1, nonce, block);
+    return memcmp(block, expected, sizeof(block)) == 0;
+}
+
+/* - - - - - - - - - - - - - - - - - - - - END CHACHA20 - - - - - - - - - - - - - - - - - - - - */
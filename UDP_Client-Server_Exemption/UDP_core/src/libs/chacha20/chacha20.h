@@ -0,0 +1,62 @@
+/**
+ * @file chacha20.h
+ * @brief Header file providing the ChaCha20 block function shared by the random source and the sealing.
+ *
+ * ChaCha20 follows RFC 8439: 20 rounds over a 256-bit key, a 32-bit block counter and a 96-bit
+ * nonce. The key and the nonce are given as the little-endian words the rounds work on, so
+ * `random.c` feeds its state as it is and `seal.c` its `SealKey` and the nonce of a trailer.
+ * Both thus run the same code, which `chacha20_self_test` checks against the RFC.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef CHACHA20_H_
+#define CHACHA20_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* - - - - - - - - - - - - - - - - - - - - - CHACHA20 - - - - - - - - - - - - - - - - - - - - - */
+
+#define CHACHA20_BLOCK_SIZE 64      /**< Bytes of keystream per block */
+
+/**
+ * @brief Loads a 32-bit word stored in little-endian order.
+ *
+ * @param[in] bytes The 4 bytes of the word.
+ *
+ * @return The word.
+ */
+uint32_t load_le32(const uint8_t *bytes);
+
+/**
+ * @brief Stores a 32-bit word in little-endian order.
+ *
+ * @param[out] bytes The 4 bytes of the word.
+ * @param[in] word The word.
+ */
+void store_le32(uint8_t *bytes, uint32_t word);
+
+/**
+ * @brief Computes one ChaCha20 block.
+ *
+ * @param[in] key The eight words of the 256-bit key.
+ * @param[in] counter The block counter.
+ * @param[in] nonce The three words of the 96-bit nonce.
+ * @param[out] block Receives the `CHACHA20_BLOCK_SIZE` bytes of keystream.
+ */
+void chacha20_block(const uint32_t key[8], uint32_t counter, const uint32_t nonce[3],
+                    uint8_t block[CHACHA20_BLOCK_SIZE]);
+
+/**
+ * @brief Runs the block function test vector of RFC 8439, section 2.3.2.
+ *
+ * @return `true` if `chacha20_block` gives the keystream of the RFC.
+ */
+bool chacha20_self_test(void);
+
+/* - - - - - - - - - - - - - - - - - - - - END CHACHA20 - - - - - - - - - - - - - - - - - - - - */
+
+#endif /* CHACHA20_H_ */
@@ -0,0 +1,241 @@
+/**
+ * @file charset.c
+ * @brief Implementation of the scalar and SIMD character-mapping kernels.
+ *
+ * Every kernel applies the same rule to each random byte `b` of a block, with `n` the
+ * charset size: `index = (b * n) >> 8`, accepted only if `(b * n) & 0xFF >= 256 % n`.
+ * Exactly `n * floor(256 / n)` byte values are accepted and each index is produced by
+ * `floor(256 / n)` of them, so the output is uniform. The SIMD kernels vectorize the
+ * multiply and the rejection test, then compact the accepted lanes through a bit mask.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#include <string.h>
+#include "charset.h"
+#include "../random/random.h"
+
+#if defined __AVX2__
+#include <immintrin.h>
+#elif defined __SSE2__ || defined _M_X64
+#include <emmintrin.h>
+#define CHARSET_SSE2
+#elif defined __ARM_NEON
+#include <arm_neon.h>
+#endif
+
+/* - - - - - - - - - - - - - - - - - - - - CHARSETS - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Builds a `Charset` at run time.
+ * @return `false` if `symbols` is empty or longer than `CHARSET_MAX_SIZE`.
+ */
+bool build_charset(Charset *charset, const char *symbols) {
+    size_t size = strlen(symbols);
+    if (size == 0 || size > CHARSET_MAX_SIZE) {
+        return false;
+    }
+    charset->symbols = symbols;
+    charset->size = (uint8_t)size;
+    charset->threshold = (uint8_t)(256 % size);
+    return true;
+}
+
+/* - - - - - - - - - - - - - - - - - - - END CHARSETS - - - - - - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - - - - - - KERNELS - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Maps bytes one at a time.
+ * @return The number of characters written, at most `capacity`.
+ */
+size_t map_charset_scalar(const Charset *charset, const uint8_t *bytes, size_t count, char *output, size_t capacity) {
+    size_t written = 0;
+    for (size_t i = 0; i < count && written < capacity; i++) {
+        unsigned int product = (unsigned int)bytes[i] * charset->size;
+        if ((product & 0xFF) >= charset->threshold) {
+            output[written++] = charset->symbols[product >> 8];
+        }
+    }
+    return written;
+}
+
+/**
+ * @brief Appends the accepted lanes of a SIMD block to `output`.
+ * @param[in] symbols Charset characters.
+ * @param[in] indices Character index of every lane.
+ * @param[in] accepted Bit `i` is set if lane `i` is accepted.
+ * @param[out] output Destination.
+ * @param[in] written Characters already in `output`.
+ * @param[in] capacity Maximum number of characters in `output`.
+ * @return The new number of characters in `output`.
+ */
+static size_t compact_lanes(const char *symbols, const uint8_t *indices, uint32_t accepted,
+                            char *output, size_t written, size_t capacity) {
+    while (accepted != 0 && written < capacity) {
+#if defined __GNUC__
+        unsigned int lane = (unsigned int)__builtin_ctz(accepted);
+#else
+        unsigned int lane = 0;
+        while (!(accepted & (1u << lane))) {
+            lane++;
+        }
+#endif
+        output[written++] = symbols[indices[lane]];
+        accepted &= accepted - 1; /**< Clear the lowest set bit */
+    }
+    return written;
+}
+
+#if defined __AVX2__
+/**
+ * @brief Maps 32 bytes per iteration with AVX2, then hands the tail to the scalar kernel.
+ */
+static size_t map_charset_avx2(const Charset *charset, const uint8_t *bytes, size_t count, char *output, size_t capacity) {
+    const __m256i size = _mm256_set1_epi16(charset->size);
+    const __m256i threshold = _mm256_set1_epi16((short)charset->threshold - 1);
+    const __m256i low_byte = _mm256_set1_epi16(0xFF);
+    uint8_t indices[32];
+    size_t written = 0;
+    size_t i = 0;
+
+    for (; i + 32 <= count && written < capacity; i += 32) {
+        __m128i first = _mm_loadu_si128((const __m128i *)(bytes + i));
+        __m128i second = _mm_loadu_si128((const __m128i *)(bytes + i + 16));
+        __m256i products_first = _mm256_mullo_epi16(_mm256_cvtepu8_epi16(first), size);
+        __m256i products_second = _mm256_mullo_epi16(_mm256_cvtepu8_epi16(second), size);
+
+        __m256i high = _mm256_packus_epi16(_mm256_srli_epi16(products_first, 8),
+                                           _mm256_srli_epi16(products_second, 8));
+        __m256i keep = _mm256_packs_epi16(
+            _mm256_cmpgt_epi16(_mm256_and_si256(products_first, low_byte), threshold),
+            _mm256_cmpgt_epi16(_mm256_and_si256(products_second, low_byte), threshold));
+        high = _mm256_permute4x64_epi64(high, 0xD8); /**< Undo the per-lane interleaving of pack */
+        keep = _mm256_permute4x64_epi64(keep, 0xD8);
+
+        _mm256_storeu_si256((__m256i *)indices, high);
+        written = compact_lanes(charset->symbols, indices, (uint32_t)_mm256_movemask_epi8(keep),
+                                output, written, capacity);
+    }
+    return written + map_charset_scalar(charset, bytes + i, count - i, output + written, capacity - written);
+}
+#endif
+
+#if defined CHARSET_SSE2
+/**
+ * @brief Maps 16 bytes per iteration with SSE2, then hands the tail to the scalar kernel.
+ */
+static size_t map_charset_sse2(const Charset *charset, const uint8_t *bytes, size_t count, char *output, size_t capacity) {
+    const __m128i size = _mm_set1_epi16(charset->size);
+    const __m128i threshold = _mm_set1_epi16((short)charset->threshold - 1);
+    const __m128i low_byte = _mm_set1_epi16(0xFF);
+    const __m128i zero = _mm_setzero_si128();
+    uint8_t indices[16];
+    size_t written = 0;
+    size_t i = 0;
+
+    for (; i + 16 <= count && written < capacity; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *)(bytes + i));
+        __m128i products_low = _mm_mullo_epi16(_mm_unpacklo_epi8(block, zero), size);
+        __m128i products_high = _mm_mullo_epi16(_mm_unpackhi_epi8(block, zero), size);
+
+        __m128i high = _mm_packus_epi16(_mm_srli_epi16(products_low, 8), _mm_srli_epi16(products_high, 8));
+        __m128i keep = _mm_packs_epi16(
+            _mm_cmpgt_epi16(_mm_and_si128(products_low, low_byte), threshold),
+            _mm_cmpgt_epi16(_mm_and_si128(products_high, low_byte), threshold));
+
+        _mm_storeu_si128((__m128i *)indices, high);
+        written = compact_lanes(charset->symbols, indices, (uint32_t)_mm_movemask_epi8(keep),
+                                output, written, capacity);
+    }
+    return written + map_charset_scalar(charset, bytes + i, count - i, output + written, capacity - written);
+}
+#endif
+
+#if !defined __AVX2__ && !defined CHARSET_SSE2 && defined __ARM_NEON
+/**
+ * @brief Maps 16 bytes per iteration with NEON, then hands the tail to the scalar kernel.
+ */
+static size_t map_charset_neon(const Charset *charset, const uint8_t *bytes, size_t count, char *output, size_t capacity) {
+    const uint8x8_t size = vdup_n_u8(charset->size);
+    const uint8x16_t threshold = vdupq_n_u8(charset->threshold);
+    uint8_t indices[16];
+    uint8_t keep[16];
+    size_t written = 0;
+    size_t i = 0;
+
+    for (; i + 16 <= count && written < capacity; i += 16) {
+        uint8x16_t block = vld1q_u8(bytes + i);
+        uint16x8_t products_low = vmull_u8(vget_low_u8(block), size);
+        uint16x8_t products_high = vmull_u8(vget_high_u8(block), size);
+
+        vst1q_u8(indices, vcombine_u8(vshrn_n_u16(products_low, 8), vshrn_n_u16(products_high, 8)));
+        vst1q_u8(keep, vcgeq_u8(vcombine_u8(vmovn_u16(products_low), vmovn_u16(products_high)), threshold));
+
+        uint32_t accepted = 0;
+        for (unsigned int lane = 0; lane < 16; lane++) {
+            accepted |= (uint32_t)(keep[lane] & 1) << lane;
+        }
+        written = compact_lanes(charset->symbols, indices, accepted, output, written, capacity);
+    }
+    return written + map_charset_scalar(charset, bytes + i, count - i, output + written, capacity - written);
+}
+#endif
+
+/**
+ * @brief Maps random bytes with the widest kernel available at compile time.
+ * @return The number of characters written, at most `capacity`.
+ */
+size_t map_charset(const Charset *charset, const uint8_t *bytes, size_t count, char *output, size_t capacity) {
+#if defined __AVX2__
+    return map_charset_avx2(charset, bytes, count, output, capacity);
+#elif defined CHARSET_SSE2
+    return map_charset_sse2(charset, bytes, count, output, capacity);
+#elif defined __ARM_NEON
+    return map_charset_neon(charset, bytes, count, output, capacity);
+#else
+    return map_charset_scalar(charset, bytes, count, output, capacity);
+#endif
+}
+
+/**
+ * @brief Name of the kernel selected by `map_charset`.
+ */
+const char *charset_kernel_name(void) {
+#if defined __AVX2__
+    return "avx2";
+#elif defined CHARSET_SSE2
+    return "sse2";
+#elif defined __ARM_NEON
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+/**
+ * @brief Fills `output` with `length` random characters from `charset`.
+ * @details Each round requests about 1.5 times the missing characters, rounded up to a
+ *          multiple of 16 bytes, so that the SIMD kernels never run on a partial block
+ *          and most passwords need a single call to `random_bytes`.
+ */
+void generate_from_charset(const Charset *charset, char *output, size_t length) {
+    uint8_t bytes[64];
+    size_t written = 0;
+
+    while (written < length) {
+        size_t missing = length - written;
+        size_t request = (missing + missing / 2 + 15) & ~(size_t)15;
+        if (request > sizeof(bytes)) {
+            request = sizeof(bytes);
+        }
+        random_bytes(bytes, request);
+        written += map_charset(charset, bytes, request, output + written, missing);
+    }
+    output[length] = '\0';
+    memset(bytes, 0, sizeof(bytes)); /**< Do not leave random material on the stack */
+}
+
+/* - - - - - - - - - - - - - - - - - - - END KERNELS - - - - - - - - - - - - - - - - - - - */
@@ -0,0 +1,110 @@
+/**
+ * @file charset.h
+ * @brief Header file providing the character-mapping kernel used by the password generators.
+ *
+ * A `Charset` is built once (at compile time with `CHARSET_INITIALIZER`, or at run time with
+ * `build_charset`) and then turns blocks of random bytes into characters without bias:
+ * - each byte `b` is multiplied by the charset size `n`;
+ * - the high byte of `b * n` is the character index;
+ * - the byte is rejected when the low byte of `b * n` is below `256 % n`.
+ *
+ * No division is needed, and on x86 (SSE2/AVX2) and ARM (NEON) the multiply and the rejection
+ * test run on 16 or 32 bytes per instruction; other targets use the scalar kernel.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef CHARSET_H_
+#define CHARSET_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* - - - - - - - - - - - - - - - - - - - - CHARSETS - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Largest number of characters a charset can hold.
+ *
+ * Sizes must fit in one byte so that `b * n` fits in 16 bits for every random byte `b`.
+ */
+#define CHARSET_MAX_SIZE 255
+
+/**
+ * @struct Charset
+ * @brief Precomputed mapping from random bytes to characters.
+ */
+typedef struct {
+    const char *symbols;  /**< Characters indexed by the kernel (not owned) */
+    uint8_t size;         /**< Number of characters, in [1, CHARSET_MAX_SIZE] */
+    uint8_t threshold;    /**< `256 % size`: products whose low byte is below it are rejected */
+} Charset;
+
+/**
+ * @brief Builds a `Charset` from a string literal at compile time.
+ *
+ * @param literal A string literal holding between 1 and `CHARSET_MAX_SIZE` characters.
+ */
+#define CHARSET_INITIALIZER(literal) \
+    { (literal), (uint8_t)(sizeof(literal) - 1), (uint8_t)(256 % (sizeof(literal) - 1)) }
+
+/**
+ * @brief Builds a `Charset` at run time.
+ *
+ * @param[out] charset The charset to initialize.
+ * @param[in] symbols Null-terminated string of characters. It must outlive `charset`.
+ *
+ * @return `true` if `symbols` holds between 1 and `CHARSET_MAX_SIZE` characters, `false` otherwise.
+ */
+bool build_charset(Charset *charset, const char *symbols);
+
+/* - - - - - - - - - - - - - - - - - - - END CHARSETS - - - - - - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - - - - - - KERNELS - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Maps random bytes to characters, skipping the bytes that would introduce bias.
+ *
+ * Uses the widest SIMD kernel available at compile time and falls back to the scalar kernel
+ * for the tail of the block.
+ *
+ * @param[in] charset The charset to map to.
+ * @param[in] bytes Random input bytes.
+ * @param[in] count Number of bytes in `bytes`.
+ * @param[out] output Destination for the characters (not null-terminated).
+ * @param[in] capacity Maximum number of characters to write.
+ *
+ * @return The number of characters written, at most `capacity`.
+ */
+size_t map_charset(const Charset *charset, const uint8_t *bytes, size_t count, char *output, size_t capacity);
+
+/**
+ * @brief Scalar version of `map_charset`, available on every target.
+ *
+ * @return The number of characters written, at most `capacity`.
+ */
+size_t map_charset_scalar(const Charset *charset, const uint8_t *bytes, size_t count, char *output, size_t capacity);
+
+/**
+ * @brief Name of the kernel selected by `map_charset` ("avx2", "sse2", "neon" or "scalar").
+ *
+ * @return A static string.
+ */
+const char *charset_kernel_name(void);
+
+/**
+ * @brief Fills `output` with `length` random characters from `charset` and null-terminates it.
+ *
+ * Random bytes are requested in blocks from `random_bytes` and wiped after use.
+ *
+ * @param[in] charset The charset to draw from.
+ * @param[out] output Destination, at least `length + 1` bytes.
+ * @param[in] length Number of characters to generate.
+ */
+void generate_from_charset(const Charset *charset, char *output, size_t length);
+
+/* - - - - - - - - - - - - - - - - - - - END KERNELS - - - - - - - - - - - - - - - - - - - */
+
+#endif /* CHARSET_H_ */
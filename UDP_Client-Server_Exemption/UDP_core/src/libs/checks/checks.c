@@ -1,5 +1,5 @@
 /**
- * @file password.c
+ * @file checks.c
  * @brief Implementation of functions for password parameter validation.
  *
  * This file contains the implementation of the following functionalities:
@@ -17,7 +17,7 @@
 #include <stddef.h>
 #include <ctype.h>
 #include <string.h>
-#include "password.h"
+#include "checks.h"
 
 /* - - - - - - - - - - - - - - - - - PASSWORD CHECKS - - - - - - - - - - - - - - - - - */
 
@@ -1,5 +1,5 @@
 /**
- * @file password.h
+ * @file checks.h
  * @brief Header file that defines functions for password validation.
  *
  * This file provides declarations for the following functions:
@@ -12,8 +12,8 @@
  * @author Michele Camassa
  */
 
-#ifndef PASSWORD_H_
-#define PASSWORD_H_
+#ifndef CHECKS_H_
+#define CHECKS_H_
 
 #include <stdbool.h>
 
@@ -70,4 +70,4 @@ bool control_length(const char *length, const int min_length, const int max_leng
 
 /* - - - - - - - - - - - - - - - END PASSWORD CHECKS - - - - - - - - - - - - - - - - - - */
 
-#endif /* PASSWORD_H_ */
+#endif /* CHECKS_H_ */
@@ -0,0 +1,300 @@
+/**
+ * @file password.c
+ * @brief Implementation of password generation functions based on various types and lengths.
+ * @version 1.0.1
+ * @date 2024-12-20
+ * @author Michele Camassa
+ *
+ * This file provides the implementation for generating passwords of different types:
+ * numeric, alphabetic, alphanumeric, secure, and unambiguous. Each password type
+ * follows specific criteria, and the functions are designed to generate passwords
+ * that meet user-defined requirements.
+ *
+ * Characters are produced by the unbiased charset kernel of `charset.h` from blocks of
+ * random bytes supplied by the per-thread cryptographically secure generator of `random.h`.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <ctype.h>
+#include <string.h>
+#include "password.h"
+#include "../charset/charset.h"
+#include "../protocol/protocol.h"
+#include "../random/random.h"
+
+
+/* - - - - - - - - - - - - - - - - - CHARSETS - - - - - - - - - - - - - - - - - */
+
+#define NUMERIC_SYMBOLS "0123456789"
+#define ALPHA_SYMBOLS "abcdefghijklmnopqrstuvwxyz"
+#define MIXED_SYMBOLS "abcdefghijklmnopqrstuvwxyz0123456789"
+#define SECURE_SYMBOLS "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789!@#$%^&*()"
+#define UNAMBIGUOUS_SYMBOLS "abcdefghjkmnpqrtuvwxyACDEFGHJKLMNPQRTUVWXY34679!@#$%^&*()"
+
+static const Charset numeric_charset = CHARSET_INITIALIZER(NUMERIC_SYMBOLS);
+static const Charset alpha_charset = CHARSET_INITIALIZER(ALPHA_SYMBOLS);
+static const Charset mixed_charset = CHARSET_INITIALIZER(MIXED_SYMBOLS);
+static const Charset secure_charset = CHARSET_INITIALIZER(SECURE_SYMBOLS);
+static const Charset unambiguous_charset = CHARSET_INITIALIZER(UNAMBIGUOUS_SYMBOLS);
+
+/* - - - - - - - - - - - - - - - - END CHARSETS - - - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - SPECIALIZED GENERATORS - - - - - - - - - - - - - - - */
+
+/*
+ * `generate_password` calls one generator per type and length, instantiated below from the
+ * same inline body. With the charset and the length known at compile time, each instance
+ * draws a block of random bytes sized for its own acceptance rate, instead of whole SIMD
+ * blocks, and maps it with a fully unrolled, branchless loop: the multiply, the rejection
+ * threshold and the lookups are constants, the block needs no bounds checks.
+ */
+
+#if defined __GNUC__
+#define FIXED_INLINE static inline __attribute__((always_inline))
+#define FIXED_UNROLL _Pragma("GCC unroll 64")
+#else
+#define FIXED_INLINE static inline
+#define FIXED_UNROLL
+#endif
+
+/**
+ * @brief Random bytes drawn by the generator of a charset and a length.
+ * @details The expected number of bytes, `length * 256 / accepted`, plus a margin that keeps
+ *          the odds of a second draw below 0.2% for every built-in type and length.
+ */
+#define FIXED_BLOCK_SIZE(symbols, length) \
+    ((length) * 256 / (256 - 256 % (sizeof(symbols) - 1)) + 3 + (length) / 4)
+
+#define FIXED_MAX_BLOCK 64      /**< Largest block of any instance (48, for secure passwords of 32 characters) */
+
+_Static_assert(FIXED_BLOCK_SIZE(SECURE_SYMBOLS, MAX_PASSWORD_LENGTH) <= FIXED_MAX_BLOCK,
+               "The specialized generators need a larger block");
+_Static_assert(MIN_PASSWORD_LENGTH == 6 && MAX_PASSWORD_LENGTH == 32,
+               "FIXED_LENGTHS must list every valid password length");
+
+/**
+ * @brief Body of every specialized generator.
+ * @details Every byte is mapped and stored; a rejected one is overwritten by the next, so the
+ *          loop has no branch. The few passwords the block falls short of are completed by
+ *          the generic generator, which keeps the output uniform.
+ * @param[in] charset The charset, a constant of this file.
+ * @param[out] password Destination of `length` characters and a null terminator.
+ * @param[in] length The password length, a constant.
+ * @param[in] block_size Random bytes to draw, a constant of at most `FIXED_MAX_BLOCK`.
+ */
+FIXED_INLINE void generate_fixed(const Charset *charset, char *password, size_t length, size_t block_size) {
+    uint8_t bytes[FIXED_MAX_BLOCK];
+    char characters[FIXED_MAX_BLOCK];
+    size_t written = 0;
+
+    random_bytes(bytes, block_size);
+    FIXED_UNROLL
+    for (size_t i = 0; i < block_size; i++) {
+        unsigned int product = (unsigned int)bytes[i] * charset->size;
+        characters[written] = charset->symbols[product >> 8];
+        written += (product & 0xFF) >= charset->threshold;
+    }
+
+    if (written >= length) {
+        memcpy(password, characters, length);
+        password[length] = '\0';
+    } else {
+        memcpy(password, characters, written);
+        generate_from_charset(charset, password + written, length - written);
+    }
+    memset(bytes, 0, sizeof(bytes));            /**< Do not leave random material on the stack */
+    memset(characters, 0, sizeof(characters));
+}
+
+/**
+ * @brief Expands `X(name, symbols, length)` for every valid password length.
+ */
+#define FIXED_LENGTHS(X, name, symbols) \
+    X(name, symbols, 6) X(name, symbols, 7) X(name, symbols, 8) X(name, symbols, 9) \
+    X(name, symbols, 10) X(name, symbols, 11) X(name, symbols, 12) X(name, symbols, 13) \
+    X(name, symbols, 14) X(name, symbols, 15) X(name, symbols, 16) X(name, symbols, 17) \
+    X(name, symbols, 18) X(name, symbols, 19) X(name, symbols, 20) X(name, symbols, 21) \
+    X(name, symbols, 22) X(name, symbols, 23) X(name, symbols, 24) X(name, symbols, 25) \
+    X(name, symbols, 26) X(name, symbols, 27) X(name, symbols, 28) X(name, symbols, 29) \
+    X(name, symbols, 30) X(name, symbols, 31) X(name, symbols, 32)
+
+#define FIXED_LENGTH_COUNT (MAX_PASSWORD_LENGTH - MIN_PASSWORD_LENGTH + 1)
+
+/**
+ * @brief Defines the generator of one type and length, e.g. `generate_secure_16`.
+ */
+#define DEFINE_FIXED_GENERATOR(name, symbols, length) \
+    static void generate_##name##_##length(char *password) { \
+        generate_fixed(&name##_charset, password, length, FIXED_BLOCK_SIZE(symbols, length)); \
+    }
+
+/**
+ * @brief Table entry of the generator of one type and length.
+ */
+#define FIXED_GENERATOR_ENTRY(name, symbols, length) generate_##name##_##length,
+
+FIXED_LENGTHS(DEFINE_FIXED_GENERATOR, numeric, NUMERIC_SYMBOLS)
+FIXED_LENGTHS(DEFINE_FIXED_GENERATOR, alpha, ALPHA_SYMBOLS)
+FIXED_LENGTHS(DEFINE_FIXED_GENERATOR, mixed, MIXED_SYMBOLS)
+FIXED_LENGTHS(DEFINE_FIXED_GENERATOR, secure, SECURE_SYMBOLS)
+FIXED_LENGTHS(DEFINE_FIXED_GENERATOR, unambiguous, UNAMBIGUOUS_SYMBOLS)
+
+/**
+ * @brief Specialized generators, indexed by type and by length minus `MIN_PASSWORD_LENGTH`.
+ */
+static void (*const fixed_generators[PASSWORD_TYPE_COUNT][FIXED_LENGTH_COUNT])(char *) = {
+    [NUMERIC] = { FIXED_LENGTHS(FIXED_GENERATOR_ENTRY, numeric, NUMERIC_SYMBOLS) },
+    [ALPHA] = { FIXED_LENGTHS(FIXED_GENERATOR_ENTRY, alpha, ALPHA_SYMBOLS) },
+    [MIXED] = { FIXED_LENGTHS(FIXED_GENERATOR_ENTRY, mixed, MIXED_SYMBOLS) },
+    [SECURE] = { FIXED_LENGTHS(FIXED_GENERATOR_ENTRY, secure, SECURE_SYMBOLS) },
+    [UNAMBIGUOUS] = { FIXED_LENGTHS(FIXED_GENERATOR_ENTRY, unambiguous, UNAMBIGUOUS_SYMBOLS) },
+};
+
+/* - - - - - - - - - - - - - - END SPECIALIZED GENERATORS - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - - - PASSWORD GENERATION - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Generates a numeric password.
+ *
+ * This function generates a password consisting of numeric digits (0-9) based on the
+ * specified length.
+ *
+ * @param[out] password Pointer to a pre-allocated array where the password will be stored.
+ * @param[in] length The desired length of the password. Must be a positive integer.
+ *
+ * @pre The `password` array should be large enough to hold `length + 1` characters.
+ * @post The `password` array contains a null-terminated numeric password.
+ */
+void generate_numeric(char *password, int length) {
+    generate_from_charset(&numeric_charset, password, length); /**< Digits between 0 and 9, null-terminated */
+}
+
+/**
+ * @brief Generates a lowercase alphabetic password.
+ *
+ * This function generates a password consisting of lowercase alphabetic characters (a-z)
+ * based on the specified length.
+ *
+ * @param[out] password Pointer to a pre-allocated array where the password will be stored.
+ * @param[in] length The desired length of the password. Must be a positive integer.
+ *
+ * @pre The `password` array should be large enough to hold `length + 1` characters.
+ * @post The `password` array contains a null-terminated alphabetic password.
+ */
+void generate_alpha(char *password, int length) {
+    generate_from_charset(&alpha_charset, password, length); /**< Letters between 'a' and 'z', null-terminated */
+}
+
+/**
+ * @brief Generates an alphanumeric password.
+ *
+ * This function generates a password consisting of both numeric digits (0-9) and lowercase
+ * alphabetic characters (a-z), each of the 36 characters being equally likely.
+ *
+ * @param[out] password Pointer to a pre-allocated array where the password will be stored.
+ * @param[in] length The desired length of the password. Must be a positive integer.
+ *
+ * @pre The `password` array should be large enough to hold `length + 1` characters.
+ * @post The `password` array contains a null-terminated alphanumeric password.
+ */
+void generate_mixed(char *password, int length) {
+    generate_from_charset(&mixed_charset, password, length); /**< Letters and digits, null-terminated */
+}
+
+/**
+ * @brief Generates a secure password.
+ *
+ * This function generates a password containing a mix of lowercase and uppercase letters,
+ * numeric digits, and special characters.
+ *
+ * @param[out] password Pointer to a pre-allocated array where the password will be stored.
+ * @param[in] length The desired length of the password. Must be a positive integer.
+ *
+ * @pre The `password` array should be large enough to hold `length + 1` characters.
+ * @post The `password` array contains a null-terminated secure password.
+ */
+void generate_secure(char *password, int length) {
+    generate_from_charset(&secure_charset, password, length); /**< Select random characters from the charset */
+}
+
+/**
+ * @brief Generates an unambiguous secure password.
+ *
+ * This function generates a password that avoids visually similar characters (e.g., `1`, `l`, `I`,
+ * `O`, and `0`). This is useful for environments where passwords may be read aloud or viewed on screens.
+ *
+ * @param[out] password Pointer to a pre-allocated array where the password will be stored.
+ * @param[in] length The desired length of the password. Must be a positive integer.
+ *
+ * @pre The `password` array should be large enough to hold `length + 1` characters.
+ * @post The `password` array contains a null-terminated unambiguous secure password.
+ */
+void generate_unambiguous(char *password, int length) {
+    generate_from_charset(&unambiguous_charset, password, length); /**< Select random characters from the charset */
+}
+
+/**
+ * @brief Generates a password based on the specified type and length.
+ *
+ * This function serves as the main interface for password generation. Valid lengths are
+ * served by the generator specialized for the type and the length, found in a table; other
+ * lengths fall back to the `generate_*` function of the type.
+ *
+ * @param[out] password Pointer to a pre-allocated array where the password will be stored.
+ * @param[in] type The type of password to generate (see `PasswordType` enum).
+ * @param[in] length The desired length of the password. Must be a positive integer.
+ *
+ * @pre The `password` array should be large enough to hold `length + 1` characters.
+ * @pre `type` must be one of the valid values defined in the `PasswordType` enum.
+ * @post The `password` array contains a null-terminated password of the specified type.
+ *
+ * @note The random number generator of the calling thread is seeded automatically from the
+ *       operating system on the first call (see `random.h`).
+ */
+void generate_password(char *password, PasswordType type, int length) {
+    if ((unsigned int)type < PASSWORD_TYPE_COUNT && length >= MIN_PASSWORD_LENGTH && length <= MAX_PASSWORD_LENGTH) {
+        fixed_generators[type][length - MIN_PASSWORD_LENGTH](password);
+        return;
+    }
+    switch(type) {
+        case NUMERIC:
+            generate_numeric(password, length);
+            break;
+        case ALPHA:
+            generate_alpha(password, length);
+            break;
+        case MIXED:
+            generate_mixed(password, length);
+            break;
+        case SECURE:
+            generate_secure(password, length);
+            break;
+        case UNAMBIGUOUS:
+            generate_unambiguous(password, length);
+            break;
+    }
+}
+
+/**
+ * @brief Returns the charset the generator of a password type draws from.
+ */
+const Charset *password_charset(PasswordType type) {
+    switch(type) {
+        case ALPHA:
+            return &alpha_charset;
+        case MIXED:
+            return &mixed_charset;
+        case SECURE:
+            return &secure_charset;
+        case UNAMBIGUOUS:
+            return &unambiguous_charset;
+        case NUMERIC:
+        default:
+            return &numeric_charset;
+    }
+}
+
+/* - - - - - - - - - - - - - - - - END PASSWORD GENERATION - - - - - - - - - - - - - - - - */
@@ -11,6 +11,7 @@
 #define PASSWORD_H_
 
 #include <stdbool.h>
+#include "../charset/charset.h"
 
 
 /* - - - - - - - - - - - - - - - - - - - PASSWORD TYPES - - - - - - - - - - - - - - - - - */
@@ -34,6 +35,8 @@ typedef enum {
     UNAMBIGUOUS  /**< Unambiguous password: excludes visually similar characters (e.g., O/0, l/1) */
 } PasswordType;
 
+#define PASSWORD_TYPE_COUNT 5  /**< Number of PasswordType values */
+
 /* - - - - - - - - - - - - - - - - - - END PASSWORD TYPES - - - - - - - - - - - - - - - - */
 
 /* - - - - - - - - - - - - - - - - - - PASSWORD GENERATION - - - - - - - - - - - - - - - - - - */
@@ -65,6 +68,29 @@ typedef enum {
  */
 void generate_password(char *password, PasswordType type, int length);
 
+/**
+ * @brief Generators of the single password types, for any length.
+ *
+ * `generate_password` calls them for the lengths its specialized generators do not cover.
+ *
+ * @param[out] password A pre-allocated array of at least `length + 1` characters.
+ * @param[in] length The desired length of the generated password.
+ */
+void generate_numeric(char *password, int length);
+void generate_alpha(char *password, int length);     /**< @copydoc generate_numeric */
+void generate_mixed(char *password, int length);     /**< @copydoc generate_numeric */
+void generate_secure(char *password, int length);    /**< @copydoc generate_numeric */
+void generate_unambiguous(char *password, int length); /**< @copydoc generate_numeric */
+
+/**
+ * @brief Returns the charset the generator of a password type draws from.
+ *
+ * @param[in] type The password type.
+ *
+ * @return The charset, valid for the whole life of the program.
+ */
+const Charset *password_charset(PasswordType type);
+
 /* - - - - - - - - - - - - - - - - - END PASSWORD GENERATION - - - - - - - - - - - - - - - - - */
 
 #endif /* PASSWORD_H_ */
@@ -0,0 +1,413 @@
+/**
+ * @file protocol.c
+ * @brief Implementation of the v2 binary wire format and of the legacy (v1) request decoder.
+ *
+ * Every multi-byte field is written byte by byte in network byte order, so the encoding
+ * does not depend on the host endianness nor on the compiler's struct padding.
+ *
+ * @version 2.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#include <string.h>
+#include "protocol.h"
+
+/* - - - - - - - - - - - - - - - - - - BYTE ORDER - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Stores a 32-bit value in network byte order.
+ * @param[out] buffer Destination (at least 4 bytes).
+ * @param[in] value The value to store.
+ */
+static void write_u32(uint8_t *buffer, uint32_t value) {
+    buffer[0] = (uint8_t)(value >> 24);
+    buffer[1] = (uint8_t)(value >> 16);
+    buffer[2] = (uint8_t)(value >> 8);
+    buffer[3] = (uint8_t)value;
+}
+
+/**
+ * @brief Stores a 16-bit value in network byte order.
+ * @param[out] buffer Destination (at least 2 bytes).
+ * @param[in] value The value to store.
+ */
+static void write_u16(uint8_t *buffer, uint16_t value) {
+    buffer[0] = (uint8_t)(value >> 8);
+    buffer[1] = (uint8_t)value;
+}
+
+/**
+ * @brief Loads a 16-bit value stored in network byte order.
+ * @param[in] buffer Source (at least 2 bytes).
+ * @return The decoded value.
+ */
+static uint16_t read_u16(const uint8_t *buffer) {
+    return (uint16_t)(((uint16_t)buffer[0] << 8) | buffer[1]);
+}
+
+/**
+ * @brief Loads a 32-bit value stored in network byte order.
+ * @param[in] buffer Source (at least 4 bytes).
+ * @return The decoded value.
+ */
+static uint32_t read_u32(const uint8_t *buffer) {
+    return ((uint32_t)buffer[0] << 24) | ((uint32_t)buffer[1] << 16) |
+           ((uint32_t)buffer[2] << 8) | (uint32_t)buffer[3];
+}
+
+/* - - - - - - - - - - - - - - - - - - END BYTE ORDER - - - - - - - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - - - - ENCODING - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Encodes a request into its v2 representation, appending `count` for bulk requests.
+ * @return The number of bytes written, or 0 if `buffer` is too small.
+ */
+size_t encode_request(const PasswordRequest *request, uint8_t *buffer, size_t buffer_size) {
+    bool bulk = (request->flags & REQUEST_FLAG_BULK) != 0;
+    size_t size = bulk ? BULK_REQUEST_SIZE : REQUEST_HEADER_SIZE;
+    if (buffer_size < size) {
+        return 0;
+    }
+    buffer[0] = PROTOCOL_VERSION_BYTE;
+    buffer[1] = (uint8_t)request->type;
+    buffer[2] = request->length;
+    buffer[3] = request->flags & (uint8_t)~(REQUEST_FLAG_LEGACY | REQUEST_FLAG_COOKIE); /**< Local only; the cookie sets its own */
+    write_u32(buffer + 4, request->request_id);
+    if (bulk) {
+        write_u16(buffer + REQUEST_HEADER_SIZE, request->count);
+    }
+    if (request->flags & REQUEST_FLAG_COOKIE) {
+        return attach_cookie(buffer, size, buffer_size, request->cookie);
+    }
+    return size;
+}
+
+/**
+ * @brief Tells whether a datagram starts with the v2 magic nibble.
+ */
+bool is_v2_datagram(const uint8_t *buffer, size_t size) {
+    return size > 0 && (buffer[0] & PROTOCOL_MAGIC_MASK) == PROTOCOL_MAGIC;
+}
+
+/**
+ * @brief Decodes a v2 request datagram.
+ * @return `false` if the datagram is too short or carries another version.
+ */
+bool decode_request(const uint8_t *buffer, size_t size, PasswordRequest *request) {
+    if (size < REQUEST_HEADER_SIZE || buffer[0] != PROTOCOL_VERSION_BYTE) {
+        return false;
+    }
+    request->type = (char)buffer[1];
+    request->length = buffer[2];
+    request->flags = buffer[3] & (uint8_t)~REQUEST_FLAG_LEGACY;
+    request->request_id = read_u32(buffer + 4);
+    request->count = 1;
+    if (request->flags & REQUEST_FLAG_COOKIE) {
+        if (size < REQUEST_HEADER_SIZE + COOKIE_SIZE) {
+            return false;
+        }
+        size -= COOKIE_SIZE; /**< The cookie ends the datagram */
+        memcpy(request->cookie, buffer + size, COOKIE_SIZE);
+    }
+    if (request->flags & REQUEST_FLAG_DEFINE) {
+        request->flags &= REQUEST_FLAG_DEFINE | REQUEST_FLAG_SEALED | REQUEST_FLAG_COOKIE; /**< The body follows the header, not a count */
+    } else if (request->flags & REQUEST_FLAG_BULK) {
+        if (size < BULK_REQUEST_SIZE) {
+            return false;
+        }
+        request->count = read_u16(buffer + REQUEST_HEADER_SIZE);
+    }
+    return true;
+}
+
+/**
+ * @brief Appends a cookie to an encoded v2 request.
+ * @return The new size of the request, or 0 if `buffer` is too small.
+ */
+size_t attach_cookie(uint8_t *buffer, size_t size, size_t buffer_size, const uint8_t *cookie) {
+    if (size < REQUEST_HEADER_SIZE || size + COOKIE_SIZE > buffer_size) {
+        return 0;
+    }
+    buffer[3] |= REQUEST_FLAG_COOKIE;
+    memcpy(buffer + size, cookie, COOKIE_SIZE);
+    return size + COOKIE_SIZE;
+}
+
+/**
+ * @brief Decodes a v1 request, parsing the length string the same way `atoi` did.
+ * @return `false` if the datagram is empty.
+ */
+bool decode_legacy_request(const uint8_t *buffer, size_t size, PasswordRequest *request) {
+    if (size == 0) {
+        return false;
+    }
+
+    unsigned int numerical_length = 0;
+    size_t i = 1;
+    while (i < size && (buffer[i] == ' ' || buffer[i] == '\t')) {
+        i++; /**< Skip leading blanks, as `atoi` does */
+    }
+    for (; i < size && buffer[i] >= '0' && buffer[i] <= '9'; i++) {
+        numerical_length = numerical_length * 10 + (buffer[i] - '0');
+        if (numerical_length > UINT8_MAX) {
+            numerical_length = UINT8_MAX; /**< Saturate: the value is out of range anyway */
+            break;
+        }
+    }
+
+    request->type = (char)buffer[0];
+    request->length = (uint8_t)numerical_length;
+    request->flags = REQUEST_FLAG_LEGACY;
+    request->request_id = 0;
+    request->count = 1;
+    return true;
+}
+
+/**
+ * @brief Encodes a response, sending only the `length` generated characters.
+ * @return The number of bytes written, or 0 if `buffer` is too small.
+ */
+size_t encode_response(const PasswordResponse *response, uint8_t *buffer, size_t buffer_size) {
+    size_t length = response->length;
+    if (length > MAX_PASSWORD_LENGTH || buffer_size < RESPONSE_HEADER_SIZE + length) {
+        return 0;
+    }
+    encode_response_header(response->status, (uint8_t)length, response->flags, response->request_id, buffer);
+    memcpy(buffer + RESPONSE_HEADER_SIZE, response->password, length);
+    return RESPONSE_HEADER_SIZE + length;
+}
+
+/**
+ * @brief Encodes the header of a v2 response.
+ * @return `RESPONSE_HEADER_SIZE`.
+ */
+size_t encode_response_header(uint8_t status, uint8_t length, uint8_t flags, uint32_t request_id, uint8_t *buffer) {
+    buffer[0] = PROTOCOL_VERSION_BYTE;
+    buffer[1] = status;
+    buffer[2] = length;
+    buffer[3] = flags & (uint8_t)~REQUEST_FLAG_LEGACY;
+    write_u32(buffer + 4, request_id);
+    return RESPONSE_HEADER_SIZE;
+}
+
+/**
+ * @brief Decodes a v2 response datagram and null-terminates the password.
+ * @return `false` if the datagram is truncated or carries another version.
+ */
+bool decode_response(const uint8_t *buffer, size_t size, PasswordResponse *response) {
+    if (size < RESPONSE_HEADER_SIZE || buffer[0] != PROTOCOL_VERSION_BYTE) {
+        return false;
+    }
+    size_t length = buffer[2];
+    size_t trailer = (buffer[3] & REQUEST_FLAG_SEALED) ? SEAL_OVERHEAD : 0;
+    if (length > MAX_PASSWORD_LENGTH || size < RESPONSE_HEADER_SIZE + length + trailer) {
+        return false;
+    }
+    response->status = buffer[1];
+    response->length = (uint8_t)length;
+    response->flags = buffer[3];
+    response->request_id = read_u32(buffer + 4);
+    memcpy(response->password, buffer + RESPONSE_HEADER_SIZE, length);
+    response->password[length] = '\0';
+    return true;
+}
+
+/**
+ * @brief Encodes the fixed part of a bulk response datagram.
+ * @return The number of bytes written, or 0 if `buffer` is too small.
+ */
+size_t encode_bulk_header(const BulkResponseHeader *header, uint8_t *buffer, size_t buffer_size) {
+    if (buffer_size < BULK_HEADER_SIZE) {
+        return 0;
+    }
+    buffer[0] = PROTOCOL_VERSION_BYTE;
+    buffer[1] = header->status;
+    buffer[2] = header->length;
+    buffer[3] = (header->flags | REQUEST_FLAG_BULK) & (uint8_t)~REQUEST_FLAG_LEGACY;
+    write_u32(buffer + 4, header->request_id);
+    write_u16(buffer + 8, header->sequence);
+    write_u16(buffer + 10, header->total);
+    write_u16(buffer + 12, header->items);
+    return BULK_HEADER_SIZE;
+}
+
+/**
+ * @brief Decodes the fixed part of a bulk response datagram.
+ * @return `false` if the datagram is not a bulk response or is shorter than announced.
+ */
+bool decode_bulk_header(const uint8_t *buffer, size_t size, BulkResponseHeader *header) {
+    if (size < BULK_HEADER_SIZE || buffer[0] != PROTOCOL_VERSION_BYTE || !(buffer[3] & REQUEST_FLAG_BULK)) {
+        return false;
+    }
+    header->status = buffer[1];
+    header->length = buffer[2];
+    header->flags = buffer[3];
+    header->request_id = read_u32(buffer + 4);
+    header->sequence = read_u16(buffer + 8);
+    header->total = read_u16(buffer + 10);
+    header->items = read_u16(buffer + 12);
+    size_t trailer = (header->flags & REQUEST_FLAG_SEALED) ? SEAL_OVERHEAD : 0;
+    return header->length <= MAX_PASSWORD_LENGTH &&
+           size >= BULK_HEADER_SIZE + (size_t)header->items * header->length + trailer;
+}
+
+/**
+ * @brief Tells whether a byte can be part of a policy (printable ASCII other than the space).
+ */
+static bool is_policy_character(uint8_t character) {
+    return character > ' ' && character <= '~';
+}
+
+/**
+ * @brief Copies `size` policy characters into a null-terminated field.
+ * @return `false` if one of them is not printable.
+ */
+static bool copy_policy_characters(char *field, const uint8_t *characters, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        if (!is_policy_character(characters[i])) {
+            return false;
+        }
+        field[i] = (char)characters[i];
+    }
+    field[size] = '\0';
+    return true;
+}
+
+/**
+ * @brief Encodes a policy definition request.
+ * @return The number of bytes written, or 0 if the definition does not fit.
+ */
+size_t encode_policy_definition(const PolicySpec *spec, uint32_t request_id, uint8_t *buffer, size_t buffer_size) {
+    size_t extra = strlen(spec->extra);
+    size_t exclude = strlen(spec->exclude);
+    size_t size = POLICY_DEFINITION_HEADER_SIZE + extra + exclude;
+    if (size > MAX_POLICY_DEFINITION_SIZE || size > buffer_size) {
+        return 0;
+    }
+    buffer[0] = PROTOCOL_VERSION_BYTE;
+    buffer[1] = 0;
+    buffer[2] = 0;
+    buffer[3] = REQUEST_FLAG_DEFINE;
+    write_u32(buffer + 4, request_id);
+    buffer[8] = spec->classes;
+    buffer[9] = spec->required;
+    buffer[10] = (uint8_t)extra;
+    memcpy(buffer + POLICY_DEFINITION_HEADER_SIZE, spec->extra, extra);
+    memcpy(buffer + POLICY_DEFINITION_HEADER_SIZE + extra, spec->exclude, exclude);
+    return size;
+}
+
+/**
+ * @brief Decodes the body of a policy definition request.
+ * @return `false` if the body is truncated, too long or holds a non-printable character.
+ */
+bool decode_policy_definition(const uint8_t *buffer, size_t size, PolicySpec *spec) {
+    if (size >= REQUEST_HEADER_SIZE && (buffer[3] & REQUEST_FLAG_COOKIE)) {
+        size = size >= REQUEST_HEADER_SIZE + COOKIE_SIZE ? size - COOKIE_SIZE : 0; /**< The cookie is not part of the body */
+    }
+    if (size < POLICY_DEFINITION_HEADER_SIZE || size > MAX_POLICY_DEFINITION_SIZE) {
+        return false;
+    }
+    size_t extra = buffer[10];
+    if (POLICY_DEFINITION_HEADER_SIZE + extra > size) {
+        return false;
+    }
+    spec->classes = buffer[8];
+    spec->required = buffer[9];
+    return copy_policy_characters(spec->extra, buffer + POLICY_DEFINITION_HEADER_SIZE, extra) &&
+           copy_policy_characters(spec->exclude, buffer + POLICY_DEFINITION_HEADER_SIZE + extra,
+                                  size - POLICY_DEFINITION_HEADER_SIZE - extra);
+}
+
+/**
+ * @brief Parses a comma-separated list of class names.
+ * @param[in] text The list.
+ * @param[in] size Number of characters of the list.
+ * @param[out] classes Receives the `POLICY_CLASS_*` bits.
+ * @return `false` if a name is unknown.
+ */
+static bool parse_policy_classes(const char *text, size_t size, uint8_t *classes) {
+    static const struct {
+        const char *name;
+        uint8_t bit;
+    } names[POLICY_CLASS_COUNT] = {
+        { "lower", POLICY_CLASS_LOWER }, { "upper", POLICY_CLASS_UPPER }, { "digit", POLICY_CLASS_DIGIT },
+        { "symbol", POLICY_CLASS_SYMBOL }, { "extra", POLICY_CLASS_EXTRA }
+    };
+
+    *classes = 0;
+    while (size > 0) {
+        size_t name_size = 0;
+        while (name_size < size && text[name_size] != ',') {
+            name_size++;
+        }
+        unsigned int i = 0;
+        while (i < POLICY_CLASS_COUNT &&
+               (strlen(names[i].name) != name_size || strncmp(names[i].name, text, name_size) != 0)) {
+            i++;
+        }
+        if (i == POLICY_CLASS_COUNT) {
+            return false;
+        }
+        *classes |= names[i].bit;
+        text += name_size;
+        size -= name_size;
+        if (size > 0) {
+            text++; /**< Skip the comma */
+            size--;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Parses the text form of a policy.
+ * @return `false` on an unknown field or class, or on characters that do not fit a definition.
+ */
+bool parse_policy_spec(const char *text, PolicySpec *spec) {
+    memset(spec, 0, sizeof(*spec));
+    while (*text != '\0') {
+        if (*text == ' ') {
+            text++;
+            continue;
+        }
+        const char *value = text;
+        while (*value != '\0' && *value != '=' && *value != ' ') {
+            value++;
+        }
+        if (*value != '=') {
+            return false;
+        }
+        size_t key_size = (size_t)(value - text);
+        value++;
+        size_t value_size = 0;
+        while (value[value_size] != '\0' && value[value_size] != ' ') {
+            value_size++;
+        }
+
+        bool parsed;
+        if (key_size == 7 && strncmp(text, "classes", 7) == 0) {
+            parsed = parse_policy_classes(value, value_size, &spec->classes);
+        } else if (key_size == 7 && strncmp(text, "require", 7) == 0) {
+            parsed = parse_policy_classes(value, value_size, &spec->required);
+        } else if (key_size == 5 && strncmp(text, "extra", 5) == 0) {
+            parsed = value_size <= MAX_POLICY_CHARACTERS &&
+                     copy_policy_characters(spec->extra, (const uint8_t *)value, value_size);
+        } else if (key_size == 7 && strncmp(text, "exclude", 7) == 0) {
+            parsed = value_size <= MAX_POLICY_CHARACTERS &&
+                     copy_policy_characters(spec->exclude, (const uint8_t *)value, value_size);
+        } else {
+            parsed = false;
+        }
+        if (!parsed) {
+            return false;
+        }
+        text = value + value_size;
+    }
+    spec->classes &= (uint8_t)~POLICY_CLASS_EXTRA; /**< The extra characters say it already */
+    return strlen(spec->extra) + strlen(spec->exclude) <= MAX_POLICY_CHARACTERS;
+}
+
+/* - - - - - - - - - - - - - - - - - - END ENCODING - - - - - - - - - - - - - - - - - - - - */
@@ -0,0 +1,597 @@
+/**
+ * @file protocol.h
+ * @brief Header file used to define constants, structs, and protocol-specific
+ *        data structures shared by the server, the client and the benchmarks.
+ *
+ * This file centralizes communication parameters, such as buffer size, password constraints,
+ * and data structures for handling request-response communication between the client and server.
+ * It is part of the core library (`UDP_core`), so every program speaks exactly the same protocol.
+ *
+ * @version 2.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* - - - - - - - - - - - - - - - - - - - CONSTANTS - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Defines the maximum size of the buffer used for communication.
+ *
+ * The buffer is utilized for various purposes, including:
+ * - Storing server names.
+ * - Handling password lengths during requests.
+ * - General data transfer between the client and server.
+ *
+ * By choosing an adequate buffer size, we ensure flexibility for various operations
+ * while avoiding memory overflow risks.
+ */
+#define BUFFER_SIZE 1024        /**< Maximum buffer size used for communication */
+
+
+/**
+ * @brief Maximum allowable length for a generated password.
+ *
+ * Passwords exceeding this length will not be accepted by either the client or server.
+ * This constant ensures compatibility and usability across different systems and avoids
+ * potential security risks related to extremely long passwords.
+ */
+#define MAX_PASSWORD_LENGTH 32  /**< Maximum permissible password length */
+
+/**
+ * @brief Minimum allowable length for a generated password.
+ *
+ * Passwords shorter than this length are considered insecure and will be rejected
+ * by the system to ensure strong password policies.
+ */
+#define MIN_PASSWORD_LENGTH 6   /**< Minimum allowed password length */
+
+
+/**
+ * @brief Default port number for client-server communication.
+ *
+ * The default port, 8080, is typically used for development and testing. It is the
+ * default port number that clients will attempt to use when connecting to the server.
+ */
+#define DEFAULT_PORT 8080       /**< Default port number for communication */
+
+/**
+ * @brief Default IP address used for client-server communication.
+ *
+ * The default IP is set to `127.0.0.1`, the loopback address, which facilitates local
+ * communication between the client and server during development and testing.
+ */
+#define DEFAULT_IP "127.0.0.1"  /**< Default IP address used for the server-client connection */
+
+/**
+ * @brief Default number of datagrams drained per `recvmmsg` call in batched mode.
+ *
+ * Batching amortizes the cost of the receive and send system calls over several requests.
+ * A batch size of 1 selects the classic one-`recvfrom`-one-`sendto` loop.
+ */
+#define DEFAULT_BATCH_SIZE 32   /**< Default number of datagrams per batch */
+
+/**
+ * @brief Upper bound for the batch size accepted on the command line.
+ */
+#define MAX_BATCH_SIZE 256      /**< Maximum number of datagrams per batch */
+
+/**
+ * @brief Upper bound for the number of worker threads accepted on the command line.
+ *
+ * Each worker owns a socket bound to the same address with `SO_REUSEPORT`, so the kernel
+ * spreads client flows across them.
+ */
+#define MAX_WORKERS 256         /**< Maximum number of worker threads */
+
+/**
+ * @brief Upper bound for the number of addresses the server listens on.
+ *
+ * Every `--listen` endpoint may resolve to several addresses (e.g. a host name or an
+ * interface with both an IPv4 and an IPv6 address); each one is bound by every worker.
+ */
+#define MAX_LISTENERS 4         /**< Maximum number of bound addresses per worker */
+
+/* - - - - - - - - - - - - - - - - - - - END CONSTANTS - - - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - - - - - WIRE FORMAT - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Magic value stored in the high nibble of the first byte of every v2 datagram.
+ *
+ * Legacy (v1) requests start with the ASCII password type letter, whose high nibble
+ * can never match this value, so the first byte alone tells the two formats apart.
+ */
+#define PROTOCOL_MAGIC 0xB0         /**< High nibble of the version byte */
+
+/**
+ * @brief Current version of the binary wire format.
+ */
+#define PROTOCOL_VERSION 2          /**< Low nibble of the version byte */
+
+/**
+ * @brief First byte of every v2 request and response datagram.
+ */
+#define PROTOCOL_VERSION_BYTE (PROTOCOL_MAGIC | PROTOCOL_VERSION)
+
+/**
+ * @brief Mask used to extract the magic nibble from the version byte.
+ */
+#define PROTOCOL_MAGIC_MASK 0xF0
+
+/**
+ * @brief Size in bytes of an encoded v2 request.
+ *
+ * Layout (multi-byte fields in network byte order):
+ * | offset | size | field        |
+ * |--------|------|--------------|
+ * | 0      | 1    | version byte |
+ * | 1      | 1    | type         |
+ * | 2      | 1    | length       |
+ * | 3      | 1    | flags        |
+ * | 4      | 4    | request id   |
+ */
+#define REQUEST_HEADER_SIZE 8
+
+/**
+ * @brief Size in bytes of the fixed part of an encoded v2 response.
+ *
+ * Layout (multi-byte fields in network byte order):
+ * | offset | size   | field        |
+ * |--------|--------|--------------|
+ * | 0      | 1      | version byte |
+ * | 1      | 1      | status       |
+ * | 2      | 1      | length       |
+ * | 3      | 1      | flags        |
+ * | 4      | 4      | request id   |
+ * | 8      | length | password     |
+ *
+ * Only the generated characters are sent; the terminator is restored by the receiver.
+ */
+#define RESPONSE_HEADER_SIZE 8
+
+/**
+ * @brief Largest datagram a v2 response can occupy, sealed trailer included.
+ */
+#define MAX_RESPONSE_SIZE (RESPONSE_HEADER_SIZE + MAX_PASSWORD_LENGTH + SEAL_OVERHEAD)
+
+/**
+ * @brief Request flag asking for `count` passwords of the same type and length.
+ *
+ * A bulk request is `BULK_REQUEST_SIZE` bytes long: the v2 header followed by
+ * a 16-bit `count` in network byte order. The passwords come back packed in one or more
+ * bulk response datagrams (see `BULK_HEADER_SIZE`).
+ */
+#define REQUEST_FLAG_BULK 0x01
+
+/**
+ * @brief Size in bytes of an encoded bulk request.
+ */
+#define BULK_REQUEST_SIZE (REQUEST_HEADER_SIZE + 2)
+
+/**
+ * @brief Size in bytes of the fixed part of a bulk response datagram.
+ *
+ * Layout: the v2 response header (with `REQUEST_FLAG_BULK` set and `length` being the
+ * length of each password), then:
+ * | offset | size  | field                                  |
+ * |--------|-------|----------------------------------------|
+ * | 8      | 2     | sequence number of this datagram       |
+ * | 10     | 2     | total number of datagrams              |
+ * | 12     | 2     | number of passwords in this datagram   |
+ * | 14     | n * l | passwords, back to back, not separated |
+ */
+#define BULK_HEADER_SIZE (RESPONSE_HEADER_SIZE + 6)
+
+/**
+ * @brief Largest UDP payload that fits in a 1500-byte Ethernet MTU without fragmentation.
+ */
+#define MAX_DATAGRAM_SIZE 1472
+
+/**
+ * @brief Maximum number of passwords in a single bulk request.
+ *
+ * The bound keeps the ratio between response and request bytes in check; larger batches
+ * are split by the client into several requests.
+ */
+#define MAX_BULK_COUNT 1024
+
+/**
+ * @brief Request flag asking for a password of a policy instead of a built-in type.
+ *
+ * The `type` byte then carries the policy ID, from 0 to `MAX_POLICIES - 1`. Policies are
+ * configured on the server or defined by the clients with `REQUEST_FLAG_DEFINE`, and can
+ * be combined with `REQUEST_FLAG_BULK`.
+ */
+#define REQUEST_FLAG_POLICY 0x02
+
+/**
+ * @brief Request flag marking the datagram as the definition of a policy.
+ *
+ * Layout: the v2 request header (`type` and `length` are ignored), then:
+ * | offset | size | field                                                  |
+ * |--------|------|--------------------------------------------------------|
+ * | 8      | 1    | classes drawn from (see the `POLICY_CLASS_*` constants) |
+ * | 9      | 1    | classes required at least once                         |
+ * | 10     | 1    | number `e` of extra characters                         |
+ * | 11     | e    | extra characters                                       |
+ * | 11 + e | rest | excluded characters                                    |
+ *
+ * The server answers with a v2 response whose single password byte is the policy ID.
+ * Defining the same policy again returns the same ID.
+ */
+#define REQUEST_FLAG_DEFINE 0x04
+
+/**
+ * @brief Size in bytes of the fixed part of a policy definition.
+ */
+#define POLICY_DEFINITION_HEADER_SIZE (REQUEST_HEADER_SIZE + 3)
+
+/**
+ * @brief Largest policy definition datagram, extra and excluded characters included.
+ */
+#define MAX_POLICY_DEFINITION_SIZE 64
+
+/**
+ * @brief Largest number of extra or excluded characters in a policy.
+ */
+#define MAX_POLICY_CHARACTERS (MAX_POLICY_DEFINITION_SIZE - POLICY_DEFINITION_HEADER_SIZE)
+
+/**
+ * @brief Number of policy IDs, as many as the values of the `type` byte.
+ */
+#define MAX_POLICIES 256
+
+/**
+ * @brief Character classes of a policy.
+ *
+ * Characters of a policy are printable ASCII characters other than the space (33 to 126).
+ * The symbol class is the one of the secure type, `!@#$%^&*()`; any other character joins
+ * a policy as an extra character.
+ */
+#define POLICY_CLASS_LOWER 0x01     /**< Lowercase letters, a-z */
+#define POLICY_CLASS_UPPER 0x02     /**< Uppercase letters, A-Z */
+#define POLICY_CLASS_DIGIT 0x04     /**< Digits, 0-9 */
+#define POLICY_CLASS_SYMBOL 0x08    /**< Symbols of the secure type */
+#define POLICY_CLASS_EXTRA 0x10     /**< The extra characters of the policy */
+#define POLICY_CLASS_COUNT 5        /**< Number of classes */
+
+/**
+ * @brief Request flag asking for a sealed response.
+ *
+ * The response carries the flag too. Its header stays in clear, the bytes after it (the
+ * password, the policy ID or the packed passwords of a bulk datagram) are encrypted with
+ * ChaCha20-Poly1305 under a key shared by the client and the server, and a trailer follows:
+ * | offset     | size | field                                               |
+ * |------------|------|-----------------------------------------------------|
+ * | h + n      | 12   | nonce, chosen by the server                         |
+ * | h + n + 12 | 16   | tag over the clear header and the n encrypted bytes |
+ *
+ * where `h` is `RESPONSE_HEADER_SIZE` or `BULK_HEADER_SIZE`. A server holding a key answers
+ * the requests without the flag with `STATUS_SEALING_REQUIRED` and no password.
+ */
+#define REQUEST_FLAG_SEALED 0x08
+
+#define SEAL_NONCE_SIZE 12          /**< Bytes of the nonce of a sealed response */
+#define SEAL_TAG_SIZE 16            /**< Bytes of the Poly1305 tag of a sealed response */
+#define SEAL_OVERHEAD (SEAL_NONCE_SIZE + SEAL_TAG_SIZE) /**< Bytes added to a datagram by the sealing */
+
+/**
+ * @brief Request flag marking a request that echoes the cookie of the server.
+ *
+ * A server started with cookies answers the v2 requests without a valid cookie, whatever they
+ * ask for, with `STATUS_COOKIE_REQUIRED` and a `COOKIE_SIZE`-byte cookie in place of the
+ * password, bound to the address and port of the client and to a time window. The client then
+ * sends its requests with the flag set and the cookie as the last `COOKIE_SIZE` bytes of the
+ * datagram (after the count of a bulk request, after the body of a policy definition), until
+ * the server challenges it again. A bulk request is challenged with a bulk response of one
+ * datagram holding one "password" of `COOKIE_SIZE` bytes. Challenges are never sealed.
+ */
+#define REQUEST_FLAG_COOKIE 0x10
+
+#define COOKIE_SIZE 8               /**< Bytes of a cookie */
+
+/**
+ * @brief Largest v2 request datagram: a policy definition and its cookie.
+ */
+#define MAX_REQUEST_SIZE (MAX_POLICY_DEFINITION_SIZE + COOKIE_SIZE)
+
+/**
+ * @brief Request flag set by the server on requests decoded from a legacy (v1) datagram.
+ *
+ * It is never sent on the wire: it only tells `send_response` to answer in the v1 format.
+ */
+#define REQUEST_FLAG_LEGACY 0x80
+
+/**
+ * @enum ResponseStatus
+ * @brief Outcome of a request, carried in the `status` byte of a v2 response.
+ */
+typedef enum {
+    STATUS_OK,              /**< The password was generated */
+    STATUS_INVALID_LENGTH,  /**< The requested length is outside [MIN_PASSWORD_LENGTH, MAX_PASSWORD_LENGTH] */
+    STATUS_INVALID_COUNT,   /**< The bulk count is outside [1, MAX_BULK_COUNT] */
+    STATUS_MALFORMED,       /**< The datagram could not be decoded */
+    STATUS_UNKNOWN_POLICY,  /**< No policy is defined with the requested ID */
+    STATUS_INVALID_POLICY,  /**< The policy definition draws from no character or requires an empty class */
+    STATUS_POLICIES_FULL,   /**< No policy ID is left for the definition */
+    STATUS_SEALING_REQUIRED, /**< The server only sends sealed responses (see `REQUEST_FLAG_SEALED`) */
+    STATUS_SEALING_UNAVAILABLE, /**< A sealed response was requested from a server without a key */
+    STATUS_COOKIE_REQUIRED  /**< The request carried no valid cookie; the cookie to echo follows (see `REQUEST_FLAG_COOKIE`) */
+} ResponseStatus;
+
+/* - - - - - - - - - - - - - - - - - - - END WIRE FORMAT - - - - - - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - - - - STRUCTURES - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @struct PasswordRequest
+ * @brief Represents a client request for password generation (decoded v2 form).
+ *
+ * This structure is encoded by the client into a `REQUEST_HEADER_SIZE` datagram and
+ * decoded by the server, containing:
+ * - `type`: Specifies the type of password (e.g., 'n' for numeric, 's' for secure).
+ * - `length`: Specifies the desired length of the generated password.
+ * - `flags`: Request options (see the `REQUEST_FLAG_*` constants).
+ * - `request_id`: Identifier echoed back by the server to match responses.
+ * - `count`: Number of passwords requested, only sent when `REQUEST_FLAG_BULK` is set.
+ * - `cookie`: Cookie of the server, only sent when `REQUEST_FLAG_COOKIE` is set.
+ */
+typedef struct {
+    char type;                      /**< Type of password requested (e.g., 'n' for numeric, 'a' for alphabetic) */
+    uint8_t length;                 /**< Desired length of the password */
+    uint8_t flags;                  /**< Request options */
+    uint32_t request_id;            /**< Identifier echoed in the response */
+    uint16_t count;                 /**< Number of passwords requested (1 unless `REQUEST_FLAG_BULK` is set) */
+    uint8_t cookie[COOKIE_SIZE];    /**< Cookie echoed to the server (only with `REQUEST_FLAG_COOKIE`) */
+} PasswordRequest;
+
+/**
+ * @struct PasswordResponse
+ * @brief Represents the server's response containing the generated password (decoded v2 form).
+ *
+ * This structure is encoded by the server into `RESPONSE_HEADER_SIZE + length` bytes and
+ * decoded by the client, containing:
+ * - `status`: Outcome of the request (see `ResponseStatus`).
+ * - `length`: Number of characters in `password`.
+ * - `flags`: Flags copied from the request.
+ * - `request_id`: Identifier copied from the request.
+ * - `password`: The generated password string.
+ *
+ * @note The `password` field is null-terminated after decoding, even though the
+ *       terminator is not transmitted.
+ */
+typedef struct {
+    uint8_t status;                          /**< Outcome of the request (see `ResponseStatus`) */
+    uint8_t length;                          /**< Number of characters in `password` */
+    uint8_t flags;                           /**< Flags copied from the request */
+    uint32_t request_id;                     /**< Identifier copied from the request */
+    char password[MAX_PASSWORD_LENGTH + 1];  /**< The generated password, null-terminated */
+} PasswordResponse;
+
+/**
+ * @struct BulkResponseHeader
+ * @brief Decoded fixed part of a bulk response datagram.
+ *
+ * The `items * length` password characters follow the header in the datagram.
+ */
+typedef struct {
+    uint8_t status;                 /**< Outcome of the request (see `ResponseStatus`) */
+    uint8_t length;                 /**< Length of every password in the datagram */
+    uint8_t flags;                  /**< Flags copied from the request */
+    uint32_t request_id;            /**< Identifier copied from the request */
+    uint16_t sequence;              /**< Position of this datagram, from 0 to `total - 1` */
+    uint16_t total;                 /**< Number of datagrams in the response */
+    uint16_t items;                 /**< Number of passwords in this datagram */
+} BulkResponseHeader;
+
+/**
+ * @struct PolicySpec
+ * @brief A policy as defined by a client or in the server configuration.
+ *
+ * The policy draws from the union of `classes` and `extra`, minus the `exclude` characters,
+ * and every password holds at least one character of each class in `required`.
+ */
+typedef struct {
+    uint8_t classes;                         /**< `POLICY_CLASS_*` bits drawn from */
+    uint8_t required;                        /**< `POLICY_CLASS_*` bits required at least once */
+    char extra[MAX_POLICY_CHARACTERS + 1];   /**< Extra characters, null-terminated */
+    char exclude[MAX_POLICY_CHARACTERS + 1]; /**< Excluded characters, null-terminated */
+} PolicySpec;
+
+/**
+ * @struct LegacyPasswordRequest
+ * @brief Layout of a v1 request, still accepted by the server during the migration to v2.
+ *
+ * @note The `length` is stored as a string, which makes every v1 datagram `BUFFER_SIZE + 1` bytes long.
+ */
+typedef struct {
+    char type;                      /**< Type of password requested */
+    char length[BUFFER_SIZE];       /**< Desired length of the password as a string */
+} LegacyPasswordRequest;
+
+/**
+ * @struct LegacyPasswordResponse
+ * @brief Layout of a v1 response, sent back to clients that issued a `LegacyPasswordRequest`.
+ */
+typedef struct {
+    char password[MAX_PASSWORD_LENGTH + 1];  /**< The generated password, null-terminated */
+} LegacyPasswordResponse;
+
+/* - - - - - - - - - - - - - - - - - - - END STRUCTURES - - - - - - - - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - - - - ENCODING - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Encodes a request into its v2 wire representation.
+ *
+ * @param[in] request The request to encode.
+ * @param[out] buffer Destination buffer.
+ * @param[in] buffer_size Size of `buffer` in bytes.
+ *
+ * @return The number of bytes written (`REQUEST_HEADER_SIZE`, or `BULK_REQUEST_SIZE` for a
+ *         bulk request, plus `COOKIE_SIZE` with a cookie), or 0 if `buffer` is too small.
+ */
+size_t encode_request(const PasswordRequest *request, uint8_t *buffer, size_t buffer_size);
+
+/**
+ * @brief Decodes a v2 request datagram.
+ *
+ * @param[in] buffer The received datagram.
+ * @param[in] size Number of bytes received.
+ * @param[out] request The decoded request.
+ *
+ * @return `true` if the datagram is a well-formed v2 request, `false` otherwise.
+ * @note `count` is set to 1 for requests without `REQUEST_FLAG_BULK`. A policy definition keeps
+ *       `REQUEST_FLAG_DEFINE`, `REQUEST_FLAG_SEALED` and `REQUEST_FLAG_COOKIE` as its only flags;
+ *       its body is decoded by `decode_policy_definition`.
+ */
+bool decode_request(const uint8_t *buffer, size_t size, PasswordRequest *request);
+
+/**
+ * @brief Appends a cookie to an encoded v2 request and sets `REQUEST_FLAG_COOKIE`.
+ *
+ * @param[in,out] buffer The encoded request, without a cookie.
+ * @param[in] size Number of bytes of the encoded request.
+ * @param[in] buffer_size Size of `buffer` in bytes.
+ * @param[in] cookie The `COOKIE_SIZE` bytes of the cookie.
+ *
+ * @return The new size of the request, or 0 if `buffer` is too small or holds no request header.
+ */
+size_t attach_cookie(uint8_t *buffer, size_t size, size_t buffer_size, const uint8_t *cookie);
+
+/**
+ * @brief Decodes a legacy (v1) request datagram.
+ *
+ * The length string is parsed up to the first non-digit character, the same way `atoi`
+ * did on the server, and saturated to 255 so that out-of-range lengths stay invalid.
+ * `REQUEST_FLAG_LEGACY` is set on the decoded request.
+ *
+ * @param[in] buffer The received datagram.
+ * @param[in] size Number of bytes received.
+ * @param[out] request The decoded request.
+ *
+ * @return `true` if the datagram carries at least a type byte, `false` otherwise.
+ */
+bool decode_legacy_request(const uint8_t *buffer, size_t size, PasswordRequest *request);
+
+/**
+ * @brief Tells whether a datagram starts with the v2 version byte.
+ *
+ * @param[in] buffer The received datagram.
+ * @param[in] size Number of bytes received.
+ *
+ * @return `true` if the datagram carries the v2 magic, `false` if it should be treated as v1.
+ */
+bool is_v2_datagram(const uint8_t *buffer, size_t size);
+
+/**
+ * @brief Encodes a response into its v2 wire representation.
+ *
+ * @param[in] response The response to encode. `response->length` characters of `password` are sent.
+ * @param[out] buffer Destination buffer.
+ * @param[in] buffer_size Size of `buffer` in bytes.
+ *
+ * @return The number of bytes written, or 0 if `buffer` is too small.
+ */
+size_t encode_response(const PasswordResponse *response, uint8_t *buffer, size_t buffer_size);
+
+/**
+ * @brief Encodes the header of a v2 response, for senders that write the password in place.
+ *
+ * @param[in] status A `ResponseStatus` value.
+ * @param[in] length Number of password characters that follow the header.
+ * @param[in] flags Flags of the request being answered.
+ * @param[in] request_id Identifier of the request being answered.
+ * @param[out] buffer Destination buffer, at least `RESPONSE_HEADER_SIZE` bytes.
+ *
+ * @return `RESPONSE_HEADER_SIZE`.
+ */
+size_t encode_response_header(uint8_t status, uint8_t length, uint8_t flags, uint32_t request_id, uint8_t *buffer);
+
+/**
+ * @brief Decodes a v2 response datagram.
+ *
+ * @param[in] buffer The received datagram.
+ * @param[in] size Number of bytes received.
+ * @param[out] response The decoded response, with `password` null-terminated.
+ *
+ * @return `true` if the datagram is a well-formed v2 response, `false` otherwise.
+ * @note The password of a sealed response is decoded still encrypted; the trailer follows it
+ *       in `buffer`, at `RESPONSE_HEADER_SIZE + length`.
+ */
+bool decode_response(const uint8_t *buffer, size_t size, PasswordResponse *response);
+
+/**
+ * @brief Encodes the fixed part of a bulk response datagram.
+ *
+ * @param[in] header The header to encode.
+ * @param[out] buffer Destination buffer; the passwords are appended after the header by the caller.
+ * @param[in] buffer_size Size of `buffer` in bytes.
+ *
+ * @return The number of bytes written (`BULK_HEADER_SIZE`), or 0 if `buffer` is too small.
+ */
+size_t encode_bulk_header(const BulkResponseHeader *header, uint8_t *buffer, size_t buffer_size);
+
+/**
+ * @brief Decodes the fixed part of a bulk response datagram.
+ *
+ * @param[in] buffer The received datagram.
+ * @param[in] size Number of bytes received.
+ * @param[out] header The decoded header.
+ *
+ * @return `true` if the datagram is a bulk response holding the announced `items * length`
+ *         characters, and the trailer if it is sealed, `false` otherwise.
+ */
+bool decode_bulk_header(const uint8_t *buffer, size_t size, BulkResponseHeader *header);
+
+/**
+ * @brief Encodes a policy definition request.
+ *
+ * @param[in] spec The policy to define.
+ * @param[in] request_id Identifier echoed in the response.
+ * @param[out] buffer Destination buffer.
+ * @param[in] buffer_size Size of `buffer` in bytes.
+ *
+ * @return The number of bytes written, or 0 if `buffer` is too small or the extra and excluded
+ *         characters do not fit in `MAX_POLICY_DEFINITION_SIZE`.
+ */
+size_t encode_policy_definition(const PolicySpec *spec, uint32_t request_id, uint8_t *buffer, size_t buffer_size);
+
+/**
+ * @brief Decodes the body of a policy definition request.
+ *
+ * @param[in] buffer The received datagram, header included.
+ * @param[in] size Number of bytes received, cookie included.
+ * @param[out] spec The decoded policy.
+ *
+ * @return `true` if the body is complete and holds only printable characters, `false` otherwise.
+ */
+bool decode_policy_definition(const uint8_t *buffer, size_t size, PolicySpec *spec);
+
+/**
+ * @brief Parses the text form of a policy, used on the command lines.
+ *
+ * The text is a list of `key=value` fields separated by spaces, e.g.
+ * `classes=lower,upper,digit require=upper,digit extra=-_ exclude=0O1lI`:
+ * - `classes`: comma-separated classes among `lower`, `upper`, `digit` and `symbol`;
+ * - `require`: classes required at least once, `extra` included;
+ * - `extra`: characters added to the classes;
+ * - `exclude`: characters removed from the classes and the extra characters.
+ *
+ * @param[in] text The null-terminated text.
+ * @param[out] spec The parsed policy.
+ *
+ * @return `true` if the text is well formed, `false` otherwise.
+ */
+bool parse_policy_spec(const char *text, PolicySpec *spec);
+
+/* - - - - - - - - - - - - - - - - - - END ENCODING - - - - - - - - - - - - - - - - - - - - */
+
+#endif // PROTOCOL_H
@@ -0,0 +1,219 @@
+/**
+ * @file random.c
+ * @brief Implementation of the per-thread ChaCha20 random byte source and of the OS entropy reader.
+ *
+ * The block function is the ChaCha20 of `chacha20.h`, shared with the sealing.
+ * Each thread keeps its own state and an output buffer of `RANDOM_BUFFER_SIZE` bytes: a refill
+ * computes 8 blocks at once, re-keys the generator from the first 32 bytes, and serves the rest.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#if defined WIN32
+#define _CRT_RAND_S         /**< Exposes rand_s() in <stdlib.h> */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#if defined __linux__
+#include <sys/random.h>     /**< Includes getrandom() */
+#endif
+
+#include "random.h"
+#include "../chacha20/chacha20.h"
+
+#if defined _MSC_VER
+#define THREAD_LOCAL __declspec(thread)  /**< Thread-local storage qualifier for MSVC */
+#else
+#define THREAD_LOCAL _Thread_local       /**< Thread-local storage qualifier for C11 compilers */
+#endif
+
+/* - - - - - - - - - - - - - - - - - - - SYSTEM ENTROPY - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Reads random bytes from the operating system entropy source.
+ * @return `false` if the source could not be read.
+ */
+bool system_random_bytes(uint8_t *buffer, size_t size) {
+#if defined WIN32
+    while (size > 0) {
+        unsigned int value;
+        if (rand_s(&value) != 0) {
+            return false;
+        }
+        size_t chunk = size < sizeof(value) ? size : sizeof(value);
+        memcpy(buffer, &value, chunk);
+        buffer += chunk;
+        size -= chunk;
+    }
+    return true;
+#elif defined __linux__
+    while (size > 0) {
+        ssize_t read_bytes = getrandom(buffer, size, 0);
+        if (read_bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        buffer += read_bytes;
+        size -= (size_t)read_bytes;
+    }
+    return true;
+#elif defined __APPLE__ || defined __FreeBSD__ || defined __OpenBSD__ || defined __NetBSD__
+    arc4random_buf(buffer, size);
+    return true;
+#else
+    FILE *source = fopen("/dev/urandom", "rb");
+    if (source == NULL) {
+        return false;
+    }
+    bool complete = fread(buffer, 1, size, source) == size;
+    fclose(source);
+    return complete;
+#endif
+}
+
+/* - - - - - - - - - - - - - - - - - - END SYSTEM ENTROPY - - - - - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - - - - - - - CHACHA20 - - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @struct ChaChaState
+ * @brief Per-thread generator state.
+ */
+typedef struct {
+    uint32_t key[8];                    /**< Current 256-bit key */
+    uint32_t nonce[3];                  /**< 96-bit nonce, drawn from the OS at seeding time */
+    uint32_t counter;                   /**< Block counter */
+    uint8_t output[RANDOM_BUFFER_SIZE]; /**< Keystream not handed out yet */
+    size_t available;                   /**< Unused bytes at the end of `output` */
+    bool seeded;                        /**< Whether the state has been seeded */
+} ChaChaState;
+
+static THREAD_LOCAL ChaChaState chacha_state;   /**< Generator owned by the calling thread */
+static RandomBackend selected_backend = RANDOM_CHACHA20;
+
+/**
+ * @brief Seeds the calling thread's generator from the operating system.
+ * @note Aborts the process if no entropy is available.
+ */
+static void chacha20_seed(ChaChaState *state) {
+    uint8_t seed[44];
+    if (!system_random_bytes(seed, sizeof(seed))) {
+        fputs("Unable to read the operating system entropy source.\n", stderr);
+        abort();
+    }
+    for (int i = 0; i < 8; i++) {
+        state->key[i] = load_le32(seed + 4 * i);
+    }
+    for (int i = 0; i < 3; i++) {
+        state->nonce[i] = load_le32(seed + 32 + 4 * i);
+    }
+    memset(seed, 0, sizeof(seed));
+    state->counter = 0;
+    state->available = 0;
+    state->seeded = true;
+}
+
+/**
+ * @brief Refills the output buffer and replaces the key with the first 32 keystream bytes.
+ */
+static void chacha20_refill(ChaChaState *state) {
+    for (size_t offset = 0; offset < RANDOM_BUFFER_SIZE; offset += 64) {
+        chacha20_block(state->key, state->counter, state->nonce, state->output + offset);
+        state->counter++;
+    }
+    for (int i = 0; i < 8; i++) {
+        state->key[i] = load_le32(state->output + 4 * i);
+    }
+    memset(state->output, 0, 32);
+    state->counter = 0;
+    state->available = RANDOM_BUFFER_SIZE - 32;
+}
+
+/**
+ * @brief Copies bytes from the calling thread's keystream buffer, refilling it as needed.
+ */
+static void chacha20_bytes(uint8_t *buffer, size_t size) {
+    ChaChaState *state = &chacha_state;
+    if (!state->seeded) {
+        chacha20_seed(state);
+    }
+
+    while (size > 0) {
+        if (state->available == 0) {
+            chacha20_refill(state);
+        }
+        size_t chunk = size < state->available ? size : state->available;
+        uint8_t *source = state->output + RANDOM_BUFFER_SIZE - state->available;
+        memcpy(buffer, source, chunk);
+        memset(source, 0, chunk); /**< Served bytes never stay in memory */
+        state->available -= chunk;
+        buffer += chunk;
+        size -= chunk;
+    }
+}
+
+/* - - - - - - - - - - - - - - - - - - - END CHACHA20 - - - - - - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - - - - - RANDOM BYTES - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Selects the backend used by every thread.
+ */
+void select_random_backend(RandomBackend backend) {
+    selected_backend = backend;
+}
+
+/**
+ * @brief Returns the backend currently in use.
+ */
+RandomBackend current_random_backend(void) {
+    return selected_backend;
+}
+
+/**
+ * @brief Fills a buffer with random bytes from the selected backend.
+ */
+void random_bytes(uint8_t *buffer, size_t size) {
+    switch (selected_backend) {
+        case RANDOM_SYSTEM:
+            if (!system_random_bytes(buffer, size)) {
+                fputs("Unable to read the operating system entropy source.\n", stderr);
+                abort();
+            }
+            break;
+        case RANDOM_CHACHA20:
+        default:
+            chacha20_bytes(buffer, size);
+            break;
+    }
+}
+
+/**
+ * @brief Returns an unbiased random integer in `[0, bound)` (Lemire's method).
+ */
+uint32_t random_below(uint32_t bound) {
+    uint32_t value;
+    random_bytes((uint8_t *)&value, sizeof(value));
+    uint64_t product = (uint64_t)value * bound;
+    uint32_t low = (uint32_t)product;
+
+    if (low < bound) {
+        uint32_t threshold = (uint32_t)-bound % bound; /**< 2^32 mod bound */
+        while (low < threshold) {
+            random_bytes((uint8_t *)&value, sizeof(value));
+            product = (uint64_t)value * bound;
+            low = (uint32_t)product;
+        }
+    }
+    return (uint32_t)(product >> 32);
+}
+
+/* - - - - - - - - - - - - - - - - - - END RANDOM BYTES - - - - - - - - - - - - - - - - - - */
@@ -0,0 +1,103 @@
+/**
+ * @file random.h
+ * @brief Header file providing the random byte source used by the password generators.
+ *
+ * Random bytes come from a pluggable backend:
+ * - `RANDOM_CHACHA20`: a per-thread ChaCha20 keystream seeded from the operating system
+ *   entropy source and refilled `RANDOM_BUFFER_SIZE` bytes at a time (default).
+ * - `RANDOM_SYSTEM`: every request is forwarded to the operating system entropy source.
+ *
+ * The ChaCha20 state lives in thread-local storage, so no lock is taken on the hot path
+ * and every worker thread owns an independent stream.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef RANDOM_H_
+#define RANDOM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* - - - - - - - - - - - - - - - - - - - RANDOM BACKENDS - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Number of keystream bytes produced by each ChaCha20 refill (8 blocks of 64 bytes).
+ *
+ * The first 32 bytes of every refill become the next key and are never handed out
+ * ("fast key erasure"), so a later compromise of the state does not reveal past output.
+ */
+#define RANDOM_BUFFER_SIZE 512
+
+/**
+ * @enum RandomBackend
+ * @brief Enumerates the available sources of random bytes.
+ */
+typedef enum {
+    RANDOM_CHACHA20,  /**< Per-thread ChaCha20 keystream seeded from the OS (default) */
+    RANDOM_SYSTEM     /**< Direct reads from the OS entropy source */
+} RandomBackend;
+
+/**
+ * @brief Selects the backend used by every thread.
+ *
+ * @param[in] backend The backend to use from now on.
+ *
+ * @pre Must be called before worker threads start generating passwords.
+ */
+void select_random_backend(RandomBackend backend);
+
+/**
+ * @brief Returns the backend currently in use.
+ *
+ * @return The selected `RandomBackend`.
+ */
+RandomBackend current_random_backend(void);
+
+/* - - - - - - - - - - - - - - - - - - END RANDOM BACKENDS - - - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - - - - - RANDOM BYTES - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Fills a buffer with cryptographically secure random bytes.
+ *
+ * With the ChaCha20 backend, the bytes are taken from the calling thread's keystream
+ * buffer, which is seeded lazily on first use.
+ *
+ * @param[out] buffer Destination buffer.
+ * @param[in] size Number of bytes to write.
+ *
+ * @post `buffer` contains `size` random bytes.
+ * @note If the operating system entropy source is unavailable, the process is aborted:
+ *       handing out predictable passwords is never an acceptable fallback.
+ */
+void random_bytes(uint8_t *buffer, size_t size);
+
+/**
+ * @brief Returns a uniformly distributed integer in `[0, bound)`.
+ *
+ * Uses Lemire's multiply-shift reduction with rejection, so the result is unbiased and
+ * no division is needed except on the rare rejection path.
+ *
+ * @param[in] bound Exclusive upper bound. Must be greater than 0.
+ *
+ * @return A random value in `[0, bound)`.
+ */
+uint32_t random_below(uint32_t bound);
+
+/**
+ * @brief Fills a buffer with random bytes read directly from the operating system.
+ *
+ * @param[out] buffer Destination buffer.
+ * @param[in] size Number of bytes to write.
+ *
+ * @return `true` on success, `false` if the entropy source could not be read.
+ */
+bool system_random_bytes(uint8_t *buffer, size_t size);
+
+/* - - - - - - - - - - - - - - - - - - END RANDOM BYTES - - - - - - - - - - - - - - - - - - */
+
+#endif /* RANDOM_H_ */
@@ -0,0 +1,313 @@
+/**
+ * @file seal.c
+ * @brief Implementation of the ChaCha20-Poly1305 AEAD of RFC 8439 on the response datagrams.
+ *
+ * Poly1305 works on five 26-bit limbs, so every product fits in 64 bits on any target.
+ * Every block of the authenticated data is padded to 16 bytes by the construction, so no
+ * partial block is ever hashed.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "seal.h"
+#include "../chacha20/chacha20.h"
+
+/* - - - - - - - - - - - - - - - - - - - - - CHACHA20 - - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Reads the nonce of a trailer as the words ChaCha20 works on.
+ */
+static void load_nonce(const uint8_t nonce[SEAL_NONCE_SIZE], uint32_t words[3]) {
+    for (int i = 0; i < 3; i++) {
+        words[i] = load_le32(nonce + 4 * i);
+    }
+}
+
+/**
+ * @brief XORs the keystream into `data`, starting with block 1 (block 0 keys Poly1305).
+ */
+static void chacha20_xor(const SealKey *key, const uint8_t nonce[SEAL_NONCE_SIZE], uint8_t *data, size_t size) {
+    uint8_t block[CHACHA20_BLOCK_SIZE];
+    uint32_t words[3];
+    load_nonce(nonce, words);
+    for (uint32_t counter = 1; size > 0; counter++) {
+        chacha20_block(key->words, counter, words, block);
+        size_t chunk = size < sizeof(block) ? size : sizeof(block);
+        for (size_t i = 0; i < chunk; i++) {
+            data[i] ^= block[i];
+        }
+        data += chunk;
+        size -= chunk;
+    }
+}
+
+/* - - - - - - - - - - - - - - - - - - - - END CHACHA20 - - - - - - - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - - - - - - - POLY1305 - - - - - - - - - - - - - - - - - - - - - */
+
+#define LIMB_MASK 0x3ffffff          /**< 26 bits */
+
+/**
+ * @struct Poly1305
+ * @brief State of a Poly1305 computation.
+ */
+typedef struct {
+    uint32_t r[5];                  /**< Clamped multiplier, in 26-bit limbs */
+    uint32_t h[5];                  /**< Accumulator, in 26-bit limbs */
+    uint32_t pad[4];                /**< Second half of the one-time key, added at the end */
+} Poly1305;
+
+/**
+ * @brief Starts a computation with a 32-byte one-time key.
+ */
+static void poly1305_init(Poly1305 *poly, const uint8_t key[32]) {
+    poly->r[0] = load_le32(key) & 0x3ffffff;
+    poly->r[1] = (load_le32(key + 3) >> 2) & 0x3ffff03;
+    poly->r[2] = (load_le32(key + 6) >> 4) & 0x3ffc0ff;
+    poly->r[3] = (load_le32(key + 9) >> 6) & 0x3f03fff;
+    poly->r[4] = (load_le32(key + 12) >> 8) & 0x00fffff;
+    memset(poly->h, 0, sizeof(poly->h));
+    for (int i = 0; i < 4; i++) {
+        poly->pad[i] = load_le32(key + 16 + 4 * i);
+    }
+}
+
+/**
+ * @brief Adds a full 16-byte block to the accumulator and multiplies it by `r`.
+ */
+static void poly1305_block(Poly1305 *poly, const uint8_t block[16]) {
+    const uint32_t r0 = poly->r[0], r1 = poly->r[1], r2 = poly->r[2], r3 = poly->r[3], r4 = poly->r[4];
+    const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+    uint32_t h0 = poly->h[0] + (load_le32(block) & LIMB_MASK);
+    uint32_t h1 = poly->h[1] + ((load_le32(block + 3) >> 2) & LIMB_MASK);
+    uint32_t h2 = poly->h[2] + ((load_le32(block + 6) >> 4) & LIMB_MASK);
+    uint32_t h3 = poly->h[3] + ((load_le32(block + 9) >> 6) & LIMB_MASK);
+    uint32_t h4 = poly->h[4] + ((load_le32(block + 12) >> 8) | (1u << 24));
+
+    uint64_t d0 = (uint64_t)h0 * r0 + (uint64_t)h1 * s4 + (uint64_t)h2 * s3 + (uint64_t)h3 * s2 + (uint64_t)h4 * s1;
+    uint64_t d1 = (uint64_t)h0 * r1 + (uint64_t)h1 * r0 + (uint64_t)h2 * s4 + (uint64_t)h3 * s3 + (uint64_t)h4 * s2;
+    uint64_t d2 = (uint64_t)h0 * r2 + (uint64_t)h1 * r1 + (uint64_t)h2 * r0 + (uint64_t)h3 * s4 + (uint64_t)h4 * s3;
+    uint64_t d3 = (uint64_t)h0 * r3 + (uint64_t)h1 * r2 + (uint64_t)h2 * r1 + (uint64_t)h3 * r0 + (uint64_t)h4 * s4;
+    uint64_t d4 = (uint64_t)h0 * r4 + (uint64_t)h1 * r3 + (uint64_t)h2 * r2 + (uint64_t)h3 * r1 + (uint64_t)h4 * r0;
+
+    uint32_t carry;
+    carry = (uint32_t)(d0 >> 26); h0 = (uint32_t)d0 & LIMB_MASK; d1 += carry;
+    carry = (uint32_t)(d1 >> 26); h1 = (uint32_t)d1 & LIMB_MASK; d2 += carry;
+    carry = (uint32_t)(d2 >> 26); h2 = (uint32_t)d2 & LIMB_MASK; d3 += carry;
+    carry = (uint32_t)(d3 >> 26); h3 = (uint32_t)d3 & LIMB_MASK; d4 += carry;
+    carry = (uint32_t)(d4 >> 26); h4 = (uint32_t)d4 & LIMB_MASK;
+    h0 += carry * 5;
+    carry = h0 >> 26; h0 &= LIMB_MASK; h1 += carry;
+
+    poly->h[0] = h0; poly->h[1] = h1; poly->h[2] = h2; poly->h[3] = h3; poly->h[4] = h4;
+}
+
+/**
+ * @brief Hashes `size` bytes, zero-padding the last block to 16 bytes.
+ */
+static void poly1305_padded(Poly1305 *poly, const uint8_t *data, size_t size) {
+    for (; size >= 16; data += 16, size -= 16) {
+        poly1305_block(poly, data);
+    }
+    if (size > 0) {
+        uint8_t block[16] = { 0 };
+        memcpy(block, data, size);
+        poly1305_block(poly, block);
+    }
+}
+
+/**
+ * @brief Reduces the accumulator modulo 2^130 - 5 and adds the pad, giving the tag.
+ */
+static void poly1305_finish(Poly1305 *poly, uint8_t tag[SEAL_TAG_SIZE]) {
+    uint32_t h0 = poly->h[0], h1 = poly->h[1], h2 = poly->h[2], h3 = poly->h[3], h4 = poly->h[4];
+    uint32_t carry;
+    carry = h1 >> 26; h1 &= LIMB_MASK; h2 += carry;
+    carry = h2 >> 26; h2 &= LIMB_MASK; h3 += carry;
+    carry = h3 >> 26; h3 &= LIMB_MASK; h4 += carry;
+    carry = h4 >> 26; h4 &= LIMB_MASK; h0 += carry * 5;
+    carry = h0 >> 26; h0 &= LIMB_MASK; h1 += carry;
+
+    uint32_t g0 = h0 + 5;     carry = g0 >> 26; g0 &= LIMB_MASK;     /**< g = h - (2^130 - 5) */
+    uint32_t g1 = h1 + carry; carry = g1 >> 26; g1 &= LIMB_MASK;
+    uint32_t g2 = h2 + carry; carry = g2 >> 26; g2 &= LIMB_MASK;
+    uint32_t g3 = h3 + carry; carry = g3 >> 26; g3 &= LIMB_MASK;
+    uint32_t g4 = h4 + carry - (1u << 26);
+
+    uint32_t select = (g4 >> 31) - 1;   /**< All ones when h >= 2^130 - 5, without branching */
+    h0 = (h0 & ~select) | (g0 & select);
+    h1 = (h1 & ~select) | (g1 & select);
+    h2 = (h2 & ~select) | (g2 & select);
+    h3 = (h3 & ~select) | (g3 & select);
+    h4 = (h4 & ~select) | (g4 & select);
+
+    uint32_t words[4] = {
+        h0 | (h1 << 26), (h1 >> 6) | (h2 << 20), (h2 >> 12) | (h3 << 14), (h3 >> 18) | (h4 << 8)
+    };
+    uint64_t sum = 0;
+    for (int i = 0; i < 4; i++) {
+        sum += (uint64_t)words[i] + poly->pad[i];
+        store_le32(tag + 4 * i, (uint32_t)sum);
+        sum >>= 32;
+    }
+}
+
+/* - - - - - - - - - - - - - - - - - - - - END POLY1305 - - - - - - - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - - - - - - - SEAL - - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Parses a key written as 64 hexadecimal digits, surrounded by optional blanks.
+ */
+bool parse_seal_key(const char *text, SealKey *key) {
+    uint8_t bytes[SEAL_KEY_SIZE];
+    while (isspace((unsigned char)*text)) {
+        text++;
+    }
+    for (size_t i = 0; i < 2 * SEAL_KEY_SIZE; i++, text++) {
+        int digit = isdigit((unsigned char)*text) ? *text - '0'
+                  : isxdigit((unsigned char)*text) ? tolower((unsigned char)*text) - 'a' + 10 : -1;
+        if (digit < 0) {
+            return false;
+        }
+        bytes[i / 2] = (uint8_t)(i % 2 == 0 ? digit << 4 : bytes[i / 2] | digit);
+    }
+    while (isspace((unsigned char)*text)) {
+        text++;
+    }
+    if (*text != '\0') {
+        return false;
+    }
+    for (size_t i = 0; i < SEAL_KEY_SIZE / 4; i++) {
+        key->words[i] = load_le32(bytes + 4 * i);
+    }
+    memset(bytes, 0, sizeof(bytes));
+    return true;
+}
+
+/**
+ * @brief Reads a key from a file holding 64 hexadecimal digits.
+ */
+bool load_seal_key(const char *path, SealKey *key) {
+    char text[4 * SEAL_KEY_SIZE + 1];
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return false;
+    }
+    size_t size = fread(text, 1, sizeof(text) - 1, file);
+    fclose(file);
+    text[size] = '\0';
+    bool parsed = parse_seal_key(text, key);
+    memset(text, 0, sizeof(text));
+    return parsed;
+}
+
+/**
+ * @brief Computes the tag of the header and the encrypted payload.
+ */
+static void compute_tag(const SealKey *key, const uint8_t *header, size_t header_size,
+                        const uint8_t *payload, size_t payload_size, const uint8_t nonce[SEAL_NONCE_SIZE],
+                        uint8_t tag[SEAL_TAG_SIZE]) {
+    uint8_t block[CHACHA20_BLOCK_SIZE];
+    uint32_t words[3];
+    Poly1305 poly;
+    load_nonce(nonce, words);
+    chacha20_block(key->words, 0, words, block);
+    poly1305_init(&poly, block);
+    poly1305_padded(&poly, header, header_size);
+    poly1305_padded(&poly, payload, payload_size);
+
+    uint8_t lengths[16];
+    store_le32(lengths, (uint32_t)header_size);
+    store_le32(lengths + 4, (uint32_t)((uint64_t)header_size >> 32));
+    store_le32(lengths + 8, (uint32_t)payload_size);
+    store_le32(lengths + 12, (uint32_t)((uint64_t)payload_size >> 32));
+    poly1305_block(&poly, lengths);
+    poly1305_finish(&poly, tag);
+}
+
+/**
+ * @brief Encrypts the payload of a datagram in place and writes its tag after the nonce.
+ */
+void seal_payload(const SealKey *key, const uint8_t *header, size_t header_size,
+                  uint8_t *payload, size_t payload_size, uint8_t *trailer) {
+    chacha20_xor(key, trailer, payload, payload_size);
+    compute_tag(key, header, header_size, payload, payload_size, trailer, trailer + SEAL_NONCE_SIZE);
+}
+
+/**
+ * @brief Checks the tag of a sealed datagram, in constant time, and decrypts its payload in place.
+ */
+bool open_payload(const SealKey *key, const uint8_t *header, size_t header_size,
+                  uint8_t *payload, size_t payload_size, const uint8_t *trailer) {
+    uint8_t tag[SEAL_TAG_SIZE];
+    compute_tag(key, header, header_size, payload, payload_size, trailer, tag);
+
+    uint8_t difference = 0;
+    for (size_t i = 0; i < SEAL_TAG_SIZE; i++) {
+        difference |= tag[i] ^ trailer[SEAL_NONCE_SIZE + i];
+    }
+    if (difference != 0) {
+        return false;
+    }
+    chacha20_xor(key, trailer, payload, payload_size);
+    return true;
+}
+
+/**
+ * @brief Runs the block function vector of RFC 8439 (section 2.3.2), then its AEAD vector
+ *        (section 2.8.2) through the sealing and the opening.
+ */
+bool seal_self_test(void) {
+    static const uint8_t aad[12] = { 0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7 };
+    static const char plaintext[] = "Ladies and Gentlemen of the class of '99: If I could offer you only one "
+                                    "tip for the future, sunscreen would be it.";
+    static const uint8_t ciphertext[sizeof(plaintext) - 1] = {
+        0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb, 0x7b, 0x86, 0xaf, 0xbc, 0x53, 0xef, 0x7e, 0xc2,
+        0xa4, 0xad, 0xed, 0x51, 0x29, 0x6e, 0x08, 0xfe, 0xa9, 0xe2, 0xb5, 0xa7, 0x36, 0xee, 0x62, 0xd6,
+        0x3d, 0xbe, 0xa4, 0x5e, 0x8c, 0xa9, 0x67, 0x12, 0x82, 0xfa, 0xfb, 0x69, 0xda, 0x92, 0x72, 0x8b,
+        0x1a, 0x71, 0xde, 0x0a, 0x9e, 0x06, 0x0b, 0x29, 0x05, 0xd6, 0xa5, 0xb6, 0x7e, 0xcd, 0x3b, 0x36,
+        0x92, 0xdd, 0xbd, 0x7f, 0x2d, 0x77, 0x8b, 0x8c, 0x98, 0x03, 0xae, 0xe3, 0x28, 0x09, 0x1b, 0x58,
+        0xfa, 0xb3, 0x24, 0xe4, 0xfa, 0xd6, 0x75, 0x94, 0x55, 0x85, 0x80, 0x8b, 0x48, 0x31, 0xd7, 0xbc,
+        0x3f, 0xf4, 0xde, 0xf0, 0x8e, 0x4b, 0x7a, 0x9d, 0xe5, 0x76, 0xd2, 0x65, 0x86, 0xce, 0xc6, 0x4b,
+        0x61, 0x16
+    };
+    static const uint8_t expected_trailer[SEAL_OVERHEAD] = {
+        0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+        0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a, 0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91
+    };
+    if (!chacha20_self_test()) {
+        return false;
+    }
+    SealKey key;
+    for (size_t i = 0; i < SEAL_KEY_SIZE / 4; i++) {
+        uint8_t bytes[4] = { (uint8_t)(0x80 + 4 * i), (uint8_t)(0x81 + 4 * i), (uint8_t)(0x82 + 4 * i),
+                             (uint8_t)(0x83 + 4 * i) };
+        key.words[i] = load_le32(bytes);
+    }
+
+    uint8_t payload[sizeof(ciphertext)];
+    uint8_t trailer[SEAL_OVERHEAD];
+    memcpy(payload, plaintext, sizeof(payload));
+    memcpy(trailer, expected_trailer, SEAL_NONCE_SIZE);
+    seal_payload(&key, aad, sizeof(aad), payload, sizeof(payload), trailer);
+    if (memcmp(payload, ciphertext, sizeof(payload)) != 0 || memcmp(trailer, expected_trailer, SEAL_OVERHEAD) != 0) {
+        return false;
+    }
+
+    if (!open_payload(&key, aad, sizeof(aad), payload, sizeof(payload), trailer) ||
+        memcmp(payload, plaintext, sizeof(payload)) != 0) {
+        return false;
+    }
+    memcpy(payload, ciphertext, sizeof(payload));
+    trailer[SEAL_OVERHEAD - 1] ^= 1;  /**< A forged tag must be refused */
+    return !open_payload(&key, aad, sizeof(aad), payload, sizeof(payload), trailer);
+}
+
+/* - - - - - - - - - - - - - - - - - - - - END SEAL - - - - - - - - - - - - - - - - - - - - */
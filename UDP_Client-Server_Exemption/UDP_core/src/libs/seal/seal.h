@@ -0,0 +1,106 @@
+/**
+ * @file seal.h
+ * @brief Header file providing the ChaCha20-Poly1305 sealing of the response datagrams.
+ *
+ * A sealed datagram keeps its header in clear, encrypts what follows it and appends the
+ * trailer described by `REQUEST_FLAG_SEALED`: the 96-bit nonce, then the 128-bit Poly1305 tag
+ * over the header (as additional data) and the encrypted bytes. The construction is the AEAD of
+ * RFC 8439, so sealing costs one ChaCha20 pass over the password characters and one Poly1305
+ * pass over the datagram, with no handshake and no extra round trip.
+ *
+ * The key is the same on the client and the server, read from a file holding 64 hexadecimal
+ * digits (e.g. the output of `openssl rand -hex 32`). The nonce is chosen by the sender of
+ * the datagram: it must never repeat under the same key.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef SEAL_H_
+#define SEAL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "../protocol/protocol.h"
+
+/* - - - - - - - - - - - - - - - - - - - - - SEAL - - - - - - - - - - - - - - - - - - - - - */
+
+#define SEAL_KEY_SIZE 32            /**< Bytes of a ChaCha20-Poly1305 key */
+
+/**
+ * @struct SealKey
+ * @brief A pre-shared key, as the eight little-endian words ChaCha20 works on.
+ */
+typedef struct {
+    uint32_t words[SEAL_KEY_SIZE / 4];  /**< The key */
+} SealKey;
+
+/**
+ * @brief Parses a key written as 64 hexadecimal digits, surrounded by optional blanks.
+ *
+ * @param[in] text The null-terminated text.
+ * @param[out] key Receives the key.
+ *
+ * @return `true` if the text is well formed, `false` otherwise.
+ */
+bool parse_seal_key(const char *text, SealKey *key);
+
+/**
+ * @brief Reads a key from a file holding 64 hexadecimal digits.
+ *
+ * @param[in] path The path of the file.
+ * @param[out] key Receives the key.
+ *
+ * @return `true` if the file was read and holds a well-formed key, `false` otherwise.
+ */
+bool load_seal_key(const char *path, SealKey *key);
+
+/**
+ * @brief Encrypts the payload of a datagram in place and writes its tag.
+ *
+ * @param[in] key The key.
+ * @param[in] header The clear header of the datagram, authenticated but not encrypted.
+ * @param[in] header_size Number of bytes of `header`.
+ * @param[in,out] payload The bytes to encrypt.
+ * @param[in] payload_size Number of bytes of `payload`.
+ * @param[in,out] trailer `SEAL_OVERHEAD` bytes: the nonce, already written by the caller,
+ *                then the tag, written by the call.
+ */
+void seal_payload(const SealKey *key, const uint8_t *header, size_t header_size,
+                  uint8_t *payload, size_t payload_size, uint8_t *trailer);
+
+/**
+ * @brief Checks the tag of a sealed datagram and decrypts its payload in place.
+ *
+ * The payload is left untouched when the tag does not match.
+ *
+ * @param[in] key The key.
+ * @param[in] header The clear header of the datagram.
+ * @param[in] header_size Number of bytes of `header`.
+ * @param[in,out] payload The bytes to decrypt.
+ * @param[in] payload_size Number of bytes of `payload`.
+ * @param[in] trailer The `SEAL_OVERHEAD` bytes of nonce and tag that follow the payload.
+ *
+ * @return `true` if the datagram is authentic, `false` if it was forged, altered or sealed
+ *         under another key.
+ */
+bool open_payload(const SealKey *key, const uint8_t *header, size_t header_size,
+                  uint8_t *payload, size_t payload_size, const uint8_t *trailer);
+
+/**
+ * @brief Checks the implementation against the test vectors of RFC 8439 (sections 2.3.2 and 2.8.2).
+ *
+ * The block function vector checks the ChaCha20 of `chacha20.h`, shared with the random
+ * source; the AEAD vector then covers the keystream, the Poly1305 limb arithmetic and the block
+ * of the lengths; the opening is checked too, with the right tag and with a forged one. Run it
+ * before using a key: a failure would make every sealed response unreadable by the other side.
+ *
+ * @return `true` if the keystream, the ciphertext and the tag match the vectors.
+ */
+bool seal_self_test(void);
+
+/* - - - - - - - - - - - - - - - - - - - - END SEAL - - - - - - - - - - - - - - - - - - - - */
+
+#endif /* SEAL_H_ */
@@ -0,0 +1,178 @@
+/**
+ * @file transport.c
+ * @brief Implementation of the request/response transport functions shared by the clients.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#if defined WIN32
+#include <winsock2.h>       /**< Include WSAGetLastError() */
+#else
+#include <errno.h>          /**< Include errno and ECONNREFUSED */
+#include <unistd.h>         /**< Include close() */
+#define closesocket close   /**< Define closesocket as close for UNIX systems */
+#endif
+
+#include <string.h>
+#include "transport.h"
+
+#if defined _MSC_VER
+#define THREAD_LOCAL __declspec(thread)  /**< Thread-local storage qualifier for MSVC */
+#else
+#define THREAD_LOCAL _Thread_local       /**< Thread-local storage qualifier for C11 compilers */
+#endif
+
+/* - - - - - - - - - - - - - - - - - - - TRANSPORT - - - - - - - - - - - - - - - - - - - */
+
+static SealKey response_key;        /**< Key of the sealed responses */
+static bool sealing;                /**< Whether `response_key` is set */
+
+/**
+ * @struct SocketCookie
+ * @brief The cookie kept for a socket.
+ */
+typedef struct {
+    bool kept;                      /**< Whether the slot holds a cookie */
+    int socket;                     /**< Socket the cookie was received on */
+    uint8_t cookie[COOKIE_SIZE];    /**< The cookie */
+} SocketCookie;
+
+static THREAD_LOCAL SocketCookie cookies[TRANSPORT_COOKIE_SLOTS];  /**< Sockets of the calling thread, modulo the size */
+
+/**
+ * @brief Asks for sealed responses from then on, and opens them with a pre-shared key.
+ */
+void enable_sealing(const SealKey *key) {
+    response_key = *key;
+    sealing = true;
+}
+
+/**
+ * @brief Length of the socket address structure of a family.
+ */
+socklen_t address_size(const struct sockaddr_storage *address) {
+    return address->ss_family == AF_INET6 ? (socklen_t)sizeof(struct sockaddr_in6)
+                                          : (socklen_t)sizeof(struct sockaddr_in);
+}
+
+/**
+ * @brief Creates a UDP socket connected to the server.
+ * @return -1 if the socket cannot be created or connected.
+ */
+int connect_server_socket(const struct sockaddr_storage *server_address) {
+    int client_socket = socket(server_address->ss_family, SOCK_DGRAM, IPPROTO_UDP);
+    if (client_socket >= 0 &&
+        connect(client_socket, (const struct sockaddr *)server_address, address_size(server_address)) < 0) {
+        closesocket(client_socket);
+        client_socket = -1;
+    }
+    return client_socket;
+}
+
+/**
+ * @brief Whether the last failed send or receive was caused by an ICMP port unreachable.
+ * @details Winsock reports it on UDP sockets as `WSAECONNRESET`.
+ */
+bool connection_refused(void) {
+#if defined WIN32
+    return WSAGetLastError() == WSAECONNRESET;
+#else
+    return errno == ECONNREFUSED;
+#endif
+}
+
+/**
+ * @brief Keeps the cookie that a server sent on a socket.
+ */
+void store_cookie(int client_socket, const uint8_t *cookie) {
+    SocketCookie *slot = &cookies[(unsigned int)client_socket % TRANSPORT_COOKIE_SLOTS];
+    slot->kept = true;
+    slot->socket = client_socket;
+    memcpy(slot->cookie, cookie, COOKIE_SIZE);
+}
+
+/**
+ * @brief Sets the sealing flag of a request and appends the cookie of the socket.
+ * @return The number of bytes to send.
+ */
+size_t mark_datagram(int client_socket, uint8_t *datagram, size_t datagram_size, size_t buffer_size) {
+    if (sealing) {
+        datagram[3] |= REQUEST_FLAG_SEALED;
+    }
+    const SocketCookie *slot = &cookies[(unsigned int)client_socket % TRANSPORT_COOKIE_SLOTS];
+    if (slot->kept && slot->socket == client_socket) {
+        datagram_size = attach_cookie(datagram, datagram_size, buffer_size, slot->cookie);
+    }
+    return datagram_size;
+}
+
+/**
+ * @brief Send a datagram as it is on a connected socket.
+ * @return false if the datagram is not fully sent.
+ */
+bool send_connected(int client_socket, const uint8_t *datagram, size_t datagram_size) {
+    int sent = send(client_socket, (const char *)datagram, datagram_size, 0);
+    if (sent < 0 && connection_refused()) {
+        sent = send(client_socket, (const char *)datagram, datagram_size, 0); /**< The error was for an older datagram */
+    }
+    return sent == (int)datagram_size;
+}
+
+/**
+ * @brief Send a password request to the server.
+ * @return false if the request cannot be encoded or is not fully sent.
+ */
+bool send_request(int client_socket, const PasswordRequest *password_request) {
+    uint8_t datagram[BULK_REQUEST_SIZE + COOKIE_SIZE];
+    size_t datagram_size = encode_request(password_request, datagram, sizeof(datagram));
+    if (datagram_size == 0) {
+        return false;
+    }
+    datagram_size = mark_datagram(client_socket, datagram, datagram_size, sizeof(datagram));
+    return send_connected(client_socket, datagram, datagram_size);
+}
+
+/**
+ * @brief Tells whether a response may be used as it was received: sealed when the sealing is
+ *        enabled, except for the errors, which carry no password, and the cookie challenges.
+ */
+bool check_sealing(uint8_t flags, uint8_t status, size_t payload_size) {
+    if (flags & REQUEST_FLAG_SEALED) {
+        return sealing;
+    }
+    if (status == STATUS_COOKIE_REQUIRED) {
+        return payload_size == COOKIE_SIZE;
+    }
+    return !sealing || (status != STATUS_OK && payload_size == 0);
+}
+
+/**
+ * @brief Checks the tag of a sealed response and decrypts it in place.
+ */
+bool open_response(const uint8_t *datagram, size_t header_size, uint8_t *payload, size_t payload_size) {
+    return open_payload(&response_key, datagram, header_size, payload, payload_size,
+                        datagram + header_size + payload_size);
+}
+
+/**
+ * @brief Receive the password response from the server and open it if it is sealed.
+ * @return false if the reception fails, the datagram is not a v2 response, or its sealing is wrong.
+ */
+bool receive_response(int client_socket, PasswordResponse *response_msg) {
+    uint8_t datagram[MAX_RESPONSE_SIZE];
+    int rcv_msg_size = recv(client_socket, (char *)datagram, sizeof(datagram), 0);
+    if (rcv_msg_size < 0 || !decode_response(datagram, rcv_msg_size, response_msg) ||
+        !check_sealing(response_msg->flags, response_msg->status, response_msg->length)) {
+        return false;
+    }
+    if (response_msg->status == STATUS_COOKIE_REQUIRED && !(response_msg->flags & REQUEST_FLAG_SEALED)) {
+        store_cookie(client_socket, (const uint8_t *)response_msg->password);
+        return true;
+    }
+    return !(response_msg->flags & REQUEST_FLAG_SEALED) ||
+           open_response(datagram, RESPONSE_HEADER_SIZE, (uint8_t *)response_msg->password, response_msg->length);
+}
+
+/* - - - - - - - - - - - - - - - - - - END TRANSPORT - - - - - - - - - - - - - - - - - - */
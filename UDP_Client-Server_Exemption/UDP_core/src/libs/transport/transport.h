@@ -0,0 +1,179 @@
+/**
+ * @file transport.h
+ * @brief Header file declaring the functions that move requests and responses over a UDP socket.
+ *
+ * These functions encode and decode the v2 wire format of `protocol.h` and are shared by the
+ * interactive client and the benchmark client. They never print: the caller decides how to
+ * report a failure.
+ *
+ * The sockets are connected UDP sockets (`connect_server_socket`): the kernel resolves the
+ * route once instead of on every `sendto`, and drops datagrams from any other peer, so a
+ * response always comes from the server. An ICMP port unreachable is reported by the next
+ * `send` or `recv` on the socket as a "connection refused" error.
+ *
+ * Once `enable_sealing` is called, every datagram sent asks for a sealed response
+ * (`REQUEST_FLAG_SEALED`) and only the responses that the key authenticates are received;
+ * a response in clear is only accepted when it reports an error and carries no password.
+ *
+ * The cookie of a server that challenges a request (`STATUS_COOKIE_REQUIRED`) is kept for the
+ * socket, in a table of the calling thread, and appended to every datagram sent on that socket
+ * from then on; the caller only has to send the challenged request again. Sockets are looked up
+ * in a small direct-mapped table, so a socket sharing its slot with another one of the same
+ * thread, or a closed descriptor reused for another server, costs at most one more challenge.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef TRANSPORT_H_
+#define TRANSPORT_H_
+
+#if defined WIN32
+#include <winsock2.h>       /**< Include Winsock 2 library for Windows */
+#include <ws2tcpip.h>       /**< Include getaddrinfo() and struct sockaddr_storage */
+#else
+#include <sys/socket.h>     /**< Include socket library for UNIX systems */
+#include <netinet/in.h>     /**< Include for internet address family structures */
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "../protocol/protocol.h"
+#include "../seal/seal.h"
+
+/* - - - - - - - - - - - - - - - - - - - TRANSPORT - - - - - - - - - - - - - - - - - - - */
+
+#define TRANSPORT_COOKIE_SLOTS 64   /**< Sockets whose cookie is kept at once, per thread */
+
+/**
+ * @brief Length of the socket address structure of a family.
+ *
+ * @param[in] address An IPv4 or IPv6 address.
+ *
+ * @return `sizeof(struct sockaddr_in6)` for `AF_INET6`, `sizeof(struct sockaddr_in)` otherwise.
+ */
+socklen_t address_size(const struct sockaddr_storage *address);
+
+/**
+ * @brief Creates a UDP socket connected to the server.
+ *
+ * @param[in] server_address The server's IPv4 or IPv6 address.
+ *
+ * @return >=0 The socket descriptor.
+ * @return -1 If the socket cannot be created or connected (e.g. no route to the address).
+ */
+int connect_server_socket(const struct sockaddr_storage *server_address);
+
+/**
+ * @brief Whether the last failed send or receive was caused by an ICMP port unreachable.
+ *
+ * @return true if the server address answered that nothing listens on the port.
+ */
+bool connection_refused(void);
+
+/**
+ * @brief Asks for sealed responses from then on, and opens them with a pre-shared key.
+ *
+ * Must be called before the threads using the transport start.
+ *
+ * @param[in] key The key shared with the server.
+ */
+void enable_sealing(const SealKey *key);
+
+/**
+ * @brief Keeps the cookie that a server sent on a socket, for the next datagrams sent on it.
+ *
+ * @param[in] client_socket The connected socket descriptor.
+ * @param[in] cookie The `COOKIE_SIZE` bytes of the cookie.
+ */
+void store_cookie(int client_socket, const uint8_t *cookie);
+
+/**
+ * @brief Prepares an encoded request for a socket.
+ *
+ * Sets `REQUEST_FLAG_SEALED` when the sealing is enabled, and appends the cookie kept for the
+ * socket (see `attach_cookie`), if any.
+ *
+ * @param[in] client_socket The connected socket descriptor.
+ * @param[in,out] datagram The encoded request, without a cookie.
+ * @param[in] datagram_size Number of bytes of the request.
+ * @param[in] buffer_size Size of `datagram` in bytes, at least `datagram_size + COOKIE_SIZE`.
+ *
+ * @return The number of bytes to send.
+ */
+size_t mark_datagram(int client_socket, uint8_t *datagram, size_t datagram_size, size_t buffer_size);
+
+/**
+ * @brief Send a datagram as it is on a connected socket.
+ *
+ * A pending "connection refused" error is consumed and the send is attempted once more.
+ *
+ * @param[in] client_socket The connected socket descriptor.
+ * @param[in] datagram The datagram.
+ * @param[in] datagram_size Number of bytes of `datagram`.
+ *
+ * @return true if the datagram is fully sent.
+ */
+bool send_connected(int client_socket, const uint8_t *datagram, size_t datagram_size);
+
+/**
+ * @brief Send a password request to the server.
+ *
+ * Encodes the PasswordRequest structure in the v2 wire format, marks it for the socket
+ * (`mark_datagram`) and sends it (`send_connected`).
+ *
+ * @param[in] client_socket The connected socket descriptor.
+ * @param[in] password_request Pointer to the PasswordRequest structure.
+ *
+ * @return true if the request is sent successfully.
+ * @return false if an error occurs during encoding or sending.
+ */
+bool send_request(int client_socket, const PasswordRequest *password_request);
+
+/**
+ * @brief Tells whether a response may be used as it was received.
+ *
+ * A sealed response is only accepted when the sealing is enabled; a response in clear when it
+ * is not, or when it carries no password (an error, or the cookie of a challenge).
+ *
+ * @param[in] flags Flags of the response.
+ * @param[in] status Status of the response.
+ * @param[in] payload_size Number of bytes after the header, trailer excluded.
+ *
+ * @return true if the response may be opened or read.
+ */
+bool check_sealing(uint8_t flags, uint8_t status, size_t payload_size);
+
+/**
+ * @brief Checks the tag of a sealed response under the pre-shared key and decrypts it in place.
+ *
+ * @param[in] datagram The received datagram, starting with its header.
+ * @param[in] header_size Number of bytes of the header.
+ * @param[in,out] payload The encrypted bytes, followed in the datagram by the trailer.
+ * @param[in] payload_size Number of bytes of `payload`.
+ *
+ * @return true if the response is authentic.
+ */
+bool open_response(const uint8_t *datagram, size_t header_size, uint8_t *payload, size_t payload_size);
+
+/**
+ * @brief Receive the password response from the server.
+ *
+ * The datagram is decoded from the v2 wire format, and its password decrypted if it is sealed.
+ * The cookie of a challenge is kept for the socket (see `store_cookie`) and the challenge is
+ * returned as a response with the `STATUS_COOKIE_REQUIRED` status.
+ *
+ * @param[in] client_socket The connected socket descriptor.
+ * @param[out] response_msg Pointer to the PasswordResponse structure to store the response.
+ *
+ * @return true if a well-formed response is received.
+ * @return false if an error occurs during reception, the response is malformed, or it is not
+ *         sealed as requested or not authentic.
+ */
+bool receive_response(int client_socket, PasswordResponse *response_msg);
+
+/* - - - - - - - - - - - - - - - - - - END TRANSPORT - - - - - - - - - - - - - - - - - - */
+
+#endif /* TRANSPORT_H_ */
@@ -0,0 +1,654 @@
+/**
+ * @file UDP_microbenchmark.c
+ * @brief Microbenchmarks of the password generators, the charset kernels and the request parsing.
+ * @details The project compiles the libraries of the server (and the input checks of the
+ * client) from their own directories, so every case measures the code that is shipped. Each
+ * group of cases can be selected on its own:
+ * - `rng`: `random_bytes` for every backend;
+ * - `generator`: the generic `generate_*` function of every type and length, for every backend;
+ * - `dispatch`: `generate_password`, i.e. the generators specialized per type and length;
+ * - `kernel`: `map_charset` against `map_charset_scalar` on the charset of every type;
+ * - `handler`: `handle_password_request` writing a whole v2 response;
+ * - `parse`: `parse_request_datagram` on v2 and v1 datagrams and `parse_password_type`;
+ * - `validation`: `control_type` and `control_length` of the client;
+ * - `seal`: `seal_response` on a single response and on a full bulk datagram, once
+ *   `seal_self_test` has checked the cipher against the vector of RFC 8439;
+ * - `cookie`: `check_cookie` on a valid, a previous-window and a forged cookie, and
+ *   `encode_cookie_challenge`;
+ * - `trace`: the tracing calls of the path of one request, with tracing off, sampling one
+ *   request out of 100 and tracing every request.
+ * The `dispatch` and `handler` cases run on the first selected backend only: compared with
+ * the `generator` cases, they measure what the specialization saves and what the handler adds. Results are printed as text, CSV or JSON.
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../../UDP_core/src/libs/charset/charset.h"   /**< Charset kernels */
+#include "../../UDP_server/src/libs/cookie/cookie.h"   /**< Anti-spoofing cookies */
+#include "../../UDP_server/src/libs/handler/handler.h" /**< Request decoding and answering */
+#include "../../UDP_core/src/libs/password/password.h" /**< Password generators */
+#include "../../UDP_core/src/libs/protocol/protocol.h" /**< Communication protocol definitions */
+#include "../../UDP_core/src/libs/random/random.h"     /**< RNG backends */
+#include "../../UDP_core/src/libs/seal/seal.h"         /**< Sealing of the responses */
+#include "../../UDP_server/src/libs/slots/slots.h"     /**< Size of the response buffers */
+#include "../../UDP_server/src/libs/trace/trace.h"     /**< Request-path tracing */
+#include "libs/measure/measure.h"                      /**< Timing loop and reports */
+#include "libs/validation/validation.h"                /**< Input checks of the client */
+
+#define KERNEL_INPUT_SIZE 4096  /**< Random bytes mapped by one kernel call */
+
+/**
+ * @enum CaseGroup
+ * @brief Groups of cases, usable as bit masks.
+ */
+typedef enum {
+    GROUP_RNG = 1 << 0,         /**< Random byte backends */
+    GROUP_GENERATOR = 1 << 1,   /**< Generators of the single types */
+    GROUP_DISPATCH = 1 << 2,    /**< `generate_password` */
+    GROUP_KERNEL = 1 << 3,      /**< Charset kernels */
+    GROUP_HANDLER = 1 << 4,     /**< `handle_password_request` */
+    GROUP_PARSE = 1 << 5,       /**< Request decoding */
+    GROUP_VALIDATION = 1 << 6,  /**< Input checks of the client */
+    GROUP_SEAL = 1 << 7,        /**< ChaCha20-Poly1305 sealing of the responses */
+    GROUP_COOKIE = 1 << 8,      /**< Anti-spoofing cookies */
+    GROUP_TRACE = 1 << 9,       /**< Request-path tracing */
+    GROUP_ALL = (1 << 10) - 1   /**< Every group */
+} CaseGroup;
+
+static const char *const group_names[] = {
+    "rng", "generator", "dispatch", "kernel", "handler", "parse", "validation", "seal", "cookie", "trace"
+};
+
+static const char type_letters[PASSWORD_TYPE_COUNT + 1] = "namsu"; /**< In PasswordType order */
+
+static const char *const type_names[PASSWORD_TYPE_COUNT] = {
+    "numeric", "alpha", "mixed", "secure", "unambiguous"
+};
+
+static const char *const backend_names[] = { "chacha20", "system" };
+
+/**
+ * @struct MicrobenchmarkOptions
+ * @brief Command-line options of the microbenchmarks.
+ */
+typedef struct {
+    MeasureOptions measure;     /**< Timing settings */
+    ReportFormat format;        /**< Output format of the results */
+    unsigned int groups;        /**< Selected CaseGroup bits */
+    const char *types;          /**< Selected type letters */
+    unsigned int min_length;    /**< Shortest password measured */
+    unsigned int max_length;    /**< Longest password measured */
+    RandomBackend backends[2];  /**< Selected backends, in order */
+    unsigned int backend_count; /**< Number of selected backends */
+} MicrobenchmarkOptions;
+
+/**
+ * @struct GeneratorCase
+ * @brief Input of the cases that produce passwords.
+ */
+typedef struct {
+    void (*generate)(char *password, int length); /**< Generator of a single type */
+    PasswordType type;          /**< Type given to `generate_password` */
+    int length;                 /**< Password length */
+    PasswordRequest request;    /**< Request given to `handle_password_request` */
+} GeneratorCase;
+
+/**
+ * @struct KernelCase
+ * @brief Input of the kernel cases.
+ */
+typedef struct {
+    size_t (*map)(const Charset *charset, const uint8_t *bytes, size_t count, char *output, size_t capacity);
+    const Charset *charset;     /**< Charset of the type */
+    const uint8_t *bytes;       /**< Random input */
+    size_t produced;            /**< Characters written by the last call */
+} KernelCase;
+
+/**
+ * @struct ParseCase
+ * @brief Input of the parsing cases.
+ */
+typedef struct {
+    uint8_t datagram[SLOT_REQUEST_SIZE]; /**< Datagram given to `parse_request_datagram` */
+    size_t size;                /**< Bytes of the datagram */
+    char type;                  /**< Letter given to `parse_password_type` */
+} ParseCase;
+
+/**
+ * @struct SealCase
+ * @brief Input of the sealing cases.
+ */
+typedef struct {
+    PasswordRequest request;    /**< Sealed request being answered */
+    uint8_t datagram[MAX_DATAGRAM_SIZE]; /**< Response sealed again at every call */
+    size_t header_size;         /**< `RESPONSE_HEADER_SIZE` or `BULK_HEADER_SIZE` */
+    size_t size;                /**< Bytes of the response before the trailer */
+} SealCase;
+
+/**
+ * @struct CookieCase
+ * @brief Input of the cookie cases.
+ */
+typedef struct {
+    PasswordRequest request;    /**< Request carrying the cookie checked */
+    struct sockaddr_storage address; /**< Sender of the request */
+    uint64_t now_ms;            /**< Time of the check */
+    uint8_t response[BULK_COOKIE_CHALLENGE_SIZE]; /**< Challenge written at every call */
+} CookieCase;
+
+static volatile uint8_t sink;   /**< Keeps the outputs of the cases alive */
+
+/**
+ * @brief Print error messages on the standard error stream.
+ * @param[in] error_message The error message to display.
+ */
+void error_handler(const char *error_message) {
+    fputs(error_message, stderr);
+}
+
+/**
+ * @brief Parse the command-line options.
+ * @param[in] argc Number of arguments.
+ * @param[in] argv Arguments.
+ * @param[out] options Pointer to the MicrobenchmarkOptions structure to fill.
+ * @return `false` if an option is unknown or out of range; the usage is printed.
+ */
+bool parse_arguments(int argc, char *argv[], MicrobenchmarkOptions *options) {
+    memset(options, 0, sizeof(*options));
+    options->measure.min_time_ns = DEFAULT_MIN_TIME_MS * 1000000ULL;
+    options->measure.repetitions = DEFAULT_REPETITIONS;
+    options->format = REPORT_TEXT;
+    options->types = type_letters;
+    options->min_length = MIN_PASSWORD_LENGTH;
+    options->max_length = MAX_PASSWORD_LENGTH;
+    options->backends[0] = RANDOM_CHACHA20;
+    options->backends[1] = RANDOM_SYSTEM;
+    options->backend_count = 2;
+
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--group") == 0 && has_value) {
+            const char *group = argv[++i];
+            unsigned int bit = 0;
+            for (unsigned int j = 0; j < sizeof(group_names) / sizeof(group_names[0]); j++) {
+                if (strcmp(group, group_names[j]) == 0) {
+                    bit = 1u << j;
+                }
+            }
+            if (bit == 0) {
+                error_handler("Invalid group.\n");
+                return false;
+            }
+            options->groups |= bit;
+        } else if (strcmp(argv[i], "--type") == 0 && has_value) {
+            options->types = argv[++i];
+            if (options->types[0] == '\0' || strspn(options->types, type_letters) != strlen(options->types)) {
+                error_handler("Invalid password types.\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--length") == 0 && has_value) {
+            int length = atoi(argv[++i]);
+            if (length < MIN_PASSWORD_LENGTH || length > MAX_PASSWORD_LENGTH) {
+                error_handler("Invalid password length.\n");
+                return false;
+            }
+            options->min_length = options->max_length = (unsigned int)length;
+        } else if (strcmp(argv[i], "--backend") == 0 && has_value) {
+            const char *backend = argv[++i];
+            if (strcmp(backend, "chacha20") == 0) {
+                options->backend_count = 1;
+            } else if (strcmp(backend, "system") == 0) {
+                options->backends[0] = RANDOM_SYSTEM;
+                options->backend_count = 1;
+            } else if (strcmp(backend, "all") != 0) {
+                error_handler("Invalid random backend.\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--min-time") == 0 && has_value) {
+            int min_time = atoi(argv[++i]);
+            if (min_time < 1) {
+                error_handler("Invalid minimum time.\n");
+                return false;
+            }
+            options->measure.min_time_ns = (uint64_t)min_time * 1000000ULL;
+        } else if (strcmp(argv[i], "--repetitions") == 0 && has_value) {
+            int repetitions = atoi(argv[++i]);
+            if (repetitions < 1) {
+                error_handler("Invalid number of repetitions.\n");
+                return false;
+            }
+            options->measure.repetitions = (unsigned int)repetitions;
+        } else if (strcmp(argv[i], "--format") == 0 && has_value) {
+            const char *format = argv[++i];
+            if (strcmp(format, "text") == 0) {
+                options->format = REPORT_TEXT;
+            } else if (strcmp(format, "csv") == 0) {
+                options->format = REPORT_CSV;
+            } else if (strcmp(format, "json") == 0) {
+                options->format = REPORT_JSON;
+            } else {
+                error_handler("Invalid output format.\n");
+                return false;
+            }
+        } else {
+            error_handler("Usage: UDP_microbenchmark [--group rng|generator|dispatch|kernel|handler|parse|validation|seal|cookie|trace]...\n"
+                          "                          [--type namsu] [--length N] [--backend chacha20|system|all]\n"
+                          "                          [--min-time MS] [--repetitions N] [--format text|csv|json]\n");
+            return false;
+        }
+    }
+    if (options->groups == 0) {
+        options->groups = GROUP_ALL;
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the generator of a single password type.
+ * @param[in] type The password type.
+ * @return The `generate_*` function of the type.
+ */
+void (*type_generator(PasswordType type))(char *, int) {
+    switch (type) {
+        case ALPHA: return generate_alpha;
+        case MIXED: return generate_mixed;
+        case SECURE: return generate_secure;
+        case UNAMBIGUOUS: return generate_unambiguous;
+        case NUMERIC:
+        default: return generate_numeric;
+    }
+}
+
+/**
+ * @brief Case body: `random_bytes` into a 64-byte block, the size the generators request at most.
+ */
+void run_random_bytes(void *context, uint64_t iterations) {
+    uint8_t block[64];
+    (void)context;
+    for (uint64_t i = 0; i < iterations; i++) {
+        random_bytes(block, sizeof(block));
+        sink = block[0];
+    }
+}
+
+/**
+ * @brief Case body: the generator of a single type.
+ */
+void run_generator(void *context, uint64_t iterations) {
+    const GeneratorCase *generator = context;
+    char password[MAX_PASSWORD_LENGTH + 1];
+    for (uint64_t i = 0; i < iterations; i++) {
+        generator->generate(password, generator->length);
+        sink = (uint8_t)password[0];
+    }
+}
+
+/**
+ * @brief Case body: `generate_password`.
+ */
+void run_dispatch(void *context, uint64_t iterations) {
+    const GeneratorCase *generator = context;
+    char password[MAX_PASSWORD_LENGTH + 1];
+    for (uint64_t i = 0; i < iterations; i++) {
+        generate_password(password, generator->type, generator->length);
+        sink = (uint8_t)password[0];
+    }
+}
+
+/**
+ * @brief Case body: `handle_password_request` writing a v2 response.
+ */
+void run_handler(void *context, uint64_t iterations) {
+    const GeneratorCase *generator = context;
+    uint8_t datagram[SLOT_RESPONSE_SIZE];
+    for (uint64_t i = 0; i < iterations; i++) {
+        size_t size = handle_password_request(&generator->request, datagram);
+        sink = datagram[size - 1];
+    }
+}
+
+/**
+ * @brief Case body: one charset kernel over `KERNEL_INPUT_SIZE` random bytes.
+ */
+void run_kernel(void *context, uint64_t iterations) {
+    KernelCase *kernel = context;
+    char output[KERNEL_INPUT_SIZE];
+    for (uint64_t i = 0; i < iterations; i++) {
+        kernel->produced = kernel->map(kernel->charset, kernel->bytes, KERNEL_INPUT_SIZE, output, sizeof(output));
+        sink = (uint8_t)output[0];
+    }
+}
+
+/**
+ * @brief Case body: `parse_request_datagram`.
+ */
+void run_parse_datagram(void *context, uint64_t iterations) {
+    const ParseCase *parse = context;
+    PasswordRequest request;
+    for (uint64_t i = 0; i < iterations; i++) {
+        parse_request_datagram(parse->datagram, parse->size, &request);
+        sink = request.length;
+    }
+}
+
+/**
+ * @brief Case body: `parse_password_type`.
+ */
+void run_parse_type(void *context, uint64_t iterations) {
+    const ParseCase *volatile parse = context; /**< Reloaded at every call: no hoisting */
+    for (uint64_t i = 0; i < iterations; i++) {
+        sink = (uint8_t)parse_password_type(parse->type);
+    }
+}
+
+/**
+ * @brief Case body: `seal_response`, i.e. the nonce, one ChaCha20 pass and one Poly1305 pass.
+ */
+void run_seal(void *context, uint64_t iterations) {
+    SealCase *seal = context;
+    for (uint64_t i = 0; i < iterations; i++) {
+        size_t size = seal_response(&seal->request, seal->datagram, seal->header_size, seal->size);
+        sink = seal->datagram[size - 1];
+    }
+}
+
+/**
+ * @brief Case body: `check_cookie` on a datagram holding a cookie.
+ */
+void run_check_cookie(void *context, uint64_t iterations) {
+    CookieCase *cookie = context;
+    for (uint64_t i = 0; i < iterations; i++) {
+        sink = (uint8_t)check_cookie(&cookie->request, REQUEST_HEADER_SIZE + COOKIE_SIZE, &cookie->address, cookie->now_ms);
+    }
+}
+
+/**
+ * @brief Case body: `encode_cookie_challenge`.
+ */
+void run_cookie_challenge(void *context, uint64_t iterations) {
+    CookieCase *cookie = context;
+    for (uint64_t i = 0; i < iterations; i++) {
+        size_t size = encode_cookie_challenge(&cookie->request, &cookie->address, cookie->now_ms, cookie->response);
+        sink = cookie->response[size - 1];
+    }
+}
+
+/**
+ * @brief Case body: the tracing calls a server loop makes for one request, up to its send.
+ */
+void run_trace_path(void *context, uint64_t iterations) {
+    const PasswordRequest *request = context;
+    for (uint64_t i = 0; i < iterations; i++) {
+        TraceRecord *trace = start_trace(i + 1);
+        trace_kernel_time(trace, 0);
+        trace_request(trace, request);
+        trace_point(trace, TRACE_LOGGED);
+        trace_point(trace, TRACE_HANDLED);
+        finish_traces();
+        sink = (uint8_t)(trace != NULL);
+    }
+}
+
+/**
+ * @brief Measures a case and prints its result.
+ * @param[in] options Pointer to the MicrobenchmarkOptions structure.
+ * @param[in,out] result The result, with the descriptive fields already set.
+ * @param[in] body The code under test.
+ * @param[in,out] context Passed unchanged to `body`.
+ * @param[in] chars_per_op Characters produced by one operation, 0 if it does not apply.
+ */
+void run_case(const MicrobenchmarkOptions *options, CaseResult *result, CaseBody body, void *context,
+              double chars_per_op) {
+    measure_case(&options->measure, body, context, result);
+    result->chars_per_s = result->ns_per_op > 0 ? chars_per_op * 1e9 / result->ns_per_op : 0.0;
+    report_case(options->format, result);
+}
+
+/**
+ * @brief Runs the cases that produce passwords: the `generator`, `dispatch` and `handler` groups.
+ * @param[in] options Pointer to the MicrobenchmarkOptions structure.
+ */
+void run_password_cases(const MicrobenchmarkOptions *options) {
+    static const struct {
+        CaseGroup group;
+        const char *group_name;
+        CaseBody body;
+    } kinds[] = {
+        { GROUP_GENERATOR, "generator", run_generator },
+        { GROUP_DISPATCH, "dispatch", run_dispatch },
+        { GROUP_HANDLER, "handler", run_handler },
+    };
+
+    for (size_t k = 0; k < sizeof(kinds) / sizeof(kinds[0]); k++) {
+        if (!(options->groups & kinds[k].group)) {
+            continue;
+        }
+        bool per_backend = kinds[k].group == GROUP_GENERATOR;
+        for (unsigned int b = 0; b < (per_backend ? options->backend_count : 1); b++) {
+            select_random_backend(options->backends[b]);
+            for (const char *letter = options->types; *letter != '\0'; letter++) {
+                PasswordType type = (PasswordType)(strchr(type_letters, *letter) - type_letters);
+                char generator_name[32];
+                snprintf(generator_name, sizeof(generator_name), "generate_%s", type_names[type]);
+
+                for (unsigned int length = options->min_length; length <= options->max_length; length++) {
+                    GeneratorCase generator = { type_generator(type), type, (int)length,
+                                                { *letter, (uint8_t)length, 0, 0, 1, { 0 } } };
+                    /* The generators are told apart by name and backend, the others by type */
+                    CaseResult result = { kinds[k].group_name, generator_name,
+                                          backend_names[options->backends[b]], length, 0, 0.0, 0.0 };
+                    if (!per_backend) {
+                        result.name = kinds[k].group == GROUP_DISPATCH ? "generate_password" : "handle_password_request";
+                        result.variant = type_names[type];
+                    }
+                    run_case(options, &result, kinds[k].body, &generator, length);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Runs the `rng` group.
+ * @param[in] options Pointer to the MicrobenchmarkOptions structure.
+ */
+void run_random_cases(const MicrobenchmarkOptions *options) {
+    for (unsigned int b = 0; b < options->backend_count; b++) {
+        select_random_backend(options->backends[b]);
+        CaseResult result = { "rng", "random_bytes", backend_names[options->backends[b]], 64, 0, 0.0, 0.0 };
+        run_case(options, &result, run_random_bytes, NULL, 64);
+    }
+}
+
+/**
+ * @brief Runs the `kernel` group: the SIMD kernel selected at compile time against the scalar one.
+ * @param[in] options Pointer to the MicrobenchmarkOptions structure.
+ * @return `false` if the random input cannot be read.
+ */
+bool run_kernel_cases(const MicrobenchmarkOptions *options) {
+    static uint8_t bytes[KERNEL_INPUT_SIZE];
+    if (!system_random_bytes(bytes, sizeof(bytes))) {
+        error_handler("Unable to read the operating system entropy source.\n");
+        return false;
+    }
+
+    bool simd = strcmp(charset_kernel_name(), "scalar") != 0;
+    for (const char *letter = options->types; *letter != '\0'; letter++) {
+        PasswordType type = (PasswordType)(strchr(type_letters, *letter) - type_letters);
+        for (int scalar = simd ? 0 : 1; scalar <= 1; scalar++) {
+            char name[32];
+            snprintf(name, sizeof(name), "map_charset_%s", scalar ? "scalar" : charset_kernel_name());
+            KernelCase kernel = { scalar ? map_charset_scalar : map_charset, password_charset(type), bytes, 0 };
+            CaseResult result = { "kernel", name, type_names[type], KERNEL_INPUT_SIZE, 0, 0.0, 0.0 };
+            measure_case(&options->measure, run_kernel, &kernel, &result);
+            result.chars_per_s = (double)kernel.produced * 1e9 / result.ns_per_op;
+            report_case(options->format, &result);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Runs the `parse` group.
+ * @param[in] options Pointer to the MicrobenchmarkOptions structure.
+ */
+void run_parse_cases(const MicrobenchmarkOptions *options) {
+    PasswordRequest request = { 's', 16, 0, 42, 1, { 0 } };
+    ParseCase parse;
+    memset(&parse, 0, sizeof(parse));
+
+    parse.size = encode_request(&request, parse.datagram, sizeof(parse.datagram));
+    CaseResult v2 = { "parse", "parse_request_datagram", "v2", 16, 0, 0.0, 0.0 };
+    run_case(options, &v2, run_parse_datagram, &parse, 0);
+
+    memset(parse.datagram, 0, sizeof(parse.datagram));
+    memcpy(parse.datagram, "s16", 3);
+    parse.size = sizeof(parse.datagram); /**< v1 datagrams are truncated to a slot */
+    CaseResult v1 = { "parse", "parse_request_datagram", "v1", 16, 0, 0.0, 0.0 };
+    run_case(options, &v1, run_parse_datagram, &parse, 0);
+
+    parse.type = 's';
+    CaseResult lower = { "parse", "parse_password_type", "lowercase", 0, 0, 0.0, 0.0 };
+    run_case(options, &lower, run_parse_type, &parse, 0);
+
+    parse.type = 'S';
+    CaseResult upper = { "parse", "parse_password_type", "uppercase", 0, 0, 0.0, 0.0 };
+    run_case(options, &upper, run_parse_type, &parse, 0);
+}
+
+/**
+ * @brief Runs the `cookie` group, from 127.0.0.1:40000.
+ * @return `false` if the cookie secret could not be drawn.
+ */
+bool run_cookie_cases(const MicrobenchmarkOptions *options) {
+    static CookieCase cookie;
+    if (!enable_cookies()) {
+        error_handler("Error enabling the cookies: SipHash self-test or entropy source failed.\n");
+        return false;
+    }
+    memset(&cookie, 0, sizeof(cookie));
+    struct sockaddr_in *ipv4 = (struct sockaddr_in *)&cookie.address;
+    ipv4->sin_family = AF_INET;
+    ipv4->sin_port = htons(40000);
+    ipv4->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    cookie.request = (PasswordRequest){ 's', 16, REQUEST_FLAG_COOKIE, 42, 1, { 0 } };
+    cookie.now_ms = 10 * COOKIE_WINDOW_MS;
+
+    CaseResult challenge = { "cookie", "encode_cookie_challenge", "single", 0, 0, 0.0, 0.0 };
+    run_case(options, &challenge, run_cookie_challenge, &cookie, 0);
+
+    memcpy(cookie.request.cookie, cookie.response + RESPONSE_HEADER_SIZE, COOKIE_SIZE);
+    CaseResult valid = { "cookie", "check_cookie", "valid", 0, 0, 0.0, 0.0 };
+    run_case(options, &valid, run_check_cookie, &cookie, 0);
+
+    cookie.now_ms += COOKIE_WINDOW_MS; /**< Second MAC: the cookie of the previous window */
+    CaseResult previous = { "cookie", "check_cookie", "previous", 0, 0, 0.0, 0.0 };
+    run_case(options, &previous, run_check_cookie, &cookie, 0);
+
+    cookie.request.cookie[0] ^= 1;
+    CaseResult forged = { "cookie", "check_cookie", "forged", 0, 0, 0.0, 0.0 };
+    run_case(options, &forged, run_check_cookie, &cookie, 0);
+    return true;
+}
+
+/**
+ * @brief Runs the `trace` group: what tracing adds to every request at each sampling interval.
+ * @return `false` if the trace ring could not be allocated.
+ */
+bool run_trace_cases(const MicrobenchmarkOptions *options) {
+    static PasswordRequest request = { 's', 16, 0, 42, 1, { 0 } };
+
+    CaseResult off = { "trace", "request path", "off", 0, 0, 0.0, 0.0 };
+    run_case(options, &off, run_trace_path, &request, 0);
+
+    enable_tracing(100);
+    if (!bind_worker_trace()) {
+        error_handler("Error allocating the trace ring.\n");
+        return false;
+    }
+    CaseResult sampled = { "trace", "request path", "1/100", 0, 0, 0.0, 0.0 };
+    run_case(options, &sampled, run_trace_path, &request, 0);
+
+    enable_tracing(1);
+    CaseResult every = { "trace", "request path", "every", 0, 0, 0.0, 0.0 };
+    run_case(options, &every, run_trace_path, &request, 0);
+    return true;
+}
+
+/**
+ * @brief Runs the `seal` group, under a fixed key.
+ * @details It must run last: once a key is set, the handler refuses the requests in clear.
+ * Timing a cipher that does not match its test vector would be meaningless, so the group stops first.
+ * @param[in] options Pointer to the MicrobenchmarkOptions structure.
+ * @return false if the ChaCha20-Poly1305 self-test fails.
+ */
+bool run_seal_cases(const MicrobenchmarkOptions *options) {
+    static SealCase seal;
+    SealKey key;
+    if (!seal_self_test()) {
+        error_handler("The ChaCha20-Poly1305 self-test failed.\n");
+        return false;
+    }
+    parse_seal_key("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", &key);
+    enable_sealing(&key);
+    memset(&seal, 0, sizeof(seal));
+
+    seal.request = (PasswordRequest){ 's', 16, REQUEST_FLAG_SEALED, 42, 1, { 0 } };
+    seal.header_size = RESPONSE_HEADER_SIZE;
+    seal.size = RESPONSE_HEADER_SIZE + 16;
+    CaseResult single = { "seal", "seal_response", "single", 16, 0, 0.0, 0.0 };
+    run_case(options, &single, run_seal, &seal, 16);
+
+    seal.request.flags |= REQUEST_FLAG_BULK;
+    seal.header_size = BULK_HEADER_SIZE;
+    seal.size = MAX_DATAGRAM_SIZE - SEAL_OVERHEAD;
+    CaseResult bulk = { "seal", "seal_response", "bulk", (unsigned int)(seal.size - BULK_HEADER_SIZE), 0, 0.0, 0.0 };
+    run_case(options, &bulk, run_seal, &seal, (double)(seal.size - BULK_HEADER_SIZE));
+    return true;
+}
+
+/**
+ * @brief Main function of the microbenchmarks.
+ * @return EXIT_SUCCESS if every selected case ran.
+ * @return EXIT_FAILURE if the options are invalid or a case could not be set up.
+ */
+int main(int argc, char *argv[]) {
+    MicrobenchmarkOptions options;
+    if (!parse_arguments(argc, argv, &options)) {
+        return EXIT_FAILURE;
+    }
+
+    bool completed = true;
+    begin_report(options.format, charset_kernel_name());
+    if (options.groups & GROUP_RNG) {
+        run_random_cases(&options);
+    }
+    run_password_cases(&options);
+    if (options.groups & GROUP_KERNEL) {
+        completed = run_kernel_cases(&options);
+    }
+    if (options.groups & GROUP_PARSE) {
+        run_parse_cases(&options);
+    }
+    if (options.groups & GROUP_VALIDATION) {
+        run_validation_cases(&options.measure, options.format);
+    }
+    if (options.groups & GROUP_COOKIE) {
+        completed = run_cookie_cases(&options) && completed;
+    }
+    if (options.groups & GROUP_TRACE) {
+        completed = run_trace_cases(&options) && completed;
+    }
+    if (options.groups & GROUP_SEAL) {
+        completed = run_seal_cases(&options) && completed;
+    }
+    end_report(options.format);
+    return completed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file measure.c
+ * @brief Implementation of the timing loop and the reports of the microbenchmarks.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#if defined WIN32
+#include <windows.h>        /**< Include QueryPerformanceCounter() */
+#else
+#include <time.h>           /**< Include clock_gettime() */
+#endif
+
+#include <stdio.h>
+#include "measure.h"
+
+/* - - - - - - - - - - - - - - - - - - - - MEASURE - - - - - - - - - - - - - - - - - - - - */
+
+static bool first_result = true;    /**< Whether no result has been printed yet (JSON commas) */
+
+/**
+ * @brief Returns a monotonic timestamp in nanoseconds.
+ */
+uint64_t monotonic_ns(void) {
+#if defined WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Runs `body` once and returns how long it took.
+ */
+static uint64_t time_run(CaseBody body, void *context, uint64_t iterations) {
+    uint64_t start = monotonic_ns();
+    body(context, iterations);
+    return monotonic_ns() - start;
+}
+
+/**
+ * @brief Calibrates and times a case.
+ * @details The calibration runs also warm up the caches, the branch predictors and the
+ *          per-thread RNG state before the timed repetitions.
+ */
+void measure_case(const MeasureOptions *options, CaseBody body, void *context, CaseResult *result) {
+    uint64_t iterations = 1;
+    while (time_run(body, context, iterations) < options->min_time_ns && iterations < (1ULL << 40)) {
+        iterations *= 2;
+    }
+
+    uint64_t best = UINT64_MAX;
+    for (unsigned int i = 0; i < options->repetitions; i++) {
+        uint64_t elapsed = time_run(body, context, iterations);
+        if (elapsed < best) {
+            best = elapsed;
+        }
+    }
+    result->iterations = iterations;
+    result->ns_per_op = (double)best / (double)iterations;
+}
+
+/**
+ * @brief Prints what comes before the first result.
+ */
+void begin_report(ReportFormat format, const char *kernel) {
+    first_result = true;
+    switch (format) {
+        case REPORT_CSV:
+            printf("group,name,variant,length,iterations,ns_per_op,chars_per_s\n");
+            break;
+        case REPORT_JSON:
+            printf("{\"kernel\": \"%s\", \"results\": [", kernel);
+            break;
+        case REPORT_TEXT:
+        default:
+            printf("Charset kernel: %s\n\n", kernel);
+            printf("%-10s %-24s %-12s %6s %12s %12s %14s\n",
+                   "group", "name", "variant", "length", "iterations", "ns/op", "chars/s");
+            break;
+    }
+    fflush(stdout);
+}
+
+/**
+ * @brief Prints one result, flushing it so that a long run shows its progress.
+ */
+void report_case(ReportFormat format, const CaseResult *result) {
+    switch (format) {
+        case REPORT_CSV:
+            printf("%s,%s,%s,%u,%llu,%.3f,%.0f\n", result->group, result->name, result->variant,
+                   result->length, (unsigned long long)result->iterations, result->ns_per_op, result->chars_per_s);
+            break;
+        case REPORT_JSON:
+            printf("%s\n  {\"group\": \"%s\", \"name\": \"%s\", \"variant\": \"%s\", \"length\": %u, "
+                   "\"iterations\": %llu, \"ns_per_op\": %.3f, \"chars_per_s\": %.0f}",
+                   first_result ? "" : ",", result->group, result->name, result->variant, result->length,
+                   (unsigned long long)result->iterations, result->ns_per_op, result->chars_per_s);
+            break;
+        case REPORT_TEXT:
+        default:
+            printf("%-10s %-24s %-12s %6u %12llu %12.1f %14.0f\n", result->group, result->name, result->variant,
+                   result->length, (unsigned long long)result->iterations, result->ns_per_op, result->chars_per_s);
+            break;
+    }
+    first_result = false;
+    fflush(stdout);
+}
+
+/**
+ * @brief Prints what comes after the last result.
+ */
+void end_report(ReportFormat format) {
+    if (format == REPORT_JSON) {
+        printf("\n]}\n");
+    }
+}
+
+/* - - - - - - - - - - - - - - - - - - - END MEASURE - - - - - - - - - - - - - - - - - - - */
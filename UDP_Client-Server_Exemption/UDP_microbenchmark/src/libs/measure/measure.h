@@ -0,0 +1,113 @@
+/**
+ * @file measure.h
+ * @brief Header file declaring the timing loop and the reports of the microbenchmarks.
+ *
+ * A case is a function that runs the code under test a given number of times. It is first
+ * calibrated, doubling the iterations until one run lasts at least the minimum time, and then
+ * run `repetitions` times with that count; the fastest repetition is kept, since noise from
+ * the scheduler, the caches or the frequency governor can only make a run slower.
+ *
+ * Results are printed as they are measured, as an aligned text table, CSV with a header line
+ * or a JSON object whose `results` array holds one object per case, so that two runs can be
+ * compared by a script: a change is a win if no case regresses.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef MEASURE_H_
+#define MEASURE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* - - - - - - - - - - - - - - - - - - - - MEASURE - - - - - - - - - - - - - - - - - - - - */
+
+#define DEFAULT_MIN_TIME_MS 10          /**< Minimum length of one repetition */
+#define DEFAULT_REPETITIONS 3           /**< Repetitions of every case */
+
+/**
+ * @brief Function running the code under test `iterations` times.
+ *
+ * @param[in,out] context The pointer given to `measure_case`.
+ * @param[in] iterations Number of operations to run.
+ */
+typedef void (*CaseBody)(void *context, uint64_t iterations);
+
+/**
+ * @struct MeasureOptions
+ * @brief Settings of the timing loop.
+ */
+typedef struct {
+    uint64_t min_time_ns;       /**< Minimum length of one repetition */
+    unsigned int repetitions;   /**< Repetitions of every case, the fastest being kept */
+} MeasureOptions;
+
+/**
+ * @struct CaseResult
+ * @brief Outcome of one case.
+ */
+typedef struct {
+    const char *group;          /**< Family of the case, e.g. `generator` or `kernel` */
+    const char *name;           /**< Function under test */
+    const char *variant;        /**< RNG backend, kernel or input of the case */
+    unsigned int length;        /**< Password length, or bytes per call; 0 if it does not apply */
+    uint64_t iterations;        /**< Operations per repetition */
+    double ns_per_op;           /**< Nanoseconds per operation in the fastest repetition */
+    double chars_per_s;         /**< Characters (bytes for the RNG) produced per second, 0 if none */
+} CaseResult;
+
+/**
+ * @enum ReportFormat
+ * @brief Formats the results can be printed in.
+ */
+typedef enum {
+    REPORT_TEXT,    /**< Aligned table */
+    REPORT_CSV,     /**< Header line and one line per case */
+    REPORT_JSON     /**< Single JSON object */
+} ReportFormat;
+
+/**
+ * @brief Returns a monotonic timestamp in nanoseconds.
+ *
+ * @return The current time.
+ */
+uint64_t monotonic_ns(void);
+
+/**
+ * @brief Calibrates and times a case.
+ *
+ * @param[in] options The timing settings.
+ * @param[in] body The code under test.
+ * @param[in,out] context Passed unchanged to `body`.
+ * @param[out] result Receives `iterations` and `ns_per_op`; the other fields are left alone.
+ */
+void measure_case(const MeasureOptions *options, CaseBody body, void *context, CaseResult *result);
+
+/**
+ * @brief Prints what comes before the first result.
+ *
+ * @param[in] format The output format.
+ * @param[in] kernel Name of the charset kernel selected at compile time.
+ */
+void begin_report(ReportFormat format, const char *kernel);
+
+/**
+ * @brief Prints one result.
+ *
+ * @param[in] format The output format.
+ * @param[in] result The result.
+ */
+void report_case(ReportFormat format, const CaseResult *result);
+
+/**
+ * @brief Prints what comes after the last result.
+ *
+ * @param[in] format The output format.
+ */
+void end_report(ReportFormat format);
+
+/* - - - - - - - - - - - - - - - - - - - END MEASURE - - - - - - - - - - - - - - - - - - - */
+
+#endif /* MEASURE_H_ */
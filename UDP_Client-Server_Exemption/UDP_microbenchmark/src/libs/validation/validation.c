@@ -0,0 +1,74 @@
+/**
+ * @file validation.c
+ * @brief Implementation of the microbenchmarks of the input checks of the client.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#include <stddef.h>
+#include "validation.h"
+#include "../../../../UDP_core/src/libs/checks/checks.h"
+#include "../../../../UDP_core/src/libs/protocol/protocol.h"
+
+/* - - - - - - - - - - - - - - - - - - - VALIDATION - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @struct CheckInput
+ * @brief Input of one validation case.
+ */
+typedef struct {
+    const char *name;           /**< Function under test */
+    const char *variant;        /**< Kind of input */
+    const char *text;           /**< Length text given to `control_length` */
+    char type;                  /**< Type letter given to `control_type` */
+} CheckInput;
+
+static volatile unsigned int accepted; /**< Keeps the results alive */
+
+/**
+ * @brief Runs `control_type` on the input of the case.
+ */
+static void run_control_type(void *context, uint64_t iterations) {
+    const CheckInput *volatile input = context; /**< Reloaded at every call: no hoisting */
+    unsigned int count = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        count += control_type("namsu", input->type);
+    }
+    accepted = count;
+}
+
+/**
+ * @brief Runs `control_length` on the input of the case.
+ */
+static void run_control_length(void *context, uint64_t iterations) {
+    const CheckInput *volatile input = context;
+    unsigned int count = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        count += control_length(input->text, MIN_PASSWORD_LENGTH, MAX_PASSWORD_LENGTH);
+    }
+    accepted = count;
+}
+
+/**
+ * @brief Measures and reports the `validation` cases.
+ */
+void run_validation_cases(const MeasureOptions *options, ReportFormat format) {
+    static const CheckInput inputs[] = {
+        { "control_type", "valid", NULL, 's' },
+        { "control_type", "invalid", NULL, 'x' },
+        { "control_length", "valid", "16", '\0' },
+        { "control_length", "range", "99", '\0' },
+        { "control_length", "nondigit", "1a", '\0' },
+    };
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        CaseResult result = { "validation", inputs[i].name, inputs[i].variant, 0, 0, 0.0, 0.0 };
+        measure_case(options, inputs[i].text == NULL ? run_control_type : run_control_length,
+                     (void *)&inputs[i], &result);
+        report_case(format, &result);
+    }
+}
+
+/* - - - - - - - - - - - - - - - - - - END VALIDATION - - - - - - - - - - - - - - - - - - */
@@ -0,0 +1,31 @@
+/**
+ * @file validation.h
+ * @brief Header file declaring the microbenchmarks of the input checks of the client.
+ *
+ * `control_type` and `control_length` validate every request typed by the user before it is
+ * sent. They are measured in their own translation unit because the client and the server
+ * each have a `password.h` of their own, which cannot be included together.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef VALIDATION_H_
+#define VALIDATION_H_
+
+#include "../measure/measure.h"
+
+/* - - - - - - - - - - - - - - - - - - - VALIDATION - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Measures and reports the `validation` cases.
+ *
+ * @param[in] options The timing settings.
+ * @param[in] format The output format.
+ */
+void run_validation_cases(const MeasureOptions *options, ReportFormat format);
+
+/* - - - - - - - - - - - - - - - - - - END VALIDATION - - - - - - - - - - - - - - - - - - */
+
+#endif /* VALIDATION_H_ */
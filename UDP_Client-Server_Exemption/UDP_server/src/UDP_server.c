@@ -7,8 +7,20 @@
  * @author Michele Camassa
  */
 
+#if defined __linux__
+#define _GNU_SOURCE         /**< Exposes recvmmsg(), sendmmsg() and pthread_setaffinity_np() */
+#endif
+
 #if defined WIN32
-#include <winsock.h> 		/**< Includes the Winsock header for Windows */
+#include <winsock2.h> 		/**< Includes the Winsock 2 header for Windows */
+#include <ws2tcpip.h> 		/**< Includes getaddrinfo() and struct sockaddr_storage */
+#include <mstcpip.h> 		/**< Includes SIO_UDP_CONNRESET and SIO_UDP_NETRESET */
+#if !defined SIO_UDP_CONNRESET
+#define SIO_UDP_CONNRESET _WSAIOW(IOC_VENDOR, 12)   /**< Missing from older MinGW headers */
+#endif
+#if !defined SIO_UDP_NETRESET
+#define SIO_UDP_NETRESET _WSAIOW(IOC_VENDOR, 15)
+#endif
 #else
 #include <unistd.h>  		/**< Includes the standard UNIX header for close() */
 #include <sys/socket.h>  	/**< Includes the socket library for UNIX */
@@ -21,14 +33,43 @@
 
 #include <stdio.h>
 #include <ctype.h>
+#include <signal.h>          /**< Includes sig_atomic_t everywhere, and sigaction() on UNIX */
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>         /**< Includes POSIX threads for the workers */
+#include <stdatomic.h>       /**< Includes the atomics of the drain state */
 
-#include "libs/password/password.h"  /**< Includes the header for password generation functions */
-#include "libs/protocol/protocol.h"  /**< Includes protocol definitions for communication */
-#include "libs/utils/utils.h"    	 /**< Includes utility functions */
+#include "../../UDP_core/src/libs/chacha20/chacha20.h" /**< Includes the self-test of the ChaCha20 block function */
+#include "../../UDP_core/src/libs/password/password.h" /**< Includes the header for password generation functions */
+#include "../../UDP_core/src/libs/protocol/protocol.h" /**< Includes protocol definitions for communication */
+#include "../../UDP_core/src/libs/random/random.h"     /**< Includes the random byte source used by the generators */
+#include "../../UDP_core/src/libs/seal/seal.h"         /**< Includes the ChaCha20-Poly1305 sealing of the responses */
+#include "../../UDP_core/src/libs/utils/utils.h"       /**< Includes utility functions */
 
+#include "libs/address/address.h"                      /**< Includes the IPv4/IPv6 address helpers */
+#include "libs/config/config.h"                        /**< Includes the runtime configuration and its live reload */
+#include "libs/cookie/cookie.h"                        /**< Includes the stateless anti-spoofing cookies */
+#include "libs/event/event.h"                          /**< Includes the event loop driving the sockets and timers */
+#include "libs/handler/handler.h"                      /**< Includes the decoding and answering of a single request */
+#include "libs/log/log.h"                              /**< Includes the asynchronous access log */
+#include "libs/metrics/metrics.h"                      /**< Includes the per-worker counters */
+#include "libs/policy/policy.h"                        /**< Includes the registry of password policies */
+#include "libs/ratelimit/ratelimit.h"                  /**< Includes the per-source token buckets */
+#include "libs/reservoir/reservoir.h"                  /**< Includes the reservoir of pre-generated passwords */
+#include "libs/slots/slots.h"                          /**< Includes the preallocated request/response slots */
+#include "libs/trace/trace.h"                          /**< Includes the sampled tracing of the request path */
+#include "libs/tuning/tuning.h"                        /**< Includes the socket buffers, busy-polling and GRO/GSO options */
+#include "libs/uring/uring.h"                          /**< Includes the io_uring data path (Linux only) */
+
+_Static_assert(MAX_RESPONSE_SIZE + 1 <= SLOT_RESPONSE_SIZE && sizeof(LegacyPasswordResponse) <= SLOT_RESPONSE_SIZE,
+               "A response and its terminator must fit in a slot");
+_Static_assert(MAX_REQUEST_SIZE <= SLOT_REQUEST_SIZE, "A v2 request must fit in a slot");
+_Static_assert(BULK_COOKIE_CHALLENGE_SIZE <= SLOT_RESPONSE_SIZE, "A cookie challenge must fit in a slot");
+
+#define LIFECYCLE_INTERVAL_MS 100    /**< Period of the reload and drain checks of every loop */
+#define DEFAULT_DRAIN_GRACE_MS 1000  /**< Default time a drain keeps answering the queued requests */
 
 /**
  * @brief Cleans up the Winsock library (Windows only).
@@ -55,11 +96,12 @@ void error_handler(const char *error_message) {
 /**
  * @brief Creates and initializes a UDP socket.
  * @details This function creates a socket for communication using the UDP protocol.
+ * @param[in] family `AF_INET` or `AF_INET6`.
  * @return >=0 The socket descriptor if socket creation is successful.
  * @return -1 If there is an error creating the socket.
  */
-int initialize_socket() {
-    int created_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+int initialize_socket(int family) {
+    int created_socket = socket(family, SOCK_DGRAM, IPPROTO_UDP);
     if (created_socket < 0) {
         error_handler("Error creating the socket.\n");
     }
@@ -67,88 +109,1831 @@ int initialize_socket() {
 }
 
 /**
- * @brief Sets up the server address structure.
- * @param[out] server_address Pointer to the sockaddr_in structure to configure.
- * @pre `server_address` must be a valid pointer.
- * @post The `server_address` structure is configured with default values.
+ * @brief Counts a socket error that only affected one datagram or peer.
+ * @details It is not printed: an ICMP storm from departed clients would flood the terminal.
  */
-void setup_server_address(struct sockaddr_in *server_address) {
-    memset(server_address, 0, sizeof(*server_address));			/**< Clears the structure */
-    server_address->sin_family = AF_INET;						/**< Sets the address family to AF_INET (IPv4) */
-    server_address->sin_port = htons(DEFAULT_PORT);				/**< Sets the server's port, converted to network byte order */
-    server_address->sin_addr.s_addr = inet_addr(DEFAULT_IP);	/**< Sets the server's IP address */
+void count_transient_error(void) {
+    count_metric(METRIC_TRANSIENT_ERRORS, 1);
+    log_message(LOG_DEBUG, "Transient socket error skipped");
 }
 
 /**
- * @brief Processes a password generation request and generates the password.
- * @param[in] request Pointer to the PasswordRequest structure containing the client input.
- * @param[out] response Pointer to the PasswordResponse structure to store the generated password.
- * @pre `request` and `response` must be valid and initialized pointers.
- * @post The `response` structure is populated with the generated password.
+ * @struct ServeContext
+ * @brief State of the handler of one data socket of a worker.
  */
-void handle_password_request(const PasswordRequest *request, PasswordResponse *response) {
-	int numerical_length = atoi(request->length);
-	PasswordType password_type;
+typedef struct {
+    SlotPool pool;            /**< Request/response slots of the socket */
+    unsigned int batch_size;  /**< Datagrams per `recvmmsg`/`sendmmsg` call */
+    int server_socket;        /**< Data socket, used directly by the bulk responses */
+    RateLimiter *limiter;     /**< Token buckets of the sources seen by the worker, shared by its sockets */
+    uint32_t queue_drops;     /**< Receive queue overflow counter already counted */
+    int64_t kernel_time_ns;   /**< Kernel receive time of the latest datagram (`SO_TIMESTAMPING`), 0 if none */
+#if defined __linux__
+    Uring ring;               /**< io_uring of the socket, `ring_fd` -1 if unused */
+    uint8_t *coalesced;       /**< GRO receive buffer of `TUNING_COALESCED_SIZE` bytes, NULL without GRO */
+    uint32_t coalesced_size;  /**< Bytes received in `coalesced` */
+    uint32_t coalesced_offset; /**< Start of the next datagram in `coalesced` */
+    uint16_t segment_size;    /**< Size of the datagrams in `coalesced` */
+    uint8_t *segments;        /**< GSO send buffer of `TUNING_COALESCED_SIZE` bytes, NULL without GSO */
+#endif
+} ServeContext;
 
-	switch (tolower(request->type)) {
-		case 'n': password_type = NUMERIC; break;
-		case 'a': password_type = ALPHA; break;
-		case 'm': password_type = MIXED; break;
-		case 's': password_type = SECURE; break;
-		case 'u': password_type = UNAMBIGUOUS; break;
-		default: password_type = NUMERIC; break;
-	}
-	generate_password(response->password, password_type, numerical_length);
+/**
+ * @brief Counts the datagrams the kernel dropped since the last reported overflow counter.
+ * @param[in,out] serve The ServeContext of the data socket.
+ * @param[in] queue_drops The counter received with the latest datagram (`SO_RXQ_OVFL`).
+ */
+void count_queue_drops(ServeContext *serve, uint32_t queue_drops) {
+    if ((int32_t)(queue_drops - serve->queue_drops) > 0) { /**< Older datagrams carry older counters */
+        count_metric(METRIC_QUEUE_DROPS, queue_drops - serve->queue_drops);
+        serve->queue_drops = queue_drops;
+    }
 }
 
 /**
- * @brief Sends a response containing the password to the client.
+ * @brief Sends an already encoded datagram to the client.
  * @param[in] server_socket The server's socket descriptor.
- * @param[in] response_msg Pointer to the PasswordResponse structure to send.
- * @param[in] client_address Pointer to the sockaddr_in structure containing the client's address.
- * @return `true` if the response was sent successfully, `false` otherwise.
- * @pre `server_socket` must be a valid UDP socket.
- * @pre `response_msg` and `client_address` must be valid pointers.
- * @post The client receives the response with the password if the sending is successful.
+ * @param[in] datagram The bytes to send.
+ * @param[in] datagram_size Number of bytes to send; 0 reports an encoding error.
+ * @param[in] client_address Pointer to the client's IPv4 or IPv6 address.
+ * @return `true` if the whole datagram was sent, or dropped because the send buffer is full or
+ *         the client cannot be reached; `false` if the socket failed.
  */
-bool send_response(int server_socket, const PasswordResponse *response_msg, const struct sockaddr_in *client_address) {
-    if (sendto(server_socket, response_msg, sizeof(*response_msg), 0,
-               (struct sockaddr *)client_address, sizeof(*client_address)) != sizeof(*response_msg)) {
+bool send_datagram(int server_socket, const uint8_t *datagram, size_t datagram_size,
+                   const struct sockaddr_storage *client_address) {
+    int sent = -1;
+    if (datagram_size != 0) {
+        do {
+            sent = sendto(server_socket, (const char *)datagram, datagram_size, 0,
+                          (const struct sockaddr *)client_address, address_size(client_address));
+        } while (sent < 0 && last_socket_result() == IO_INTERRUPTED);
+    }
+    IoResult result = sent < 0 && datagram_size != 0 ? last_socket_result() : IO_DONE;
+    if (result == IO_AGAIN || result == IO_TRANSIENT) {
+        count_metric(METRIC_SEND_ERRORS, 1); /**< Dropped, as the network would */
+        if (result == IO_TRANSIENT) {
+            count_transient_error();
+        }
+        return true;
+    }
+    if (sent != (int)datagram_size) {
+        count_metric(METRIC_SEND_ERRORS, 1);
         error_handler("Error sending the response (Generated password).\n");
         return false;
     }
+    count_metric(METRIC_BYTES_OUT, datagram_size);
     return true;
 }
 
+#if defined __linux__
 /**
- * @brief Receives a password generation request from the client.
- * @param[in] server_socket The server's socket descriptor.
- * @param[out] request_msg Pointer to the PasswordRequest structure to store the client's request.
- * @param[out] client_address Pointer to the sockaddr_in structure to store the client's address.
- * @return `true` if the request was received successfully, `false` otherwise.
+ * @brief Sends the datagrams built back to back in the GSO buffer with one `UDP_SEGMENT` send.
+ * @details If the device or the kernel refuses the segmentation, GSO is turned off for the
+ *          socket and the datagrams are sent one by one.
+ * @param[in,out] serve The ServeContext of the data socket.
+ * @param[in] size Bytes to send from `serve->segments`.
+ * @param[in] segment_size Size of every datagram but the last.
+ * @param[in] client_address Pointer to the client's IPv4 or IPv6 address.
+ * @return `true` if the datagrams were sent or dropped like `send_datagram` drops them.
+ */
+bool send_bulk_segments(ServeContext *serve, size_t size, uint16_t segment_size,
+                        const struct sockaddr_storage *client_address) {
+    unsigned int segments = (unsigned int)((size + segment_size - 1) / segment_size);
+    bool refused = false;
+    if (segments > 1) {
+        int sent;
+        do {
+            sent = send_segments(serve->server_socket, serve->segments, size, segment_size, client_address);
+        } while (sent < 0 && last_socket_result() == IO_INTERRUPTED);
+        if (sent == (int)size) {
+            count_metric(METRIC_BYTES_OUT, size);
+            return true;
+        }
+        IoResult result = sent < 0 ? last_socket_result() : IO_ERROR;
+        if (result == IO_AGAIN || result == IO_TRANSIENT) {
+            count_metric(METRIC_SEND_ERRORS, segments);
+            if (result == IO_TRANSIENT) {
+                count_transient_error();
+            }
+            return true;
+        }
+        refused = true; /**< e.g. EIO from a device without checksum offload */
+    }
+
+    bool sent_all = true;
+    for (size_t offset = 0; sent_all && offset < size; offset += segment_size) {
+        size_t datagram_size = size - offset < segment_size ? size - offset : segment_size;
+        sent_all = send_datagram(serve->server_socket, serve->segments + offset, datagram_size, client_address);
+    }
+    if (refused) {
+        free(serve->segments);
+        serve->segments = NULL;
+        log_message(LOG_WARNING, "UDP_SEGMENT send failed, sending bulk responses one datagram at a time");
+    }
+    return sent_all;
+}
+#endif
+
+/**
+ * @brief Number of passwords of a bulk request packed in each datagram.
+ */
+static unsigned int bulk_per_datagram(const PasswordRequest *request) {
+    return (unsigned int)((MAX_DATAGRAM_SIZE - BULK_HEADER_SIZE - seal_response_overhead(request)) / request->length);
+}
+
+/**
+ * @brief Number of datagrams `send_bulk_response` sends for a request: 1 for an invalid one.
+ */
+static unsigned int bulk_datagram_count(const PasswordRequest *request) {
+    if (request->length == 0 || request->length > MAX_PASSWORD_LENGTH ||
+        request->count == 0 || request->count > current_config()->max_count) {
+        return 1;
+    }
+    unsigned int per_datagram = bulk_per_datagram(request);
+    return (request->count + per_datagram - 1) / per_datagram;
+}
+
+/**
+ * @brief Generates the passwords of a bulk request and sends them in numbered datagrams.
+ * @details As many passwords as fit in `MAX_DATAGRAM_SIZE` are packed back to back in each
+ *          datagram, so a single datagram carries up to 97 passwords of 15 characters. If the
+ *          length, the count or the policy is invalid, a single datagram with the error status is sent.
+ *          A sealed request gets every datagram sealed on its own, so the client opens them in any order.
+ *          With GSO the datagrams are built back to back and handed to the kernel together,
+ *          up to `TUNING_MAX_SEGMENTS` per call.
+ * @param[in,out] serve The ServeContext of the data socket.
+ * @param[in] request Pointer to the bulk PasswordRequest.
+ * @param[in] client_address Pointer to the client's IPv4 or IPv6 address.
+ * @return `true` if every datagram was sent successfully, `false` otherwise.
+ */
+bool send_bulk_response(ServeContext *serve, const PasswordRequest *request, const struct sockaddr_storage *client_address) {
+    uint8_t datagram[MAX_DATAGRAM_SIZE + 1];  /**< One extra byte for the terminator of the last password */
+    int server_socket = serve->server_socket;
+    BulkResponseHeader header;
+
+    header.status = STATUS_OK;
+    header.length = request->length;
+    header.flags = request->flags;
+    header.request_id = request->request_id;
+    header.sequence = 0;
+    header.total = 1;
+    header.items = 0;
+
+    PasswordSource source;
+    header.status = (uint8_t)resolve_password_source(request, &source);
+    if (header.status == STATUS_OK && (request->count == 0 || request->count > current_config()->max_count)) {
+        header.status = STATUS_INVALID_COUNT;
+    }
+    count_metric(METRIC_BULK, 1);
+    if (header.status != STATUS_OK) {
+        count_metric(METRIC_INVALID, 1);
+        header.length = 0;
+        size_t datagram_size = encode_bulk_header(&header, datagram, sizeof(datagram));
+        datagram_size = seal_response(request, datagram, BULK_HEADER_SIZE, datagram_size);
+        return send_datagram(server_socket, datagram, datagram_size, client_address);
+    }
+
+    size_t trailer = seal_response_overhead(request);
+    unsigned int per_datagram = bulk_per_datagram(request);
+    unsigned int remaining = request->count;
+    header.total = (uint16_t)((remaining + per_datagram - 1) / per_datagram);
+
+#if defined __linux__
+    size_t segment_size = BULK_HEADER_SIZE + (size_t)per_datagram * request->length + trailer;
+    unsigned int per_send = (unsigned int)((TUNING_COALESCED_SIZE - 1) / segment_size); /**< Room for a terminator */
+    per_send = per_send < TUNING_MAX_SEGMENTS ? per_send : TUNING_MAX_SEGMENTS;
+    size_t used = 0;
+    while (serve->segments != NULL && header.total > 1 && header.sequence < header.total) {
+        header.items = (uint16_t)(remaining < per_datagram ? remaining : per_datagram);
+        uint8_t *segment = serve->segments + used;
+        size_t segment_used = encode_bulk_header(&header, segment, TUNING_COALESCED_SIZE - used);
+        for (unsigned int i = 0; i < header.items; i++) {
+            fill_source_password((char *)segment + segment_used, &source, request->length);
+            segment_used += request->length;
+        }
+        used += seal_response(request, segment, BULK_HEADER_SIZE, segment_used);
+        remaining -= header.items;
+        header.sequence++;
+        if (header.sequence % per_send == 0 || header.sequence == header.total) {
+            if (!send_bulk_segments(serve, used, (uint16_t)segment_size, client_address)) {
+                return false;
+            }
+            used = 0; /**< Without GSO any more, the classic loop sends the rest */
+        }
+    }
+#endif
+
+    for (; header.sequence < header.total; header.sequence++) {
+        header.items = (uint16_t)(remaining < per_datagram ? remaining : per_datagram);
+        size_t datagram_size = encode_bulk_header(&header, datagram, sizeof(datagram));
+        for (unsigned int i = 0; i < header.items; i++) {
+            fill_source_password((char *)datagram + datagram_size, &source, request->length);
+            datagram_size += request->length;
+        }
+        datagram_size = seal_response(request, datagram, BULK_HEADER_SIZE, datagram_size);
+        if (!send_datagram(server_socket, datagram, datagram_size, client_address)) {
+            return false;
+        }
+        remaining -= header.items;
+    }
+    return true;
+}
+
+#if defined __linux__
+/**
+ * @brief Moves the next datagram of the GRO buffer into a slot.
+ * @details Every datagram of a coalesced buffer comes from the same sender, whose address is
+ *          already in the slot.
+ */
+void take_coalesced(ServeContext *serve, Slot *slot) {
+    uint32_t size = serve->coalesced_size - serve->coalesced_offset;
+    size = size < serve->segment_size ? size : serve->segment_size;
+    count_metric(METRIC_BYTES_IN, size);
+    slot->request_size = size < sizeof(slot->request) ? size : (uint32_t)sizeof(slot->request);
+    memcpy(slot->request, serve->coalesced + serve->coalesced_offset, slot->request_size);
+    serve->coalesced_offset += size;
+}
+#endif
+
+/**
+ * @brief Receives a password generation request from the client into a slot.
+ * @details Datagrams longer than `SLOT_REQUEST_SIZE` (v1 requests) are truncated, which does
+ *          not change how they are decoded. On Linux the datagram is read with `recvmsg` to get
+ *          the queue overflow counter; with GRO, a coalesced buffer is received once and its
+ *          datagrams are then returned one per call without touching the socket.
+ * @param[in,out] serve The ServeContext of the data socket.
+ * @param[in] server_socket The server's non-blocking socket descriptor.
+ * @param[out] slot The slot that receives the request bytes, their size and the client's address.
+ * @return `IO_DONE` if a request was received, `IO_AGAIN` if the socket is drained,
+ *         `IO_INTERRUPTED` if the call must be repeated, `IO_TRANSIENT` if it reported an error
+ *         left by an earlier datagram (counted), `IO_ERROR` if the socket failed.
  * @pre `server_socket` must be a valid UDP socket.
- * @pre `request_msg` and `client_address` must be valid pointers.
- * @post The `request_msg` and `client_address` structures are populated with the client's data if receiving is successful.
  */
-bool receive_request(int server_socket, PasswordRequest *request_msg, struct sockaddr_in *client_address) {
-    unsigned int client_address_size = sizeof(*client_address);
-    int rcv_msg_size = recvfrom(server_socket, request_msg, sizeof(*request_msg), 0,
-                                (struct sockaddr *)client_address, &client_address_size);
+IoResult receive_request(ServeContext *serve, int server_socket, Slot *slot) {
+#if defined __linux__
+    if (serve->coalesced_offset < serve->coalesced_size) {
+        take_coalesced(serve, slot);
+        return IO_DONE;
+    }
+
+    union {
+        struct cmsghdr header;                      /**< Aligns the buffer */
+        uint8_t bytes[TUNING_CONTROL_SIZE];
+    } control;
+    struct iovec vector;
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    vector.iov_base = serve->coalesced != NULL ? serve->coalesced : slot->request;
+    vector.iov_len = serve->coalesced != NULL ? TUNING_COALESCED_SIZE : sizeof(slot->request);
+    message.msg_name = &slot->client_address;
+    message.msg_namelen = sizeof(slot->client_address);
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control.bytes;
+    message.msg_controllen = sizeof(control.bytes);
+    int rcv_msg_size = (int)recvmsg(server_socket, &message, 0);
+#else
+    (void)serve;
+    socklen_t client_address_size = sizeof(slot->client_address);
+    int rcv_msg_size = recvfrom(server_socket, (char *)slot->request, sizeof(slot->request), 0,
+                                (struct sockaddr *)&slot->client_address, &client_address_size);
+#endif
+#if defined WIN32
+    if (rcv_msg_size < 0 && WSAGetLastError() == WSAEMSGSIZE) {
+        rcv_msg_size = sizeof(slot->request); /**< Winsock reports truncation as an error */
+    }
+#endif
     if (rcv_msg_size < 0) {
+        IoResult result = last_socket_result();
+        if (result == IO_TRANSIENT) {
+            count_transient_error();
+        } else if (result == IO_ERROR) {
+            count_metric(METRIC_RECEIVE_ERRORS, 1);
+            error_handler("Error receiving the request (Password settings).\n");
+        }
+        return result;
+    }
+
+#if defined __linux__
+    uint32_t queue_drops = serve->queue_drops;
+    uint16_t segment_size = 0;
+    serve->kernel_time_ns = 0;
+    read_receive_control(&message, &queue_drops, &segment_size, &serve->kernel_time_ns);
+    count_queue_drops(serve, queue_drops);
+    if (serve->coalesced != NULL) {
+        serve->coalesced_size = (uint32_t)rcv_msg_size;
+        serve->coalesced_offset = 0;
+        serve->segment_size = segment_size != 0 ? segment_size : (uint16_t)rcv_msg_size;
+        take_coalesced(serve, slot);
+        return IO_DONE;
+    }
+#endif
+    slot->request_size = (uint32_t)rcv_msg_size;
+    count_metric(METRIC_BYTES_IN, slot->request_size);
+    return IO_DONE;
+}
+
+/**
+ * @brief Applies the rate limit of the worker to the sender of a received slot.
+ * @param[in,out] serve The ServeContext of the data socket.
+ * @param[in] slot The received slot.
+ * @param[in] now_ms Current monotonic time in milliseconds.
+ * @return `true` if the request must be served, `false` if it is dropped.
+ */
+bool admit_request(ServeContext *serve, const Slot *slot, uint32_t now_ms) {
+    if (allow_request(serve->limiter, address_key(&slot->client_address), now_ms, 1)) {
+        return true;
+    }
+    count_metric(METRIC_RATE_LIMITED, 1);
+    return false;
+}
+
+/**
+ * @brief Charges the sender of a bulk request for the datagrams of its response.
+ * @details `admit_request` already took the token of the first datagram; the limit thus
+ *          bounds the datagrams sent to an address, not the requests received from it.
+ * @param[in,out] serve The ServeContext of the data socket.
+ * @param[in] slot The received slot.
+ * @param[in] request The decoded bulk request, its cookie checked.
+ * @param[in] now_ms Current monotonic time in milliseconds.
+ * @return `true` if the response must be sent, `false` if the request is dropped.
+ */
+bool admit_bulk_response(ServeContext *serve, const Slot *slot, const PasswordRequest *request, uint32_t now_ms) {
+    unsigned int datagrams = bulk_datagram_count(request);
+    if (datagrams == 1 || allow_request(serve->limiter, address_key(&slot->client_address), now_ms, datagrams - 1)) {
+        return true;
+    }
+    count_metric(METRIC_RATE_LIMITED, 1);
+    return false;
+}
+
+/**
+ * @brief Applies the cookie check to a decoded request.
+ * @details A request without a valid cookie gets the challenge written into its slot, to be
+ *          sent in place of the answer, whatever it asked for: a forged source thus costs one
+ *          MAC and one datagram barely larger than its own.
+ * @param[in] request The decoded request.
+ * @param[in,out] slot The received slot; receives the challenge.
+ * @param[in] received_ns Monotonic time of the reception in nanoseconds; unlike the 32-bit
+ *            milliseconds of the rate limit, it does not wrap while the server runs.
+ * @return `COOKIE_VALID` if the request must be served, `COOKIE_CHALLENGE` if the slot holds the
+ *         challenge to send, `COOKIE_DROP` if the datagram is ignored.
+ */
+CookieVerdict challenge_sender(const PasswordRequest *request, Slot *slot, uint64_t received_ns) {
+    uint64_t now_ms = received_ns / 1000000;
+    CookieVerdict verdict = check_cookie(request, slot->request_size, &slot->client_address, now_ms);
+    if (verdict == COOKIE_CHALLENGE) {
+        slot->response_size = (uint32_t)encode_cookie_challenge(request, &slot->client_address, now_ms, slot->response);
+        count_metric(METRIC_COOKIE_CHALLENGES, 1);
+    } else if (verdict == COOKIE_DROP) {
+        count_metric(METRIC_COOKIE_DROPS, 1);
+    }
+    return verdict;
+}
+
+/**
+ * @brief Data socket handler answering one datagram at a time.
+ * @details Each request costs one `recvfrom` and one `sendto`; the socket is drained until
+ *          `recvfrom` would block. This is the portable path, used on Windows and whenever
+ *          batching is disabled. With GRO it is also the Linux path: one `recvmsg` then
+ *          returns a whole burst of a client, and its datagrams are answered one by one.
+ * @param[in] server_socket The readable server socket.
+ * @param[in] context Pointer to the ServeContext of the data socket.
+ * @return `false` when a socket error must stop the worker.
+ */
+bool drain_per_packet(int server_socket, void *context) {
+    ServeContext *serve = context;
+    Slot *slot = &serve->pool.slots[0];
+
+    while (true) {
+        IoResult result = receive_request(serve, server_socket, slot);
+        if (result == IO_AGAIN) {
+            return true;
+        }
+        if (result == IO_INTERRUPTED || result == IO_TRANSIENT) {
+            continue;
+        }
+        if (result == IO_ERROR) {
+            return false;
+        }
+        uint64_t received_ns = metrics_now_ns();
+        uint32_t now_ms = (uint32_t)(received_ns / 1000000);
+        TraceRecord *trace = start_trace(received_ns);
+        trace_kernel_time(trace, serve->kernel_time_ns);
+        if (!admit_request(serve, slot, now_ms)) {
+            continue;
+        }
+
+        PasswordRequest request;
+        parse_request_datagram(slot->request, slot->request_size, &request);
+        trace_request(trace, &request);
+
+        log_access(&slot->client_address, &request);
+        trace_point(trace, TRACE_LOGGED);
+
+        CookieVerdict verdict = challenge_sender(&request, slot, received_ns);
+        if (verdict == COOKIE_DROP) {
+            continue;
+        }
+        if (verdict == COOKIE_VALID && (request.flags & REQUEST_FLAG_BULK)) {
+            if (!admit_bulk_response(serve, slot, &request, now_ms)) {
+                continue;
+            }
+            bool sent = send_bulk_response(serve, &request, &slot->client_address);
+            trace_point(trace, TRACE_HANDLED);
+            finish_traces();
+            if (!sent) {
+                return false;
+            }
+            continue;
+        }
+
+        if (verdict == COOKIE_VALID) {
+            uint64_t started = metrics_now_ns();
+            slot->response_size = (uint32_t)answer_request(&request, slot->request, slot->request_size, slot->response);
+            record_handle_time(metrics_now_ns() - started);
+        }
+        trace_point(trace, TRACE_HANDLED);
+
+        bool sent = send_datagram(server_socket, slot->response, slot->response_size, &slot->client_address);
+        finish_traces();
+        if (!sent) {
+            return false;
+        }
+    }
+}
+
+#if defined __linux__
+/**
+ * @brief Sets the kernel receive time of a traced request from the ancillary data of its datagram.
+ * @param[in,out] trace The record of the request, or NULL if it is not traced.
+ * @param[in] message The receive header of the datagram.
+ */
+void trace_message_kernel_time(TraceRecord *trace, const struct msghdr *message) {
+    if (trace != NULL) {
+        uint32_t queue_drops = 0;
+        uint16_t segment_size = 0;
+        int64_t kernel_time_ns = 0;
+        read_receive_control(message, &queue_drops, &segment_size, &kernel_time_ns);
+        trace_kernel_time(trace, kernel_time_ns);
+    }
+}
+
+/**
+ * @brief Data socket handler answering datagrams in batches with `recvmmsg`/`sendmmsg` (Linux only).
+ * @details Up to `batch_size` datagrams are drained per `recvmmsg` call. Every datagram is
+ *          received into, parsed from and answered in its own slot, whose `iovec`s are handed to
+ *          `sendmmsg` unchanged. A short batch means the queue was empty, so with an
+ *          edge-triggered loop the next datagram raises a new event and the handler returns
+ *          without paying for a last `recvmmsg` that would only report `EAGAIN`.
+ * @param[in] server_socket The readable server socket.
+ * @param[in] context Pointer to the ServeContext of the data socket.
+ * @return `false` when a socket error must stop the worker.
+ */
+bool drain_batched(int server_socket, void *context) {
+    ServeContext *serve = context;
+    SlotPool *pool = &serve->pool;
+    unsigned int batch_size = serve->batch_size;
+    bool healthy = true;
+    int received = (int)batch_size;
+
+    while (healthy && received == (int)batch_size) {
+        prepare_slot_receive(pool, batch_size);
+
+        received = recvmmsg(server_socket, pool->rx_messages, batch_size, MSG_DONTWAIT, NULL);
+        if (received < 0) {
+            IoResult result = last_socket_result();
+            if (result == IO_INTERRUPTED || result == IO_TRANSIENT) {
+                if (result == IO_TRANSIENT) {
+                    count_transient_error();
+                }
+                received = (int)batch_size;
+                continue;
+            }
+            if (result == IO_AGAIN) {
+                return true;
+            }
+            count_metric(METRIC_RECEIVE_ERRORS, 1);
+            error_handler("Error receiving the request (Password settings).\n");
+            return false;
+        }
+
+        uint32_t queue_drops = serve->queue_drops;
+        uint16_t segment_size = 0;
+        if (received > 0) {
+            int64_t kernel_time_ns = 0;
+            read_receive_control(&pool->rx_messages[received - 1].msg_hdr, &queue_drops, &segment_size,
+                                 &kernel_time_ns); /**< The latest counter */
+            count_queue_drops(serve, queue_drops);
+        }
+
+        unsigned int ready = 0;
+        uint64_t received_ns = metrics_now_ns();
+        uint32_t now_ms = (uint32_t)(received_ns / 1000000);
+        for (int i = 0; i < received; i++) {
+            Slot *slot = &pool->slots[i];
+            PasswordRequest request;
+
+            slot->request_size = pool->rx_messages[i].msg_len;
+            count_metric(METRIC_BYTES_IN, slot->request_size);
+            TraceRecord *trace = start_trace(received_ns);
+            trace_message_kernel_time(trace, &pool->rx_messages[i].msg_hdr);
+            if (!admit_request(serve, slot, now_ms)) {
+                continue;
+            }
+            parse_request_datagram(slot->request, slot->request_size, &request);
+            trace_request(trace, &request);
+            log_access(&slot->client_address, &request);
+            trace_point(trace, TRACE_LOGGED);
+
+            CookieVerdict verdict = challenge_sender(&request, slot, received_ns);
+            if (verdict == COOKIE_DROP) {
+                continue;
+            }
+            if (verdict == COOKIE_VALID && (request.flags & REQUEST_FLAG_BULK)) {
+                if (!admit_bulk_response(serve, slot, &request, now_ms)) {
+                    continue;
+                }
+                healthy = send_bulk_response(serve, &request, &slot->client_address) && healthy;
+                trace_point(trace, TRACE_HANDLED);
+                continue;
+            }
+
+            if (verdict == COOKIE_VALID) {
+                uint64_t started = metrics_now_ns();
+                slot->response_size = (uint32_t)answer_request(&request, slot->request, slot->request_size, slot->response);
+                record_handle_time(metrics_now_ns() - started);
+            }
+            trace_point(trace, TRACE_HANDLED);
+            queue_slot_response(pool, slot, ready++);
+        }
+
+        for (unsigned int sent = 0; sent < ready; ) {
+            int flushed = sendmmsg(server_socket, pool->tx_messages + sent, ready - sent, 0);
+            if (flushed < 0) {
+                IoResult result = last_socket_result();
+                if (result == IO_INTERRUPTED) {
+                    continue;
+                }
+                if (result == IO_TRANSIENT) {
+                    count_metric(METRIC_SEND_ERRORS, 1);
+                    count_transient_error();
+                    sent++; /**< `sendmmsg` failed on its first message: skip that client only */
+                    continue;
+                }
+                count_metric(METRIC_SEND_ERRORS, ready - sent);
+                if (result == IO_AGAIN) {
+                    break; /**< Full send buffer: the rest of the batch is dropped */
+                }
+                error_handler("Error sending the response (Generated password).\n");
+                healthy = false;
+                break;
+            }
+            for (int k = 0; k < flushed; k++) {
+                count_metric(METRIC_BYTES_OUT, pool->tx_messages[sent + k].msg_hdr.msg_iov->iov_len);
+            }
+            sent += flushed;
+        }
+        finish_traces();
+    }
+    return healthy;
+}
+
+/**
+ * @brief Ring descriptor handler answering the datagrams received by the io_uring (Linux only).
+ * @details Every pending completion is processed before the queued sends are submitted in a
+ *          single `io_uring_enter`. Bulk requests are rare and answered with plain `sendto`s.
+ * @param[in] ring_fd The readable ring descriptor (unused, the ring is in the context).
+ * @param[in] context Pointer to the ServeContext of the data socket.
+ * @return `false` when a receive or submission error must stop the worker.
+ */
+bool drain_uring(int ring_fd, void *context) {
+    ServeContext *serve = context;
+    Uring *ring = &serve->ring;
+    bool healthy = true;
+    IoResult result;
+    Slot *slot;
+    uint64_t received_ns = metrics_now_ns();
+    uint32_t now_ms = (uint32_t)(received_ns / 1000000);
+    (void)ring_fd;
+
+    while ((result = uring_receive(ring, &slot)) == IO_DONE) {
+        PasswordRequest request;
+
+        count_metric(METRIC_BYTES_IN, slot->request_size);
+        TraceRecord *trace = start_trace(received_ns);
+        trace_kernel_time(trace, ring->kernel_time_ns);
+        if (!admit_request(serve, slot, now_ms)) {
+            uring_release(ring, slot);
+            continue;
+        }
+        parse_request_datagram(slot->request, slot->request_size, &request);
+        trace_request(trace, &request);
+        log_access(&slot->client_address, &request);
+        trace_point(trace, TRACE_LOGGED);
+
+        CookieVerdict verdict = challenge_sender(&request, slot, received_ns);
+        if (verdict == COOKIE_DROP) {
+            uring_release(ring, slot);
+            continue;
+        }
+        if (verdict == COOKIE_VALID && (request.flags & REQUEST_FLAG_BULK)) {
+            if (admit_bulk_response(serve, slot, &request, now_ms)) {
+                healthy = send_bulk_response(serve, &request, &slot->client_address) && healthy;
+            }
+            trace_point(trace, TRACE_HANDLED);
+            uring_release(ring, slot);
+            continue;
+        }
+
+        if (verdict == COOKIE_VALID) {
+            uint64_t started = metrics_now_ns();
+            slot->response_size = (uint32_t)answer_request(&request, slot->request, slot->request_size, slot->response);
+            record_handle_time(metrics_now_ns() - started);
+        }
+        trace_point(trace, TRACE_HANDLED);
+        uring_send(ring, slot);
+    }
+
+    if (result == IO_ERROR) {
+        count_metric(METRIC_RECEIVE_ERRORS, 1);
         error_handler("Error receiving the request (Password settings).\n");
+        healthy = false;
+    }
+    count_metric(METRIC_BYTES_OUT, ring->sent_bytes);
+    count_metric(METRIC_SEND_ERRORS, ring->failed_sends);
+    count_metric(METRIC_TRANSIENT_ERRORS, ring->transient_errors);
+    count_queue_drops(serve, ring->queue_drops);
+    ring->sent_bytes = 0;
+    ring->failed_sends = 0;
+    ring->transient_errors = 0;
+
+    if (!uring_submit(ring)) {
+        error_handler("Error sending the response (Generated password).\n");
+        healthy = false;
+    }
+    finish_traces();
+    return healthy;
+}
+#endif
+
+/**
+ * @brief Returns the bucket size of a configuration, derived from its rate when not set.
+ * @param[in] config The configuration.
+ * @return The burst, in [1, RATE_LIMIT_MAX_BURST].
+ */
+uint32_t effective_burst(const ServerConfig *config) {
+    if (config->burst != 0) {
+        return config->burst;
+    }
+    return config->rate < RATE_LIMIT_MAX_BURST ? (config->rate > 0 ? config->rate : 1) : RATE_LIMIT_MAX_BURST;
+}
+
+/**
+ * @struct ServerOptions
+ * @brief Runtime settings selected on the command line and in the configuration file.
+ */
+typedef struct {
+    unsigned int batch_size;  /**< Datagrams per batch; 1 selects the per-packet loop */
+    unsigned int workers;     /**< Number of worker threads, each with its own socket */
+    bool pin_workers;         /**< Pins worker `i` to CPU `i` (modulo the CPU count) */
+    LogOptions log;           /**< Level, format and sampling of the access log */
+    const char *listen[MAX_LISTENERS]; /**< `--listen` endpoints; `DEFAULT_IP` when none is given */
+    unsigned int listen_count; /**< Number of `--listen` endpoints */
+    unsigned short port;      /**< Port of the endpoints that do not name one */
+    struct sockaddr_storage listeners[MAX_LISTENERS]; /**< Resolved addresses, bound by every worker */
+    unsigned int listener_count; /**< Number of resolved addresses */
+    unsigned short admin_port; /**< Loopback port of the metrics endpoint; 0 disables it */
+    unsigned int stats_interval; /**< Seconds between two summary log records; 0 disables them */
+    bool use_uring;           /**< Serves the data socket through io_uring when the kernel supports it */
+    ReservoirOptions reservoir; /**< Size and producers of the password reservoir */
+    RateLimitOptions rate_limit; /**< Per-source token buckets of every worker */
+    SocketTuning tuning;      /**< Buffers, busy-polling and GRO/GSO of the data sockets */
+    const char *config_path;  /**< `--config` file, read again on every reload; NULL if none */
+    ServerConfig config;      /**< Settings of the file and of the command line, published at startup */
+    bool reuse_port;          /**< Sets `SO_REUSEPORT` on every socket, so a new server can take over */
+    unsigned int drain_grace_ms; /**< Time a drain keeps answering the queued requests */
+    const char *trace_file;   /**< Chrome trace written on a `trace-dump` query and at exit; NULL if none */
+} ServerOptions;
+
+/**
+ * @brief Parses the optional command-line arguments of the server.
+ * @details The server must still start without any argument. Supported options:
+ *          - `--listen ENDPOINT`: address to serve, repeatable: `HOST`, `HOST:PORT`, `[IPV6]:PORT`,
+ *            `:PORT` or an interface name. An empty host or `*` listens on every IPv4 and IPv6
+ *            address of the machine (default `127.0.0.1`).
+ *          - `--port N`: port of the endpoints that do not name one (default 8080).
+ *          - `--batch N`: number of datagrams per `recvmmsg`/`sendmmsg` call (1 disables batching).
+ *          - `--workers N`: number of worker threads sharing the port through `SO_REUSEPORT`.
+ *          - `--pin`: pins each worker thread to its own CPU (Linux only).
+ *          - `--rng chacha20|system`: source of random bytes for the generators.
+ *          - `--log-level off|error|warning|info|debug`: most verbose records written (default info).
+ *          - `--log-format color|plain|json`: colored terminal output, or structured lines.
+ *          - `--log-sample N`: keeps one access record out of N per worker.
+ *          - `--admin-port N`: answers datagrams on 127.0.0.1:N with the metrics in Prometheus text format.
+ *          - `--stats-interval S`: logs a summary of the traffic every S seconds.
+ *          - `--uring`: serves the data sockets through io_uring (Linux 6.0 or later, otherwise ignored).
+ *          - `--reservoir N`: keeps N pre-generated passwords per type and length (a power of two).
+ *          - `--producers N`: number of low-priority threads refilling the reservoir (default 1).
+ *          - `--rate-limit R`: drops requests beyond R response datagrams per second to one source address.
+ *          - `--burst B`: requests a source can send at once (default R, at most 4095).
+ *          - `--min-length N`, `--max-length N`: narrows the password lengths served.
+ *          - `--max-count N`: largest bulk request served (default and at most 1024).
+ *          - `--clients N`: source addresses tracked per worker (a power of two, default 65536).
+ *          - `--rcvbuf BYTES`, `--sndbuf BYTES`: sizes of the socket buffers (default: system).
+ *          - `--busy-poll US`: busy-polls the device for up to US microseconds before sleeping (Linux only).
+ *          - `--gro`: receives coalesced bursts with `UDP_GRO`, in the per-packet loop (Linux only).
+ *          - `--gso`: sends the datagrams of a bulk response together with `UDP_SEGMENT` (Linux only).
+ *          - `--policy ID:SPEC`: serves the policy SPEC (see `parse_policy_spec`) under ID, below 128,
+ *            repeatable. IDs from 128 on are given to the policies defined by the clients.
+ *          - `--psk-file PATH`: seals every response with the key of PATH (64 hexadecimal digits)
+ *            and refuses the requests that do not ask for sealed responses.
+ *          - `--cookies`: serves only the v2 requests that echo the cookie of their source address
+ *            (see `cookie.h`), answering the others with a challenge. Without it, only the bulk
+ *            requests asking for more than one datagram need a cookie.
+ *          - `--allow-legacy`: with `--cookies`, still serves the v1 requests, which carry no
+ *            cookie, when their datagram is at least as large as the answer; dropped otherwise.
+ *          - `--config PATH`: reads the settings of PATH (see `config.h`) at that point of the
+ *            command line, so the options after it override the file. The file is read again on
+ *            `SIGHUP` and on a `reload` admin query; the options it does not set keep their value.
+ *          - `--reuse-port`: binds every socket with `SO_REUSEPORT`, so that a new server can bind
+ *            the same endpoints before this one drains on `SIGTERM` (Linux and BSD only).
+ *          - `--drain-grace MS`: time a drain keeps answering the datagrams already queued (default 1000).
+ *          - `--trace N`: traces the path of one request out of N per worker (see `trace.h`), with
+ *            the kernel receive times on Linux; the `trace` admin query answers the percentiles
+ *            of every stage.
+ *          - `--trace-file PATH`: writes the traced requests to PATH in the Chrome trace format
+ *            on a `trace-dump` admin query and when the server stops.
+ * @param[in] argc Argument count.
+ * @param[in] argv Argument vector.
+ * @param[out] options Pointer to the ServerOptions structure to populate.
+ * @return `true` if every argument is valid, `false` otherwise.
+ */
+bool parse_arguments(int argc, char *argv[], ServerOptions *options) {
+    options->batch_size = DEFAULT_BATCH_SIZE;
+    options->listen_count = 0;
+    options->port = DEFAULT_PORT;
+    options->listener_count = 0;
+    options->workers = 1;
+    options->pin_workers = false;
+    default_log_options(&options->log);
+    options->admin_port = 0;
+    options->stats_interval = 0;
+    options->use_uring = false;
+    options->reservoir.capacity = 0;
+    options->reservoir.producers = 1;
+    options->rate_limit.clients = RATE_LIMIT_DEFAULT_CLIENTS;
+    default_socket_tuning(&options->tuning);
+    options->config_path = NULL;
+    default_server_config(&options->config);
+    options->reuse_port = false;
+    options->drain_grace_ms = DEFAULT_DRAIN_GRACE_MS;
+    options->trace_file = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            int batch_size = atoi(argv[++i]);
+            if (batch_size < 1 || batch_size > MAX_BATCH_SIZE) {
+                error_handler("Invalid batch size.\n");
+                return false;
+            }
+            options->batch_size = (unsigned int)batch_size;
+        } else if (strcmp(argv[i], "--listen") == 0 && i + 1 < argc) {
+            if (options->listen_count == MAX_LISTENERS) {
+                error_handler("Too many listen addresses.\n");
+                return false;
+            }
+            options->listen[options->listen_count++] = argv[++i];
+        } else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            int port = atoi(argv[++i]);
+            if (port < 1 || port > 65535) {
+                error_handler("Invalid port.\n");
+                return false;
+            }
+            options->port = (unsigned short)port;
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            int workers = atoi(argv[++i]);
+            if (workers < 1 || workers > MAX_WORKERS) {
+                error_handler("Invalid number of workers.\n");
+                return false;
+            }
+            options->workers = (unsigned int)workers;
+        } else if (strcmp(argv[i], "--pin") == 0) {
+            options->pin_workers = true;
+        } else if (strcmp(argv[i], "--uring") == 0) {
+            options->use_uring = true;
+        } else if (strcmp(argv[i], "--reservoir") == 0 && i + 1 < argc) {
+            int reservoir_capacity = atoi(argv[++i]);
+            if (reservoir_capacity < 1 || reservoir_capacity > RESERVOIR_MAX_CAPACITY ||
+                (reservoir_capacity & (reservoir_capacity - 1)) != 0) {
+                error_handler("Invalid reservoir size.\n");
+                return false;
+            }
+            options->reservoir.capacity = (unsigned int)reservoir_capacity;
+        } else if (strcmp(argv[i], "--producers") == 0 && i + 1 < argc) {
+            int producers = atoi(argv[++i]);
+            if (producers < 1 || producers > RESERVOIR_MAX_PRODUCERS) {
+                error_handler("Invalid number of producers.\n");
+                return false;
+            }
+            options->reservoir.producers = (unsigned int)producers;
+        } else if (strncmp(argv[i], "--", 2) == 0 && is_live_setting(argv[i] + 2) && i + 1 < argc) {
+            char message[96];
+            if (!apply_config_setting(&options->config, argv[i] + 2, argv[i + 1])) {
+                snprintf(message, sizeof(message), "Invalid value of %s.\n", argv[i]);
+                error_handler(message);
+                return false;
+            }
+            i++;
+        } else if (strcmp(argv[i], "--config") == 0 && i + 1 < argc) {
+            unsigned int line;
+            options->config_path = argv[++i];
+            options->config.port = options->port;
+            if (!load_config(options->config_path, &options->config, &line)) {
+                char message[96];
+                snprintf(message, sizeof(message), "Invalid configuration file (line %u).\n", line);
+                error_handler(line != 0 ? message : "Invalid or unreadable configuration file.\n");
+                return false;
+            }
+            options->port = options->config.port;
+            if (options->config.listen_count > 0) {
+                options->listen_count = options->config.listen_count;
+                for (unsigned int j = 0; j < options->listen_count; j++) {
+                    options->listen[j] = options->config.listen[j];
+                }
+            }
+        } else if (strcmp(argv[i], "--reuse-port") == 0) {
+            options->reuse_port = true;
+        } else if (strcmp(argv[i], "--drain-grace") == 0 && i + 1 < argc) {
+            int drain_grace = atoi(argv[++i]);
+            if (drain_grace < 1 || drain_grace > 60000) {
+                error_handler("Invalid drain grace time.\n");
+                return false;
+            }
+            options->drain_grace_ms = (unsigned int)drain_grace;
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            long interval = atol(argv[++i]);
+            if (interval < 1 || interval > TRACE_MAX_INTERVAL) {
+                error_handler("Invalid trace sampling interval.\n");
+                return false;
+            }
+            enable_tracing((unsigned int)interval);
+            options->tuning.rx_timestamps = true;
+        } else if (strcmp(argv[i], "--trace-file") == 0 && i + 1 < argc) {
+            options->trace_file = argv[++i];
+        } else if (strcmp(argv[i], "--clients") == 0 && i + 1 < argc) {
+            long clients = atol(argv[++i]);
+            if (clients < 1024 || clients > (long)RATE_LIMIT_MAX_CLIENTS || (clients & (clients - 1)) != 0) {
+                error_handler("Invalid number of tracked clients.\n");
+                return false;
+            }
+            options->rate_limit.clients = (uint32_t)clients;
+        } else if (strcmp(argv[i], "--rng") == 0 && i + 1 < argc) {
+            const char *backend = argv[++i];
+            if (strcmp(backend, "chacha20") == 0) {
+                select_random_backend(RANDOM_CHACHA20);
+            } else if (strcmp(backend, "system") == 0) {
+                select_random_backend(RANDOM_SYSTEM);
+            } else {
+                error_handler("Invalid random backend.\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--log-format") == 0 && i + 1 < argc) {
+            const char *format = argv[++i];
+            if (strcmp(format, "color") == 0) {
+                options->log.format = LOG_FORMAT_COLOR;
+            } else if (strcmp(format, "plain") == 0) {
+                options->log.format = LOG_FORMAT_PLAIN;
+            } else if (strcmp(format, "json") == 0) {
+                options->log.format = LOG_FORMAT_JSON;
+            } else {
+                error_handler("Invalid log format.\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--admin-port") == 0 && i + 1 < argc) {
+            int admin_port = atoi(argv[++i]);
+            if (admin_port < 1 || admin_port > 65535) {
+                error_handler("Invalid admin port.\n");
+                return false;
+            }
+            options->admin_port = (unsigned short)admin_port;
+        } else if (strcmp(argv[i], "--stats-interval") == 0 && i + 1 < argc) {
+            int stats_interval = atoi(argv[++i]);
+            if (stats_interval < 1 || stats_interval > 86400) {
+                error_handler("Invalid statistics interval.\n");
+                return false;
+            }
+            options->stats_interval = (unsigned int)stats_interval;
+        } else if ((strcmp(argv[i], "--rcvbuf") == 0 || strcmp(argv[i], "--sndbuf") == 0) && i + 1 < argc) {
+            bool receive = strcmp(argv[i], "--rcvbuf") == 0;
+            long size = atol(argv[++i]);
+            if (size < 4096 || size > TUNING_MAX_BUFFER) {
+                error_handler("Invalid socket buffer size.\n");
+                return false;
+            }
+            *(receive ? &options->tuning.receive_buffer : &options->tuning.send_buffer) = (int)size;
+        } else if (strcmp(argv[i], "--busy-poll") == 0 && i + 1 < argc) {
+            int busy_poll = atoi(argv[++i]);
+            if (busy_poll < 1 || busy_poll > TUNING_MAX_BUSY_POLL) {
+                error_handler("Invalid busy-polling time.\n");
+                return false;
+            }
+            options->tuning.busy_poll_us = busy_poll;
+        } else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc) {
+            char *separator;
+            long id = strtol(argv[++i], &separator, 10);
+            PolicySpec spec;
+            if (separator == argv[i] || *separator != ':' || id < 0 || id >= POLICY_FIRST_DEFINED ||
+                !parse_policy_spec(separator + 1, &spec) || configure_policy((unsigned int)id, &spec) != STATUS_OK) {
+                error_handler("Invalid policy.\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--psk-file") == 0 && i + 1 < argc) {
+            if (!seal_self_test()) {
+                error_handler("The ChaCha20-Poly1305 self-test failed.\n");
+                return false;
+            }
+            SealKey key;
+            if (!load_seal_key(argv[++i], &key)) {
+                error_handler("Invalid pre-shared key file.\n");
+                return false;
+            }
+            enable_sealing(&key);
+            memset(&key, 0, sizeof(key));
+        } else if (strcmp(argv[i], "--cookies") == 0) {
+            if (!enable_cookies()) {
+                error_handler("Error enabling the cookies: SipHash self-test or entropy source failed.\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--allow-legacy") == 0) {
+            allow_legacy_requests();
+        } else if (strcmp(argv[i], "--gro") == 0) {
+            options->tuning.gro = true;
+        } else if (strcmp(argv[i], "--gso") == 0) {
+            options->tuning.gso = true;
+        } else {
+            error_handler("Usage: UDP_server [--listen ENDPOINT]... [--port N]\n"
+                          "                  [--batch N] [--workers N] [--pin] [--uring] [--rng chacha20|system]\n"
+                          "                  [--log-level off|error|warning|info|debug] [--log-format color|plain|json]\n"
+                          "                  [--log-sample N] [--admin-port N] [--stats-interval S]\n"
+                          "                  [--reservoir N] [--producers N] [--rate-limit R] [--burst B] [--clients N]\n"
+                          "                  [--min-length N] [--max-length N] [--max-count N]\n"
+                          "                  [--rcvbuf BYTES] [--sndbuf BYTES] [--busy-poll US] [--gro] [--gso]\n"
+                          "                  [--policy ID:SPEC]... [--psk-file PATH] [--cookies] [--allow-legacy]\n"
+                          "                  [--config PATH] [--reuse-port] [--drain-grace MS]\n"
+                          "                  [--trace N] [--trace-file PATH]\n");
+            return false;
+        }
+    }
+    if (options->admin_port == options->port) {
+        error_handler("Invalid admin port.\n");
         return false;
     }
+    if (options->config.min_length > options->config.max_length) {
+        error_handler("Invalid password length bounds.\n");
+        return false;
+    }
+    options->rate_limit.rate = options->config.rate;
+    options->rate_limit.burst = effective_burst(&options->config);
+    options->log.level = options->config.log_level;
+    options->log.sample_rate = options->config.log_sample;
+    return true;
+}
+
+/**
+ * @brief Resolves the `--listen` endpoints of the options into the addresses to bind.
+ * @param[in,out] options Pointer to the ServerOptions structure; fills `listeners`.
+ * @return `false` if an endpoint does not resolve or there are too many addresses.
+ */
+bool resolve_listeners(ServerOptions *options) {
+    const char *default_endpoint = DEFAULT_IP;
+    const char **endpoints = options->listen_count != 0 ? options->listen : &default_endpoint;
+    unsigned int endpoint_count = options->listen_count != 0 ? options->listen_count : 1;
+
+    options->listener_count = 0;
+    for (unsigned int i = 0; i < endpoint_count; i++) {
+        unsigned int resolved = resolve_endpoint(endpoints[i], options->port,
+                                                 options->listeners + options->listener_count,
+                                                 MAX_LISTENERS - options->listener_count);
+        if (resolved == 0) {
+            error_handler("Invalid listen address.\n");
+            return false;
+        }
+        options->listener_count += resolved;
+    }
     return true;
 }
 
+/**
+ * @brief Logs the resolved listener addresses.
+ * @param[in] options Pointer to the ServerOptions structure.
+ */
+void log_listeners(const ServerOptions *options) {
+    for (unsigned int i = 0; i < options->listener_count; i++) {
+        char host[ADDRESS_TEXT_SIZE];
+        char message[LOG_MESSAGE_SIZE];
+        unsigned short port;
+        format_address(&options->listeners[i], host, &port);
+        snprintf(message, sizeof(message), options->listeners[i].ss_family == AF_INET6 ? "Listening on [%s]:%u"
+                                                                                        : "Listening on %s:%u",
+                 host, port);
+        log_message(LOG_INFO, message);
+    }
+}
+
+/**
+ * @brief Creates a UDP socket and binds it to a server address.
+ * @details An IPv6 socket is made dual-stack (`IPV6_V6ONLY` off), so binding `::` also serves
+ *          IPv4 clients, whose addresses are then seen as IPv4-mapped IPv6 addresses.
+ * @param[in] address The IPv4 or IPv6 address to bind.
+ * @param[in] reuse_port Whether to set `SO_REUSEPORT` before binding, so that several
+ *                       sockets can share the same address and port.
+ * @param[in] tuning The buffers, busy-polling and GRO of the socket.
+ * @return >=0 The bound socket descriptor.
+ * @return -1 If the socket could not be created, configured or bound.
+ */
+int open_server_socket(const struct sockaddr_storage *address, bool reuse_port, const SocketTuning *tuning) {
+    int server_socket = initialize_socket(address->ss_family);
+    if (server_socket < 0) {
+        return -1;
+    }
+    tune_socket(server_socket, tuning);
+
+#if defined WIN32
+    /* Without this, an ICMP port unreachable caused by a response makes the next recvfrom fail
+     * with WSAECONNRESET; the errors are still classified as transient if they slip through */
+    BOOL report = FALSE;
+    DWORD returned = 0;
+    if (WSAIoctl(server_socket, SIO_UDP_CONNRESET, &report, sizeof(report), NULL, 0, &returned, NULL, NULL) != 0 ||
+        WSAIoctl(server_socket, SIO_UDP_NETRESET, &report, sizeof(report), NULL, 0, &returned, NULL, NULL) != 0) {
+        error_handler("Error disabling the UDP connection reset reports.\n");
+    }
+#endif
+
+    if (address->ss_family == AF_INET6) {
+        int v6_only = 0;
+        if (setsockopt(server_socket, IPPROTO_IPV6, IPV6_V6ONLY, (const char *)&v6_only, sizeof(v6_only)) < 0) {
+            error_handler("Error disabling IPV6_V6ONLY.\n");
+        }
+    }
+
+#if defined SO_REUSEPORT
+    int enable = 1;
+    if (reuse_port && setsockopt(server_socket, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0) {
+        error_handler("Error enabling SO_REUSEPORT.\n");
+        closesocket(server_socket);
+        return -1;
+    }
+#else
+    (void)reuse_port;
+#endif
+
+    if (bind(server_socket, (const struct sockaddr *)address, address_size(address)) < 0) {
+    	error_handler("Bind failed.\n");
+        closesocket(server_socket);
+        return -1;
+    }
+    return server_socket;
+}
+
+/**
+ * @brief Logs the options the kernel applied to a data socket, warning about those it refused.
+ * @param[in] server_socket The data socket.
+ * @param[in] address The address it is bound to.
+ * @param[in] requested The requested options.
+ */
+void log_socket_tuning(int server_socket, const struct sockaddr_storage *address, const SocketTuning *requested) {
+    SocketTuning applied;
+    char host[ADDRESS_TEXT_SIZE];
+    char message[LOG_MESSAGE_SIZE];
+    unsigned short port;
+
+    read_socket_tuning(server_socket, &applied);
+    format_address(address, host, &port);
+    snprintf(message, sizeof(message), "Socket %.40s:%u buffers: receive %d, send %d bytes",
+             host, port, applied.receive_buffer, applied.send_buffer);
+    log_message(LOG_INFO, message);
+    snprintf(message, sizeof(message), "Socket %.40s:%u busy poll %d us, GRO %s, GSO %s", host, port,
+             applied.busy_poll_us, applied.gro ? "on" : "off", requested->gso && applied.gso ? "on" : "off");
+    log_message(LOG_INFO, message);
+
+    if (applied.receive_buffer < requested->receive_buffer) {
+        snprintf(message, sizeof(message), "Receive buffer limited to %d of %d bytes, raise net.core.rmem_max",
+                 applied.receive_buffer, requested->receive_buffer);
+        log_message(LOG_WARNING, message);
+    }
+    if (applied.send_buffer < requested->send_buffer) {
+        snprintf(message, sizeof(message), "Send buffer limited to %d of %d bytes, raise net.core.wmem_max",
+                 applied.send_buffer, requested->send_buffer);
+        log_message(LOG_WARNING, message);
+    }
+    if (applied.busy_poll_us != requested->busy_poll_us) {
+        log_message(LOG_WARNING, "SO_BUSY_POLL refused: it needs CAP_NET_ADMIN above net.core.busy_read");
+    }
+    if (requested->gro && !applied.gro) {
+        log_message(LOG_WARNING, "UDP_GRO is not supported, receiving one datagram per call");
+    }
+    if (requested->gso && !applied.gso) {
+        log_message(LOG_WARNING, "UDP_SEGMENT is not supported, sending bulk responses one datagram at a time");
+    }
+#if defined __linux__
+    if (requested->rx_timestamps && !applied.rx_timestamps) {
+        log_message(LOG_WARNING, "SO_TIMESTAMPING refused, tracing without the kernel receive times");
+    }
+#endif
+}
+
+/**
+ * @brief Opens one socket per listener address.
+ * @param[in] options Pointer to the ServerOptions structure.
+ * @param[in] reuse_port Whether the sockets are shared with other workers.
+ * @param[in] report Whether to log the options the kernel applied (once per server, not per worker).
+ * @param[out] server_sockets Receives `options->listener_count` descriptors.
+ * @return `false` if a socket could not be opened; the others are already closed.
+ */
+bool open_listeners(const ServerOptions *options, bool reuse_port, bool report, int *server_sockets) {
+    for (unsigned int i = 0; i < options->listener_count; i++) {
+        server_sockets[i] = open_server_socket(&options->listeners[i], reuse_port, &options->tuning);
+        if (server_sockets[i] < 0) {
+            while (i-- > 0) {
+                closesocket(server_sockets[i]);
+            }
+            return false;
+        }
+        if (report) {
+            log_socket_tuning(server_sockets[i], &options->listeners[i], &options->tuning);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Closes the sockets opened by `open_listeners`.
+ */
+void close_listeners(const ServerOptions *options, const int *server_sockets) {
+    for (unsigned int i = 0; i < options->listener_count; i++) {
+        closesocket(server_sockets[i]);
+    }
+}
+
+static volatile sig_atomic_t reload_signaled;  /**< Set by `SIGHUP`, cleared by the primary loop */
+static volatile sig_atomic_t drain_signaled;   /**< Set by `SIGTERM` */
+static atomic_bool draining;                   /**< Set once the server started draining */
+static atomic_uint drain_deadline_ms;          /**< When the draining loops stop (monotonic, wraps) */
+
+/**
+ * @brief Reads the configuration file again and publishes it to the workers.
+ * @details The settings the file no longer names keep their value. Changing `listen` or `port`
+ *          needs a new server; those changes are reported and ignored. Only the primary loop
+ *          calls this function, so the publications never race.
+ * @param[in] options Pointer to the ServerOptions structure.
+ * @return `true` if the configuration was published.
+ */
+bool reload_config(const ServerOptions *options) {
+    char message[LOG_MESSAGE_SIZE];
+    if (options->config_path == NULL) {
+        log_message(LOG_WARNING, "No configuration file to reload");
+        return false;
+    }
+
+    const ServerConfig *previous = current_config();
+    ServerConfig config = *previous;
+    unsigned int line;
+    if (!load_config(options->config_path, &config, &line)) {
+        if (line != 0) {
+            snprintf(message, sizeof(message), "Configuration not reloaded: invalid setting on line %u", line);
+        } else {
+            snprintf(message, sizeof(message), "Configuration not reloaded: unreadable file or invalid lengths");
+        }
+        log_message(LOG_ERROR, message);
+        return false;
+    }
+
+    bool moved = config.port != previous->port || config.listen_count != previous->listen_count;
+    for (unsigned int i = 0; !moved && i < config.listen_count; i++) {
+        moved = strcmp(config.listen[i], previous->listen[i]) != 0;
+    }
+    if (moved) {
+        log_message(LOG_WARNING, "The listen and port changes need a new server (see --reuse-port)");
+        config.port = previous->port;
+        config.listen_count = previous->listen_count;
+        memcpy(config.listen, previous->listen, sizeof(config.listen));
+    }
+    if (!tune_logger(config.log_level, config.log_sample)) {
+        log_message(LOG_WARNING, "The log was started off: enabling it needs a restart");
+        config.log_level = previous->log_level;
+    }
+
+    const ServerConfig *published = publish_config(&config);
+    if (published == NULL) {
+        log_message(LOG_ERROR, "Configuration not reloaded: out of memory");
+        return false;
+    }
+    snprintf(message, sizeof(message), "Configuration reloaded (generation %u)", (unsigned int)published->generation);
+    log_message(LOG_INFO, message);
+    return true;
+}
+
+/**
+ * @brief Starts draining: every loop leaves its endpoints and stops after the grace time.
+ * @param[in] options Pointer to the ServerOptions structure.
+ * @param[in] now_ms Current monotonic time in milliseconds.
+ */
+void start_drain(const ServerOptions *options, uint32_t now_ms) {
+    char message[LOG_MESSAGE_SIZE];
+    atomic_store(&drain_deadline_ms, now_ms + options->drain_grace_ms);
+    atomic_store(&draining, true);
+    snprintf(message, sizeof(message), "Draining: leaving the endpoints, stopping in %u ms", options->drain_grace_ms);
+    log_message(LOG_WARNING, message);
+}
+
+/**
+ * @brief Stops a socket from receiving new datagrams, keeping those already queued.
+ * @details The socket is connected to its own address (loopback for a wildcard one), a peer
+ *          that never sends to it. A connected UDP socket only receives from its peer, and
+ *          Linux (since 5.4) then skips it when it picks the socket of a `SO_REUSEPORT`
+ *          group, so the other servers bound to the endpoint get the new datagrams while this
+ *          one answers its queue: `sendto` still reaches any client.
+ * @param[in] server_socket The bound socket.
+ * @return `false` if the socket could not be connected.
+ */
+bool leave_port(int server_socket) {
+    struct sockaddr_storage local;
+    socklen_t local_size = sizeof(local);
+    if (getsockname(server_socket, (struct sockaddr *)&local, &local_size) < 0) {
+        return false;
+    }
+    if (local.ss_family == AF_INET6) {
+        struct sockaddr_in6 *ipv6 = (struct sockaddr_in6 *)&local;
+        if (IN6_IS_ADDR_UNSPECIFIED(&ipv6->sin6_addr)) {
+            ipv6->sin6_addr = in6addr_loopback;
+        }
+    } else {
+        struct sockaddr_in *ipv4 = (struct sockaddr_in *)&local;
+        if (ipv4->sin_addr.s_addr == htonl(INADDR_ANY)) {
+            ipv4->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        }
+    }
+    return connect(server_socket, (const struct sockaddr *)&local, address_size(&local)) == 0;
+}
+
+#if !defined WIN32
+/**
+ * @brief `SIGHUP` handler: asks the primary loop to reload the configuration.
+ */
+void on_reload_signal(int signal_number) {
+    (void)signal_number;
+    reload_signaled = 1;
+}
+
+/**
+ * @brief `SIGTERM` handler: asks the primary loop to start draining.
+ */
+void on_drain_signal(int signal_number) {
+    (void)signal_number;
+    drain_signaled = 1;
+}
+
+/**
+ * @brief Installs the reload and drain signal handlers.
+ * @return `false` if a handler could not be installed.
+ */
+bool install_signal_handlers(void) {
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    action.sa_handler = on_reload_signal;
+    if (sigaction(SIGHUP, &action, NULL) < 0) {
+        return false;
+    }
+    action.sa_handler = on_drain_signal;
+    return sigaction(SIGTERM, &action, NULL) == 0;
+}
+#endif
+
+/**
+ * @brief Creates the admin socket, bound to the loopback interface only.
+ * @param[in] port The admin port.
+ * @param[in] reuse_port Whether to set `SO_REUSEPORT`, so that the next server can bind it too.
+ * @return >=0 The bound socket descriptor.
+ * @return -1 If the socket could not be created or bound.
+ */
+int open_admin_socket(unsigned short port, bool reuse_port) {
+    int admin_socket = initialize_socket(AF_INET);
+    if (admin_socket < 0) {
+        return -1;
+    }
+
+    struct sockaddr_in admin_address;
+    memset(&admin_address, 0, sizeof(admin_address));
+    admin_address.sin_family = AF_INET;
+    admin_address.sin_port = htons(port);
+    admin_address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+#if defined SO_REUSEPORT
+    int enable = 1;
+    if (reuse_port && setsockopt(admin_socket, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0) {
+        error_handler("Error enabling SO_REUSEPORT.\n");
+        closesocket(admin_socket);
+        return -1;
+    }
+#else
+    (void)reuse_port;
+#endif
+
+    if (bind(admin_socket, (struct sockaddr *)&admin_address, sizeof(admin_address)) < 0) {
+        error_handler("Admin bind failed.\n");
+        closesocket(admin_socket);
+        return -1;
+    }
+    return admin_socket;
+}
+
+/**
+ * @brief Tells that the server is listening, in color or as a record of the chosen format.
+ * @details The plain and JSON formats keep one record per line on the standard output, so the
+ *          colored banner would corrupt them.
+ * @param[in] options Pointer to the ServerOptions structure.
+ */
+void announce_listening(const ServerOptions *options) {
+    if (options->log.format == LOG_FORMAT_COLOR) {
+        print_with_color("Server listening...\n\n", BLUE);
+    } else {
+        log_message(LOG_INFO, "Server listening");
+    }
+}
+
+/**
+ * @brief Writes the traced requests to the `--trace-file`, if one was given.
+ * @param[in] options Pointer to the ServerOptions structure.
+ * @return The number of requests written, 0 without a trace file, -1 if it could not be written.
+ */
+long dump_trace(const ServerOptions *options) {
+    char message[LOG_MESSAGE_SIZE];
+    if (options->trace_file == NULL || !tracing_enabled()) {
+        return 0;
+    }
+    long written = write_chrome_trace(options->trace_file);
+    if (written < 0) {
+        snprintf(message, sizeof(message), "Error writing the trace file %.60s", options->trace_file);
+        log_message(LOG_ERROR, message);
+    } else {
+        snprintf(message, sizeof(message), "Wrote %ld traced requests to %.50s", written, options->trace_file);
+        log_message(LOG_INFO, message);
+    }
+    return written;
+}
+
+/**
+ * @brief Admin socket handler: answers every datagram with the current metrics.
+ * @details A `reload` query reloads the configuration file and is answered with the outcome. A
+ *          `trace` query is answered with the percentiles of every stage of the traced requests,
+ *          a `trace-dump` query writes them to the `--trace-file`. Any other query (e.g. `echo | nc -u -w1 127.0.0.1 PORT`) is answered with the Prometheus text
+ *          exposition of the summed worker counters, in a single datagram. While two servers share
+ *          the admin port through `--reuse-port`, a query reaches either of them.
+ * @param[in] admin_socket The readable admin socket.
+ * @param[in] context Pointer to the ServerOptions structure.
+ * @return `false` when the socket fails.
+ */
+bool answer_admin(int admin_socket, void *context) {
+    static char text[16384];  /**< Only the loop owning the admin socket uses it */
+    const ServerOptions *options = context;
+    char query[64];
+
+    while (true) {
+        struct sockaddr_in peer_address;
+        socklen_t peer_address_size = sizeof(peer_address);
+        int query_size = (int)recvfrom(admin_socket, query, sizeof(query) - 1, 0, (struct sockaddr *)&peer_address,
+                                       &peer_address_size);
+        if (query_size < 0) {
+#if defined WIN32
+            if (WSAGetLastError() == WSAEMSGSIZE) {
+                continue;
+            }
+#endif
+            IoResult result = last_socket_result();
+            if (result == IO_INTERRUPTED || result == IO_TRANSIENT) {
+                continue; /**< e.g. the previous scraper went away before its answer */
+            }
+            if (result == IO_AGAIN) {
+                return true;
+            }
+            error_handler("Error receiving an admin query.\n");
+            return false;
+        }
+
+        while (query_size > 0 && isspace((unsigned char)query[query_size - 1])) {
+            query_size--;
+        }
+        query[query_size] = '\0';
+        if (strcmp(query, "reload") == 0) {
+            int size = reload_config(options)
+                       ? snprintf(text, sizeof(text), "reloaded generation %u\n", (unsigned int)current_config()->generation)
+                       : snprintf(text, sizeof(text), "reload failed, see the log\n");
+            sendto(admin_socket, text, (size_t)size, 0, (struct sockaddr *)&peer_address, sizeof(peer_address));
+            continue;
+        }
+        if (strcmp(query, "trace") == 0 || strcmp(query, "trace-dump") == 0) {
+            size_t size;
+            if (!tracing_enabled()) {
+                size = (size_t)snprintf(text, sizeof(text), "tracing disabled, start with --trace N\n");
+            } else if (strcmp(query, "trace") == 0) {
+                size = format_trace_stages(text, sizeof(text));
+            } else if (options->trace_file == NULL) {
+                size = (size_t)snprintf(text, sizeof(text), "no trace file, start with --trace-file PATH\n");
+            } else {
+                long written = dump_trace(options);
+                size = written >= 0 ? (size_t)snprintf(text, sizeof(text), "wrote %ld requests\n", written)
+                                    : (size_t)snprintf(text, sizeof(text), "trace dump failed, see the log\n");
+            }
+            sendto(admin_socket, text, size, 0, (struct sockaddr *)&peer_address, sizeof(peer_address));
+            continue;
+        }
+
+        MetricsSnapshot snapshot;
+        snapshot_metrics(&snapshot);
+        size_t size = format_metrics(&snapshot, text, sizeof(text));
+        size += (size_t)snprintf(text + size, sizeof(text) - size,
+                                 "# HELP passwdgen_log_dropped_total Access records dropped by the full log ring.\n"
+                                 "# TYPE passwdgen_log_dropped_total counter\n"
+                                 "passwdgen_log_dropped_total %llu\n"
+                                 "# HELP passwdgen_config_generation Configurations published since startup.\n"
+                                 "# TYPE passwdgen_config_generation gauge\n"
+                                 "passwdgen_config_generation %u\n"
+                                 "# HELP passwdgen_draining Whether the server is leaving its endpoints to another one.\n"
+                                 "# TYPE passwdgen_draining gauge\n"
+                                 "passwdgen_draining %d\n", (unsigned long long)dropped_log_records(),
+                                 (unsigned int)current_config()->generation, atomic_load(&draining) ? 1 : 0);
+        if (size >= sizeof(text)) {
+            size = sizeof(text) - 1;
+        }
+        sendto(admin_socket, text, size, 0, (struct sockaddr *)&peer_address, sizeof(peer_address));
+    }
+}
+
+/**
+ * @struct StatsContext
+ * @brief Totals seen by the previous summary record.
+ */
+typedef struct {
+    uint64_t requests;        /**< Requests of every type */
+    uint64_t bytes_out;       /**< Bytes sent */
+    unsigned int interval;    /**< Seconds between two records */
+} StatsContext;
+
+/**
+ * @brief Timer handler: logs the traffic served since the previous call.
+ * @param[in] context Pointer to the StatsContext of the timer.
+ */
+void report_stats(void *context) {
+    StatsContext *stats = context;
+    MetricsSnapshot snapshot;
+    snapshot_metrics(&snapshot);
+
+    uint64_t requests = 0;
+    for (unsigned int i = 0; i < PASSWORD_TYPE_COUNT; i++) {
+        requests += snapshot.requests[i];
+    }
+    uint64_t bytes_out = snapshot.counters[METRIC_BYTES_OUT];
+
+    char message[96];
+    snprintf(message, sizeof(message), "Served %llu requests (%llu req/s, %llu bytes out) in the last %u s",
+             (unsigned long long)(requests - stats->requests),
+             (unsigned long long)((requests - stats->requests) / stats->interval),
+             (unsigned long long)(bytes_out - stats->bytes_out), stats->interval);
+    log_message(LOG_INFO, message);
+
+    stats->requests = requests;
+    stats->bytes_out = bytes_out;
+}
+
+/**
+ * @struct LifecycleContext
+ * @brief State of the reload and drain checks of one loop.
+ */
+typedef struct {
+    EventLoop *loop;              /**< The loop to stop at the end of a drain */
+    const int *server_sockets;    /**< The `options->listener_count` data sockets of the loop */
+    int admin_socket;             /**< The admin socket of the loop, or -1 */
+    RateLimiter *limiter;         /**< The rate limiter of the loop */
+    const ServerOptions *options; /**< Pointer to the ServerOptions structure */
+    uint32_t generation;          /**< Configuration the limiter follows; 0 before the first check */
+    bool primary;                 /**< Whether this loop handles the signals */
+    bool left;                    /**< Whether the sockets already left their endpoints */
+} LifecycleContext;
+
+/**
+ * @brief Timer handler: applies the reloads and carries out the drain.
+ * @details The primary loop turns the signals into a reload or the start of a drain. Every loop
+ *          then retunes its rate limiter when a new configuration is published, and during a
+ *          drain leaves its endpoints once and stops at the deadline, having answered what was
+ *          queued in the meantime.
+ * @param[in] context Pointer to the LifecycleContext of the loop.
+ */
+void check_lifecycle(void *context) {
+    LifecycleContext *lifecycle = context;
+    const ServerOptions *options = lifecycle->options;
+    uint32_t now_ms = (uint32_t)(metrics_now_ns() / 1000000);
+
+    if (lifecycle->primary) {
+        if (reload_signaled) {
+            reload_signaled = 0;
+            reload_config(options);
+        }
+        if (drain_signaled && !atomic_load(&draining)) {
+            start_drain(options, now_ms);
+        }
+    }
+
+    const ServerConfig *config = current_config();
+    if (config->generation != lifecycle->generation) {
+        RateLimitOptions rate_limit = { config->rate, effective_burst(config), options->rate_limit.clients };
+        if (!tune_rate_limiter(lifecycle->limiter, &rate_limit)) {
+            log_message(LOG_ERROR, "Rate limiter disabled: its table could not be allocated");
+        }
+        lifecycle->generation = config->generation;
+    }
+
+    if (atomic_load(&draining)) {
+        if (!lifecycle->left) {
+            lifecycle->left = true;
+            for (unsigned int i = 0; i < options->listener_count; i++) {
+                if (!leave_port(lifecycle->server_sockets[i])) {
+                    log_message(LOG_ERROR, "Error leaving an endpoint: new datagrams still reach it");
+                }
+            }
+            if (lifecycle->admin_socket >= 0) {
+                leave_port(lifecycle->admin_socket);
+            }
+        }
+        if ((int32_t)(now_ms - atomic_load(&drain_deadline_ms)) >= 0) {
+            event_loop_stop(lifecycle->loop);
+        }
+    }
+}
+
+/**
+ * @brief Prepares the handler of one data socket.
+ * @details The handler is selected by the options. With `--uring` the loop watches the ring
+ *          descriptor instead of the data socket, and falls back to the classic handlers if
+ *          the ring cannot be created. A socket the kernel accepted `UDP_GRO` on always uses
+ *          the per-packet handler, the only one with a buffer large enough for a coalesced burst.
+ * @param[out] serve The ServeContext to initialize.
+ * @param[in] server_socket The bound server socket.
+ * @param[in] limiter The rate limiter of the worker.
+ * @param[in] options Pointer to the ServerOptions structure.
+ * @param[out] drain Receives the handler to register.
+ * @param[out] data_source Receives the descriptor to watch.
+ * @return `false` if the slots or the GRO/GSO buffers cannot be allocated.
+ */
+bool prepare_serve_context(ServeContext *serve, int server_socket, RateLimiter *limiter,
+                           const ServerOptions *options, SocketHandler *drain, int *data_source) {
+    memset(serve, 0, sizeof(*serve));
+    serve->batch_size = 1;
+    serve->server_socket = server_socket;
+    serve->limiter = limiter;
+    *drain = drain_per_packet;
+    *data_source = server_socket;
+#if defined __linux__
+    SocketTuning applied;
+    read_socket_tuning(server_socket, &applied);
+    serve->ring.ring_fd = -1;
+    if ((applied.gro && (serve->coalesced = malloc(TUNING_COALESCED_SIZE)) == NULL) ||
+        (options->tuning.gso && applied.gso && (serve->segments = malloc(TUNING_COALESCED_SIZE)) == NULL)) {
+        return false;
+    }
+    if (options->batch_size > 1 && !applied.gro) {
+        *drain = drain_batched;
+        serve->batch_size = options->batch_size;
+    }
+    if (options->use_uring && !applied.gro && init_slot_pool(&serve->pool, URING_SLOTS)) {
+        if (uring_init(&serve->ring, server_socket, &serve->pool)) {
+            *drain = drain_uring;
+            *data_source = serve->ring.ring_fd;
+        } else {
+            free_slot_pool(&serve->pool);
+            log_message(LOG_WARNING, "io_uring is not available, using the classic data path");
+        }
+    }
+#else
+    (void)options;
+#endif
+    return serve->pool.slots != NULL || init_slot_pool(&serve->pool, serve->batch_size);
+}
+
+/**
+ * @brief Releases the ring, the slots and the GRO/GSO buffers of a data socket handler.
+ */
+void release_serve_context(ServeContext *serve) {
+#if defined __linux__
+    if (serve->ring.ring_fd >= 0) {
+        uring_close(&serve->ring);
+    }
+    free(serve->coalesced);
+    free(serve->segments);
+    serve->coalesced = NULL;
+    serve->segments = NULL;
+#endif
+    free_slot_pool(&serve->pool);
+}
+
+/**
+ * @brief Serves already bound data sockets, and optionally the admin socket, from one event loop.
+ * @details Every data socket has its own handler and slots; the rate limiter is shared, so a
+ *          client reaching the worker over IPv4 and IPv6 draws from the same bucket if its
+ *          addresses map to the same key. Every loop runs the reload and drain checks of
+ *          `check_lifecycle`; the primary loop (the first worker, or the only one) also runs the
+ *          periodic summary timer and handles the signals.
+ * @param[in] server_sockets The `options->listener_count` bound server sockets.
+ * @param[in] admin_socket The bound admin socket, or -1 if this loop does not serve it.
+ * @param[in] primary Whether this loop runs the server-wide timers.
+ * @param[in] options Pointer to the ServerOptions structure.
+ * @return `true` once a drain stopped the loop, `false` when a socket error stops it.
+ */
+bool serve_sockets(const int *server_sockets, int admin_socket, bool primary, const ServerOptions *options) {
+    ServeContext serves[MAX_LISTENERS];
+    SocketHandler drains[MAX_LISTENERS];
+    int data_sources[MAX_LISTENERS];
+    RateLimiter limiter;
+    unsigned int prepared = 0;
+
+    bind_worker_metrics();
+    if (!bind_worker_trace()) {
+        log_message(LOG_WARNING, "Error allocating the trace ring, the worker is not traced");
+    }
+    bool ready = init_rate_limiter(&limiter, &options->rate_limit);
+    while (ready && prepared < options->listener_count) {
+        ready = prepare_serve_context(&serves[prepared], server_sockets[prepared], &limiter, options,
+                                      &drains[prepared], &data_sources[prepared]);
+        if (!ready) {
+            release_serve_context(&serves[prepared]);
+        } else {
+            prepared++;
+        }
+    }
+    if (!ready) {
+        error_handler("Error allocating the request slots.\n");
+        while (prepared-- > 0) {
+            release_serve_context(&serves[prepared]);
+        }
+        free_rate_limiter(&limiter);
+        return false;
+    }
+
+    EventLoop loop;
+    StatsContext stats = { 0, 0, options->stats_interval };
+    LifecycleContext lifecycle = { &loop, server_sockets, admin_socket, &limiter, options, 0, primary, false };
+    bool drained = false;
+    ready = event_loop_init(&loop);
+    for (unsigned int i = 0; ready && i < prepared; i++) {
+        ready = event_loop_add_socket(&loop, data_sources[i], drains[i], &serves[i]);
+    }
+    if (ready && admin_socket >= 0) {
+        ready = event_loop_add_socket(&loop, admin_socket, answer_admin, (void *)options);
+    }
+    if (ready) {
+        ready = event_loop_add_timer(&loop, LIFECYCLE_INTERVAL_MS, check_lifecycle, &lifecycle);
+    }
+    if (ready && primary && options->stats_interval != 0) {
+        ready = event_loop_add_timer(&loop, options->stats_interval * 1000, report_stats, &stats);
+    }
+
+    if (!ready) {
+        error_handler("Error setting up the event loop.\n");
+    } else {
+        drained = event_loop_run(&loop);
+    }
+
+    event_loop_close(&loop);
+    for (unsigned int i = 0; i < prepared; i++) {
+        release_serve_context(&serves[i]);
+    }
+    free_rate_limiter(&limiter);
+    return drained;
+}
+
+#if !defined WIN32
+/**
+ * @struct WorkerContext
+ * @brief Arguments handed to a worker thread.
+ */
+typedef struct {
+    unsigned int index;            /**< Position of the worker, used for CPU pinning */
+    int server_sockets[MAX_LISTENERS]; /**< Sockets owned by the worker, one per listener */
+    int admin_socket;              /**< Admin socket served by this worker, or -1 */
+    const ServerOptions *options;  /**< Shared, read-only server options */
+    pthread_t thread;              /**< Thread running the worker */
+    bool drained;                  /**< Whether the worker stopped at the end of a drain */
+} WorkerContext;
+
+/**
+ * @brief Thread entry point of a worker: optionally pins itself, then serves its sockets.
+ * @param[in] argument Pointer to the WorkerContext of the worker.
+ * @return Always NULL.
+ */
+void *run_worker(void *argument) {
+    WorkerContext *worker = argument;
+
+#if defined __linux__
+    if (worker->options->pin_workers) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(worker->index % (cpus > 0 ? (unsigned long)cpus : 1UL), &cpu_set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) != 0) {
+            error_handler("Error pinning the worker to its CPU.\n");
+        }
+    }
+#endif
+
+    worker->drained = serve_sockets(worker->server_sockets, worker->admin_socket, worker->index == 0, worker->options);
+    return NULL;
+}
+
+/**
+ * @brief Runs `options->workers` workers, each on its own `SO_REUSEPORT` sockets.
+ * @details All sockets are bound before any thread starts, so a bind error is reported
+ *          immediately and the kernel already balances flows over the whole group when
+ *          the first datagram arrives. The function returns once every worker has stopped.
+ * @param[in] options Pointer to the ServerOptions structure.
+ * @param[in] admin_socket The admin socket, served by the first worker, or -1.
+ * @return `true` if every worker stopped at the end of a drain, `false` on failure.
+ */
+bool run_workers(const ServerOptions *options, int admin_socket) {
+    WorkerContext *workers = calloc(options->workers, sizeof(WorkerContext));
+    if (workers == NULL) {
+        error_handler("Error allocating the workers.\n");
+        return false;
+    }
+
+    unsigned int opened = 0;
+    for (; opened < options->workers; opened++) {
+        workers[opened].index = opened;
+        workers[opened].options = options;
+        workers[opened].admin_socket = opened == 0 ? admin_socket : -1;
+        if (!open_listeners(options, true, opened == 0, workers[opened].server_sockets)) {
+            break;
+        }
+    }
+
+    unsigned int started = 0;
+    bool drained = opened == options->workers;
+    if (opened == options->workers) {
+        announce_listening(options);
+        for (; started < opened; started++) {
+            if (pthread_create(&workers[started].thread, NULL, run_worker, &workers[started]) != 0) {
+                error_handler("Error starting a worker thread.\n");
+                drained = false;
+                break;
+            }
+        }
+    }
+
+    for (unsigned int i = 0; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+        drained = drained && workers[i].drained;
+    }
+    for (unsigned int i = 0; i < opened; i++) {
+        close_listeners(options, workers[i].server_sockets);
+    }
+    free(workers);
+    return drained;
+}
+#endif
+
 /**
  * @brief Entry point for the UDP server program.
  * @return Program exit status.
  * @return EXIT_SUCCESS If the server ran successfully.
  * @return EXIT_FAILURE If an error occurred during execution.
- * @details Initializes the server, listens for client requests, and processes them in an infinite loop.
+ * @details Initializes the server, listens for client requests, and processes them until a drain
+ *          (`SIGTERM`) ends, which is the successful exit.
  */
-int main() {
+int main(int argc, char *argv[]) {
+
+    ServerOptions options;
+    if (!parse_arguments(argc, argv, &options)) {
+        return EXIT_FAILURE;
+    }
+    if (!chacha20_self_test()) {
+        error_handler("The ChaCha20 self-test failed.\n");
+        return EXIT_FAILURE;
+    }
+    if (!init_cookies()) {
+        error_handler("Error drawing the secret of the cookies: SipHash self-test or entropy source failed.\n");
+        return EXIT_FAILURE;
+    }
+    if (publish_config(&options.config) == NULL) {
+        error_handler("Error publishing the configuration.\n");
+        return EXIT_FAILURE;
+    }
+#if !defined WIN32
+    if (!install_signal_handlers()) {
+        error_handler("Error installing the signal handlers.\n");
+        return EXIT_FAILURE;
+    }
+#endif
 
 #if defined WIN32
 	// Initialize Winsock
@@ -161,47 +1946,62 @@ int main() {
 	}
 #endif
 
-    int server_socket = initialize_socket();
-    if (server_socket < 0) {
+    if (!resolve_listeners(&options)) {
         clear_winsock();
         return EXIT_FAILURE;
     }
 
-    struct sockaddr_in server_address, client_address;
+    if (!start_logger(&options.log)) {
+        error_handler("Error starting the logger thread.\n");
+        clear_winsock();
+        return EXIT_FAILURE;
+    }
 
-    setup_server_address(&server_address);
+    log_listeners(&options);
 
-    if (bind(server_socket, (struct sockaddr *)&server_address, sizeof(server_address)) < 0) {
-    	error_handler("Bind failed.\n");
-        closesocket(server_socket);
+    if (!start_reservoir(&options.reservoir)) {
+        error_handler("Error starting the password reservoir.\n");
+        stop_logger();
         clear_winsock();
         return EXIT_FAILURE;
     }
 
-    print_with_color("Server listening...\n\n", BLUE);
-
-    while (true) {
-        PasswordRequest request;
-        PasswordResponse response;
+    int admin_socket = -1;
+    if (options.admin_port != 0 && (admin_socket = open_admin_socket(options.admin_port, options.reuse_port)) < 0) {
+        stop_reservoir();
+        stop_logger();
+        clear_winsock();
+        return EXIT_FAILURE;
+    }
 
-        if (!receive_request(server_socket, &request, &client_address)) {
-            closesocket(server_socket);
-            clear_winsock();
-            return EXIT_FAILURE;
+#if !defined WIN32
+    if (options.workers > 1) {
+        bool drained = run_workers(&options, admin_socket);
+        dump_trace(&options);
+        if (admin_socket >= 0) {
+            closesocket(admin_socket);
         }
+        stop_reservoir();
+        stop_logger();
+        clear_winsock();
+        return drained ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+#endif
 
-        print_with_color("New connection from ", GREEN);
-        print_with_color(inet_ntoa(client_address.sin_addr), YELLOW);
-        print_with_color(":", CYAN);
-        printf("%d\n", ntohs(client_address.sin_port));
-
-        handle_password_request(&request, &response);
-
-        if (!send_response(server_socket, &response, &client_address)) {
-            closesocket(server_socket);
-            clear_winsock();
-            return EXIT_FAILURE;
-        }
+    int server_sockets[MAX_LISTENERS];
+    bool drained = false;
+    if (open_listeners(&options, options.reuse_port, true, server_sockets)) {
+        announce_listening(&options);
+        drained = serve_sockets(server_sockets, admin_socket, true, &options);
+        close_listeners(&options, server_sockets);
+    }
+    dump_trace(&options);
 
+    if (admin_socket >= 0) {
+        closesocket(admin_socket);
     }
+    stop_reservoir();
+    stop_logger();
+    clear_winsock();
+    return drained ? EXIT_SUCCESS : EXIT_FAILURE;
 }
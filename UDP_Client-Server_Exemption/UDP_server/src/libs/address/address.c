@@ -0,0 +1,217 @@
+/**
+ * @file address.c
+ * @brief Implementation of the address helpers of the dual-stack server.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#if !defined WIN32
+#include <netdb.h>          /**< Includes getaddrinfo() and getnameinfo() */
+#include <ifaddrs.h>        /**< Includes getifaddrs() */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "address.h"
+
+/* - - - - - - - - - - - - - - - - - - - - ADDRESSES - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Length of the socket address structure of a family.
+ */
+socklen_t address_size(const struct sockaddr_storage *address) {
+    return address->ss_family == AF_INET6 ? (socklen_t)sizeof(struct sockaddr_in6)
+                                          : (socklen_t)sizeof(struct sockaddr_in);
+}
+
+/**
+ * @brief Splits an endpoint into its host and port texts.
+ * @return `false` if the endpoint is malformed or too long.
+ */
+static bool split_endpoint(const char *endpoint, unsigned short default_port,
+                           char *host, size_t host_size, char *port, size_t port_size) {
+    const char *host_start = endpoint;
+    const char *host_end;
+    const char *port_text = NULL;
+
+    if (*endpoint == '[') {
+        host_start = endpoint + 1;
+        host_end = strchr(host_start, ']');
+        if (host_end == NULL || (host_end[1] != '\0' && host_end[1] != ':')) {
+            return false;
+        }
+        if (host_end[1] == ':') {
+            port_text = host_end + 2;
+        }
+    } else {
+        const char *colon = strchr(endpoint, ':');
+        if (colon != NULL && strchr(colon + 1, ':') == NULL) {
+            host_end = colon;                                 /**< HOST:PORT */
+            port_text = colon + 1;
+        } else {
+            host_end = endpoint + strlen(endpoint);           /**< HOST, or a bare IPv6 address */
+        }
+    }
+
+    size_t host_length = (size_t)(host_end - host_start);
+    if (host_length >= host_size) {
+        return false;
+    }
+    memcpy(host, host_start, host_length);
+    host[host_length] = '\0';
+    if (host_length == 0 || strcmp(host, "*") == 0) {
+        snprintf(host, host_size, "::");                     /**< Dual-stack wildcard */
+    }
+
+    if (port_text == NULL || *port_text == '\0') {
+        snprintf(port, port_size, "%u", default_port);
+        return true;
+    }
+    char *end;
+    long value = strtol(port_text, &end, 10);
+    if (*end != '\0' || value < 1 || value > 65535) {
+        return false;
+    }
+    snprintf(port, port_size, "%ld", value);
+    return true;
+}
+
+/**
+ * @brief Appends an address to a list unless it is already there.
+ */
+static unsigned int add_address(struct sockaddr_storage *addresses, unsigned int count, unsigned int capacity,
+                                const struct sockaddr *address, size_t size) {
+    if (count == capacity || size > sizeof(struct sockaddr_storage)) {
+        return count;
+    }
+    struct sockaddr_storage candidate;
+    memset(&candidate, 0, sizeof(candidate));
+    memcpy(&candidate, address, size);
+    for (unsigned int i = 0; i < count; i++) {
+        if (memcmp(&addresses[i], &candidate, sizeof(candidate)) == 0) {
+            return count;
+        }
+    }
+    addresses[count] = candidate;
+    return count + 1;
+}
+
+#if !defined WIN32
+/**
+ * @brief Collects the IPv4 and IPv6 addresses of a network interface.
+ */
+static unsigned int resolve_interface(const char *name, unsigned short port,
+                                      struct sockaddr_storage *addresses, unsigned int capacity) {
+    struct ifaddrs *interfaces;
+    unsigned int count = 0;
+    if (getifaddrs(&interfaces) != 0) {
+        return 0;
+    }
+    for (struct ifaddrs *entry = interfaces; entry != NULL; entry = entry->ifa_next) {
+        if (entry->ifa_addr == NULL || strcmp(entry->ifa_name, name) != 0) {
+            continue;
+        }
+        if (entry->ifa_addr->sa_family == AF_INET) {
+            struct sockaddr_in address = *(const struct sockaddr_in *)entry->ifa_addr;
+            address.sin_port = htons(port);
+            count = add_address(addresses, count, capacity, (const struct sockaddr *)&address, sizeof(address));
+        } else if (entry->ifa_addr->sa_family == AF_INET6) {
+            struct sockaddr_in6 address = *(const struct sockaddr_in6 *)entry->ifa_addr;
+            address.sin6_port = htons(port);
+            count = add_address(addresses, count, capacity, (const struct sockaddr *)&address, sizeof(address));
+        }
+    }
+    freeifaddrs(interfaces);
+    return count;
+}
+#endif
+
+/**
+ * @brief Resolves a listen endpoint into the addresses to bind.
+ */
+unsigned int resolve_endpoint(const char *endpoint, unsigned short default_port,
+                              struct sockaddr_storage *addresses, unsigned int capacity) {
+    char host[256];
+    char port[8];
+    if (!split_endpoint(endpoint, default_port, host, sizeof(host), port, sizeof(port))) {
+        return 0;
+    }
+
+    struct addrinfo hints;
+    struct addrinfo *results;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_protocol = IPPROTO_UDP;
+    hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+
+    unsigned int count = 0;
+    if (getaddrinfo(host, port, &hints, &results) == 0) {
+        for (struct addrinfo *result = results; result != NULL; result = result->ai_next) {
+            if (result->ai_family == AF_INET || result->ai_family == AF_INET6) {
+                count = add_address(addresses, count, capacity, result->ai_addr, result->ai_addrlen);
+            }
+        }
+        freeaddrinfo(results);
+    }
+#if !defined WIN32
+    if (count == 0) {
+        count = resolve_interface(host, (unsigned short)atoi(port), addresses, capacity);
+    }
+#endif
+    return count;
+}
+
+/**
+ * @brief Writes the numeric host and the port of an address.
+ */
+void format_address(const struct sockaddr_storage *address, char *host, unsigned short *port) {
+    struct sockaddr_storage printable = *address;
+
+    if (address->ss_family == AF_INET6) {
+        const struct sockaddr_in6 *address6 = (const struct sockaddr_in6 *)address;
+        *port = ntohs(address6->sin6_port);
+        if (IN6_IS_ADDR_V4MAPPED(&address6->sin6_addr)) {
+            struct sockaddr_in *address4 = (struct sockaddr_in *)&printable;
+            memset(&printable, 0, sizeof(printable));
+            address4->sin_family = AF_INET;
+            memcpy(&address4->sin_addr, &address6->sin6_addr.s6_addr[12], 4);
+        }
+    } else {
+        *port = ntohs(((const struct sockaddr_in *)address)->sin_port);
+    }
+
+    if (getnameinfo((const struct sockaddr *)&printable, address_size(&printable),
+                    host, ADDRESS_TEXT_SIZE, NULL, 0, NI_NUMERICHOST) != 0) {
+        snprintf(host, ADDRESS_TEXT_SIZE, "?");
+    }
+}
+
+/**
+ * @brief Non-zero 32-bit digest identifying the client behind an address.
+ */
+uint32_t address_key(const struct sockaddr_storage *address) {
+    uint32_t key;
+
+    if (address->ss_family == AF_INET6) {
+        const uint8_t *bytes = ((const struct sockaddr_in6 *)address)->sin6_addr.s6_addr;
+        if (IN6_IS_ADDR_V4MAPPED(&((const struct sockaddr_in6 *)address)->sin6_addr)) {
+            memcpy(&key, bytes + 12, sizeof(key));
+        } else {
+            uint64_t prefix;
+            memcpy(&prefix, bytes, sizeof(prefix));  /**< The /64 network prefix */
+            prefix ^= prefix >> 33;
+            prefix *= 0xFF51AFD7ED558CCDULL;
+            prefix ^= prefix >> 33;
+            key = (uint32_t)prefix;
+        }
+    } else {
+        key = ((const struct sockaddr_in *)address)->sin_addr.s_addr;
+    }
+    return key != 0 ? key : 1;
+}
+
+/* - - - - - - - - - - - - - - - - - - - END ADDRESSES - - - - - - - - - - - - - - - - - - - */
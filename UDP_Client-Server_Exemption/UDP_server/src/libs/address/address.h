@@ -0,0 +1,84 @@
+/**
+ * @file address.h
+ * @brief Header file declaring the address helpers of the dual-stack server.
+ *
+ * Every address handled by the server is kept in a `struct sockaddr_storage`, so the same code
+ * serves IPv4 sockets, IPv6 sockets and dual-stack IPv6 sockets, on which IPv4 clients appear
+ * as IPv4-mapped addresses (`::ffff:a.b.c.d`).
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef ADDRESS_H_
+#define ADDRESS_H_
+
+#if defined WIN32
+#include <winsock2.h>       /**< Include Winsock 2 library for Windows */
+#include <ws2tcpip.h>       /**< Include getaddrinfo() and struct sockaddr_storage */
+#else
+#include <sys/socket.h>     /**< Include socket library for UNIX systems */
+#include <netinet/in.h>     /**< Include for internet address family structures */
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* - - - - - - - - - - - - - - - - - - - - ADDRESSES - - - - - - - - - - - - - - - - - - - - */
+
+#define ADDRESS_TEXT_SIZE 64    /**< Room for a numeric IPv6 address with its scope */
+
+/**
+ * @brief Length of the socket address structure of a family.
+ *
+ * @param[in] address An IPv4 or IPv6 address.
+ *
+ * @return `sizeof(struct sockaddr_in6)` for IPv6, `sizeof(struct sockaddr_in)` otherwise.
+ */
+socklen_t address_size(const struct sockaddr_storage *address);
+
+/**
+ * @brief Resolves a listen endpoint into the addresses to bind.
+ *
+ * The endpoint is `HOST`, `HOST:PORT`, `[IPV6]:PORT` or `:PORT`. An empty host or `*` selects
+ * the dual-stack wildcard `::`. On POSIX systems `HOST` may also be an interface name, which
+ * selects every IPv4 and IPv6 address of that interface.
+ *
+ * @param[in] endpoint The endpoint text.
+ * @param[in] default_port Port used when the endpoint has none.
+ * @param[out] addresses Destination of the addresses.
+ * @param[in] capacity Maximum number of addresses stored.
+ *
+ * @return The number of addresses stored, 0 if the endpoint cannot be resolved.
+ */
+unsigned int resolve_endpoint(const char *endpoint, unsigned short default_port,
+                              struct sockaddr_storage *addresses, unsigned int capacity);
+
+/**
+ * @brief Writes the numeric host and the port of an address.
+ *
+ * IPv4-mapped IPv6 addresses are written as plain IPv4 addresses.
+ *
+ * @param[in] address The address.
+ * @param[out] host Destination of the host, at least `ADDRESS_TEXT_SIZE` bytes.
+ * @param[out] port Port in host byte order.
+ */
+void format_address(const struct sockaddr_storage *address, char *host, unsigned short *port);
+
+/**
+ * @brief Non-zero 32-bit digest identifying the client behind an address.
+ *
+ * IPv4 clients (mapped or not) are identified by their address, IPv6 clients by their /64
+ * prefix, the smallest block usually assigned to one site.
+ *
+ * @param[in] address The address.
+ *
+ * @return The digest, never 0.
+ */
+uint32_t address_key(const struct sockaddr_storage *address);
+
+/* - - - - - - - - - - - - - - - - - - - END ADDRESSES - - - - - - - - - - - - - - - - - - - */
+
+#endif /* ADDRESS_H_ */
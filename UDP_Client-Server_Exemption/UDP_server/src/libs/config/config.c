@@ -0,0 +1,223 @@
+/**
+ * @file config.c
+ * @brief Implementation of the configuration file parser and of its atomic publication.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#include <stdio.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "config.h"
+#include "../ratelimit/ratelimit.h"
+
+/* - - - - - - - - - - - - - - - - - - - - CONFIG - - - - - - - - - - - - - - - - - - - - */
+
+static const ServerConfig default_config = {
+    MIN_PASSWORD_LENGTH, MAX_PASSWORD_LENGTH, MAX_BULK_COUNT, 0, 0, LOG_INFO, 1, DEFAULT_PORT, { { 0 } }, 0, 0
+};
+
+static _Atomic(const ServerConfig *) published = &default_config;
+
+/**
+ * @brief Fills a ServerConfig with the compile-time defaults.
+ */
+void default_server_config(ServerConfig *config) {
+    *config = default_config;
+}
+
+/**
+ * @brief Parses a whole decimal number within bounds.
+ */
+static bool parse_number(const char *text, long minimum, long maximum, long *number) {
+    char *end;
+    if (!isdigit((unsigned char)*text)) {
+        return false;
+    }
+    long value = strtol(text, &end, 10);
+    if (*end != '\0' || value < minimum || value > maximum) {
+        return false;
+    }
+    *number = value;
+    return true;
+}
+
+/**
+ * @brief Applies one setting to a configuration.
+ */
+bool apply_config_setting(ServerConfig *config, const char *key, const char *value) {
+    long number;
+
+    if (strcmp(key, "min-length") == 0 || strcmp(key, "max-length") == 0) {
+        if (!parse_number(value, MIN_PASSWORD_LENGTH, MAX_PASSWORD_LENGTH, &number)) {
+            return false;
+        }
+        *(key[1] == 'i' ? &config->min_length : &config->max_length) = (uint8_t)number;
+    } else if (strcmp(key, "max-count") == 0) {
+        if (!parse_number(value, 1, MAX_BULK_COUNT, &number)) {
+            return false;
+        }
+        config->max_count = (uint16_t)number;
+    } else if (strcmp(key, "rate-limit") == 0) {
+        if (!parse_number(value, 0, 1000000, &number)) {
+            return false;
+        }
+        config->rate = (uint32_t)number;
+    } else if (strcmp(key, "burst") == 0) {
+        if (!parse_number(value, 0, RATE_LIMIT_MAX_BURST, &number)) {
+            return false;
+        }
+        config->burst = (uint32_t)number;
+    } else if (strcmp(key, "log-level") == 0) {
+        const char *names[] = { "off", "error", "warning", "info", "debug" };
+        unsigned int found = 0;
+        while (found < 5 && strcmp(value, names[found]) != 0) {
+            found++;
+        }
+        if (found == 5) {
+            return false;
+        }
+        config->log_level = (LogLevel)found;
+    } else if (strcmp(key, "log-sample") == 0) {
+        if (!parse_number(value, 1, 1000000, &number)) {
+            return false;
+        }
+        config->log_sample = (unsigned int)number;
+    } else if (strcmp(key, "port") == 0) {
+        if (!parse_number(value, 1, 65535, &number)) {
+            return false;
+        }
+        config->port = (unsigned short)number;
+    } else if (strcmp(key, "listen") == 0) {
+        if (config->listen_count == MAX_LISTENERS || strlen(value) >= CONFIG_VALUE_SIZE) {
+            return false;
+        }
+        strcpy(config->listen[config->listen_count++], value);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Tells whether a key names a setting that can change while the server runs.
+ */
+bool is_live_setting(const char *key) {
+    const char *live[] = { "min-length", "max-length", "max-count", "rate-limit", "burst", "log-level", "log-sample" };
+    for (size_t i = 0; i < sizeof(live) / sizeof(live[0]); i++) {
+        if (strcmp(key, live[i]) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Splits a line into its key and value, in place.
+ *
+ * @return `false` for a blank or comment line.
+ */
+static bool split_setting(char *line, char **key, char **value) {
+    char *comment = strchr(line, '#');
+    if (comment != NULL) {
+        *comment = '\0';
+    }
+    while (isspace((unsigned char)*line)) {
+        line++;
+    }
+    size_t length = strlen(line);
+    while (length > 0 && isspace((unsigned char)line[length - 1])) {
+        line[--length] = '\0';
+    }
+    if (length == 0) {
+        return false;
+    }
+
+    *key = line;
+    while (*line != '\0' && *line != '=' && !isspace((unsigned char)*line)) {
+        line++;
+    }
+    char *separator = line;
+    while (isspace((unsigned char)*line)) {
+        line++;
+    }
+    if (*line == '=') {
+        line++;
+        while (isspace((unsigned char)*line)) {
+            line++;
+        }
+    }
+    *separator = '\0';
+    *value = line;
+    return true;
+}
+
+/**
+ * @brief Reads a configuration file on top of a configuration.
+ */
+bool load_config(const char *path, ServerConfig *config, unsigned int *error_line) {
+    FILE *file = fopen(path, "r");
+    *error_line = 0;
+    if (file == NULL) {
+        return false;
+    }
+
+    ServerConfig loaded = *config;
+    char line[CONFIG_LINE_SIZE];
+    unsigned int number = 0;
+    bool listed = false;
+    bool valid = true;
+    while (valid && fgets(line, sizeof(line), file) != NULL) {
+        number++;
+        char *key;
+        char *value;
+        if (strchr(line, '\n') == NULL && !feof(file)) {
+            valid = false;  /**< Longer than CONFIG_LINE_SIZE */
+        } else if (split_setting(line, &key, &value)) {
+            if (strcmp(key, "listen") == 0 && !listed) {
+                loaded.listen_count = 0;
+                listed = true;
+            }
+            valid = apply_config_setting(&loaded, key, value);
+        }
+    }
+    bool failed = ferror(file) != 0;
+    fclose(file);
+
+    if (!valid) {
+        *error_line = number;
+        return false;
+    }
+    if (failed || loaded.min_length > loaded.max_length) {
+        return false;
+    }
+    *config = loaded;
+    return true;
+}
+
+/**
+ * @brief Publishes a copy of a configuration under the next generation.
+ */
+const ServerConfig *publish_config(const ServerConfig *config) {
+    ServerConfig *copy = malloc(sizeof(*copy));
+    if (copy == NULL) {
+        return NULL;
+    }
+    *copy = *config;
+    copy->generation = atomic_load_explicit(&published, memory_order_relaxed)->generation + 1;
+    atomic_store_explicit(&published, copy, memory_order_release);
+    return copy;
+}
+
+/**
+ * @brief Returns the configuration in force.
+ */
+const ServerConfig *current_config(void) {
+    return atomic_load_explicit(&published, memory_order_acquire);
+}
+
+/* - - - - - - - - - - - - - - - - - - - END CONFIG - - - - - - - - - - - - - - - - - - - */
@@ -0,0 +1,126 @@
+/**
+ * @file config.h
+ * @brief Header file declaring the runtime configuration of the server and its live reload.
+ *
+ * The compile-time limits of `protocol.h` stay the bounds of the wire format and the sizes of
+ * the buffers; a configuration file can narrow them and tune the rate limit and the log while
+ * the server runs. The file holds one `key value` (or `key = value`) setting per line, with `#`
+ * starting a comment; the keys are the names of the matching command-line options:
+ *
+ *     listen 0.0.0.0:8080     # read at startup only, repeatable
+ *     port 8080               # read at startup only
+ *     min-length 8
+ *     max-length 32
+ *     max-count 1000
+ *     rate-limit 500          # 0 disables the limiter
+ *     burst 100               # 0 derives it from the rate
+ *     log-level info
+ *     log-sample 1
+ *
+ * The settings in force are published through a single atomic pointer: a reload parses the
+ * file into a new copy and swaps the pointer, so the serving threads read a consistent set
+ * with one load and never take a lock. The previous copy is never freed, since a thread may
+ * still be reading it; a reload leaks a few hundred bytes.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../log/log.h"
+#include "../../../../UDP_core/src/libs/protocol/protocol.h"
+
+/* - - - - - - - - - - - - - - - - - - - - CONFIG - - - - - - - - - - - - - - - - - - - - */
+
+#define CONFIG_VALUE_SIZE 64        /**< Longest value of a setting, terminator included */
+#define CONFIG_LINE_SIZE 256        /**< Longest line of a configuration file */
+
+/**
+ * @struct ServerConfig
+ * @brief Settings read from the configuration file and the command line.
+ */
+typedef struct {
+    uint8_t min_length;         /**< Shortest password served, at least `MIN_PASSWORD_LENGTH` */
+    uint8_t max_length;         /**< Longest password served, at most `MAX_PASSWORD_LENGTH` */
+    uint16_t max_count;         /**< Most passwords of a bulk request, at most `MAX_BULK_COUNT` */
+    uint32_t rate;              /**< Requests per second allowed per source; 0 disables the limiter */
+    uint32_t burst;             /**< Requests a source can send at once; 0 derives it from `rate` */
+    LogLevel log_level;         /**< Most verbose records written */
+    unsigned int log_sample;    /**< One access record out of `log_sample` is kept, per thread */
+    unsigned short port;        /**< Port of the endpoints that do not name one (startup only) */
+    char listen[MAX_LISTENERS][CONFIG_VALUE_SIZE]; /**< `listen` endpoints (startup only) */
+    unsigned int listen_count;  /**< Number of `listen` endpoints */
+    uint32_t generation;        /**< Number of the publication, starting at 1; 0 before any */
+} ServerConfig;
+
+/**
+ * @brief Fills a ServerConfig with the compile-time defaults of `protocol.h`.
+ *
+ * @param[out] config The configuration to initialize.
+ */
+void default_server_config(ServerConfig *config);
+
+/**
+ * @brief Applies one setting to a configuration.
+ *
+ * @param[in,out] config The configuration.
+ * @param[in] key The name of the setting, e.g. `max-length`.
+ * @param[in] value Its value, as written in the file or on the command line.
+ *
+ * @return `false` if the key is unknown or the value is out of range; `config` is then unchanged.
+ */
+bool apply_config_setting(ServerConfig *config, const char *key, const char *value);
+
+/**
+ * @brief Tells whether a key names a setting that can change while the server runs.
+ *
+ * @param[in] key The name of the setting.
+ *
+ * @return `true` for every known key but `listen` and `port`, `false` for those and unknown keys.
+ */
+bool is_live_setting(const char *key);
+
+/**
+ * @brief Reads a configuration file on top of a configuration.
+ *
+ * The keys absent from the file keep their value; the first `listen` of the file replaces the
+ * endpoints already listed. `min-length` must not end up above `max-length`.
+ *
+ * @param[in] path The path of the file.
+ * @param[in,out] config The configuration; unchanged on failure.
+ * @param[out] error_line Receives the line of the first invalid setting, or 0 if the file
+ *                        could not be read or the lengths do not fit together.
+ *
+ * @return `true` if every line is valid.
+ */
+bool load_config(const char *path, ServerConfig *config, unsigned int *error_line);
+
+/**
+ * @brief Publishes a configuration to every serving thread.
+ *
+ * The configuration is copied and numbered with the next generation. Only one thread at a
+ * time may publish (the primary worker, or the startup code).
+ *
+ * @param[in] config The new settings.
+ *
+ * @return The published copy, or NULL if it could not be allocated (the previous one stays).
+ */
+const ServerConfig *publish_config(const ServerConfig *config);
+
+/**
+ * @brief Returns the configuration in force.
+ *
+ * One acquire load: cheap enough for every request.
+ *
+ * @return The last published configuration, or the defaults before the first publication.
+ */
+const ServerConfig *current_config(void);
+
+/* - - - - - - - - - - - - - - - - - - - END CONFIG - - - - - - - - - - - - - - - - - - - */
+
+#endif /* CONFIG_H_ */
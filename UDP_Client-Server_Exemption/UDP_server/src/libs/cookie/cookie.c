@@ -0,0 +1,250 @@
+/**
+ * @file cookie.c
+ * @brief Implementation of the stateless anti-spoofing cookies with SipHash-2-4.
+ *
+ * The MAC covers the window number, the port and the address of the sender, with IPv4-mapped
+ * IPv6 addresses reduced to their IPv4 address so both forms get the same cookie.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#include <string.h>
+
+#include "cookie.h"
+#include "../../../../UDP_core/src/libs/random/random.h"
+
+/* - - - - - - - - - - - - - - - - - - - - SIPHASH - - - - - - - - - - - - - - - - - - - - */
+
+#define ROTATE_LEFT64(value, bits) (((value) << (bits)) | ((value) >> (64 - (bits))))
+
+#define SIP_ROUND(v0, v1, v2, v3)                                                   \
+    do {                                                                            \
+        v0 += v1; v1 = ROTATE_LEFT64(v1, 13); v1 ^= v0; v0 = ROTATE_LEFT64(v0, 32); \
+        v2 += v3; v3 = ROTATE_LEFT64(v3, 16); v3 ^= v2;                             \
+        v0 += v3; v3 = ROTATE_LEFT64(v3, 21); v3 ^= v0;                             \
+        v2 += v1; v1 = ROTATE_LEFT64(v1, 17); v1 ^= v2; v2 = ROTATE_LEFT64(v2, 32); \
+    } while (0)
+
+static uint64_t cookie_key[2];      /**< Secret of the cookies */
+static bool keyed;                  /**< Whether `cookie_key` is set */
+static bool cookies;                /**< Whether every v2 request needs a cookie */
+static bool legacy;                 /**< Whether the v1 requests are served with the cookies enabled */
+
+/**
+ * @brief Loads a 64-bit word stored in little-endian order.
+ */
+static uint64_t load_le64(const uint8_t *bytes) {
+    uint64_t word = 0;
+    for (int i = 7; i >= 0; i--) {
+        word = (word << 8) | bytes[i];
+    }
+    return word;
+}
+
+/**
+ * @brief Computes the SipHash-2-4 of a message under a 128-bit key.
+ */
+static uint64_t siphash24(const uint64_t key[2], const uint8_t *message, size_t size) {
+    uint64_t v0 = 0x736f6d6570736575ULL ^ key[0];
+    uint64_t v1 = 0x646f72616e646f6dULL ^ key[1];
+    uint64_t v2 = 0x6c7967656e657261ULL ^ key[0];
+    uint64_t v3 = 0x7465646279746573ULL ^ key[1];
+    size_t blocks = size & ~(size_t)7;
+
+    for (size_t i = 0; i < blocks; i += 8) {
+        uint64_t word = load_le64(message + i);
+        v3 ^= word;
+        SIP_ROUND(v0, v1, v2, v3);
+        SIP_ROUND(v0, v1, v2, v3);
+        v0 ^= word;
+    }
+    uint64_t last = (uint64_t)size << 56;
+    for (size_t i = blocks; i < size; i++) {
+        last |= (uint64_t)message[i] << (8 * (i - blocks));
+    }
+    v3 ^= last;
+    SIP_ROUND(v0, v1, v2, v3);
+    SIP_ROUND(v0, v1, v2, v3);
+    v0 ^= last;
+
+    v2 ^= 0xff;
+    for (int round = 0; round < 4; round++) {
+        SIP_ROUND(v0, v1, v2, v3);
+    }
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+/**
+ * @brief Checks `siphash24` against reference vectors of the SipHash paper, on each side of the
+ *        8-byte block boundaries: key 00..0f, message 00..(n-1).
+ */
+static bool siphash_self_test(void) {
+    static const struct {
+        size_t size;
+        uint64_t hash;
+    } vectors[] = {
+        { 0, 0x726fdb47dd0e0e31ULL },
+        { 1, 0x74f839c593dc67fdULL },
+        { 7, 0xab0200f58b01d137ULL },
+        { 8, 0x93f5f5799a932462ULL },
+        { 15, 0xa129ca6149be45e5ULL },
+        { 63, 0x958a324ceb064572ULL }
+    };
+    uint8_t bytes[64];
+    for (size_t i = 0; i < sizeof(bytes); i++) {
+        bytes[i] = (uint8_t)i;
+    }
+    const uint64_t key[2] = { load_le64(bytes), load_le64(bytes + 8) };
+    for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        if (siphash24(key, bytes, vectors[i].size) != vectors[i].hash) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* - - - - - - - - - - - - - - - - - - - - END SIPHASH - - - - - - - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - - - - - - COOKIES - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Checks SipHash-2-4 and draws the secret of the cookies, once.
+ */
+bool init_cookies(void) {
+    uint8_t secret[sizeof(cookie_key)];
+    if (keyed) {
+        return true;
+    }
+    if (!siphash_self_test() || !system_random_bytes(secret, sizeof(secret))) {
+        return false;
+    }
+    cookie_key[0] = load_le64(secret);
+    cookie_key[1] = load_le64(secret + 8);
+    memset(secret, 0, sizeof(secret));
+    keyed = true;
+    return true;
+}
+
+/**
+ * @brief Draws the secret of the cookies if needed and requires them on every v2 request.
+ */
+bool enable_cookies(void) {
+    if (!init_cookies()) {
+        return false;
+    }
+    cookies = true;
+    return true;
+}
+
+/**
+ * @brief Keeps serving the large enough v1 requests once the cookies are enabled.
+ */
+void allow_legacy_requests(void) {
+    legacy = true;
+}
+
+/**
+ * @brief Computes the cookie of a sender for a window.
+ */
+static void compute_cookie(const struct sockaddr_storage *address, uint32_t window, uint8_t *cookie) {
+    uint8_t message[6 + 16];   /**< Window, port, then 4 or 16 address bytes */
+    size_t size = 6;
+    const uint8_t *port;
+
+    message[0] = (uint8_t)(window >> 24);
+    message[1] = (uint8_t)(window >> 16);
+    message[2] = (uint8_t)(window >> 8);
+    message[3] = (uint8_t)window;
+    if (address->ss_family == AF_INET6) {
+        const struct sockaddr_in6 *ipv6 = (const struct sockaddr_in6 *)address;
+        bool mapped = IN6_IS_ADDR_V4MAPPED(&ipv6->sin6_addr);
+        port = (const uint8_t *)&ipv6->sin6_port;
+        memcpy(message + size, ipv6->sin6_addr.s6_addr + (mapped ? 12 : 0), mapped ? 4 : 16);
+        size += mapped ? 4 : 16;
+    } else {
+        const struct sockaddr_in *ipv4 = (const struct sockaddr_in *)address;
+        port = (const uint8_t *)&ipv4->sin_port;
+        memcpy(message + size, &ipv4->sin_addr, 4);
+        size += 4;
+    }
+    message[4] = port[0];
+    message[5] = port[1];
+
+    uint64_t tag = siphash24(cookie_key, message, size);
+    for (int i = 0; i < COOKIE_SIZE; i++) {
+        cookie[i] = (uint8_t)(tag >> (8 * i));
+    }
+}
+
+/**
+ * @brief Compares two cookies in constant time.
+ */
+static bool same_cookie(const uint8_t *first, const uint8_t *second) {
+    uint8_t difference = 0;
+    for (int i = 0; i < COOKIE_SIZE; i++) {
+        difference |= first[i] ^ second[i];
+    }
+    return difference == 0;
+}
+
+/**
+ * @brief Checks the cookie of a decoded request against the current and the previous windows.
+ */
+CookieVerdict check_cookie(const PasswordRequest *request, size_t datagram_size,
+                           const struct sockaddr_storage *address, uint64_t now_ms) {
+    size_t free_size = COOKIE_FREE_BULK_SIZE - ((request->flags & REQUEST_FLAG_SEALED) ? SEAL_OVERHEAD : 0);
+    bool large_bulk = (request->flags & REQUEST_FLAG_BULK) && (size_t)request->count * request->length > free_size;
+    if (!cookies && !large_bulk) {
+        return COOKIE_VALID;
+    }
+    if (!keyed) {
+        return COOKIE_DROP; /**< init_cookies was not called: nothing to check a cookie with */
+    }
+    if (request->flags & REQUEST_FLAG_LEGACY) {
+        return legacy && datagram_size >= sizeof(LegacyPasswordResponse) ? COOKIE_VALID : COOKIE_DROP;
+    }
+    if (datagram_size < REQUEST_HEADER_SIZE) {
+        return COOKIE_DROP;
+    }
+    if (!(request->flags & REQUEST_FLAG_COOKIE)) {
+        return COOKIE_CHALLENGE;
+    }
+
+    uint32_t window = (uint32_t)(now_ms / COOKIE_WINDOW_MS);
+    uint8_t expected[COOKIE_SIZE];
+    compute_cookie(address, window, expected);
+    if (same_cookie(request->cookie, expected)) {
+        return COOKIE_VALID;
+    }
+    compute_cookie(address, window - 1, expected);
+    return same_cookie(request->cookie, expected) ? COOKIE_VALID : COOKIE_CHALLENGE;
+}
+
+/**
+ * @brief Writes the challenge answering a request with the cookie of its sender.
+ */
+size_t encode_cookie_challenge(const PasswordRequest *request, const struct sockaddr_storage *address,
+                               uint64_t now_ms, uint8_t *response) {
+    uint8_t flags = request->flags & (uint8_t)~REQUEST_FLAG_SEALED;   /**< A challenge is never sealed */
+    size_t size;
+
+    if (request->flags & REQUEST_FLAG_BULK) {
+        BulkResponseHeader header;
+        header.status = STATUS_COOKIE_REQUIRED;
+        header.length = COOKIE_SIZE;
+        header.flags = flags;
+        header.request_id = request->request_id;
+        header.sequence = 0;
+        header.total = 1;
+        header.items = 1;
+        size = encode_bulk_header(&header, response, BULK_HEADER_SIZE);
+    } else {
+        size = encode_response_header(STATUS_COOKIE_REQUIRED, COOKIE_SIZE, flags, request->request_id, response);
+    }
+    compute_cookie(address, (uint32_t)(now_ms / COOKIE_WINDOW_MS), response + size);
+    return size + COOKIE_SIZE;
+}
+
+/* - - - - - - - - - - - - - - - - - - - END COOKIES - - - - - - - - - - - - - - - - - - - */
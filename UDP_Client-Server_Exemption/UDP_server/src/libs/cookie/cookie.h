@@ -0,0 +1,131 @@
+/**
+ * @file cookie.h
+ * @brief Header file declaring the stateless anti-spoofing cookies of the server.
+ *
+ * With cookies enabled, a v2 request is only served when it echoes a cookie (see
+ * `REQUEST_FLAG_COOKIE`); any other one is answered with a challenge carrying the cookie of its
+ * sender. The cookie is a MAC of the address and port of the sender and of the current time
+ * window under a secret drawn at startup, so the server keeps no state per client: a check
+ * recomputes the MAC and compares it. A forged source never sees its challenge, so it cannot
+ * get a password sent to its victim, and every challenge is barely larger than the request
+ * that triggered it.
+ *
+ * The MAC is SipHash-2-4, which checks a cookie in a few tens of nanoseconds, well below the
+ * cost of a password. A cookie is accepted during the window it was given in and the next
+ * one, so it lives between `COOKIE_WINDOW_MS` and twice that long.
+ *
+ * A bulk request asking for more than one datagram of passwords (`COOKIE_FREE_BULK_SIZE`,
+ * less the trailer when it is sealed) needs a cookie even when the cookies are not enabled:
+ * otherwise a 10-byte request with a forged source would make the server send tens of
+ * kilobytes to its victim.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef COOKIE_H_
+#define COOKIE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "../address/address.h"
+#include "../../../../UDP_core/src/libs/protocol/protocol.h"
+
+/* - - - - - - - - - - - - - - - - - - - - COOKIES - - - - - - - - - - - - - - - - - - - - */
+
+#define COOKIE_WINDOW_MS 60000      /**< Length of a cookie window, in milliseconds */
+
+#define COOKIE_FREE_BULK_SIZE (MAX_DATAGRAM_SIZE - BULK_HEADER_SIZE) /**< Password bytes of one bulk datagram, served without a cookie */
+
+/**
+ * @brief Size of a challenge: a v2 response header and the cookie.
+ */
+#define COOKIE_CHALLENGE_SIZE (RESPONSE_HEADER_SIZE + COOKIE_SIZE)
+
+/**
+ * @brief Size of the challenge of a bulk request: a bulk header and the cookie.
+ */
+#define BULK_COOKIE_CHALLENGE_SIZE (BULK_HEADER_SIZE + COOKIE_SIZE)
+
+/**
+ * @enum CookieVerdict
+ * @brief What to do with a received request.
+ */
+typedef enum {
+    COOKIE_VALID,       /**< Serve the request */
+    COOKIE_CHALLENGE,   /**< Answer with a challenge instead (see `encode_cookie_challenge`) */
+    COOKIE_DROP         /**< Ignore the datagram: even a challenge would be larger than it */
+} CookieVerdict;
+
+/**
+ * @brief Checks SipHash-2-4 and draws the secret of the cookies.
+ *
+ * Must be called before the workers start, whether the cookies are enabled or not: the large
+ * bulk requests always need one. SipHash is first checked against the reference vectors of
+ * its paper, so a broken MAC never hands out cookies that cannot be checked. Calling it again
+ * keeps the secret.
+ *
+ * @return `true` on success, `false` if the self-test failed or the entropy source could not
+ *         be read.
+ */
+bool init_cookies(void);
+
+/**
+ * @brief Requires a cookie on every v2 request, calling `init_cookies` if needed.
+ *
+ * Must be called before the workers start.
+ *
+ * @return `false` if `init_cookies` failed.
+ */
+bool enable_cookies(void);
+
+/**
+ * @brief Keeps serving the v1 requests once the cookies are enabled.
+ *
+ * A v1 request carries no cookie: its sender is never checked, so by default the cookies drop
+ * them all. With this opt-in a v1 request is served when its datagram is at least as large as
+ * its answer, so a forged one reflects no more bytes than it took to send, but it still gets
+ * a password sent to any source. Must be called before the workers start.
+ */
+void allow_legacy_requests(void);
+
+/**
+ * @brief Checks the cookie of a decoded request.
+ *
+ * Legacy (v1) requests carry no cookie: with the cookies enabled they are dropped, unless
+ * `allow_legacy_requests` was called and the datagram is at least as large as its answer, so
+ * they cannot amplify a flood. The v2 datagrams shorter than a request header are dropped.
+ *
+ * @param[in] request The decoded request.
+ * @param[in] datagram_size Number of bytes of the received datagram.
+ * @param[in] address The address of the sender.
+ * @param[in] now_ms Current monotonic time in milliseconds, on 64 bits: a 32-bit time would
+ *            wrap after 49.7 days and bring back the windows of the start.
+ *
+ * @return The verdict; always `COOKIE_VALID` when cookies are disabled, except for the bulk
+ *         requests asking for more than `COOKIE_FREE_BULK_SIZE` bytes.
+ */
+CookieVerdict check_cookie(const PasswordRequest *request, size_t datagram_size,
+                           const struct sockaddr_storage *address, uint64_t now_ms);
+
+/**
+ * @brief Writes the challenge answering a request with the cookie of its sender.
+ *
+ * The challenge copies the flags and the ID of the request, without `REQUEST_FLAG_SEALED`,
+ * and is laid out as a bulk response of one datagram for bulk requests.
+ *
+ * @param[in] request The decoded request.
+ * @param[in] address The address of the sender.
+ * @param[in] now_ms Current monotonic time in milliseconds, on 64 bits.
+ * @param[out] response Destination, at least `BULK_COOKIE_CHALLENGE_SIZE` bytes.
+ *
+ * @return The number of bytes to send: `COOKIE_CHALLENGE_SIZE` or `BULK_COOKIE_CHALLENGE_SIZE`.
+ */
+size_t encode_cookie_challenge(const PasswordRequest *request, const struct sockaddr_storage *address,
+                               uint64_t now_ms, uint8_t *response);
+
+/* - - - - - - - - - - - - - - - - - - - END COOKIES - - - - - - - - - - - - - - - - - - - */
+
+#endif /* COOKIE_H_ */
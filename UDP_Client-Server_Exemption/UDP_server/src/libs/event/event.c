@@ -0,0 +1,300 @@
+/**
+ * @file event.c
+ * @brief Implementation of the event loop on epoll, kqueue and select.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#if defined WIN32
+#include <winsock2.h>       /**< Includes select() and ioctlsocket() */
+#include <windows.h>        /**< Includes GetTickCount64() */
+#else
+#include <unistd.h>         /**< Includes close() */
+#include <fcntl.h>          /**< Includes fcntl() */
+#include <errno.h>
+#include <time.h>           /**< Includes clock_gettime() */
+#include <sys/select.h>     /**< Includes select() */
+#if defined __linux__
+#include <sys/epoll.h>
+#define EVENT_EPOLL
+#elif defined __APPLE__ || defined __FreeBSD__ || defined __OpenBSD__ || defined __NetBSD__
+#include <sys/types.h>
+#include <sys/event.h>
+#define EVENT_KQUEUE
+#endif
+#endif
+
+#include <string.h>
+#include "event.h"
+
+#define EVENT_BATCH 16     /**< Readiness events fetched per wait */
+
+/* - - - - - - - - - - - - - - - - - - - - EVENT LOOP - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Monotonic time in milliseconds.
+ */
+static uint64_t monotonic_ms(void) {
+#if defined WIN32
+    return (uint64_t)GetTickCount64();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+#endif
+}
+
+/**
+ * @brief Switches a socket to non-blocking mode.
+ */
+static bool set_nonblocking(int socket) {
+#if defined WIN32
+    u_long enable = 1;
+    return ioctlsocket(socket, FIONBIO, &enable) == 0;
+#else
+    int flags = fcntl(socket, F_GETFL, 0);
+    return flags >= 0 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+}
+
+/**
+ * @brief Creates the backend of a loop.
+ */
+bool event_loop_init(EventLoop *loop) {
+    memset(loop, 0, sizeof(*loop));
+#if defined EVENT_EPOLL
+    loop->backend = epoll_create1(EPOLL_CLOEXEC);
+    return loop->backend >= 0;
+#elif defined EVENT_KQUEUE
+    loop->backend = kqueue();
+    return loop->backend >= 0;
+#else
+    loop->backend = -1;
+    return true;
+#endif
+}
+
+/**
+ * @brief Registers a socket, switching it to non-blocking mode.
+ */
+bool event_loop_add_socket(EventLoop *loop, int socket, SocketHandler handler, void *context) {
+    if (loop->source_count == EVENT_MAX_SOURCES || !set_nonblocking(socket)) {
+        return false;
+    }
+    EventSource *source = &loop->sources[loop->source_count];
+    source->socket = socket;
+    source->handler = handler;
+    source->context = context;
+
+#if defined EVENT_EPOLL
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | EPOLLET;
+    event.data.ptr = source;
+    if (epoll_ctl(loop->backend, EPOLL_CTL_ADD, socket, &event) < 0) {
+        return false;
+    }
+#elif defined EVENT_KQUEUE
+    struct kevent change;
+    EV_SET(&change, socket, EVFILT_READ, EV_ADD | EV_CLEAR, 0, 0, source);
+    if (kevent(loop->backend, &change, 1, NULL, 0, NULL) < 0) {
+        return false;
+    }
+#endif
+    loop->source_count++;
+    return true;
+}
+
+/**
+ * @brief Registers a periodic timer.
+ */
+bool event_loop_add_timer(EventLoop *loop, uint32_t interval_ms, TimerHandler handler, void *context) {
+    if (loop->timer_count == EVENT_MAX_TIMERS || interval_ms == 0) {
+        return false;
+    }
+    EventTimer *timer = &loop->timers[loop->timer_count++];
+    timer->interval_ms = interval_ms;
+    timer->deadline_ms = monotonic_ms() + interval_ms;
+    timer->handler = handler;
+    timer->context = context;
+    return true;
+}
+
+/**
+ * @brief Runs the expired timers.
+ * @return Milliseconds until the next deadline, or -1 if there is no timer.
+ */
+static int run_timers(EventLoop *loop) {
+    if (loop->timer_count == 0) {
+        return -1;
+    }
+    uint64_t now = monotonic_ms();
+    uint64_t next = UINT64_MAX;
+    for (unsigned int i = 0; i < loop->timer_count; i++) {
+        EventTimer *timer = &loop->timers[i];
+        if (timer->deadline_ms <= now) {
+            timer->handler(timer->context);
+            while (timer->deadline_ms <= now) {
+                timer->deadline_ms += timer->interval_ms; /**< Skip the periods missed while busy */
+            }
+        }
+        if (timer->deadline_ms < next) {
+            next = timer->deadline_ms;
+        }
+    }
+    return (int)(next - now);
+}
+
+/**
+ * @brief Waits for readiness and runs the handlers of the ready sockets.
+ * @return `false` if the backend or a handler failed.
+ */
+static bool dispatch(EventLoop *loop, int timeout_ms) {
+#if defined EVENT_EPOLL
+    struct epoll_event events[EVENT_BATCH];
+    int ready = epoll_wait(loop->backend, events, EVENT_BATCH, timeout_ms);
+    if (ready < 0) {
+        return errno == EINTR;
+    }
+    for (int i = 0; i < ready; i++) {
+        EventSource *source = events[i].data.ptr;
+        if (!source->handler(source->socket, source->context)) {
+            return false;
+        }
+    }
+    return true;
+#elif defined EVENT_KQUEUE
+    struct kevent events[EVENT_BATCH];
+    struct timespec timeout = { timeout_ms / 1000, (long)(timeout_ms % 1000) * 1000000 };
+    int ready = kevent(loop->backend, NULL, 0, events, EVENT_BATCH, timeout_ms < 0 ? NULL : &timeout);
+    if (ready < 0) {
+        return errno == EINTR;
+    }
+    for (int i = 0; i < ready; i++) {
+        EventSource *source = events[i].udata;
+        if (!source->handler(source->socket, source->context)) {
+            return false;
+        }
+    }
+    return true;
+#else
+    fd_set readable;
+    int highest = -1;
+    FD_ZERO(&readable);
+    for (unsigned int i = 0; i < loop->source_count; i++) {
+        FD_SET(loop->sources[i].socket, &readable);
+        if (loop->sources[i].socket > highest) {
+            highest = loop->sources[i].socket;
+        }
+    }
+    struct timeval timeout = { timeout_ms / 1000, (long)(timeout_ms % 1000) * 1000 };
+    int ready = select(highest + 1, &readable, NULL, NULL, timeout_ms < 0 ? NULL : &timeout);
+    if (ready < 0) {
+        return last_socket_result() == IO_INTERRUPTED;
+    }
+    for (unsigned int i = 0; ready > 0 && i < loop->source_count; i++) {
+        EventSource *source = &loop->sources[i];
+        if (FD_ISSET(source->socket, &readable) && !source->handler(source->socket, source->context)) {
+            return false;
+        }
+    }
+    return true;
+#endif
+}
+
+/**
+ * @brief Runs the loop until it is stopped or fails.
+ */
+bool event_loop_run(EventLoop *loop) {
+    while (!loop->stopped) {
+        int timeout_ms = run_timers(loop);
+        if (!dispatch(loop, timeout_ms)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Asks the loop to return after the current handlers.
+ */
+void event_loop_stop(EventLoop *loop) {
+    loop->stopped = true;
+}
+
+/**
+ * @brief Releases the backend of a loop.
+ */
+void event_loop_close(EventLoop *loop) {
+#if defined EVENT_EPOLL || defined EVENT_KQUEUE
+    if (loop->backend >= 0) {
+        close(loop->backend);
+    }
+#endif
+    loop->backend = -1;
+    loop->source_count = 0;
+    loop->timer_count = 0;
+}
+
+/**
+ * @brief Classifies the error code of a failed socket call.
+ */
+IoResult socket_error_result(int error) {
+    switch (error) {
+#if defined WIN32
+        case WSAEWOULDBLOCK:
+            return IO_AGAIN;
+        case WSAEINTR:
+            return IO_INTERRUPTED;
+        case WSAECONNRESET:     /**< ICMP port unreachable, when SIO_UDP_CONNRESET is still on */
+        case WSAENETRESET:      /**< ICMP TTL expired */
+        case WSAEHOSTUNREACH:
+        case WSAENETUNREACH:
+        case WSAEADDRNOTAVAIL:
+        case WSAEACCES:
+        case WSAEMSGSIZE:
+        case WSAENOBUFS:
+            return IO_TRANSIENT;
+#else
+        case EAGAIN:
+#if EWOULDBLOCK != EAGAIN
+        case EWOULDBLOCK:
+#endif
+            return IO_AGAIN;
+        case EINTR:
+            return IO_INTERRUPTED;
+        case ECONNREFUSED:      /**< ICMP port unreachable from an earlier datagram */
+        case ECONNRESET:
+        case EHOSTUNREACH:
+        case ENETUNREACH:
+        case ENETDOWN:
+        case EADDRNOTAVAIL:
+        case EACCES:            /**< Broadcast destination */
+        case EPERM:             /**< Dropped by a firewall rule */
+        case EMSGSIZE:
+        case ENOBUFS:
+        case ENOMEM:
+#if defined EHOSTDOWN
+        case EHOSTDOWN:
+#endif
+            return IO_TRANSIENT;
+#endif
+        default:
+            return IO_ERROR;
+    }
+}
+
+/**
+ * @brief Result of a socket call that returned a negative value.
+ */
+IoResult last_socket_result(void) {
+#if defined WIN32
+    return socket_error_result(WSAGetLastError());
+#else
+    return socket_error_result(errno);
+#endif
+}
+
+/* - - - - - - - - - - - - - - - - - - - END EVENT LOOP - - - - - - - - - - - - - - - - - - - */
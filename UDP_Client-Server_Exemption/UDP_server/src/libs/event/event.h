@@ -0,0 +1,174 @@
+/**
+ * @file event.h
+ * @brief Header file declaring the event loop that drives the sockets and timers of a worker.
+ *
+ * One loop per worker waits for readiness on all of its sockets (data, admin) and for the next
+ * timer deadline in a single call, then runs the matching handlers:
+ * - epoll on Linux and kqueue on BSD/macOS, both edge-triggered;
+ * - `select` elsewhere (Windows included), which is level-triggered but drives the same handlers.
+ *
+ * Sockets added to a loop are switched to non-blocking mode, and because readiness is reported
+ * only on edges a handler must drain its socket until the receive call would block. The helpers
+ * at the end of the file classify the error of the last socket call portably for that purpose.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef EVENT_H_
+#define EVENT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* - - - - - - - - - - - - - - - - - - - - EVENT LOOP - - - - - - - - - - - - - - - - - - - - */
+
+#define EVENT_MAX_SOURCES 8     /**< Sockets a loop can drive */
+#define EVENT_MAX_TIMERS 8      /**< Timers a loop can drive */
+
+/**
+ * @brief Called when a socket becomes readable.
+ *
+ * @param[in] socket The readable socket.
+ * @param[in] context The pointer given to `event_loop_add_socket`.
+ *
+ * @return `false` to stop the loop because of a fatal error.
+ */
+typedef bool (*SocketHandler)(int socket, void *context);
+
+/**
+ * @brief Called when a timer expires.
+ *
+ * @param[in] context The pointer given to `event_loop_add_timer`.
+ */
+typedef void (*TimerHandler)(void *context);
+
+/**
+ * @struct EventSource
+ * @brief A socket registered with a loop.
+ */
+typedef struct {
+    int socket;                 /**< The socket descriptor */
+    SocketHandler handler;      /**< Called when the socket is readable */
+    void *context;              /**< Passed to `handler` */
+} EventSource;
+
+/**
+ * @struct EventTimer
+ * @brief A periodic timer registered with a loop.
+ */
+typedef struct {
+    uint64_t interval_ms;       /**< Period */
+    uint64_t deadline_ms;       /**< Next expiry, on the loop's monotonic clock */
+    TimerHandler handler;       /**< Called at every expiry */
+    void *context;              /**< Passed to `handler` */
+} EventTimer;
+
+/**
+ * @struct EventLoop
+ * @brief Sockets, timers and backend descriptor of one loop.
+ */
+typedef struct {
+    int backend;                                /**< epoll or kqueue descriptor, -1 for `select` */
+    EventSource sources[EVENT_MAX_SOURCES];     /**< Registered sockets */
+    unsigned int source_count;                  /**< Number of registered sockets */
+    EventTimer timers[EVENT_MAX_TIMERS];        /**< Registered timers */
+    unsigned int timer_count;                   /**< Number of registered timers */
+    bool stopped;                               /**< Set by `event_loop_stop` */
+} EventLoop;
+
+/**
+ * @enum IoResult
+ * @brief Outcome of a non-blocking socket call.
+ */
+typedef enum {
+    IO_DONE,        /**< The call transferred data */
+    IO_AGAIN,       /**< Nothing to do until the next readiness event */
+    IO_INTERRUPTED, /**< Interrupted by a signal: the call must be repeated */
+    IO_TRANSIENT,   /**< Failed because of one datagram or peer: skip it and go on */
+    IO_ERROR        /**< The socket itself failed: the worker must stop */
+} IoResult;
+
+/**
+ * @brief Creates the backend of a loop.
+ *
+ * @param[out] loop The loop to initialize.
+ *
+ * @return `false` if the backend descriptor could not be created.
+ */
+bool event_loop_init(EventLoop *loop);
+
+/**
+ * @brief Registers a socket, switching it to non-blocking mode.
+ *
+ * @param[in,out] loop The loop.
+ * @param[in] socket The socket descriptor.
+ * @param[in] handler Called when the socket is readable.
+ * @param[in] context Passed to `handler`.
+ *
+ * @return `false` if the loop is full or the socket could not be registered.
+ */
+bool event_loop_add_socket(EventLoop *loop, int socket, SocketHandler handler, void *context);
+
+/**
+ * @brief Registers a periodic timer; its first expiry is one interval from now.
+ *
+ * @param[in,out] loop The loop.
+ * @param[in] interval_ms Period, at least 1 ms.
+ * @param[in] handler Called at every expiry.
+ * @param[in] context Passed to `handler`.
+ *
+ * @return `false` if the loop is full.
+ */
+bool event_loop_add_timer(EventLoop *loop, uint32_t interval_ms, TimerHandler handler, void *context);
+
+/**
+ * @brief Runs the loop until `event_loop_stop` is called or a handler or the backend fails.
+ *
+ * @param[in,out] loop The loop.
+ *
+ * @return `true` if the loop was stopped, `false` on failure.
+ */
+bool event_loop_run(EventLoop *loop);
+
+/**
+ * @brief Asks the loop to return after the current handlers.
+ *
+ * @param[in,out] loop The loop.
+ */
+void event_loop_stop(EventLoop *loop);
+
+/**
+ * @brief Releases the backend of a loop (the sockets are not closed).
+ *
+ * @param[in,out] loop The loop.
+ */
+void event_loop_close(EventLoop *loop);
+
+/**
+ * @brief Classifies the error code of a failed socket call.
+ *
+ * An unconnected UDP socket reports on its next call the ICMP errors caused by an earlier
+ * datagram (port or host unreachable, `ECONNREFUSED`/`WSAECONNRESET` once a client has gone
+ * away), and a send can fail for one destination only (no route, filtered, no buffer space).
+ * None of these says anything about the socket, so they are `IO_TRANSIENT`; only the errors
+ * of the descriptor itself (closed, not a socket, bad memory, ...) are `IO_ERROR`.
+ *
+ * @param[in] error An `errno` value, or a `WSAGetLastError` value on Windows.
+ *
+ * @return The IoResult of the error.
+ */
+IoResult socket_error_result(int error);
+
+/**
+ * @brief Result of a socket call that returned a negative value.
+ *
+ * @return `IO_AGAIN` if the call would have blocked, `IO_INTERRUPTED` if a signal interrupted it,
+ *         `IO_TRANSIENT` for an error tied to one datagram or peer, `IO_ERROR` otherwise.
+ */
+IoResult last_socket_result(void);
+
+/* - - - - - - - - - - - - - - - - - - - END EVENT LOOP - - - - - - - - - - - - - - - - - - - */
+
+#endif /* EVENT_H_ */
@@ -0,0 +1,247 @@
+/**
+ * @file handler.c
+ * @brief Implementation of the decoding and answering of a single password request.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#include <ctype.h>
+#include <string.h>
+#include <stdbool.h>
+#include "handler.h"
+#include "../config/config.h"
+#include "../metrics/metrics.h"
+#include "../../../../UDP_core/src/libs/random/random.h"
+#include "../reservoir/reservoir.h"
+
+#if defined _MSC_VER
+#define THREAD_LOCAL __declspec(thread)  /**< Thread-local storage qualifier for MSVC */
+#else
+#define THREAD_LOCAL _Thread_local       /**< Thread-local storage qualifier for C11 compilers */
+#endif
+
+#define NONCE_SALT_SIZE (SEAL_NONCE_SIZE - 4)   /**< Random part of a nonce, before the counter */
+
+/* - - - - - - - - - - - - - - - - - - - - HANDLER - - - - - - - - - - - - - - - - - - - - */
+
+static SealKey response_key;        /**< Key of the sealed responses */
+static bool sealing;                /**< Whether `response_key` is set */
+
+static THREAD_LOCAL uint8_t nonce_salt[NONCE_SALT_SIZE]; /**< Random part of the nonces of the calling thread */
+static THREAD_LOCAL uint32_t nonce_counter;              /**< Nonces sealed with `nonce_salt`, modulo 2^32 */
+
+/**
+ * @brief Maps the type letter of a request to a PasswordType.
+ * @param[in] type The type letter sent by the client (case-insensitive).
+ * @return The matching PasswordType, `NUMERIC` for unknown letters.
+ */
+PasswordType parse_password_type(char type) {
+	switch (tolower(type)) {
+		case 'n': return NUMERIC;
+		case 'a': return ALPHA;
+		case 'm': return MIXED;
+		case 's': return SECURE;
+		case 'u': return UNAMBIGUOUS;
+		default: return NUMERIC;
+	}
+}
+
+/**
+ * @brief Writes a password, taken from the reservoir when it has one ready.
+ * @param[out] password Destination of `length` characters and a null terminator.
+ * @param[in] type The password type.
+ * @param[in] length The password length, already validated.
+ */
+void fill_password(char *password, PasswordType type, int length) {
+    if (!take_password(password, type, length)) {
+        if (reservoir_enabled()) {
+            count_metric(METRIC_RESERVOIR_MISSES, 1);
+        }
+        generate_password(password, type, length);
+    }
+}
+
+/**
+ * @brief Makes the server seal the responses with a pre-shared key.
+ */
+void enable_sealing(const SealKey *key) {
+    response_key = *key;
+    sealing = true;
+}
+
+/**
+ * @brief Tells whether a request matches the sealing of the server.
+ */
+static ResponseStatus sealing_status(const PasswordRequest *request) {
+    if (request->flags & REQUEST_FLAG_SEALED) {
+        return sealing ? STATUS_OK : STATUS_SEALING_UNAVAILABLE;
+    }
+    return sealing ? STATUS_SEALING_REQUIRED : STATUS_OK;
+}
+
+/**
+ * @brief Returns the bytes the sealing adds to every response datagram of a request.
+ */
+size_t seal_response_overhead(const PasswordRequest *request) {
+    return sealing && (request->flags & REQUEST_FLAG_SEALED) ? SEAL_OVERHEAD : 0; /**< Never set on v1 requests */
+}
+
+/**
+ * @brief Seals a response datagram when its request asked for it.
+ */
+size_t seal_response(const PasswordRequest *request, uint8_t *datagram, size_t header_size, size_t size) {
+    if (!(request->flags & REQUEST_FLAG_SEALED)) {
+        return size;
+    }
+    if (!sealing) {
+        datagram[3] &= (uint8_t)~REQUEST_FLAG_SEALED; /**< Tells the client the response is in clear */
+        return size;
+    }
+
+    uint8_t *trailer = datagram + size;
+    if (nonce_counter == 0) {
+        random_bytes(nonce_salt, sizeof(nonce_salt));
+    }
+    memcpy(trailer, nonce_salt, sizeof(nonce_salt));
+    trailer[NONCE_SALT_SIZE] = (uint8_t)(nonce_counter >> 24);
+    trailer[NONCE_SALT_SIZE + 1] = (uint8_t)(nonce_counter >> 16);
+    trailer[NONCE_SALT_SIZE + 2] = (uint8_t)(nonce_counter >> 8);
+    trailer[NONCE_SALT_SIZE + 3] = (uint8_t)nonce_counter;
+    nonce_counter++;
+
+    seal_payload(&response_key, datagram, header_size, datagram + header_size, size - header_size, trailer);
+    count_metric(METRIC_SEALED, 1);
+    return size + SEAL_OVERHEAD;
+}
+
+/**
+ * @brief Finds what the passwords of a request are drawn from and validates its length.
+ * @return `STATUS_OK`, `STATUS_UNKNOWN_POLICY`, `STATUS_INVALID_LENGTH` or a sealing mismatch.
+ */
+ResponseStatus resolve_password_source(const PasswordRequest *request, PasswordSource *source) {
+    source->type = NUMERIC;
+    source->policy = NULL;
+    if (request->flags & REQUEST_FLAG_POLICY) {
+        count_metric(METRIC_POLICY_REQUESTS, 1);
+        source->policy = find_policy((uint8_t)request->type);
+        if (source->policy == NULL) {
+            return STATUS_UNKNOWN_POLICY;
+        }
+    } else {
+        source->type = parse_password_type(request->type);
+        count_request(source->type);
+    }
+    const ServerConfig *config = current_config();
+    if (request->length < config->min_length || request->length > config->max_length) {
+        return STATUS_INVALID_LENGTH;
+    }
+    return sealing_status(request);
+}
+
+/**
+ * @brief Writes a password of a type, through the reservoir, or of a policy.
+ */
+void fill_source_password(char *password, const PasswordSource *source, int length) {
+    if (source->policy != NULL) {
+        generate_policy_password(source->policy, password, length);
+    } else {
+        fill_password(password, source->type, length);
+    }
+}
+
+/**
+ * @brief Processes a password generation request, writing the response datagram in place.
+ * @details The password is generated directly inside the datagram, after the v2 header or at the
+ *          start of a `LegacyPasswordResponse` for clients that issued a v1 request, so it is never
+ *          copied or formatted again before being sent.
+ * @param[in] request Pointer to the PasswordRequest structure containing the client input.
+ * @param[out] datagram Destination of the response, at least `SLOT_RESPONSE_SIZE` bytes.
+ * @return The number of bytes to send.
+ * @pre `request` and `datagram` must be valid pointers.
+ * @post The datagram carries the generated password, or the error status and an empty password
+ *       (an empty v1 response) if the length is out of range, the policy is unknown or the
+ *       request does not match the sealing of the server. It is not sealed yet.
+ */
+size_t handle_password_request(const PasswordRequest *request, uint8_t *datagram) {
+	PasswordSource source;
+	ResponseStatus status = resolve_password_source(request, &source);
+
+	if (status != STATUS_OK) {
+		count_metric(METRIC_INVALID, 1);
+	}
+
+	if (request->flags & REQUEST_FLAG_LEGACY) {
+		memset(datagram, 0, sizeof(LegacyPasswordResponse));
+		if (status == STATUS_OK) {
+			fill_source_password((char *)datagram, &source, request->length);
+		}
+		return sizeof(LegacyPasswordResponse);
+	}
+
+	if (status != STATUS_OK) {
+		return encode_response_header((uint8_t)status, 0, request->flags, request->request_id, datagram);
+	}
+
+	size_t header_size = encode_response_header(STATUS_OK, request->length, request->flags, request->request_id, datagram);
+	fill_source_password((char *)datagram + header_size, &source, request->length);
+	return header_size + request->length;
+}
+
+/**
+ * @brief Processes a policy definition, writing the response datagram in place.
+ * @details Definitions are rare, so compiling the policy here, on the worker that received
+ *          it, costs nothing to the other requests.
+ */
+size_t handle_policy_definition(const PasswordRequest *request, const uint8_t *datagram, size_t datagram_size,
+                                uint8_t *response) {
+    PolicySpec spec;
+    ResponseStatus status = STATUS_MALFORMED;
+    uint8_t id = 0;
+
+    count_metric(METRIC_POLICY_DEFINITIONS, 1);
+    if (!decode_policy_definition(datagram, datagram_size, &spec)) {
+        count_metric(METRIC_MALFORMED, 1);
+    } else if ((status = sealing_status(request)) == STATUS_OK) {
+        status = define_policy(&spec, &id);
+    }
+    if (status != STATUS_OK) {
+        return encode_response_header((uint8_t)status, 0, request->flags, request->request_id, response);
+    }
+    size_t header_size = encode_response_header(STATUS_OK, 1, request->flags, request->request_id, response);
+    response[header_size] = id;
+    return header_size + 1;
+}
+
+/**
+ * @brief Answers a single-datagram request: a password request or a policy definition.
+ */
+size_t answer_request(const PasswordRequest *request, const uint8_t *datagram, size_t datagram_size,
+                      uint8_t *response) {
+    size_t size = (request->flags & REQUEST_FLAG_DEFINE)
+                ? handle_policy_definition(request, datagram, datagram_size, response)
+                : handle_password_request(request, response);
+    return seal_response(request, response, RESPONSE_HEADER_SIZE, size);
+}
+
+/**
+ * @brief Decodes a received datagram into a PasswordRequest.
+ * @details Both the v2 binary format and legacy v1 datagrams are accepted. A datagram that
+ *          cannot be decoded is turned into a zero-length request, so the client is answered
+ *          with `STATUS_INVALID_LENGTH` instead of being ignored.
+ * @param[in] datagram The received bytes.
+ * @param[in] datagram_size Number of bytes received.
+ * @param[out] request Pointer to the PasswordRequest structure to populate.
+ */
+void parse_request_datagram(const uint8_t *datagram, size_t datagram_size, PasswordRequest *request) {
+    bool decoded = is_v2_datagram(datagram, datagram_size)
+                 ? decode_request(datagram, datagram_size, request)
+                 : decode_legacy_request(datagram, datagram_size, request);
+    if (!decoded) {
+        count_metric(METRIC_MALFORMED, 1);
+        memset(request, 0, sizeof(*request)); /**< Length 0 is always rejected */
+    }
+}
+
+/* - - - - - - - - - - - - - - - - - - - END HANDLER - - - - - - - - - - - - - - - - - - - */
@@ -0,0 +1,164 @@
+/**
+ * @file handler.h
+ * @brief Header file declaring the decoding and answering of a single password request.
+ *
+ * These functions form the per-request work of every data path of the server (blocking,
+ * batched, event-driven and io_uring): a received datagram is decoded into a PasswordRequest,
+ * and the response datagram is written in place with the password generated directly inside
+ * it. They keep no state of their own besides the counters of `metrics.h`, the key set by
+ * `enable_sealing` and the nonce counter of each thread, so they can also be driven on their
+ * own, e.g. by the microbenchmarks.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef HANDLER_H_
+#define HANDLER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../../../../UDP_core/src/libs/password/password.h"
+#include "../policy/policy.h"
+#include "../../../../UDP_core/src/libs/protocol/protocol.h"
+#include "../../../../UDP_core/src/libs/seal/seal.h"
+
+/* - - - - - - - - - - - - - - - - - - - - HANDLER - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Maps the type letter of a request to a PasswordType.
+ *
+ * @param[in] type The type letter sent by the client (case-insensitive).
+ *
+ * @return The matching PasswordType, `NUMERIC` for unknown letters.
+ */
+PasswordType parse_password_type(char type);
+
+/**
+ * @struct PasswordSource
+ * @brief What the passwords of a request are drawn from: a built-in type or a policy.
+ */
+typedef struct {
+    PasswordType type;              /**< The built-in type, when `policy` is NULL */
+    const Policy *policy;           /**< The compiled policy of a `REQUEST_FLAG_POLICY` request */
+} PasswordSource;
+
+/**
+ * @brief Finds what the passwords of a request are drawn from and validates its length.
+ *
+ * The length must lie within the bounds of the configuration in force (see `current_config`).
+ * The request is counted, per type or as a policy request.
+ *
+ * @param[in] request The decoded request.
+ * @param[out] source Receives the type or the policy.
+ *
+ * @return `STATUS_OK`, `STATUS_UNKNOWN_POLICY`, `STATUS_INVALID_LENGTH`, or
+ *         `STATUS_SEALING_REQUIRED` / `STATUS_SEALING_UNAVAILABLE` if the request does not
+ *         match the sealing of the server.
+ */
+ResponseStatus resolve_password_source(const PasswordRequest *request, PasswordSource *source);
+
+/**
+ * @brief Writes a password of a type or a policy.
+ *
+ * @param[out] password Destination of `length` characters and a null terminator.
+ * @param[in] source The type or the policy, as resolved by `resolve_password_source`.
+ * @param[in] length The password length, already validated.
+ */
+void fill_source_password(char *password, const PasswordSource *source, int length);
+
+/**
+ * @brief Writes a password, taken from the reservoir when it has one ready.
+ *
+ * @param[out] password Destination of `length` characters and a null terminator.
+ * @param[in] type The password type.
+ * @param[in] length The password length, already validated.
+ */
+void fill_password(char *password, PasswordType type, int length);
+
+/**
+ * @brief Processes a password generation request, writing the response datagram in place.
+ *
+ * @param[in] request The decoded request.
+ * @param[out] datagram Destination of the response, at least `SLOT_RESPONSE_SIZE` bytes.
+ *
+ * @return The number of bytes to send.
+ */
+size_t handle_password_request(const PasswordRequest *request, uint8_t *datagram);
+
+/**
+ * @brief Processes a policy definition, writing the response datagram in place.
+ *
+ * @param[in] request The decoded header of the definition.
+ * @param[in] datagram The received bytes, body of the definition included.
+ * @param[in] datagram_size Number of bytes received.
+ * @param[out] response Destination of the response, at least `SLOT_RESPONSE_SIZE` bytes.
+ *
+ * @return The number of bytes to send: the response carries the policy ID as its single
+ *         password byte, or no byte and the error status.
+ */
+size_t handle_policy_definition(const PasswordRequest *request, const uint8_t *datagram, size_t datagram_size,
+                                uint8_t *response);
+
+/**
+ * @brief Makes the server seal the responses with a pre-shared key.
+ *
+ * Must be called before the workers start. From then on only the requests carrying
+ * `REQUEST_FLAG_SEALED` are served; the others get `STATUS_SEALING_REQUIRED` and no password,
+ * or an empty response in the v1 format, so no password ever leaves the server in clear.
+ *
+ * @param[in] key The key shared with the clients.
+ */
+void enable_sealing(const SealKey *key);
+
+/**
+ * @brief Returns the bytes the sealing adds to every response datagram of a request.
+ *
+ * @param[in] request The decoded request.
+ *
+ * @return `SEAL_OVERHEAD` if the responses to the request are sealed, 0 otherwise.
+ */
+size_t seal_response_overhead(const PasswordRequest *request);
+
+/**
+ * @brief Seals a response datagram when its request asked for it.
+ *
+ * The nonce is made of 8 random bytes drawn by the calling thread and a 32-bit counter; a
+ * thread draws new random bytes whenever its counter wraps, so a nonce is never reused.
+ * Without a key, the datagram is sent as is, with `REQUEST_FLAG_SEALED` cleared.
+ *
+ * @param[in] request The decoded request.
+ * @param[in,out] datagram The response datagram, with `SEAL_OVERHEAD` bytes of room after `size`.
+ * @param[in] header_size `RESPONSE_HEADER_SIZE`, or `BULK_HEADER_SIZE` for a bulk datagram.
+ * @param[in] size Number of bytes of the datagram, header included.
+ *
+ * @return The number of bytes to send: `size`, plus `SEAL_OVERHEAD` if the datagram was sealed.
+ */
+size_t seal_response(const PasswordRequest *request, uint8_t *datagram, size_t header_size, size_t size);
+
+/**
+ * @brief Answers a single-datagram request: a password request or a policy definition.
+ *
+ * @param[in] request The decoded request.
+ * @param[in] datagram The received bytes.
+ * @param[in] datagram_size Number of bytes received.
+ * @param[out] response Destination of the response, at least `SLOT_RESPONSE_SIZE` bytes.
+ *
+ * @return The number of bytes to send, the response being sealed if the request asked for it.
+ */
+size_t answer_request(const PasswordRequest *request, const uint8_t *datagram, size_t datagram_size,
+                      uint8_t *response);
+
+/**
+ * @brief Decodes a received datagram, v2 or legacy v1, into a PasswordRequest.
+ *
+ * @param[in] datagram The received bytes.
+ * @param[in] datagram_size Number of bytes received.
+ * @param[out] request Receives the request; a zero-length request if the datagram is malformed.
+ */
+void parse_request_datagram(const uint8_t *datagram, size_t datagram_size, PasswordRequest *request);
+
+/* - - - - - - - - - - - - - - - - - - - END HANDLER - - - - - - - - - - - - - - - - - - - */
+
+#endif /* HANDLER_H_ */
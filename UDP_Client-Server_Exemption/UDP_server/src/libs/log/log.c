@@ -0,0 +1,406 @@
+/**
+ * @file log.c
+ * @brief Implementation of the asynchronous log.
+ *
+ * The ring is a bounded multi-producer, single-consumer queue in the style of Vyukov: every cell
+ * carries a sequence number that tells producers whether it is free and the consumer whether it
+ * is full, so producers only contend on one atomic counter and never wait for each other.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#if defined WIN32
+#include <winsock2.h>       /**< Included before windows.h, which would pull in Winsock 1 */
+#include <windows.h>        /**< Includes Sleep() and GetSystemTimeAsFileTime() */
+#else
+#include <time.h>           /**< Includes nanosleep() and gmtime_r() */
+#endif
+
+#include <ctype.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "log.h"
+#include "../address/address.h"
+#include "../../../../UDP_core/src/libs/utils/utils.h"
+
+#if defined _MSC_VER
+#define THREAD_LOCAL __declspec(thread)  /**< Thread-local storage qualifier for MSVC */
+#else
+#define THREAD_LOCAL _Thread_local       /**< Thread-local storage qualifier for C11 compilers */
+#endif
+
+/* - - - - - - - - - - - - - - - - - - - - - RING - - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @enum RecordKind
+ * @brief What a record describes.
+ */
+typedef enum {
+    RECORD_ACCESS,      /**< A received request */
+    RECORD_MESSAGE      /**< A free-form message */
+} RecordKind;
+
+/**
+ * @struct LogRecord
+ * @brief Binary record copied by the serving threads; it is formatted by the drain thread.
+ */
+typedef struct {
+    uint64_t time_ms;                   /**< Wall-clock time, in milliseconds since the epoch */
+    uint8_t client[sizeof(struct sockaddr_in6)]; /**< Client socket address, a sockaddr_in or a sockaddr_in6 */
+    uint32_t request_id;                /**< Identifier of the request */
+    uint16_t count;                     /**< Passwords requested */
+    uint8_t level;                      /**< A LogLevel value */
+    uint8_t kind;                       /**< A RecordKind value */
+    uint8_t length;                     /**< Password length requested */
+    uint8_t flags;                      /**< Request flags */
+    char type;                          /**< Password type requested */
+    char message[LOG_MESSAGE_SIZE];     /**< Null-terminated message of a RECORD_MESSAGE */
+} LogRecord;
+
+/**
+ * @struct LogCell
+ * @brief One entry of the ring.
+ */
+typedef struct {
+    atomic_size_t sequence;     /**< `position` when free, `position + 1` when it holds a record */
+    LogRecord record;           /**< The record */
+} LogCell;
+
+static LogCell ring[LOG_RING_SIZE];
+static atomic_size_t enqueue_position;          /**< Next position claimed by a producer */
+static size_t dequeue_position;                 /**< Next position read by the drain thread */
+static atomic_uint_fast64_t dropped_records;
+static atomic_bool stopping;
+static bool running;
+static LogOptions log_options = { LOG_OFF, LOG_FORMAT_COLOR, 1 };
+static atomic_uint live_level = LOG_OFF;        /**< Level in force, changed by `tune_logger` */
+static atomic_uint live_sample = 1;             /**< Sampling rate in force */
+static pthread_t drain_thread;
+static THREAD_LOCAL unsigned int sample_counter; /**< Access records seen by the calling thread */
+
+/**
+ * @brief Returns the wall-clock time in milliseconds since the epoch.
+ */
+static uint64_t wall_clock_ms(void) {
+#if defined WIN32
+    FILETIME now;
+    GetSystemTimeAsFileTime(&now);
+    uint64_t ticks = ((uint64_t)now.dwHighDateTime << 32) | now.dwLowDateTime; /**< 100 ns since 1601 */
+    return ticks / 10000 - 11644473600000ULL;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+#endif
+}
+
+/**
+ * @brief Claims a free cell of the ring.
+ * @return The cell, to be filled then published with `publish_cell`, or NULL if the ring is full.
+ */
+static LogCell *claim_cell(size_t *position) {
+    size_t claimed = atomic_load_explicit(&enqueue_position, memory_order_relaxed);
+    while (true) {
+        LogCell *cell = &ring[claimed & (LOG_RING_SIZE - 1)];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t)sequence - (intptr_t)claimed;
+        if (difference == 0) {
+            if (atomic_compare_exchange_weak_explicit(&enqueue_position, &claimed, claimed + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                *position = claimed;
+                return cell;
+            }
+        } else if (difference < 0) {
+            atomic_fetch_add_explicit(&dropped_records, 1, memory_order_relaxed);
+            return NULL;
+        } else {
+            claimed = atomic_load_explicit(&enqueue_position, memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Hands a filled cell over to the drain thread.
+ */
+static void publish_cell(LogCell *cell, size_t position) {
+    atomic_store_explicit(&cell->sequence, position + 1, memory_order_release);
+}
+
+/* - - - - - - - - - - - - - - - - - - - - END RING - - - - - - - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - - - - - - - DRAIN - - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Name of a level in the plain and JSON formats.
+ */
+static const char *level_name(uint8_t level) {
+    switch (level) {
+        case LOG_ERROR:   return "error";
+        case LOG_WARNING: return "warning";
+        case LOG_INFO:    return "info";
+        default:          return "debug";
+    }
+}
+
+/**
+ * @brief Formats a timestamp as ISO 8601 UTC with milliseconds.
+ */
+static void format_time(uint64_t time_ms, char *buffer, size_t buffer_size) {
+    time_t seconds = (time_t)(time_ms / 1000);
+    struct tm utc;
+#if defined WIN32
+    gmtime_s(&utc, &seconds);
+#else
+    gmtime_r(&seconds, &utc);
+#endif
+    size_t written = strftime(buffer, buffer_size, "%Y-%m-%dT%H:%M:%S", &utc);
+    snprintf(buffer + written, buffer_size - written, ".%03uZ", (unsigned int)(time_ms % 1000));
+}
+
+/**
+ * @brief Writes one record in the configured format.
+ */
+static void write_record(const LogRecord *record) {
+    struct sockaddr_storage client;
+    char host[ADDRESS_TEXT_SIZE];
+    unsigned short port = 0;
+    if (record->kind == RECORD_ACCESS) {
+        memset(&client, 0, sizeof(client));
+        memcpy(&client, record->client, sizeof(record->client));
+        format_address(&client, host, &port);
+    }
+    bool bracketed = record->kind == RECORD_ACCESS && strchr(host, ':') != NULL; /**< IPv6 */
+    char type = isalnum((unsigned char)record->type) ? record->type : '?'; /**< Raw client byte: never a quote or a newline */
+    char time_text[32];
+    format_time(record->time_ms, time_text, sizeof(time_text));
+
+    switch (log_options.format) {
+        case LOG_FORMAT_PLAIN:
+            if (record->kind == RECORD_ACCESS) {
+                printf("%s %s access client=%s%s%s:%u id=%lu type=%c length=%u count=%u\n",
+                       time_text, level_name(record->level), bracketed ? "[" : "", host, bracketed ? "]" : "", port,
+                       (unsigned long)record->request_id, type, record->length, record->count);
+            } else {
+                printf("%s %s %s\n", time_text, level_name(record->level), record->message);
+            }
+            break;
+        case LOG_FORMAT_JSON:
+            if (record->kind == RECORD_ACCESS) {
+                printf("{\"time\":\"%s\",\"level\":\"%s\",\"event\":\"access\",\"client\":\"%s\",\"port\":%u,"
+                       "\"id\":%lu,\"type\":\"%c\",\"length\":%u,\"count\":%u}\n",
+                       time_text, level_name(record->level), host, port,
+                       (unsigned long)record->request_id, type, record->length, record->count);
+            } else {
+                printf("{\"time\":\"%s\",\"level\":\"%s\",\"event\":\"message\",\"message\":\"",
+                       time_text, level_name(record->level));
+                for (const char *c = record->message; *c != '\0'; c++) {
+                    if (*c == '"' || *c == '\\') {
+                        putchar('\\');
+                    }
+                    putchar(*c >= ' ' ? *c : ' ');
+                }
+                printf("\"}\n");
+            }
+            break;
+        case LOG_FORMAT_COLOR:
+        default:
+            if (record->kind == RECORD_ACCESS) {
+                print_with_color("New connection from ", GREEN);
+                print_with_color(host, YELLOW);
+                print_with_color(":", CYAN);
+                printf("%u\n", port);
+            } else {
+                print_with_color(record->message, record->level <= LOG_ERROR ? MAGENTA :
+                                                  record->level == LOG_WARNING ? YELLOW : BLUE);
+                printf("\n");
+            }
+            break;
+    }
+}
+
+/**
+ * @brief Writes every published record.
+ * @return The number of records written.
+ */
+static size_t drain_ring(void) {
+    size_t drained = 0;
+    while (true) {
+        LogCell *cell = &ring[dequeue_position & (LOG_RING_SIZE - 1)];
+        if (atomic_load_explicit(&cell->sequence, memory_order_acquire) != dequeue_position + 1) {
+            return drained;
+        }
+        write_record(&cell->record);
+        atomic_store_explicit(&cell->sequence, dequeue_position + LOG_RING_SIZE, memory_order_release);
+        dequeue_position++;
+        drained++;
+    }
+}
+
+/**
+ * @brief Entry point of the drain thread: writes records until the logger is stopped.
+ */
+static void *run_drain(void *argument) {
+    (void)argument;
+    uint64_t reported_drops = 0;
+
+    while (true) {
+        size_t drained = drain_ring();
+
+        uint64_t drops = atomic_load_explicit(&dropped_records, memory_order_relaxed);
+        if (drops != reported_drops) {
+            LogRecord record = { .time_ms = wall_clock_ms(), .level = LOG_WARNING, .kind = RECORD_MESSAGE };
+            snprintf(record.message, sizeof(record.message), "%llu log records dropped (ring full)",
+                     (unsigned long long)(drops - reported_drops));
+            write_record(&record);
+            reported_drops = drops;
+            drained++;
+        }
+
+        if (drained > 0) {
+            fflush(stdout);
+        } else if (atomic_load(&stopping)) {
+            return NULL;
+        } else {
+#if defined WIN32
+            Sleep(1);
+#else
+            struct timespec pause = { 0, 1000000 };
+            nanosleep(&pause, NULL);
+#endif
+        }
+    }
+}
+
+/* - - - - - - - - - - - - - - - - - - - - END DRAIN - - - - - - - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - - - - - - - - LOG - - - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Fills a LogOptions with the defaults.
+ */
+void default_log_options(LogOptions *options) {
+    options->level = LOG_INFO;
+    options->format = LOG_FORMAT_COLOR;
+    options->sample_rate = 1;
+}
+
+/**
+ * @brief Starts the drain thread.
+ */
+bool start_logger(const LogOptions *options) {
+    if (running) {
+        return true;
+    }
+    for (size_t i = 0; i < LOG_RING_SIZE; i++) {
+        atomic_init(&ring[i].sequence, i);
+    }
+    atomic_init(&enqueue_position, 0);
+    atomic_init(&dropped_records, 0);
+    atomic_init(&stopping, false);
+    dequeue_position = 0;
+
+    if (options->level == LOG_OFF) {
+        return true;
+    }
+    if (pthread_create(&drain_thread, NULL, run_drain, NULL) != 0) {
+        return false;
+    }
+    log_options = *options;
+    if (log_options.sample_rate == 0) {
+        log_options.sample_rate = 1;
+    }
+    atomic_store_explicit(&live_level, (unsigned int)log_options.level, memory_order_relaxed);
+    atomic_store_explicit(&live_sample, log_options.sample_rate, memory_order_relaxed);
+    running = true;
+    return true;
+}
+
+/**
+ * @brief Writes the records still in the ring and stops the drain thread.
+ */
+void stop_logger(void) {
+    if (!running) {
+        return;
+    }
+    atomic_store_explicit(&live_level, LOG_OFF, memory_order_relaxed);
+    atomic_store(&stopping, true);
+    pthread_join(drain_thread, NULL);
+    running = false;
+}
+
+/**
+ * @brief Changes the level and the sampling of a running logger.
+ */
+bool tune_logger(LogLevel level, unsigned int sample_rate) {
+    if (!running) {
+        return level == LOG_OFF;
+    }
+    atomic_store_explicit(&live_level, (unsigned int)level, memory_order_relaxed);
+    atomic_store_explicit(&live_sample, sample_rate > 0 ? sample_rate : 1, memory_order_relaxed);
+    return true;
+}
+
+/**
+ * @brief Queues an access record for a received request.
+ */
+void log_access(const struct sockaddr_storage *client_address, const PasswordRequest *request) {
+    if (atomic_load_explicit(&live_level, memory_order_relaxed) < LOG_INFO ||
+        ++sample_counter % atomic_load_explicit(&live_sample, memory_order_relaxed) != 0) {
+        return;
+    }
+
+    size_t position;
+    LogCell *cell = claim_cell(&position);
+    if (cell == NULL) {
+        return;
+    }
+    LogRecord *record = &cell->record;
+    record->time_ms = wall_clock_ms();
+    memset(record->client, 0, sizeof(record->client));
+    memcpy(record->client, client_address, address_size(client_address));
+    record->request_id = request->request_id;
+    record->count = request->count;
+    record->level = LOG_INFO;
+    record->kind = RECORD_ACCESS;
+    record->type = request->type;
+    record->length = request->length;
+    record->flags = request->flags;
+    publish_cell(cell, position);
+}
+
+/**
+ * @brief Queues a free-form message.
+ */
+void log_message(LogLevel level, const char *message) {
+    if (level == LOG_OFF || (unsigned int)level > atomic_load_explicit(&live_level, memory_order_relaxed)) {
+        return;
+    }
+
+    size_t position;
+    LogCell *cell = claim_cell(&position);
+    if (cell == NULL) {
+        return;
+    }
+    LogRecord *record = &cell->record;
+    record->time_ms = wall_clock_ms();
+    record->level = (uint8_t)level;
+    record->kind = RECORD_MESSAGE;
+    strncpy(record->message, message, sizeof(record->message) - 1);
+    record->message[sizeof(record->message) - 1] = '\0';
+    publish_cell(cell, position);
+}
+
+/**
+ * @brief Number of records dropped because the ring was full.
+ */
+uint64_t dropped_log_records(void) {
+    return atomic_load_explicit(&dropped_records, memory_order_relaxed);
+}
+
+/* - - - - - - - - - - - - - - - - - - - - - END LOG - - - - - - - - - - - - - - - - - - - - - */
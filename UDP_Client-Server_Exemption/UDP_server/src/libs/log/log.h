@@ -0,0 +1,126 @@
+/**
+ * @file log.h
+ * @brief Header file declaring the asynchronous access and message log of the server.
+ *
+ * Serving threads never write to the terminal: they copy a small binary record into a bounded
+ * lock-free ring and go on. A background thread drains the ring, formats the records (address
+ * conversion included) and writes them to the standard output. When the ring is full the record
+ * is dropped and counted, so logging can never block or slow down packet processing.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef LOG_H_
+#define LOG_H_
+
+#if defined WIN32
+#include <winsock2.h>       /**< Include Winsock 2 library for Windows */
+#include <ws2tcpip.h>       /**< Include struct sockaddr_storage */
+#else
+#include <sys/socket.h>     /**< Include struct sockaddr_storage */
+#include <netinet/in.h>     /**< Include for internet address family structures */
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../../../UDP_core/src/libs/protocol/protocol.h"
+
+/* - - - - - - - - - - - - - - - - - - - - - LOG - - - - - - - - - - - - - - - - - - - - - */
+
+#define LOG_RING_SIZE 4096          /**< Records the ring can hold; a power of two */
+#define LOG_MESSAGE_SIZE 96         /**< Characters kept from a free-form message */
+
+/**
+ * @enum LogLevel
+ * @brief Severity of a record; records above the configured level are discarded.
+ */
+typedef enum {
+    LOG_OFF,        /**< Nothing is logged */
+    LOG_ERROR,      /**< Errors only */
+    LOG_WARNING,    /**< Errors and warnings */
+    LOG_INFO,       /**< Also access records (the default) */
+    LOG_DEBUG       /**< Everything */
+} LogLevel;
+
+/**
+ * @enum LogFormat
+ * @brief How the drain thread writes the records.
+ */
+typedef enum {
+    LOG_FORMAT_COLOR,   /**< The colored terminal output of `print_with_color` */
+    LOG_FORMAT_PLAIN,   /**< One `key=value` line per record, without ANSI codes */
+    LOG_FORMAT_JSON     /**< One JSON object per line */
+} LogFormat;
+
+/**
+ * @struct LogOptions
+ * @brief Settings of the logger.
+ */
+typedef struct {
+    LogLevel level;             /**< Most verbose level written */
+    LogFormat format;           /**< Output format */
+    unsigned int sample_rate;   /**< Only one access record out of `sample_rate` is kept, per thread */
+} LogOptions;
+
+/**
+ * @brief Fills a LogOptions with the defaults: info level, colored output, no sampling.
+ *
+ * @param[out] options The options to initialize.
+ */
+void default_log_options(LogOptions *options);
+
+/**
+ * @brief Starts the drain thread. Before this call, and if the level is `LOG_OFF`, nothing is logged.
+ *
+ * @param[in] options The settings of the logger (copied).
+ *
+ * @return `true` if the logger is running or disabled, `false` if the thread could not be started.
+ */
+bool start_logger(const LogOptions *options);
+
+/**
+ * @brief Writes the records still in the ring and stops the drain thread.
+ */
+void stop_logger(void);
+
+/**
+ * @brief Changes the level and the sampling of a running logger, e.g. on a configuration reload.
+ *
+ * The serving threads see the change within a few records.
+ *
+ * @param[in] level The new most verbose level.
+ * @param[in] sample_rate Keeps one access record out of `sample_rate` per thread.
+ *
+ * @return `false` if the logger was started with `LOG_OFF` and `level` is not: the drain
+ *         thread only exists when the logger starts enabled.
+ */
+bool tune_logger(LogLevel level, unsigned int sample_rate);
+
+/**
+ * @brief Queues an access record for a received request.
+ *
+ * @param[in] client_address Sender of the request, IPv4 or IPv6.
+ * @param[in] request The decoded request.
+ */
+void log_access(const struct sockaddr_storage *client_address, const PasswordRequest *request);
+
+/**
+ * @brief Queues a free-form message, truncated to `LOG_MESSAGE_SIZE - 1` characters.
+ *
+ * @param[in] level Severity of the message.
+ * @param[in] message The message.
+ */
+void log_message(LogLevel level, const char *message);
+
+/**
+ * @brief Number of records dropped because the ring was full.
+ *
+ * @return The count since the logger was started.
+ */
+uint64_t dropped_log_records(void);
+
+/* - - - - - - - - - - - - - - - - - - - - END LOG - - - - - - - - - - - - - - - - - - - - */
+
+#endif /* LOG_H_ */
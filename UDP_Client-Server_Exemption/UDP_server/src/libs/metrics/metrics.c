@@ -0,0 +1,229 @@
+/**
+ * @file metrics.c
+ * @brief Implementation of the lock-free counters of the server.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#if defined WIN32
+#include <windows.h>        /**< Includes QueryPerformanceCounter() */
+#else
+#include <time.h>           /**< Includes clock_gettime() */
+#endif
+
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include "metrics.h"
+
+#if defined _MSC_VER
+#define THREAD_LOCAL __declspec(thread)  /**< Thread-local storage qualifier for MSVC */
+#else
+#define THREAD_LOCAL _Thread_local       /**< Thread-local storage qualifier for C11 compilers */
+#endif
+
+/* - - - - - - - - - - - - - - - - - - - - METRICS - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @struct MetricBlock
+ * @brief Counters written by a single thread; aligned so that two blocks never share a cache line.
+ */
+typedef struct {
+    _Alignas(64) atomic_uint_fast64_t counters[METRIC_COUNTERS];
+    atomic_uint_fast64_t requests[PASSWORD_TYPE_COUNT];
+    atomic_uint_fast64_t handle_buckets[HANDLE_TIME_BUCKETS + 1];
+    atomic_uint_fast64_t handle_sum_ns;
+} MetricBlock;
+
+static MetricBlock blocks[MAX_METRIC_BLOCKS];          /**< Block 0 is shared by unregistered threads */
+static atomic_uint registered_blocks = 1;
+static THREAD_LOCAL MetricBlock *thread_block = &blocks[0];
+
+static const char *const type_names[PASSWORD_TYPE_COUNT] = {
+    "numeric", "alpha", "mixed", "secure", "unambiguous"
+};
+
+/**
+ * @brief Adds to a counter that only the calling thread writes.
+ */
+static void add_owned(atomic_uint_fast64_t *counter, uint64_t amount) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + amount,
+                          memory_order_relaxed);
+}
+
+/**
+ * @brief Gives the calling thread its own block of counters.
+ */
+void bind_worker_metrics(void) {
+    if (thread_block != &blocks[0]) {
+        return;
+    }
+    unsigned int index = atomic_fetch_add(&registered_blocks, 1);
+    if (index < MAX_METRIC_BLOCKS) {
+        thread_block = &blocks[index];
+    }
+}
+
+/**
+ * @brief Adds `amount` to a counter of the calling thread.
+ */
+void count_metric(MetricCounter counter, uint64_t amount) {
+    add_owned(&thread_block->counters[counter], amount);
+}
+
+/**
+ * @brief Counts one request of the given type for the calling thread.
+ */
+void count_request(PasswordType type) {
+    if ((unsigned int)type < PASSWORD_TYPE_COUNT) {
+        add_owned(&thread_block->requests[type], 1);
+    }
+}
+
+/**
+ * @brief Records the time spent in `handle_password_request` by the calling thread.
+ */
+void record_handle_time(uint64_t elapsed_ns) {
+    unsigned int bucket = 0;
+    uint64_t bound = HANDLE_TIME_FIRST_BOUND_NS;
+    while (bucket < HANDLE_TIME_BUCKETS && elapsed_ns > bound) {
+        bound *= 2;
+        bucket++;
+    }
+    add_owned(&thread_block->handle_buckets[bucket], 1);
+    add_owned(&thread_block->handle_sum_ns, elapsed_ns);
+}
+
+/**
+ * @brief Monotonic timestamp in nanoseconds.
+ */
+uint64_t metrics_now_ns(void) {
+#if defined WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Sums the blocks of every thread.
+ */
+void snapshot_metrics(MetricsSnapshot *snapshot) {
+    memset(snapshot, 0, sizeof(*snapshot));
+    unsigned int used = atomic_load(&registered_blocks);
+    if (used > MAX_METRIC_BLOCKS) {
+        used = MAX_METRIC_BLOCKS;
+    }
+    snapshot->workers = used - 1;
+
+    for (unsigned int b = 0; b < used; b++) {
+        MetricBlock *block = &blocks[b];
+        for (unsigned int i = 0; i < METRIC_COUNTERS; i++) {
+            snapshot->counters[i] += atomic_load_explicit(&block->counters[i], memory_order_relaxed);
+        }
+        for (unsigned int i = 0; i < PASSWORD_TYPE_COUNT; i++) {
+            snapshot->requests[i] += atomic_load_explicit(&block->requests[i], memory_order_relaxed);
+        }
+        for (unsigned int i = 0; i <= HANDLE_TIME_BUCKETS; i++) {
+            snapshot->handle_buckets[i] += atomic_load_explicit(&block->handle_buckets[i], memory_order_relaxed);
+        }
+        snapshot->handle_sum_ns += atomic_load_explicit(&block->handle_sum_ns, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Appends formatted text to a buffer, never writing past its end.
+ */
+static void append(char *buffer, size_t buffer_size, size_t *used, const char *format, ...) {
+    if (*used >= buffer_size) {
+        return;
+    }
+    va_list arguments;
+    va_start(arguments, format);
+    int written = vsnprintf(buffer + *used, buffer_size - *used, format, arguments);
+    va_end(arguments);
+    if (written > 0) {
+        *used += (size_t)written;
+        if (*used >= buffer_size) {
+            *used = buffer_size - 1; /**< Output truncated by vsnprintf */
+        }
+    }
+}
+
+/**
+ * @brief Writes a snapshot in the Prometheus text exposition format.
+ */
+size_t format_metrics(const MetricsSnapshot *snapshot, char *buffer, size_t buffer_size) {
+    static const struct {
+        MetricCounter counter;
+        const char *name;
+        const char *help;
+    } counters[] = {
+        { METRIC_BYTES_IN, "passwdgen_received_bytes_total", "Bytes of the received datagrams." },
+        { METRIC_BYTES_OUT, "passwdgen_sent_bytes_total", "Bytes of the sent datagrams." },
+        { METRIC_RECEIVE_ERRORS, "passwdgen_receive_errors_total", "Failed receive calls." },
+        { METRIC_SEND_ERRORS, "passwdgen_send_errors_total", "Datagrams that could not be sent." },
+        { METRIC_MALFORMED, "passwdgen_malformed_requests_total", "Datagrams that could not be decoded." },
+        { METRIC_INVALID, "passwdgen_invalid_requests_total", "Requests rejected for their length, count or policy." },
+        { METRIC_BULK, "passwdgen_bulk_requests_total", "Bulk requests." },
+        { METRIC_RESERVOIR_MISSES, "passwdgen_reservoir_misses_total", "Passwords generated inline on an empty reservoir." },
+        { METRIC_RATE_LIMITED, "passwdgen_rate_limited_total", "Datagrams dropped by the per-source rate limit." },
+        { METRIC_TRANSIENT_ERRORS, "passwdgen_transient_errors_total", "Socket errors tied to one datagram or peer, skipped." },
+        { METRIC_QUEUE_DROPS, "passwdgen_receive_queue_drops_total", "Datagrams dropped by the kernel on a full receive queue." },
+        { METRIC_POLICY_REQUESTS, "passwdgen_policy_requests_total", "Requests for a password of a policy." },
+        { METRIC_POLICY_DEFINITIONS, "passwdgen_policy_definitions_total", "Policy definitions received." },
+        { METRIC_SEALED, "passwdgen_sealed_responses_total", "Response datagrams sealed with the pre-shared key." },
+        { METRIC_COOKIE_CHALLENGES, "passwdgen_cookie_challenges_total", "Requests answered with a cookie challenge." },
+        { METRIC_COOKIE_DROPS, "passwdgen_cookie_drops_total", "Datagrams dropped by the cookie check, too short to be challenged." },
+    };
+    size_t used = 0;
+    if (buffer_size == 0) {
+        return 0;
+    }
+    buffer[0] = '\0';
+
+    append(buffer, buffer_size, &used, "# HELP passwdgen_requests_total Requests per password type.\n"
+                                       "# TYPE passwdgen_requests_total counter\n");
+    for (unsigned int i = 0; i < PASSWORD_TYPE_COUNT; i++) {
+        append(buffer, buffer_size, &used, "passwdgen_requests_total{type=\"%s\"} %llu\n",
+               type_names[i], (unsigned long long)snapshot->requests[i]);
+    }
+
+    for (size_t i = 0; i < sizeof(counters) / sizeof(counters[0]); i++) {
+        append(buffer, buffer_size, &used, "# HELP %s %s\n# TYPE %s counter\n%s %llu\n",
+               counters[i].name, counters[i].help, counters[i].name, counters[i].name,
+               (unsigned long long)snapshot->counters[counters[i].counter]);
+    }
+
+    append(buffer, buffer_size, &used, "# HELP passwdgen_handle_seconds Time spent generating a response.\n"
+                                       "# TYPE passwdgen_handle_seconds histogram\n");
+    uint64_t cumulative = 0;
+    uint64_t bound = HANDLE_TIME_FIRST_BOUND_NS;
+    for (unsigned int i = 0; i < HANDLE_TIME_BUCKETS; i++, bound *= 2) {
+        cumulative += snapshot->handle_buckets[i];
+        append(buffer, buffer_size, &used, "passwdgen_handle_seconds_bucket{le=\"%.9g\"} %llu\n",
+               (double)bound / 1e9, (unsigned long long)cumulative);
+    }
+    cumulative += snapshot->handle_buckets[HANDLE_TIME_BUCKETS];
+    append(buffer, buffer_size, &used, "passwdgen_handle_seconds_bucket{le=\"+Inf\"} %llu\n"
+                                       "passwdgen_handle_seconds_sum %.9f\n"
+                                       "passwdgen_handle_seconds_count %llu\n",
+           (unsigned long long)cumulative, (double)snapshot->handle_sum_ns / 1e9, (unsigned long long)cumulative);
+
+    append(buffer, buffer_size, &used, "# HELP passwdgen_workers Serving threads.\n"
+                                       "# TYPE passwdgen_workers gauge\npasswdgen_workers %u\n", snapshot->workers);
+    return used;
+}
+
+/* - - - - - - - - - - - - - - - - - - - END METRICS - - - - - - - - - - - - - - - - - - - */
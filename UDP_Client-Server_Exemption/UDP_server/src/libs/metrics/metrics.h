@@ -0,0 +1,121 @@
+/**
+ * @file metrics.h
+ * @brief Header file declaring the lock-free counters of the server.
+ *
+ * Every serving thread owns a cache-line aligned block of counters and is the only one that
+ * writes it, so an update is a relaxed load and store with no atomic read-modify-write and no
+ * false sharing between workers. Readers (the admin endpoint) sum the blocks of all threads
+ * with relaxed loads; the totals may be a few requests apart from each other but never lock
+ * or slow down the workers.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef METRICS_H_
+#define METRICS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../../../../UDP_core/src/libs/password/password.h"
+
+/* - - - - - - - - - - - - - - - - - - - - METRICS - - - - - - - - - - - - - - - - - - - - */
+
+#define HANDLE_TIME_BUCKETS 20          /**< Finite buckets of the handle-time histogram */
+#define HANDLE_TIME_FIRST_BOUND_NS 256  /**< Upper bound of the first bucket; each next one doubles */
+#define MAX_METRIC_BLOCKS 257           /**< One block per worker, plus one for unregistered threads */
+
+/**
+ * @enum MetricCounter
+ * @brief Counters kept by every worker.
+ */
+typedef enum {
+    METRIC_BYTES_IN,            /**< Bytes of the received datagrams */
+    METRIC_BYTES_OUT,           /**< Bytes of the sent datagrams */
+    METRIC_RECEIVE_ERRORS,      /**< Failed receive calls */
+    METRIC_SEND_ERRORS,         /**< Datagrams that could not be sent */
+    METRIC_MALFORMED,           /**< Datagrams that could not be decoded */
+    METRIC_INVALID,             /**< Requests rejected because of their length, count or policy */
+    METRIC_BULK,                /**< Bulk requests */
+    METRIC_RESERVOIR_MISSES,    /**< Passwords generated inline because the reservoir was empty */
+    METRIC_RATE_LIMITED,        /**< Datagrams dropped by the per-source rate limit */
+    METRIC_TRANSIENT_ERRORS,    /**< Socket errors tied to one datagram or peer, skipped */
+    METRIC_QUEUE_DROPS,         /**< Datagrams dropped by the kernel on a full receive queue */
+    METRIC_POLICY_REQUESTS,     /**< Requests for a password of a policy */
+    METRIC_POLICY_DEFINITIONS,  /**< Policy definitions received */
+    METRIC_SEALED,              /**< Response datagrams sealed with the pre-shared key */
+    METRIC_COOKIE_CHALLENGES,   /**< Requests answered with a cookie challenge */
+    METRIC_COOKIE_DROPS,        /**< Datagrams dropped by the cookie check, too short to be challenged */
+    METRIC_COUNTERS             /**< Number of counters */
+} MetricCounter;
+
+/**
+ * @struct MetricsSnapshot
+ * @brief Sum of the counters of every worker at one point in time.
+ */
+typedef struct {
+    uint64_t counters[METRIC_COUNTERS];                 /**< Indexed by MetricCounter */
+    uint64_t requests[PASSWORD_TYPE_COUNT];             /**< Requests per PasswordType */
+    uint64_t handle_buckets[HANDLE_TIME_BUCKETS + 1];   /**< Handle times per bucket (not cumulative); the last one is unbounded */
+    uint64_t handle_sum_ns;                             /**< Sum of the handle times */
+    unsigned int workers;                               /**< Threads that registered a block */
+} MetricsSnapshot;
+
+/**
+ * @brief Gives the calling thread its own block of counters.
+ *
+ * Threads that never call it share a fallback block. Calling it twice is harmless.
+ */
+void bind_worker_metrics(void);
+
+/**
+ * @brief Adds `amount` to a counter of the calling thread.
+ *
+ * @param[in] counter The counter.
+ * @param[in] amount The increment.
+ */
+void count_metric(MetricCounter counter, uint64_t amount);
+
+/**
+ * @brief Counts one request of the given type for the calling thread.
+ *
+ * @param[in] type The password type requested.
+ */
+void count_request(PasswordType type);
+
+/**
+ * @brief Records the time spent in `handle_password_request` by the calling thread.
+ *
+ * @param[in] elapsed_ns The duration, in nanoseconds.
+ */
+void record_handle_time(uint64_t elapsed_ns);
+
+/**
+ * @brief Monotonic timestamp in nanoseconds, for measuring handle times.
+ *
+ * @return The current time.
+ */
+uint64_t metrics_now_ns(void);
+
+/**
+ * @brief Sums the blocks of every thread.
+ *
+ * @param[out] snapshot The totals.
+ */
+void snapshot_metrics(MetricsSnapshot *snapshot);
+
+/**
+ * @brief Writes a snapshot in the Prometheus text exposition format.
+ *
+ * @param[in] snapshot The totals to write.
+ * @param[out] buffer Destination, null-terminated.
+ * @param[in] buffer_size Size of `buffer` in bytes.
+ *
+ * @return The number of characters written, without the terminator.
+ */
+size_t format_metrics(const MetricsSnapshot *snapshot, char *buffer, size_t buffer_size);
+
+/* - - - - - - - - - - - - - - - - - - - END METRICS - - - - - - - - - - - - - - - - - - - */
+
+#endif /* METRICS_H_ */
@@ -0,0 +1,214 @@
+/**
+ * @file policy.c
+ * @brief Implementation of the registry of password policies.
+ *
+ * The registry is an array of pointers indexed by ID. A slot is written once, under a lock
+ * that only serializes the definitions, with a release store after the policy is compiled;
+ * the workers read it with an acquire load, so they always see a complete policy.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "policy.h"
+#include "../../../../UDP_core/src/libs/random/random.h"
+
+/* - - - - - - - - - - - - - - - - - - - - POLICIES - - - - - - - - - - - - - - - - - - - - */
+
+static _Atomic(Policy *) policies[MAX_POLICIES];
+static pthread_mutex_t definition_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char policy_symbols[] = "!@#$%^&*()";  /**< Symbols of the secure type */
+
+/**
+ * @brief Returns the classes a character belongs to by nature, ignoring the extra characters.
+ */
+static uint8_t natural_class(char character) {
+    if (character >= 'a' && character <= 'z') {
+        return POLICY_CLASS_LOWER;
+    }
+    if (character >= 'A' && character <= 'Z') {
+        return POLICY_CLASS_UPPER;
+    }
+    if (character >= '0' && character <= '9') {
+        return POLICY_CLASS_DIGIT;
+    }
+    return strchr(policy_symbols, character) != NULL ? POLICY_CLASS_SYMBOL : 0;
+}
+
+/**
+ * @brief Compiles a policy into its lookup tables.
+ * @return `STATUS_INVALID_POLICY` if the policy draws from no character or requires an empty class.
+ */
+static ResponseStatus compile_policy(const PolicySpec *spec, Policy *policy) {
+    size_t size = 0;
+    size_t class_sizes[POLICY_CLASS_COUNT] = { 0 };
+
+    memset(policy, 0, sizeof(*policy));
+    for (char character = '!'; character <= '~'; character++) {
+        uint8_t classes = natural_class(character);
+        bool extra = strchr(spec->extra, character) != NULL;
+        if (((classes & spec->classes) == 0 && !extra) || strchr(spec->exclude, character) != NULL) {
+            continue;
+        }
+        classes |= extra ? POLICY_CLASS_EXTRA : 0;
+        policy->class_of[(unsigned char)character] = classes;
+        policy->symbols[size++] = character;
+        for (unsigned int i = 0; i < POLICY_CLASS_COUNT; i++) {
+            if (classes & (1u << i)) {
+                policy->class_symbols[i][class_sizes[i]++] = character;
+            }
+        }
+    }
+
+    if (!build_charset(&policy->charset, policy->symbols) || spec->required >= (1u << POLICY_CLASS_COUNT)) {
+        return STATUS_INVALID_POLICY;
+    }
+    for (unsigned int i = 0; i < POLICY_CLASS_COUNT; i++) {
+        if ((spec->required & (1u << i)) && !build_charset(&policy->class_charsets[i], policy->class_symbols[i])) {
+            return STATUS_INVALID_POLICY; /**< Nothing left of a required class */
+        }
+    }
+    policy->required = spec->required;
+    return STATUS_OK;
+}
+
+/**
+ * @brief Tells whether two compiled policies generate the same passwords.
+ */
+static bool same_policy(const Policy *first, const Policy *second) {
+    return first->required == second->required &&
+           memcmp(first->class_of, second->class_of, sizeof(first->class_of)) == 0;
+}
+
+/**
+ * @brief Hashes what defines a compiled policy (FNV-1a).
+ */
+static uint32_t hash_policy(const Policy *policy) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(policy->class_of); i++) {
+        hash = (hash ^ policy->class_of[i]) * 16777619u;
+    }
+    return (hash ^ policy->required) * 16777619u;
+}
+
+/**
+ * @brief Compiles a policy on the heap.
+ * @return The policy, or NULL with `status` set if it is invalid or memory is exhausted.
+ */
+static Policy *new_policy(const PolicySpec *spec, ResponseStatus *status) {
+    Policy *policy = malloc(sizeof(*policy));
+    if (policy == NULL) {
+        *status = STATUS_POLICIES_FULL;
+        return NULL;
+    }
+    *status = compile_policy(spec, policy);
+    if (*status != STATUS_OK) {
+        free(policy);
+        return NULL;
+    }
+    return policy;
+}
+
+/**
+ * @brief Adds a policy of the server configuration.
+ */
+ResponseStatus configure_policy(unsigned int id, const PolicySpec *spec) {
+    if (id >= POLICY_FIRST_DEFINED || atomic_load(&policies[id]) != NULL) {
+        return STATUS_POLICIES_FULL;
+    }
+    ResponseStatus status;
+    Policy *policy = new_policy(spec, &status);
+    if (policy != NULL) {
+        atomic_store_explicit(&policies[id], policy, memory_order_release);
+    }
+    return status;
+}
+
+/**
+ * @brief Adds a policy defined by a client, or finds the identical one already defined.
+ * @details The ID is the hash of the policy, with linear probing over the IDs given to the
+ *          clients when two policies collide.
+ */
+ResponseStatus define_policy(const PolicySpec *spec, uint8_t *id) {
+    ResponseStatus status;
+    Policy *policy = new_policy(spec, &status);
+    if (policy == NULL) {
+        return status;
+    }
+
+    const unsigned int range = MAX_POLICIES - POLICY_FIRST_DEFINED;
+    uint32_t start = hash_policy(policy) % range;
+    status = STATUS_POLICIES_FULL;
+    pthread_mutex_lock(&definition_lock);
+    for (unsigned int probe = 0; probe < range; probe++) {
+        unsigned int slot = POLICY_FIRST_DEFINED + (start + probe) % range;
+        Policy *existing = atomic_load_explicit(&policies[slot], memory_order_relaxed);
+        if (existing == NULL) {
+            atomic_store_explicit(&policies[slot], policy, memory_order_release);
+            policy = NULL;
+        } else if (!same_policy(existing, policy)) {
+            continue;
+        }
+        *id = (uint8_t)slot;
+        status = STATUS_OK;
+        break;
+    }
+    pthread_mutex_unlock(&definition_lock);
+    free(policy); /**< Already defined, or no ID left */
+    return status;
+}
+
+/**
+ * @brief Finds a policy by ID.
+ */
+const Policy *find_policy(uint8_t id) {
+    return atomic_load_explicit(&policies[id], memory_order_acquire);
+}
+
+/**
+ * @brief Returns the classes present in a password.
+ */
+static uint8_t password_classes(const Policy *policy, const char *password, int length) {
+    uint8_t classes = 0;
+    for (int i = 0; i < length; i++) {
+        classes |= policy->class_of[(unsigned char)password[i]];
+    }
+    return classes;
+}
+
+/**
+ * @brief Generates a password of a policy.
+ */
+void generate_policy_password(const Policy *policy, char *password, int length) {
+    for (unsigned int attempt = 0; attempt < POLICY_MAX_ATTEMPTS; attempt++) {
+        generate_from_charset(&policy->charset, password, (size_t)length);
+        if ((password_classes(policy, password, length) & policy->required) == policy->required) {
+            return;
+        }
+    }
+
+    uint32_t taken = 0;     /**< Positions already given to a class (length <= 32) */
+    for (unsigned int i = 0; i < POLICY_CLASS_COUNT; i++) {
+        if (!(policy->required & (1u << i))) {
+            continue;
+        }
+        uint32_t position;
+        do {
+            position = random_below((uint32_t)length);
+        } while (taken & (1u << position));
+        taken |= 1u << position;
+
+        char character[2];
+        generate_from_charset(&policy->class_charsets[i], character, 1);
+        password[position] = character[0];
+    }
+}
+
+/* - - - - - - - - - - - - - - - - - - - END POLICIES - - - - - - - - - - - - - - - - - - - */
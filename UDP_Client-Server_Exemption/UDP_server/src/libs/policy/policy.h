@@ -0,0 +1,101 @@
+/**
+ * @file policy.h
+ * @brief Header file declaring the registry of password policies.
+ *
+ * A policy is a charset with required character classes (see `PolicySpec`). It is compiled
+ * once, when it is configured or defined, into:
+ * - a `Charset`, the dense lookup table and rejection threshold of the charset kernel;
+ * - a table giving the classes of every ASCII character;
+ * - one `Charset` per class, for the rare passwords that keep missing a required class.
+ *
+ * Compiled policies are cached by ID and never freed, so the workers look them up without
+ * locking and never parse anything on the request path.
+ * IDs below `POLICY_FIRST_DEFINED` are reserved to the server configuration; the others are
+ * given to the policies defined by the clients and derived from their content, so defining a
+ * policy again, on this server or on another one with the same policies, gives the same ID.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef POLICY_H_
+#define POLICY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../../../UDP_core/src/libs/charset/charset.h"
+#include "../../../../UDP_core/src/libs/protocol/protocol.h"
+
+/* - - - - - - - - - - - - - - - - - - - - POLICIES - - - - - - - - - - - - - - - - - - - - */
+
+#define POLICY_FIRST_DEFINED 128    /**< First ID given to the policies defined by the clients */
+#define POLICY_MAX_ATTEMPTS 64      /**< Passwords drawn before forcing the missing classes in */
+
+/**
+ * @struct Policy
+ * @brief A compiled policy.
+ */
+typedef struct {
+    char symbols[CHARSET_MAX_SIZE + 1];                                 /**< Characters of the policy, in ASCII order */
+    Charset charset;                                                    /**< Kernel table of `symbols` */
+    uint8_t class_of[128];                                              /**< `POLICY_CLASS_*` bits of each character, 0 if excluded */
+    uint8_t required;                                                   /**< Classes required at least once */
+    char class_symbols[POLICY_CLASS_COUNT][CHARSET_MAX_SIZE + 1];       /**< Characters of each class */
+    Charset class_charsets[POLICY_CLASS_COUNT];                         /**< Kernel table of each non-empty class */
+} Policy;
+
+/**
+ * @brief Adds a policy of the server configuration.
+ *
+ * Must be called before the workers start.
+ *
+ * @param[in] id The ID of the policy, below `POLICY_FIRST_DEFINED`.
+ * @param[in] spec The policy.
+ *
+ * @return `STATUS_OK`, `STATUS_INVALID_POLICY` if the policy draws from no character or
+ *         requires an empty class, or `STATUS_POLICIES_FULL` if the ID is out of range or taken.
+ */
+ResponseStatus configure_policy(unsigned int id, const PolicySpec *spec);
+
+/**
+ * @brief Adds a policy defined by a client, or finds the identical one already defined.
+ *
+ * The ID is derived from the compiled policy, so it does not depend on how the definition
+ * was written (order of the extra characters, excluded characters outside the classes...).
+ *
+ * @param[in] spec The policy.
+ * @param[out] id Receives the ID of the policy.
+ *
+ * @return `STATUS_OK`, `STATUS_INVALID_POLICY`, or `STATUS_POLICIES_FULL` if every ID given
+ *         to the clients is taken.
+ */
+ResponseStatus define_policy(const PolicySpec *spec, uint8_t *id);
+
+/**
+ * @brief Finds a policy by ID.
+ *
+ * @param[in] id The ID sent in the `type` byte of a request.
+ *
+ * @return The compiled policy, or NULL if none has this ID.
+ */
+const Policy *find_policy(uint8_t id);
+
+/**
+ * @brief Generates a password of a policy.
+ *
+ * Passwords are drawn from the whole charset until one holds every required class, which
+ * keeps every compliant password equally likely. After `POLICY_MAX_ATTEMPTS` failures (a
+ * required class much smaller than the charset and a short length) one character of each
+ * required class is written at its own random position of the last draw instead, which
+ * slightly favours the passwords with few characters of those classes.
+ *
+ * @param[in] policy The policy.
+ * @param[out] password Destination, at least `length + 1` bytes, null-terminated.
+ * @param[in] length Number of characters, at least `MIN_PASSWORD_LENGTH`.
+ */
+void generate_policy_password(const Policy *policy, char *password, int length);
+
+/* - - - - - - - - - - - - - - - - - - - END POLICIES - - - - - - - - - - - - - - - - - - - */
+
+#endif /* POLICY_H_ */
@@ -0,0 +1,140 @@
+/**
+ * @file ratelimit.c
+ * @brief Implementation of the per-source token buckets.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ratelimit.h"
+
+_Static_assert(sizeof(RateBucket) == 12, "A bucket must stay a few bytes per client");
+
+#define TOKEN_SCALE 16      /**< Fractions of a request stored per token unit */
+
+/* - - - - - - - - - - - - - - - - - - - - RATE LIMIT - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Allocates the table of one worker.
+ */
+bool init_rate_limiter(RateLimiter *limiter, const RateLimitOptions *options) {
+    memset(limiter, 0, sizeof(*limiter));
+    if (options->rate == 0) {
+        return true;
+    }
+
+    unsigned int bits = 0;
+    while ((1u << bits) < options->clients) {
+        bits++;
+    }
+    limiter->buckets = calloc((size_t)(1u << bits) + RATE_LIMIT_PROBES, sizeof(RateBucket));
+    if (limiter->buckets == NULL) {
+        return false;
+    }
+    limiter->mask = (1u << bits) - 1;
+    limiter->shift = 32 - bits;
+    limiter->rate = options->rate;
+    limiter->full = options->burst * TOKEN_SCALE;
+    return true;
+}
+
+/**
+ * @brief Applies new settings to a limiter, keeping the buckets already filled.
+ */
+bool tune_rate_limiter(RateLimiter *limiter, const RateLimitOptions *options) {
+    if (options->rate == 0 || limiter->buckets == NULL) {
+        free_rate_limiter(limiter);
+        return init_rate_limiter(limiter, options);
+    }
+    limiter->rate = options->rate;
+    limiter->full = options->burst * TOKEN_SCALE;
+    return true;
+}
+
+/**
+ * @brief Releases the table of a limiter.
+ */
+void free_rate_limiter(RateLimiter *limiter) {
+    free(limiter->buckets);
+    memset(limiter, 0, sizeof(*limiter));
+}
+
+/**
+ * @brief Adds the tokens earned since the last refill, up to a full bucket.
+ */
+static void refill(const RateLimiter *limiter, RateBucket *bucket, uint32_t now_ms) {
+    uint64_t earned = (uint64_t)(uint32_t)(now_ms - bucket->updated_ms) * limiter->rate * TOKEN_SCALE / 1000;
+    if (earned == 0) {
+        return; /**< Keep the timestamp, so that the fractions are not lost */
+    }
+    uint64_t tokens = bucket->tokens + earned;
+    bucket->tokens = (uint16_t)(tokens < limiter->full ? tokens : limiter->full);
+    bucket->updated_ms = now_ms;
+}
+
+/**
+ * @brief Picks the bucket to reuse in a full probe window.
+ * @details Idle clients go first: their bucket is full, so forgetting them changes nothing.
+ *          Otherwise the CLOCK pass clears the referenced bits and takes the first cold bucket.
+ */
+static RateBucket *evict(const RateLimiter *limiter, RateBucket *window, uint32_t now_ms) {
+    for (unsigned int i = 0; i < RATE_LIMIT_PROBES; i++) {
+        refill(limiter, &window[i], now_ms);
+        if (window[i].tokens == limiter->full) {
+            return &window[i];
+        }
+    }
+    for (unsigned int i = 0; i < RATE_LIMIT_PROBES; i++) {
+        if (!window[i].referenced) {
+            return &window[i];
+        }
+        window[i].referenced = 0;
+    }
+    return &window[0];
+}
+
+/**
+ * @brief Takes `cost` tokens from the bucket of a client, a whole bucket at most with the admission.
+ */
+bool allow_request(RateLimiter *limiter, uint32_t key, uint32_t now_ms, uint32_t cost) {
+    if (limiter->buckets == NULL) {
+        return true;
+    }
+
+    RateBucket *window = &limiter->buckets[((key * 0x9E3779B1u) >> limiter->shift) & limiter->mask];
+    RateBucket *bucket = NULL;
+    RateBucket *free_bucket = NULL;
+    for (unsigned int i = 0; i < RATE_LIMIT_PROBES; i++) {
+        if (window[i].key == key) {
+            bucket = &window[i];
+            break;
+        }
+        if (window[i].key == 0 && free_bucket == NULL) {
+            free_bucket = &window[i];
+        }
+    }
+
+    if (bucket == NULL) {
+        bucket = free_bucket != NULL ? free_bucket : evict(limiter, window, now_ms);
+        bucket->key = key;
+        bucket->updated_ms = now_ms;
+        bucket->tokens = (uint16_t)limiter->full;
+    } else {
+        refill(limiter, bucket, now_ms);
+    }
+
+    bucket->referenced = 1;
+    uint64_t charged = (uint64_t)cost * TOKEN_SCALE;
+    uint32_t most = cost > 1 ? limiter->full - TOKEN_SCALE : limiter->full; /**< Leaves the token of the admission */
+    charged = charged < most ? charged : most;
+    if (bucket->tokens < charged) {
+        return false;
+    }
+    bucket->tokens -= (uint16_t)charged;
+    return true;
+}
+
+/* - - - - - - - - - - - - - - - - - - - END RATE LIMIT - - - - - - - - - - - - - - - - - - - */
@@ -0,0 +1,118 @@
+/**
+ * @file ratelimit.h
+ * @brief Header file declaring the per-source token buckets of the server.
+ *
+ * Every worker owns a RateLimiter, so the check takes no lock. A limiter is an open-addressing
+ * hash table of 12-byte buckets keyed by a 32-bit client key (see `address_key`). A lookup probes a fixed
+ * window of `RATE_LIMIT_PROBES` entries. When the window is full, a CLOCK pass picks a victim:
+ * it prefers buckets that have refilled completely (idle clients), then buckets not hit since
+ * the last pass. So the table never grows, and a flood of spoofed sources only evicts idle
+ * or cold clients.
+ *
+ * The kernel spreads a client's flows over the workers by port, so a client that uses several
+ * source ports can get up to `workers` times the configured rate.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef RATELIMIT_H_
+#define RATELIMIT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* - - - - - - - - - - - - - - - - - - - - RATE LIMIT - - - - - - - - - - - - - - - - - - - - */
+
+#define RATE_LIMIT_PROBES 8                 /**< Entries probed per lookup */
+#define RATE_LIMIT_MAX_BURST 4095           /**< Largest bucket, in requests */
+#define RATE_LIMIT_MAX_CLIENTS (1u << 24)   /**< Largest table, in entries per worker */
+#define RATE_LIMIT_DEFAULT_CLIENTS 65536    /**< Default table size, in entries per worker */
+
+/**
+ * @struct RateLimitOptions
+ * @brief Settings shared by every limiter.
+ */
+typedef struct {
+    uint32_t rate;          /**< Requests per second allowed per source; 0 disables the limiter */
+    uint32_t burst;         /**< Requests a source can send at once, in [1, RATE_LIMIT_MAX_BURST] */
+    uint32_t clients;       /**< Table entries per worker, a power of two */
+} RateLimitOptions;
+
+/**
+ * @struct RateBucket
+ * @brief Token bucket of one source address.
+ */
+typedef struct {
+    uint32_t key;           /**< Client key; 0 for a free entry */
+    uint32_t updated_ms;    /**< Time of the last refill, milliseconds (wraps) */
+    uint16_t tokens;        /**< Tokens left, in 1/16 of a request */
+    uint8_t referenced;     /**< CLOCK bit: set on every hit, cleared by an eviction pass */
+    uint8_t unused;         /**< Padding */
+} RateBucket;
+
+/**
+ * @struct RateLimiter
+ * @brief The bucket table of one worker.
+ */
+typedef struct {
+    RateBucket *buckets;    /**< `mask + 1 + RATE_LIMIT_PROBES` entries, so windows never wrap */
+    uint32_t mask;          /**< Table size minus one */
+    unsigned int shift;     /**< 32 minus log2 of the table size */
+    uint32_t rate;          /**< Requests per second */
+    uint32_t full;          /**< Size of a full bucket, in 1/16 of a request */
+} RateLimiter;
+
+/**
+ * @brief Allocates the table of one worker.
+ *
+ * @param[out] limiter The limiter to initialize.
+ * @param[in] options The shared settings; a zero rate leaves the limiter disabled.
+ *
+ * @return `false` if the memory could not be allocated.
+ */
+bool init_rate_limiter(RateLimiter *limiter, const RateLimitOptions *options);
+
+/**
+ * @brief Applies new settings to a limiter, keeping the buckets already filled.
+ *
+ * A zero rate releases the table; a limiter that had none allocates it. The table size of
+ * `options` is only read when the table is allocated.
+ *
+ * @param[in,out] limiter The limiter of the calling worker.
+ * @param[in] options The new settings.
+ *
+ * @return `false` if the table could not be allocated; the limiter is then left disabled.
+ */
+bool tune_rate_limiter(RateLimiter *limiter, const RateLimitOptions *options);
+
+/**
+ * @brief Releases the table of a limiter.
+ *
+ * @param[in,out] limiter The limiter; it can be released again safely.
+ */
+void free_rate_limiter(RateLimiter *limiter);
+
+/**
+ * @brief Takes tokens from the bucket of a client.
+ *
+ * A request costs one token per response datagram, so a bulk request is charged for what it
+ * makes the server send rather than as a single request: one token when it is admitted, then
+ * `cost` more for the rest of its response. A cost above one is charged at most the size of
+ * the bucket less one token, so that with the token of its admission a large response takes
+ * a full bucket, and still gets through once the client has been idle.
+ *
+ * @param[in,out] limiter The limiter of the calling worker.
+ * @param[in] key Non-zero key of the client.
+ * @param[in] now_ms Current monotonic time in milliseconds (may wrap).
+ * @param[in] cost Tokens to take, in requests.
+ *
+ * @return `true` if the request may be served, always `true` for a disabled limiter; no token
+ *         is taken otherwise.
+ */
+bool allow_request(RateLimiter *limiter, uint32_t key, uint32_t now_ms, uint32_t cost);
+
+/* - - - - - - - - - - - - - - - - - - - END RATE LIMIT - - - - - - - - - - - - - - - - - - - */
+
+#endif /* RATELIMIT_H_ */
@@ -0,0 +1,289 @@
+/**
+ * @file reservoir.c
+ * @brief Implementation of the reservoir of pre-generated passwords.
+ *
+ * Every queue is a bounded single-producer, multi-consumer ring in the style of Vyukov, like the
+ * log ring: each cell carries a sequence number that tells the producer whether it is free and a
+ * consumer whether it is full, so a pop is one compare-and-swap and never waits for the producer.
+ * The queues are split between the producers before any of them starts, so each queue is only
+ * ever filled by one of them: it owns the enqueue position and publishes a cell with a plain
+ * store of its sequence.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#if defined __linux__
+#define _GNU_SOURCE         /**< Exposes SCHED_IDLE and MADV_DONTDUMP */
+#endif
+
+#if defined WIN32
+#include <windows.h>        /**< Includes Sleep(), VirtualAlloc() and VirtualLock() */
+#else
+#include <sys/mman.h>       /**< Includes mmap(), mlock() and madvise() */
+#include <time.h>           /**< Includes nanosleep() */
+#endif
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "reservoir.h"
+#include "../../../../UDP_core/src/libs/protocol/protocol.h"
+
+/* - - - - - - - - - - - - - - - - - - - - - QUEUES - - - - - - - - - - - - - - - - - - - - - */
+
+#define RESERVOIR_LENGTHS (MAX_PASSWORD_LENGTH - MIN_PASSWORD_LENGTH + 1)  /**< Lengths per type */
+#define RESERVOIR_QUEUES (PASSWORD_TYPE_COUNT * RESERVOIR_LENGTHS)          /**< Queues in total */
+
+/**
+ * @struct ReservoirCell
+ * @brief One entry of a queue.
+ */
+typedef struct {
+    atomic_size_t sequence;                     /**< `position` when free, `position + 1` when it holds a password */
+    char password[MAX_PASSWORD_LENGTH + 1];     /**< The password, null-terminated */
+} ReservoirCell;
+
+/**
+ * @struct ReservoirQueue
+ * @brief The ready passwords of one type and length.
+ */
+typedef struct {
+    _Alignas(64) size_t enqueue_position;           /**< Next position filled, owned by the producer */
+    _Alignas(64) atomic_size_t dequeue_position;    /**< Next position claimed by a consumer */
+    ReservoirCell *cells;                           /**< `capacity` cells */
+} ReservoirQueue;
+
+static ReservoirQueue queues[RESERVOIR_QUEUES];
+static ReservoirCell *cell_memory;          /**< Cells of every queue, in one locked mapping */
+static size_t cell_memory_size;
+static size_t capacity;                     /**< Cells per queue, 0 when the reservoir is disabled */
+static pthread_t producer_threads[RESERVOIR_MAX_PRODUCERS];
+static unsigned int producer_count;        /**< Producers started */
+static unsigned int producer_stride;        /**< Producers sharing the queues, set before they start */
+static atomic_bool stopping;
+
+/**
+ * @brief Overwrites memory with zeros in a way the compiler cannot drop before a release.
+ */
+static void wipe(void *memory, size_t size) {
+    volatile unsigned char *bytes = memory;
+    while (size-- > 0) {
+        *bytes++ = 0;
+    }
+}
+
+/**
+ * @brief Maps zeroed memory kept out of swap and, on Linux, out of core dumps.
+ * @details Locking is best effort: it fails under a low `RLIMIT_MEMLOCK`, which is not fatal.
+ */
+static void *map_secret_memory(size_t size) {
+#if defined WIN32
+    void *memory = VirtualAlloc(NULL, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (memory != NULL) {
+        VirtualLock(memory, size);
+    }
+    return memory;
+#else
+    void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return NULL;
+    }
+    mlock(memory, size);
+#if defined MADV_DONTDUMP
+    madvise(memory, size, MADV_DONTDUMP);
+#endif
+    return memory;
+#endif
+}
+
+/**
+ * @brief Releases memory returned by `map_secret_memory`.
+ */
+static void unmap_secret_memory(void *memory, size_t size) {
+#if defined WIN32
+    (void)size;
+    VirtualFree(memory, 0, MEM_RELEASE);
+#else
+    munlock(memory, size);
+    munmap(memory, size);
+#endif
+}
+
+/**
+ * @brief Queue of a type and length.
+ */
+static ReservoirQueue *queue_of(PasswordType type, int length) {
+    return &queues[(unsigned int)type * RESERVOIR_LENGTHS + (unsigned int)(length - MIN_PASSWORD_LENGTH)];
+}
+
+/**
+ * @brief Generates passwords into the free cells of a queue until it is full.
+ * @return The number of passwords generated.
+ */
+static size_t fill_queue(ReservoirQueue *queue, PasswordType type, int length) {
+    size_t produced = 0;
+    size_t position = queue->enqueue_position;
+
+    while (!atomic_load_explicit(&stopping, memory_order_relaxed)) {
+        ReservoirCell *cell = &queue->cells[position & (capacity - 1)];
+        if (atomic_load_explicit(&cell->sequence, memory_order_acquire) != position) {
+            break; /**< Full: the cell still holds the password of the previous lap */
+        }
+        generate_password(cell->password, type, length);
+        atomic_store_explicit(&cell->sequence, position + 1, memory_order_release);
+        position++;
+        produced++;
+    }
+    queue->enqueue_position = position;
+    return produced;
+}
+
+/* - - - - - - - - - - - - - - - - - - - - END QUEUES - - - - - - - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - - - - - - PRODUCERS - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Entry point of a producer: refills its share of the queues until the reservoir stops.
+ * @param[in] argument Index of the producer, cast to a pointer.
+ */
+static void *run_producer(void *argument) {
+    unsigned int index = (unsigned int)(uintptr_t)argument;
+
+#if defined __linux__
+    struct sched_param parameters = { 0 };
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &parameters); /**< Only runs when a CPU is idle */
+#else
+    struct sched_param parameters = { sched_get_priority_min(SCHED_OTHER) };
+    pthread_setschedparam(pthread_self(), SCHED_OTHER, &parameters);
+#endif
+
+    while (!atomic_load(&stopping)) {
+        size_t produced = 0;
+        for (unsigned int i = index; i < RESERVOIR_QUEUES; i += producer_stride) {
+            produced += fill_queue(&queues[i], (PasswordType)(i / RESERVOIR_LENGTHS),
+                                   (int)(i % RESERVOIR_LENGTHS) + MIN_PASSWORD_LENGTH);
+        }
+        if (produced == 0) {
+#if defined WIN32
+            Sleep(1);
+#else
+            struct timespec pause = { 0, 1000000 };
+            nanosleep(&pause, NULL);
+#endif
+        }
+    }
+    return NULL;
+}
+
+/* - - - - - - - - - - - - - - - - - - - END PRODUCERS - - - - - - - - - - - - - - - - - - - */
+
+/* - - - - - - - - - - - - - - - - - - - - RESERVOIR - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Allocates the queues, then starts the producers that fill them.
+ */
+bool start_reservoir(const ReservoirOptions *options) {
+    if (capacity != 0 || options->capacity == 0) {
+        return true;
+    }
+    if (options->capacity > RESERVOIR_MAX_CAPACITY || (options->capacity & (options->capacity - 1)) != 0 ||
+        options->producers == 0 || options->producers > RESERVOIR_MAX_PRODUCERS) {
+        return false;
+    }
+
+    cell_memory_size = (size_t)RESERVOIR_QUEUES * options->capacity * sizeof(ReservoirCell);
+    cell_memory = map_secret_memory(cell_memory_size);
+    if (cell_memory == NULL) {
+        return false;
+    }
+    for (unsigned int i = 0; i < RESERVOIR_QUEUES; i++) {
+        queues[i].cells = cell_memory + (size_t)i * options->capacity;
+        queues[i].enqueue_position = 0;
+        atomic_init(&queues[i].dequeue_position, 0);
+        for (size_t j = 0; j < options->capacity; j++) {
+            atomic_init(&queues[i].cells[j].sequence, j);
+        }
+    }
+    capacity = options->capacity;
+    atomic_init(&stopping, false);
+
+    producer_stride = options->producers; /**< Read by the producers: never changes while they run */
+    for (producer_count = 0; producer_count < options->producers; producer_count++) {
+        if (pthread_create(&producer_threads[producer_count], NULL, run_producer,
+                           (void *)(uintptr_t)producer_count) != 0) {
+            break;
+        }
+    }
+    if (producer_count < options->producers) {
+        stop_reservoir();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Stops the producers, then wipes and frees every buffered entry.
+ */
+void stop_reservoir(void) {
+    if (capacity == 0) {
+        return;
+    }
+    atomic_store(&stopping, true);
+    for (unsigned int i = 0; i < producer_count; i++) {
+        pthread_join(producer_threads[i], NULL);
+    }
+    producer_count = 0;
+    capacity = 0; /**< From now on `take_password` fails without touching the cells */
+
+    wipe(cell_memory, cell_memory_size);
+    unmap_secret_memory(cell_memory, cell_memory_size);
+    cell_memory = NULL;
+    memset(queues, 0, sizeof(queues));
+}
+
+/**
+ * @brief Whether `start_reservoir` enabled the reservoir.
+ */
+bool reservoir_enabled(void) {
+    return capacity != 0;
+}
+
+/**
+ * @brief Takes a ready password of the given type and length, wiping its cell.
+ */
+bool take_password(char *password, PasswordType type, int length) {
+    if (capacity == 0 || (unsigned int)type >= PASSWORD_TYPE_COUNT ||
+        length < MIN_PASSWORD_LENGTH || length > MAX_PASSWORD_LENGTH) {
+        return false;
+    }
+
+    ReservoirQueue *queue = queue_of(type, length);
+    size_t position = atomic_load_explicit(&queue->dequeue_position, memory_order_relaxed);
+    ReservoirCell *cell;
+    while (true) {
+        cell = &queue->cells[position & (capacity - 1)];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+        if (difference < 0) {
+            return false; /**< Empty */
+        }
+        if (difference > 0) {
+            position = atomic_load_explicit(&queue->dequeue_position, memory_order_relaxed);
+        } else if (atomic_compare_exchange_weak_explicit(&queue->dequeue_position, &position, position + 1,
+                                                         memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    memcpy(password, cell->password, (size_t)length + 1);
+    memset(cell->password, 0, (size_t)length); /**< An entry is handed out exactly once */
+    atomic_store_explicit(&cell->sequence, position + capacity, memory_order_release);
+    return true;
+}
+
+/* - - - - - - - - - - - - - - - - - - - END RESERVOIR - - - - - - - - - - - - - - - - - - - */
@@ -0,0 +1,73 @@
+/**
+ * @file reservoir.h
+ * @brief Header file declaring the reservoir of pre-generated passwords.
+ *
+ * The reservoir keeps one bounded queue of ready passwords per type and length, refilled by
+ * producer threads running at the lowest scheduling priority, so they only use the CPU time
+ * the serving threads leave idle. Serving a request then costs a pop and a copy; when a queue
+ * is empty the caller generates the password inline as before. Each entry is handed out
+ * exactly once and wiped as it is taken, and the entries still buffered are wiped when the
+ * reservoir is stopped.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef RESERVOIR_H_
+#define RESERVOIR_H_
+
+#include <stdbool.h>
+#include "../../../../UDP_core/src/libs/password/password.h"
+
+/* - - - - - - - - - - - - - - - - - - - - RESERVOIR - - - - - - - - - - - - - - - - - - - - */
+
+#define RESERVOIR_MAX_CAPACITY 4096     /**< Maximum entries per type and length */
+#define RESERVOIR_MAX_PRODUCERS 16      /**< Maximum producer threads */
+
+/**
+ * @struct ReservoirOptions
+ * @brief Settings of the reservoir.
+ */
+typedef struct {
+    unsigned int capacity;      /**< Entries per type and length, a power of two; 0 disables the reservoir */
+    unsigned int producers;     /**< Producer threads, at least 1 */
+} ReservoirOptions;
+
+/**
+ * @brief Allocates the queues, then starts the producers that fill them.
+ *
+ * @param[in] options The settings of the reservoir.
+ *
+ * @return `true` if the reservoir is running or disabled, `false` if it could not be started.
+ */
+bool start_reservoir(const ReservoirOptions *options);
+
+/**
+ * @brief Stops the producers, then wipes and frees every buffered entry.
+ *
+ * Must be called once no thread calls `take_password` any more.
+ */
+void stop_reservoir(void);
+
+/**
+ * @brief Whether `start_reservoir` enabled the reservoir.
+ *
+ * @return `true` between a successful `start_reservoir` with a capacity and `stop_reservoir`.
+ */
+bool reservoir_enabled(void);
+
+/**
+ * @brief Takes a ready password of the given type and length.
+ *
+ * @param[out] password Destination of `length` characters and a null terminator.
+ * @param[in] type The password type.
+ * @param[in] length The password length, in [MIN_PASSWORD_LENGTH, MAX_PASSWORD_LENGTH].
+ *
+ * @return `false` if the reservoir is disabled or has no entry left for this type and length.
+ */
+bool take_password(char *password, PasswordType type, int length);
+
+/* - - - - - - - - - - - - - - - - - - - END RESERVOIR - - - - - - - - - - - - - - - - - - - */
+
+#endif /* RESERVOIR_H_ */
@@ -0,0 +1,126 @@
+/**
+ * @file slots.c
+ * @brief Implementation of the preallocated request/response slots.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#if defined __linux__
+#define _GNU_SOURCE         /**< Exposes struct mmsghdr */
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#if defined WIN32
+#include <malloc.h>         /**< Includes _aligned_malloc() */
+#endif
+
+#include "slots.h"
+#include "../address/address.h"
+
+/* - - - - - - - - - - - - - - - - - - - - SLOTS - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Allocates `size` zeroed bytes aligned to `SLOT_ALIGNMENT`.
+ */
+static void *allocate_aligned(size_t size) {
+#if defined WIN32
+    void *memory = _aligned_malloc(size, SLOT_ALIGNMENT);
+#else
+    void *memory = aligned_alloc(SLOT_ALIGNMENT, size); /**< sizeof(Slot) is a multiple of the alignment */
+#endif
+    if (memory != NULL) {
+        memset(memory, 0, size);
+    }
+    return memory;
+}
+
+/**
+ * @brief Releases memory returned by `allocate_aligned`.
+ */
+static void free_aligned(void *memory) {
+#if defined WIN32
+    _aligned_free(memory);
+#else
+    free(memory);
+#endif
+}
+
+/**
+ * @brief Allocates a pool and wires every slot to its receive message header.
+ */
+bool init_slot_pool(SlotPool *pool, unsigned int capacity) {
+    memset(pool, 0, sizeof(*pool));
+    pool->slots = allocate_aligned((size_t)capacity * sizeof(Slot));
+    pool->capacity = capacity;
+    bool allocated = pool->slots != NULL;
+#if defined __linux__
+    pool->rx_messages = calloc(capacity, sizeof(struct mmsghdr));
+    pool->tx_messages = calloc(capacity, sizeof(struct mmsghdr));
+    pool->controls = calloc(capacity, SLOT_CONTROL_SIZE); /**< Aligned for struct cmsghdr, like any allocation */
+    allocated = allocated && pool->rx_messages != NULL && pool->tx_messages != NULL && pool->controls != NULL;
+#endif
+    if (!allocated) {
+        free_slot_pool(pool);
+        return false;
+    }
+
+#if defined __linux__
+    for (unsigned int i = 0; i < capacity; i++) {
+        Slot *slot = &pool->slots[i];
+        slot->request_vector.iov_base = slot->request;
+        slot->request_vector.iov_len = sizeof(slot->request);
+        slot->response_vector.iov_base = slot->response;
+        pool->rx_messages[i].msg_hdr.msg_iov = &slot->request_vector;
+        pool->rx_messages[i].msg_hdr.msg_iovlen = 1;
+        pool->rx_messages[i].msg_hdr.msg_name = &slot->client_address;
+        pool->rx_messages[i].msg_hdr.msg_control = pool->controls + (size_t)i * SLOT_CONTROL_SIZE;
+    }
+#endif
+    return true;
+}
+
+/**
+ * @brief Releases the memory of a pool.
+ */
+void free_slot_pool(SlotPool *pool) {
+    free_aligned(pool->slots);
+#if defined __linux__
+    free(pool->rx_messages);
+    free(pool->tx_messages);
+    free(pool->controls);
+    pool->rx_messages = NULL;
+    pool->tx_messages = NULL;
+    pool->controls = NULL;
+#endif
+    pool->slots = NULL;
+    pool->capacity = 0;
+}
+
+#if defined __linux__
+/**
+ * @brief Resets the address and ancillary data lengths of the first `count` receive headers.
+ */
+void prepare_slot_receive(SlotPool *pool, unsigned int count) {
+    for (unsigned int i = 0; i < count; i++) {
+        pool->rx_messages[i].msg_hdr.msg_namelen = sizeof(pool->slots[i].client_address); /**< Overwritten by the kernel */
+        pool->rx_messages[i].msg_hdr.msg_controllen = SLOT_CONTROL_SIZE;
+    }
+}
+
+/**
+ * @brief Appends the response of a slot to the send headers.
+ */
+void queue_slot_response(SlotPool *pool, Slot *slot, unsigned int position) {
+    struct msghdr *header = &pool->tx_messages[position].msg_hdr;
+    slot->response_vector.iov_len = slot->response_size;
+    header->msg_iov = &slot->response_vector;
+    header->msg_iovlen = 1;
+    header->msg_name = &slot->client_address;
+    header->msg_namelen = address_size(&slot->client_address);
+}
+#endif
+
+/* - - - - - - - - - - - - - - - - - - - END SLOTS - - - - - - - - - - - - - - - - - - - */
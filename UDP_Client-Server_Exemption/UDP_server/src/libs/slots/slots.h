@@ -0,0 +1,111 @@
+/**
+ * @file slots.h
+ * @brief Header file declaring the preallocated request/response slots of the server hot path.
+ *
+ * A slot holds everything the server touches to answer one datagram: the received bytes, the
+ * response being built, the client address and (on Linux) the two `iovec`s that point at them.
+ * Slots are cache-line aligned and sized so that a request and its response take one cache
+ * line each; a pool is allocated once per serving thread, so no memory is allocated or copied
+ * per request. The same pool backs the per-packet loop (one slot) and the `recvmmsg`/`sendmmsg`
+ * loop (one slot per datagram of the batch).
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef SLOTS_H_
+#define SLOTS_H_
+
+#if defined WIN32
+#include <winsock2.h>       /**< Include Winsock 2 library for Windows */
+#include <ws2tcpip.h>       /**< Include struct sockaddr_storage */
+#else
+#include <sys/socket.h>     /**< Include socket library (struct mmsghdr, struct iovec) */
+#include <sys/uio.h>        /**< Include struct iovec */
+#include <netinet/in.h>     /**< Include for internet address family structures */
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* - - - - - - - - - - - - - - - - - - - - SLOTS - - - - - - - - - - - - - - - - - - - - */
+
+#define SLOT_ALIGNMENT 64       /**< Cache line size the slots are aligned to */
+#define SLOT_REQUEST_SIZE 128   /**< Received bytes kept per request */
+#define SLOT_RESPONSE_SIZE 128  /**< Room for the largest response, sealed or not, plus a terminator */
+#define SLOT_CONTROL_SIZE 128   /**< Room for the ancillary data of a receive header */
+
+/**
+ * @struct Slot
+ * @brief Storage for one request and its response.
+ *
+ * v2 requests take at most `MAX_REQUEST_SIZE` bytes. A v1 request is 1025 bytes, but only its
+ * type and the leading digits of its length are meaningful, so a longer datagram is truncated
+ * to `SLOT_REQUEST_SIZE` bytes without changing how it is decoded.
+ */
+typedef struct {
+    _Alignas(SLOT_ALIGNMENT) uint8_t request[SLOT_REQUEST_SIZE];  /**< Received bytes */
+    uint8_t response[SLOT_RESPONSE_SIZE];                         /**< Response datagram being built */
+    struct sockaddr_storage client_address;                       /**< Sender of the request, IPv4 or IPv6 */
+    uint32_t request_size;                                        /**< Bytes stored in `request` */
+    uint32_t response_size;                                       /**< Bytes to send from `response`, 0 for none */
+#if defined __linux__
+    struct iovec request_vector;                                  /**< Points at `request` */
+    struct iovec response_vector;                                 /**< Points at `response` */
+#endif
+} Slot;
+
+/**
+ * @struct SlotPool
+ * @brief Slots of one serving thread, with the message headers of the batched loop.
+ */
+typedef struct {
+    Slot *slots;                        /**< `capacity` aligned slots */
+    unsigned int capacity;              /**< Number of slots */
+#if defined __linux__
+    struct mmsghdr *rx_messages;        /**< One receive header per slot, wired to the slot */
+    struct mmsghdr *tx_messages;        /**< Send headers, filled with the slots that have a response */
+    uint8_t *controls;                  /**< `SLOT_CONTROL_SIZE` bytes of ancillary data per receive header */
+#endif
+} SlotPool;
+
+/**
+ * @brief Allocates a pool and wires every slot to its receive message header.
+ *
+ * @param[out] pool The pool to initialize.
+ * @param[in] capacity Number of slots, at least 1.
+ *
+ * @return `true` on success, `false` if the memory could not be allocated.
+ */
+bool init_slot_pool(SlotPool *pool, unsigned int capacity);
+
+/**
+ * @brief Releases the memory of a pool.
+ *
+ * @param[in,out] pool The pool to release; it can be released again safely.
+ */
+void free_slot_pool(SlotPool *pool);
+
+#if defined __linux__
+/**
+ * @brief Resets the address and ancillary data lengths of the first `count` receive headers before `recvmmsg`.
+ *
+ * @param[in,out] pool The pool.
+ * @param[in] count Number of headers passed to `recvmmsg`.
+ */
+void prepare_slot_receive(SlotPool *pool, unsigned int count);
+
+/**
+ * @brief Appends the response of a slot to the send headers.
+ *
+ * @param[in,out] pool The pool.
+ * @param[in] slot The slot whose response is queued; `response_size` must not be 0.
+ * @param[in] position Index of the send header to fill.
+ */
+void queue_slot_response(SlotPool *pool, Slot *slot, unsigned int position);
+#endif
+
+/* - - - - - - - - - - - - - - - - - - - END SLOTS - - - - - - - - - - - - - - - - - - - */
+
+#endif /* SLOTS_H_ */
@@ -0,0 +1,408 @@
+/**
+ * @file trace.c
+ * @brief Implementation of the per-worker trace rings, stage histograms and Chrome trace dump.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#include <time.h>           /**< Includes clock_gettime() */
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace.h"
+#include "../metrics/metrics.h"
+
+#if defined _MSC_VER
+#define THREAD_LOCAL __declspec(thread)  /**< Thread-local storage qualifier for MSVC */
+#else
+#define THREAD_LOCAL _Thread_local       /**< Thread-local storage qualifier for C11 compilers */
+#endif
+
+_Static_assert((TRACE_RING_SIZE & (TRACE_RING_SIZE - 1)) == 0, "The trace ring needs a power of two records");
+
+/* - - - - - - - - - - - - - - - - - - - - TRACE - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @struct TraceRing
+ * @brief Records and histograms written by a single worker.
+ */
+typedef struct {
+    TraceRecord records[TRACE_RING_SIZE];
+    atomic_uint_fast64_t committed;     /**< Records published to the readers */
+    uint64_t reserved;                  /**< Records started; only the owner reads it */
+    unsigned int countdown;             /**< Requests left before the next traced one */
+    unsigned int index;                 /**< Position of the worker, the thread of the Chrome trace */
+    atomic_uint_fast64_t buckets[TRACE_STAGES][TRACE_BUCKETS];
+    atomic_uint_fast64_t sum_ns[TRACE_STAGES];
+    atomic_uint_fast64_t max_ns[TRACE_STAGES];
+} TraceRing;
+
+static const char *const stage_names[TRACE_STAGES] = {
+    "kernel", "queue", "parse", "log", "handle", "send", "total"
+};
+
+static unsigned int trace_interval;                 /**< 0 while tracing is disabled */
+static _Atomic(TraceRing *) rings[MAX_WORKERS];
+static atomic_uint ring_count;
+static THREAD_LOCAL TraceRing *thread_ring;
+
+/**
+ * @brief Enables tracing for the workers bound afterwards.
+ */
+void enable_tracing(unsigned int interval) {
+    trace_interval = interval;
+}
+
+/**
+ * @brief Tells whether tracing is enabled.
+ */
+bool tracing_enabled(void) {
+    return trace_interval != 0;
+}
+
+/**
+ * @brief Gives the calling thread its own ring, if tracing is enabled.
+ */
+bool bind_worker_trace(void) {
+    if (trace_interval == 0 || thread_ring != NULL) {
+        return true;
+    }
+    unsigned int index = atomic_fetch_add(&ring_count, 1);
+    TraceRing *ring = index < MAX_WORKERS ? calloc(1, sizeof(*ring)) : NULL;
+    if (ring == NULL) {
+        return false;
+    }
+    ring->countdown = trace_interval;
+    ring->index = index;
+    thread_ring = ring;
+    atomic_store(&rings[index], ring);
+    return true;
+}
+
+/**
+ * @brief Decides whether the request the calling thread starts on is traced.
+ */
+TraceRecord *start_trace(uint64_t received_ns) {
+    TraceRing *ring = thread_ring;
+    if (ring == NULL || --ring->countdown != 0) {
+        return NULL;
+    }
+    ring->countdown = trace_interval;
+    uint64_t committed = atomic_load_explicit(&ring->committed, memory_order_relaxed);
+    if (ring->reserved - committed >= TRACE_RING_SIZE / 2) {
+        return NULL;    /**< Keeps the readers' window valid; only an endless batch gets here */
+    }
+
+    TraceRecord *record = &ring->records[ring->reserved++ & (TRACE_RING_SIZE - 1)];
+    memset(record, 0, sizeof(*record));
+    record->points[TRACE_RECEIVED] = received_ns;
+    record->points[TRACE_STARTED] = metrics_now_ns();
+    return record;
+}
+
+/**
+ * @brief Sets the kernel receive time of a traced request, moved to the monotonic clock.
+ */
+void trace_kernel_time(TraceRecord *record, int64_t kernel_time_ns) {
+#if defined WIN32
+    (void)record;
+    (void)kernel_time_ns;
+#else
+    if (record == NULL || kernel_time_ns == 0) {
+        return;
+    }
+    struct timespec now;
+    uint64_t monotonic = metrics_now_ns();
+    clock_gettime(CLOCK_REALTIME, &now);
+    int64_t delay = (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec - kernel_time_ns;
+    uint64_t kernel = delay > 0 && (uint64_t)delay < monotonic ? monotonic - (uint64_t)delay : monotonic;
+    uint64_t received = record->points[TRACE_RECEIVED];
+    record->points[TRACE_KERNEL] = kernel < received ? kernel : received;   /**< A stepped clock never runs backwards here */
+#endif
+}
+
+/**
+ * @brief Sets `TRACE_PARSED` and copies what the request asked for.
+ */
+void trace_request(TraceRecord *record, const PasswordRequest *request) {
+    if (record == NULL) {
+        return;
+    }
+    record->points[TRACE_PARSED] = metrics_now_ns();
+    record->type = request->type;
+    record->length = request->length;
+    record->flags = request->flags;
+}
+
+/**
+ * @brief Sets a point of a traced request to the current time.
+ */
+void trace_point(TraceRecord *record, TracePoint point) {
+    if (record != NULL) {
+        record->points[point] = metrics_now_ns();
+    }
+}
+
+/**
+ * @brief Returns the histogram bucket of a duration: exact below 8 ns, then four per power of two.
+ */
+static unsigned int bucket_of(uint64_t value) {
+    if (value < 8) {
+        return (unsigned int)value;
+    }
+#if defined __GNUC__
+    unsigned int msb = 63 - (unsigned int)__builtin_clzll(value);
+#else
+    unsigned int msb = 3;
+    while (msb < 63 && (value >> (msb + 1)) != 0) {
+        msb++;
+    }
+#endif
+    unsigned int bucket = 4 * (msb - 1) + (unsigned int)((value >> (msb - 2)) & 3);
+    return bucket < TRACE_BUCKETS ? bucket : TRACE_BUCKETS - 1;
+}
+
+/**
+ * @brief Returns the exclusive upper bound of a bucket, in nanoseconds.
+ */
+static uint64_t bucket_bound(unsigned int bucket) {
+    if (bucket < 8) {
+        return bucket + 1;
+    }
+    unsigned int shift = bucket / 4 - 1;
+    return (uint64_t)(4 + bucket % 4 + 1) << shift;
+}
+
+/**
+ * @brief Adds to a counter that only the calling thread writes.
+ */
+static void add_owned(atomic_uint_fast64_t *counter, uint64_t amount) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + amount,
+                          memory_order_relaxed);
+}
+
+/**
+ * @brief Adds one duration to the histogram of a stage.
+ */
+static void record_stage(TraceRing *ring, TraceStage stage, uint64_t start, uint64_t end) {
+    if (start == 0 || end < start) {
+        return;
+    }
+    uint64_t duration = end - start;
+    add_owned(&ring->buckets[stage][bucket_of(duration)], 1);
+    add_owned(&ring->sum_ns[stage], duration);
+    if (duration > atomic_load_explicit(&ring->max_ns[stage], memory_order_relaxed)) {
+        atomic_store_explicit(&ring->max_ns[stage], duration, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Ends the traced requests of the calling thread once their responses are sent.
+ */
+void finish_traces(void) {
+    TraceRing *ring = thread_ring;
+    if (ring == NULL) {
+        return;
+    }
+    uint64_t committed = atomic_load_explicit(&ring->committed, memory_order_relaxed);
+    if (committed == ring->reserved) {
+        return;
+    }
+
+    uint64_t now = metrics_now_ns();
+    for (uint64_t i = committed; i < ring->reserved; i++) {
+        TraceRecord *record = &ring->records[i & (TRACE_RING_SIZE - 1)];
+        if (record->points[TRACE_HANDLED] == 0) {
+            continue;   /**< Dropped: stays without TRACE_SENT, which the readers skip */
+        }
+        record->points[TRACE_SENT] = now;
+        for (unsigned int stage = TRACE_STAGE_KERNEL; stage < TRACE_STAGE_TOTAL; stage++) {
+            record_stage(ring, (TraceStage)stage, record->points[stage], record->points[stage + 1]);
+        }
+        uint64_t first = record->points[TRACE_KERNEL] != 0 ? record->points[TRACE_KERNEL] : record->points[TRACE_RECEIVED];
+        record_stage(ring, TRACE_STAGE_TOTAL, first, now);
+    }
+    atomic_store_explicit(&ring->committed, ring->reserved, memory_order_release);
+}
+
+/**
+ * @brief Appends formatted text to a buffer, never writing past its end.
+ */
+static void append(char *buffer, size_t buffer_size, size_t *used, const char *format, ...) {
+    if (*used >= buffer_size) {
+        return;
+    }
+    va_list arguments;
+    va_start(arguments, format);
+    int written = vsnprintf(buffer + *used, buffer_size - *used, format, arguments);
+    va_end(arguments);
+    if (written > 0) {
+        *used += (size_t)written;
+        if (*used >= buffer_size) {
+            *used = buffer_size - 1; /**< Output truncated by vsnprintf */
+        }
+    }
+}
+
+/**
+ * @brief Returns the upper bound of the bucket holding a quantile, in microseconds.
+ */
+static double quantile_us(const uint64_t *buckets, uint64_t count, double quantile, uint64_t max_ns) {
+    uint64_t rank = (uint64_t)(quantile * (double)count);
+    uint64_t seen = 0;
+    unsigned int bucket = 0;
+    while (bucket < TRACE_BUCKETS - 1 && seen + buckets[bucket] <= rank) {
+        seen += buckets[bucket++];
+    }
+    uint64_t bound = bucket_bound(bucket);
+    return (double)(bound < max_ns ? bound : max_ns) / 1e3;
+}
+
+/**
+ * @brief Writes the histograms of every worker as a table of percentiles per stage.
+ */
+size_t format_trace_stages(char *buffer, size_t buffer_size) {
+    static uint64_t buckets[TRACE_STAGES][TRACE_BUCKETS];   /**< Only the admin loop formats the table */
+    uint64_t sum_ns[TRACE_STAGES] = { 0 };
+    uint64_t max_ns[TRACE_STAGES] = { 0 };
+    unsigned int workers = atomic_load(&ring_count);
+    size_t used = 0;
+
+    if (buffer_size == 0) {
+        return 0;
+    }
+    buffer[0] = '\0';
+    memset(buckets, 0, sizeof(buckets));
+    workers = workers < MAX_WORKERS ? workers : MAX_WORKERS;
+    for (unsigned int w = 0; w < workers; w++) {
+        TraceRing *ring = atomic_load(&rings[w]);
+        if (ring == NULL) {
+            continue;
+        }
+        for (unsigned int stage = 0; stage < TRACE_STAGES; stage++) {
+            for (unsigned int i = 0; i < TRACE_BUCKETS; i++) {
+                buckets[stage][i] += atomic_load_explicit(&ring->buckets[stage][i], memory_order_relaxed);
+            }
+            sum_ns[stage] += atomic_load_explicit(&ring->sum_ns[stage], memory_order_relaxed);
+            uint64_t max = atomic_load_explicit(&ring->max_ns[stage], memory_order_relaxed);
+            max_ns[stage] = max > max_ns[stage] ? max : max_ns[stage];
+        }
+    }
+
+    append(buffer, buffer_size, &used, "# one request out of %u per worker, %u workers\n"
+           "stage      requests    mean us     p50 us     p99 us   p99.9 us     max us\n", trace_interval, workers);
+    for (unsigned int stage = 0; stage < TRACE_STAGES; stage++) {
+        uint64_t count = 0;
+        for (unsigned int i = 0; i < TRACE_BUCKETS; i++) {
+            count += buckets[stage][i];
+        }
+        if (count == 0) {
+            append(buffer, buffer_size, &used, "%-8s %10u %10s %10s %10s %10s %10s\n", stage_names[stage], 0u,
+                   "-", "-", "-", "-", "-");
+            continue;
+        }
+        append(buffer, buffer_size, &used, "%-8s %10llu %10.1f %10.1f %10.1f %10.1f %10.1f\n", stage_names[stage],
+               (unsigned long long)count, (double)sum_ns[stage] / (double)count / 1e3,
+               quantile_us(buckets[stage], count, 0.5, max_ns[stage]),
+               quantile_us(buckets[stage], count, 0.99, max_ns[stage]),
+               quantile_us(buckets[stage], count, 0.999, max_ns[stage]), (double)max_ns[stage] / 1e3);
+    }
+    return used;
+}
+
+/**
+ * @brief Copies the published records of a ring that the worker cannot overwrite meanwhile.
+ * @details The worker reserves at most `TRACE_RING_SIZE / 2` records past the published ones,
+ *          so after the copy every record from `committed - TRACE_RING_SIZE / 2` on is intact.
+ * @return The number of records copied into `copies`, oldest first.
+ */
+static size_t copy_records(TraceRing *ring, TraceRecord *copies) {
+    uint64_t committed = atomic_load_explicit(&ring->committed, memory_order_acquire);
+    uint64_t first = committed > TRACE_RING_SIZE ? committed - TRACE_RING_SIZE : 0;
+    for (uint64_t i = first; i < committed; i++) {
+        copies[i - first] = ring->records[i & (TRACE_RING_SIZE - 1)];
+    }
+    atomic_thread_fence(memory_order_acquire);
+    uint64_t now_committed = atomic_load_explicit(&ring->committed, memory_order_relaxed);
+    uint64_t intact = now_committed > TRACE_RING_SIZE / 2 ? now_committed - TRACE_RING_SIZE / 2 : 0;
+    if (intact <= first) {
+        return (size_t)(committed - first);
+    }
+    if (intact >= committed) {
+        return 0;
+    }
+    memmove(copies, copies + (intact - first), (size_t)(committed - intact) * sizeof(*copies));
+    return (size_t)(committed - intact);
+}
+
+/**
+ * @brief Writes one complete ("X") event of the Chrome trace format.
+ */
+static void write_event(FILE *file, const char *name, unsigned int thread, uint64_t start, uint64_t end) {
+    fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+            name, thread, (double)start / 1e3, (double)(end - start) / 1e3);
+}
+
+/**
+ * @brief Writes the records of every worker to a file in the Chrome trace event format.
+ */
+long write_chrome_trace(const char *path) {
+    FILE *file = fopen(path, "w");
+    TraceRecord *copies = malloc(sizeof(TraceRecord) * TRACE_RING_SIZE);
+    long written = 0;
+    if (file == NULL || copies == NULL) {
+        if (file != NULL) {
+            fclose(file);
+        }
+        free(copies);
+        return -1;
+    }
+
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+          "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"UDP_server\"}}", file);
+    unsigned int workers = atomic_load(&ring_count);
+    workers = workers < MAX_WORKERS ? workers : MAX_WORKERS;
+    for (unsigned int w = 0; w < workers; w++) {
+        TraceRing *ring = atomic_load(&rings[w]);
+        if (ring == NULL) {
+            continue;
+        }
+        fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"worker %u\"}}",
+                ring->index, ring->index);
+
+        size_t count = copy_records(ring, copies);
+        for (size_t i = 0; i < count; i++) {
+            const TraceRecord *record = &copies[i];
+            const uint64_t *points = record->points;
+            if (points[TRACE_SENT] == 0) {
+                continue;
+            }
+            uint64_t first = points[TRACE_KERNEL] != 0 ? points[TRACE_KERNEL] : points[TRACE_RECEIVED];
+            fprintf(file, ",\n{\"name\":\"request\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,"
+                          "\"args\":{\"type\":\"%c\",\"length\":%u,\"flags\":%u}}",
+                    ring->index, (double)first / 1e3, (double)(points[TRACE_SENT] - first) / 1e3,
+                    isalnum((unsigned char)record->type) ? record->type : '?', record->length, record->flags);
+            for (unsigned int stage = TRACE_STAGE_KERNEL; stage < TRACE_STAGE_TOTAL; stage++) {
+                if (points[stage] != 0 && points[stage + 1] >= points[stage]) {
+                    write_event(file, stage_names[stage], ring->index, points[stage], points[stage + 1]);
+                }
+            }
+            written++;
+        }
+    }
+    fputs("\n]}\n", file);
+
+    free(copies);
+    bool failed = ferror(file) != 0;
+    if (fclose(file) != 0 || failed) {
+        return -1;
+    }
+    return written;
+}
+
+/* - - - - - - - - - - - - - - - - - - - END TRACE - - - - - - - - - - - - - - - - - - - */
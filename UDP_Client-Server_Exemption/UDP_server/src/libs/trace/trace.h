@@ -0,0 +1,180 @@
+/**
+ * @file trace.h
+ * @brief Header file declaring the request-path tracing of the server.
+ *
+ * With tracing enabled, every worker times one request out of `interval` at each point of its
+ * path and keeps the last `TRACE_RING_SIZE` of them in a ring of its own:
+ *
+ *     kernel     the kernel received the datagram (`SO_TIMESTAMPING`, Linux only)
+ *     received   the receive call returned it (the whole batch, with `recvmmsg` or io_uring)
+ *     started    the worker started on it
+ *     parsed     rate limit passed and datagram decoded
+ *     logged     access record queued
+ *     handled    response built (cookie check included; a bulk response is sent by then)
+ *     sent       datagram handed to the kernel (the end of the batch, in the batched loops)
+ *
+ * A stage is the time between two consecutive points, `total` the time between the first and
+ * the last one. The stages of every traced request are also summed in per-worker histograms,
+ * with four buckets per power of two, so a percentile is known within 25%.
+ *
+ * An untraced request costs a countdown and a few tests of a NULL pointer; a traced one a few
+ * clock reads (about 20 ns each with a vDSO), so one request out of 100 keeps the overhead far
+ * below 1%. The kernel timestamps come in the ancillary data of every datagram once tracing is
+ * enabled, whether the request is traced or not.
+ *
+ * Only the owning worker writes its ring; a reader (the admin endpoint, or the exit) copies the
+ * records while it runs and keeps those the worker cannot have overwritten during the copy.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../../../UDP_core/src/libs/protocol/protocol.h"
+
+/* - - - - - - - - - - - - - - - - - - - - TRACE - - - - - - - - - - - - - - - - - - - - */
+
+#define TRACE_RING_SIZE 4096        /**< Records kept per worker (a power of two) */
+#define TRACE_BUCKETS 160           /**< Buckets of a stage histogram: four per power of two up to 2^40 ns */
+#define TRACE_MAX_INTERVAL 1000000  /**< Largest sampling interval accepted */
+
+/**
+ * @enum TracePoint
+ * @brief Points of the path of a request, in order.
+ */
+typedef enum {
+    TRACE_KERNEL,       /**< Kernel receive time, 0 when not reported */
+    TRACE_RECEIVED,     /**< Receive call returned */
+    TRACE_STARTED,      /**< Worker started on the request */
+    TRACE_PARSED,       /**< Admitted and decoded */
+    TRACE_LOGGED,       /**< Access record queued */
+    TRACE_HANDLED,      /**< Response built */
+    TRACE_SENT,         /**< Response handed to the kernel */
+    TRACE_POINTS        /**< Number of points */
+} TracePoint;
+
+/**
+ * @enum TraceStage
+ * @brief Stages of the histograms: stage `s` runs from point `s` to point `s + 1`.
+ */
+typedef enum {
+    TRACE_STAGE_KERNEL,     /**< Socket queue and receive call */
+    TRACE_STAGE_QUEUE,      /**< Wait behind the earlier requests of the batch */
+    TRACE_STAGE_PARSE,      /**< Rate limit and decoding */
+    TRACE_STAGE_LOG,        /**< Access log */
+    TRACE_STAGE_HANDLE,     /**< Cookie check and generation */
+    TRACE_STAGE_SEND,       /**< Send, or wait for the send of the batch */
+    TRACE_STAGE_TOTAL,      /**< First point to `TRACE_SENT` */
+    TRACE_STAGES            /**< Number of stages */
+} TraceStage;
+
+/**
+ * @struct TraceRecord
+ * @brief Monotonic timestamps of one traced request, in nanoseconds (see `metrics_now_ns`).
+ */
+typedef struct {
+    uint64_t points[TRACE_POINTS];  /**< Indexed by TracePoint; 0 for a point not reached */
+    char type;                      /**< Type of the request */
+    uint8_t length;                 /**< Length of the request */
+    uint8_t flags;                  /**< Flags of the request */
+} TraceRecord;
+
+/**
+ * @brief Enables tracing for the workers bound afterwards.
+ *
+ * Must be called before the workers start.
+ *
+ * @param[in] interval One request out of `interval` is traced per worker, in [1, TRACE_MAX_INTERVAL].
+ */
+void enable_tracing(unsigned int interval);
+
+/**
+ * @brief Tells whether tracing is enabled.
+ *
+ * @return `true` after `enable_tracing`.
+ */
+bool tracing_enabled(void);
+
+/**
+ * @brief Gives the calling thread its own ring, if tracing is enabled.
+ *
+ * Calling it twice is harmless.
+ *
+ * @return `false` if the ring could not be allocated (the thread is then not traced).
+ */
+bool bind_worker_trace(void);
+
+/**
+ * @brief Decides whether the request the calling thread starts on is traced.
+ *
+ * @param[in] received_ns Time the receive call returned the request.
+ *
+ * @return The record to fill, with `TRACE_RECEIVED` and `TRACE_STARTED` set, or NULL if the
+ *         request is not traced. Every function below accepts NULL and then does nothing.
+ */
+TraceRecord *start_trace(uint64_t received_ns);
+
+/**
+ * @brief Sets the kernel receive time of a traced request.
+ *
+ * @param[in,out] record The record, or NULL.
+ * @param[in] kernel_time_ns The `SO_TIMESTAMPING` software time (`CLOCK_REALTIME`), 0 if none.
+ */
+void trace_kernel_time(TraceRecord *record, int64_t kernel_time_ns);
+
+/**
+ * @brief Sets `TRACE_PARSED` and copies what the request asked for.
+ *
+ * @param[in,out] record The record, or NULL.
+ * @param[in] request The decoded request.
+ */
+void trace_request(TraceRecord *record, const PasswordRequest *request);
+
+/**
+ * @brief Sets a point of a traced request to the current time.
+ *
+ * @param[in,out] record The record, or NULL.
+ * @param[in] point The point reached.
+ */
+void trace_point(TraceRecord *record, TracePoint point);
+
+/**
+ * @brief Ends the traced requests of the calling thread once their responses are sent.
+ *
+ * Sets `TRACE_SENT` of every request started since the previous call that reached
+ * `TRACE_HANDLED`, adds their stages to the histograms and publishes them; the others were
+ * dropped (rate limit, cookie) and are discarded.
+ */
+void finish_traces(void);
+
+/**
+ * @brief Writes the histograms of every worker as a table of percentiles per stage.
+ *
+ * @param[out] buffer Destination, null-terminated.
+ * @param[in] buffer_size Size of `buffer` in bytes.
+ *
+ * @return The number of characters written, without the terminator.
+ */
+size_t format_trace_stages(char *buffer, size_t buffer_size);
+
+/**
+ * @brief Writes the records of every worker to a file in the Chrome trace event format.
+ *
+ * The file opens in `chrome://tracing` or Perfetto: one row per worker, one `request` event per
+ * traced request with its stages nested inside.
+ *
+ * @param[in] path The path of the file, replaced if it exists.
+ *
+ * @return The number of requests written, or -1 if the file could not be written.
+ */
+long write_chrome_trace(const char *path);
+
+/* - - - - - - - - - - - - - - - - - - - END TRACE - - - - - - - - - - - - - - - - - - - */
+
+#endif /* TRACE_H_ */
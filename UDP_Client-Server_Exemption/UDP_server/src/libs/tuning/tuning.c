@@ -0,0 +1,178 @@
+/**
+ * @file tuning.c
+ * @brief Implementation of the kernel tuning of the data sockets.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#if defined __linux__
+#define _GNU_SOURCE         /**< Exposes SO_RCVBUFFORCE and SO_BUSY_POLL */
+#endif
+
+#include <string.h>
+#include <time.h>           /**< Includes struct timespec */
+#if !defined WIN32
+#include <netinet/udp.h>    /**< Includes UDP_SEGMENT, UDP_GRO and SOL_UDP */
+#endif
+#if defined __linux__
+#include <linux/net_tstamp.h> /**< Includes the SOF_TIMESTAMPING_* flags */
+#endif
+
+#include "tuning.h"
+#include "../address/address.h"
+
+#if defined __linux__
+#if !defined UDP_SEGMENT
+#define UDP_SEGMENT 103     /**< Missing from the headers of glibc before 2.29 */
+#endif
+#if !defined UDP_GRO
+#define UDP_GRO 104
+#endif
+#if !defined SO_BUSY_POLL
+#define SO_BUSY_POLL 46
+#endif
+#endif
+
+/* - - - - - - - - - - - - - - - - - - - - TUNING - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Requests the default options.
+ */
+void default_socket_tuning(SocketTuning *tuning) {
+    memset(tuning, 0, sizeof(*tuning));
+}
+
+/**
+ * @brief Reads an integer socket option, 0 if it cannot be read.
+ */
+static int get_int_option(int socket, int level, int name) {
+    int value = 0;
+    socklen_t size = sizeof(value);
+    if (getsockopt(socket, level, name, (char *)&value, &size) < 0) {
+        return 0;
+    }
+    return value;
+}
+
+/**
+ * @brief Sizes a socket buffer, forcing it past the system limit when the process may.
+ */
+static void size_buffer(int socket, int name, int force_name, int size) {
+    if (size == 0) {
+        return;
+    }
+    setsockopt(socket, SOL_SOCKET, name, (const char *)&size, sizeof(size));
+#if defined __linux__
+    if (get_int_option(socket, SOL_SOCKET, name) / 2 < size) {
+        setsockopt(socket, SOL_SOCKET, force_name, &size, sizeof(size)); /**< EPERM without CAP_NET_ADMIN */
+    }
+#else
+    (void)force_name;
+#endif
+}
+
+/**
+ * @brief Applies the requested options to a socket.
+ */
+void tune_socket(int socket, const SocketTuning *tuning) {
+#if defined __linux__
+    size_buffer(socket, SO_RCVBUF, SO_RCVBUFFORCE, tuning->receive_buffer);
+    size_buffer(socket, SO_SNDBUF, SO_SNDBUFFORCE, tuning->send_buffer);
+
+    int enable = 1;
+    setsockopt(socket, SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable));
+    if (tuning->busy_poll_us != 0) {
+        setsockopt(socket, SOL_SOCKET, SO_BUSY_POLL, &tuning->busy_poll_us, sizeof(tuning->busy_poll_us));
+    }
+    if (tuning->gro) {
+        setsockopt(socket, SOL_UDP, UDP_GRO, &enable, sizeof(enable));
+    }
+    if (tuning->rx_timestamps) {
+        int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+        setsockopt(socket, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags));
+    }
+#else
+    size_buffer(socket, SO_RCVBUF, 0, tuning->receive_buffer);
+    size_buffer(socket, SO_SNDBUF, 0, tuning->send_buffer);
+#endif
+}
+
+/**
+ * @brief Reads the options the kernel actually applied to a socket.
+ */
+void read_socket_tuning(int socket, SocketTuning *applied) {
+    default_socket_tuning(applied);
+    applied->receive_buffer = get_int_option(socket, SOL_SOCKET, SO_RCVBUF);
+    applied->send_buffer = get_int_option(socket, SOL_SOCKET, SO_SNDBUF);
+#if defined __linux__
+    applied->receive_buffer /= 2;
+    applied->send_buffer /= 2;
+    applied->busy_poll_us = get_int_option(socket, SOL_SOCKET, SO_BUSY_POLL);
+    applied->gro = get_int_option(socket, SOL_UDP, UDP_GRO) != 0;
+    applied->rx_timestamps = (get_int_option(socket, SOL_SOCKET, SO_TIMESTAMPING) & SOF_TIMESTAMPING_RX_SOFTWARE) != 0;
+
+    int segment_size = 0;
+    socklen_t size = sizeof(segment_size);
+    applied->gso = getsockopt(socket, SOL_UDP, UDP_SEGMENT, &segment_size, &size) == 0;
+#endif
+}
+
+#if defined __linux__
+/**
+ * @brief Extracts the queue overflow counter, the GRO segment size and the kernel receive time
+ *        from the ancillary data.
+ */
+void read_receive_control(const struct msghdr *message, uint32_t *queue_drops, uint16_t *segment_size,
+                          int64_t *kernel_time_ns) {
+    if (message->msg_controllen == 0) {
+        return;
+    }
+    for (struct cmsghdr *control = CMSG_FIRSTHDR(message); control != NULL;
+         control = CMSG_NXTHDR((struct msghdr *)message, control)) {
+        if (control->cmsg_level == SOL_SOCKET && control->cmsg_type == SO_RXQ_OVFL) {
+            memcpy(queue_drops, CMSG_DATA(control), sizeof(*queue_drops));
+        } else if (control->cmsg_level == SOL_UDP && control->cmsg_type == UDP_GRO) {
+            int size;
+            memcpy(&size, CMSG_DATA(control), sizeof(size));
+            *segment_size = (uint16_t)size;
+        } else if (control->cmsg_level == SOL_SOCKET && control->cmsg_type == SCM_TIMESTAMPING) {
+            struct timespec stamps[3];  /**< Software, deprecated and hardware times */
+            memcpy(stamps, CMSG_DATA(control), sizeof(stamps));
+            *kernel_time_ns = (int64_t)stamps[0].tv_sec * 1000000000LL + stamps[0].tv_nsec;
+        }
+    }
+}
+
+/**
+ * @brief Sends a buffer of back-to-back datagrams, segmented by the kernel, with one call.
+ */
+int send_segments(int socket, const uint8_t *data, size_t size, uint16_t segment_size,
+                  const struct sockaddr_storage *address) {
+    union {
+        struct cmsghdr header;                      /**< Aligns the buffer */
+        uint8_t bytes[CMSG_SPACE(sizeof(uint16_t))];
+    } control;
+    struct iovec vector = { (void *)data, size };
+    struct msghdr message;
+
+    memset(&message, 0, sizeof(message));
+    memset(&control, 0, sizeof(control));
+    message.msg_name = (void *)address;
+    message.msg_namelen = address_size(address);
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control.bytes;
+    message.msg_controllen = sizeof(control.bytes);
+
+    struct cmsghdr *header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_UDP;
+    header->cmsg_type = UDP_SEGMENT;
+    header->cmsg_len = CMSG_LEN(sizeof(segment_size));
+    memcpy(CMSG_DATA(header), &segment_size, sizeof(segment_size));
+    return (int)sendmsg(socket, &message, 0);
+}
+#endif
+
+/* - - - - - - - - - - - - - - - - - - - END TUNING - - - - - - - - - - - - - - - - - - - */
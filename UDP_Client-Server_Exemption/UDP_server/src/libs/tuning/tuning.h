@@ -0,0 +1,126 @@
+/**
+ * @file tuning.h
+ * @brief Header file declaring the kernel tuning of the data sockets.
+ *
+ * A default socket gets a receive buffer of a few hundred kilobytes: a burst larger than that
+ * overflows the queue and the kernel drops the datagrams before the server sees them, which
+ * the clients observe as timeouts. The buffers can be sized on the command line; the kernel
+ * silently clamps the request to `net.core.rmem_max`/`wmem_max` (unless the process holds
+ * `CAP_NET_ADMIN`), so the values actually applied are read back and reported.
+ *
+ * On Linux the sockets also report the overflow counter of their queue (`SO_RXQ_OVFL`) in the
+ * ancillary data of every datagram received after a drop, and can optionally:
+ * - busy-poll the device queue for some microseconds before sleeping (`SO_BUSY_POLL`);
+ * - receive bursts of one flow coalesced in a single buffer (`UDP_GRO`), which is then split
+ *   back into its datagrams using the segment size given in the ancillary data;
+ * - send the numbered datagrams of a bulk response as one buffer that the kernel or the
+ *   device segments (`UDP_SEGMENT`, generic segmentation offload);
+ * - stamp every received datagram with the time the kernel took it (`SO_TIMESTAMPING`,
+ *   software receive timestamps), for the tracing of the request path.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef TUNING_H_
+#define TUNING_H_
+
+#if defined WIN32
+#include <winsock2.h>       /**< Include Winsock 2 library for Windows */
+#include <ws2tcpip.h>       /**< Include struct sockaddr_storage */
+#else
+#include <sys/socket.h>     /**< Include struct msghdr */
+#include <netinet/in.h>     /**< Include for internet address family structures */
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* - - - - - - - - - - - - - - - - - - - - TUNING - - - - - - - - - - - - - - - - - - - - */
+
+#define TUNING_MAX_BUFFER (1 << 30)     /**< Largest socket buffer accepted on the command line */
+#define TUNING_MAX_BUSY_POLL 100000     /**< Longest busy-polling time in microseconds */
+#define TUNING_COALESCED_SIZE 65536     /**< Room for the largest coalesced (GRO) or segmented (GSO) buffer */
+#define TUNING_MAX_SEGMENTS 64          /**< Datagrams per `UDP_SEGMENT` send accepted by every kernel */
+#define TUNING_CONTROL_SIZE 128         /**< Room for the ancillary data of a received datagram */
+
+/**
+ * @struct SocketTuning
+ * @brief Options of a data socket, as requested or as read back from the kernel.
+ */
+typedef struct {
+    int receive_buffer;         /**< `SO_RCVBUF` in bytes, 0 for the system default */
+    int send_buffer;            /**< `SO_SNDBUF` in bytes, 0 for the system default */
+    int busy_poll_us;           /**< `SO_BUSY_POLL` in microseconds, 0 to sleep at once */
+    bool gro;                   /**< Coalesced receive (`UDP_GRO`) */
+    bool gso;                   /**< Segmented bulk sends (`UDP_SEGMENT`); read back, it means supported */
+    bool rx_timestamps;         /**< Kernel receive timestamps (`SO_TIMESTAMPING`) */
+} SocketTuning;
+
+/**
+ * @brief Requests the default options: system buffers, no busy-polling, no GRO, GSO or timestamps.
+ *
+ * @param[out] tuning The options to initialize.
+ */
+void default_socket_tuning(SocketTuning *tuning);
+
+/**
+ * @brief Applies the requested options to a socket.
+ *
+ * Every option is best effort: the values the kernel kept are what `read_socket_tuning`
+ * returns. A buffer clamped by the system limit is retried with `SO_RCVBUFFORCE` or
+ * `SO_SNDBUFFORCE`, which only succeed with `CAP_NET_ADMIN`. On Linux the overflow counter
+ * of the receive queue is always enabled.
+ *
+ * @param[in] socket The socket, before or after binding.
+ * @param[in] tuning The requested options.
+ */
+void tune_socket(int socket, const SocketTuning *tuning);
+
+/**
+ * @brief Reads the options the kernel actually applied to a socket.
+ *
+ * The buffer sizes are halved back on Linux, which doubles the requested value to account
+ * for its bookkeeping, so they compare with what was requested.
+ *
+ * @param[in] socket The socket.
+ * @param[out] applied Receives the options; `gso` tells whether the kernel accepts `UDP_SEGMENT`.
+ */
+void read_socket_tuning(int socket, SocketTuning *applied);
+
+#if defined __linux__
+/**
+ * @brief Extracts the queue overflow counter, the GRO segment size and the kernel receive time
+ *        from the ancillary data.
+ *
+ * @param[in] message The header filled by `recvmsg`/`recvmmsg`.
+ * @param[in,out] queue_drops Receives the counter of datagrams dropped by the socket so far,
+ *                            left unchanged if the datagram carries none (no drop yet).
+ * @param[in,out] segment_size Receives the size of the coalesced datagrams, left unchanged if
+ *                             the buffer holds a single datagram.
+ * @param[in,out] kernel_time_ns Receives the software receive timestamp in nanoseconds of
+ *                               `CLOCK_REALTIME`, left unchanged if the datagram carries none.
+ */
+void read_receive_control(const struct msghdr *message, uint32_t *queue_drops, uint16_t *segment_size,
+                          int64_t *kernel_time_ns);
+
+/**
+ * @brief Sends a buffer of back-to-back datagrams, segmented by the kernel, with one call.
+ *
+ * @param[in] socket The socket.
+ * @param[in] data The datagrams; all of them are `segment_size` bytes but the last, which can be shorter.
+ * @param[in] size Total bytes, at most `TUNING_COALESCED_SIZE` and `TUNING_MAX_SEGMENTS` segments.
+ * @param[in] segment_size Size of each datagram.
+ * @param[in] address The destination.
+ *
+ * @return The bytes sent, or -1 with the error in `errno`.
+ */
+int send_segments(int socket, const uint8_t *data, size_t size, uint16_t segment_size,
+                  const struct sockaddr_storage *address);
+#endif
+
+/* - - - - - - - - - - - - - - - - - - - END TUNING - - - - - - - - - - - - - - - - - - - */
+
+#endif /* TUNING_H_ */
@@ -0,0 +1,333 @@
+/**
+ * @file uring.c
+ * @brief Implementation of the io_uring data path on the raw system calls.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#if defined __linux__
+
+#define _GNU_SOURCE         /**< Exposes struct mmsghdr */
+
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>           /**< Includes struct timespec */
+#include <unistd.h>         /**< Includes syscall() and close() */
+#include <sys/mman.h>       /**< Includes mmap() */
+#include <sys/syscall.h>
+#include "uring.h"
+#include "../tuning/tuning.h"
+
+_Static_assert(offsetof(Slot, response) == SLOT_REQUEST_SIZE,
+               "The request and response of a slot must form one contiguous receive buffer");
+_Static_assert((URING_SLOTS & (URING_SLOTS - 1)) == 0 && URING_SLOTS <= 32768,
+               "The provided-buffer ring needs a power of two entries");
+
+#define URING_BUFFER_GROUP 0                                    /**< Buffer group of the slots */
+#define URING_BUFFER_SIZE (SLOT_REQUEST_SIZE + SLOT_RESPONSE_SIZE) /**< Receive space of a slot */
+/**
+ * @brief Room for the ancillary data: the queue overflow counter and the receive timestamps.
+ */
+#define URING_CONTROL_SIZE (CMSG_SPACE(sizeof(uint32_t)) + CMSG_SPACE(3 * sizeof(struct timespec)))
+#define URING_RECEIVE_TAG 0                                     /**< `user_data` of the receive; sends use slot index + 1 */
+
+/* - - - - - - - - - - - - - - - - - - - - URING - - - - - - - - - - - - - - - - - - - - */
+
+/**
+ * @brief Appends a slot to the provided-buffer ring.
+ */
+static void provide_slot(Uring *ring, Slot *slot) {
+    struct io_uring_buf *buffer = &ring->buffers->bufs[ring->buffer_tail & (URING_SLOTS - 1)];
+    buffer->addr = (uint64_t)(uintptr_t)slot;
+    buffer->len = URING_BUFFER_SIZE;
+    buffer->bid = (uint16_t)(slot - ring->pool->slots);
+    ring->buffer_tail++;
+    __atomic_store_n(&ring->buffers->tail, ring->buffer_tail, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Hands the queued SQEs to the kernel.
+ * @return `false` on a submission error other than a transient one.
+ */
+static bool enter_ring(Uring *ring) {
+    while (ring->queued > 0) {
+        int submitted = (int)syscall(__NR_io_uring_enter, ring->ring_fd, ring->queued, 0, 0, NULL, 0);
+        if (submitted < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EBUSY; /**< Retried at the next submit */
+        }
+        ring->queued -= (unsigned int)submitted;
+    }
+    return true;
+}
+
+/**
+ * @brief Returns a free SQE, submitting the queued ones first if the queue is full.
+ * @return NULL if the queue is full and cannot be submitted.
+ */
+static struct io_uring_sqe *next_sqe(Uring *ring) {
+    unsigned int tail = *ring->sq_tail;
+    while (tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) >= ring->sq_entries) {
+        if (!enter_ring(ring) || ring->queued == ring->sq_entries) {
+            return NULL;
+        }
+    }
+    struct io_uring_sqe *sqe = &ring->sqes[tail & ring->sq_mask];
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+/**
+ * @brief Publishes the SQE returned by the last `next_sqe`.
+ */
+static void push_sqe(Uring *ring) {
+    __atomic_store_n(ring->sq_tail, *ring->sq_tail + 1, __ATOMIC_RELEASE);
+    ring->queued++;
+}
+
+/**
+ * @brief Queues the multishot `recvmsg` on the data socket.
+ */
+static void arm_receive(Uring *ring) {
+    struct io_uring_sqe *sqe = next_sqe(ring);
+    if (sqe == NULL) {
+        return; /**< Still disarmed: retried by the next submit */
+    }
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = ring->socket;
+    sqe->addr = (uint64_t)(uintptr_t)&ring->receive_header;
+    sqe->len = 1;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->user_data = URING_RECEIVE_TAG;
+    push_sqe(ring);
+    ring->receiving = true;
+}
+
+/**
+ * @brief Creates a ring serving `socket` with the slots of `pool`, and arms the receive.
+ * @details `IORING_SETUP_SINGLE_ISSUER` doubles as the feature test: it was added in the
+ *          same release as the multishot `recvmsg` (Linux 6.0).
+ */
+bool uring_init(Uring *ring, int socket, SlotPool *pool) {
+    memset(ring, 0, sizeof(*ring));
+    ring->ring_fd = -1;
+    if (pool->capacity != URING_SLOTS) {
+        return false;
+    }
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_SINGLE_ISSUER;
+    ring->ring_fd = (int)syscall(__NR_io_uring_setup, URING_SLOTS, &params);
+    if (ring->ring_fd < 0 || !(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP)) {
+        uring_close(ring);
+        return false;
+    }
+
+    size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->ring_size = sq_size > cq_size ? sq_size : cq_size;
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->ring_memory = mmap(NULL, ring->ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             ring->ring_fd, IORING_OFF_SQ_RING);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring->ring_fd, IORING_OFF_SQES);
+    ring->buffers = mmap(NULL, URING_SLOTS * sizeof(struct io_uring_buf), PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring->ring_memory == MAP_FAILED || ring->sqes == MAP_FAILED || ring->buffers == MAP_FAILED) {
+        uring_close(ring);
+        return false;
+    }
+
+    uint8_t *base = ring->ring_memory;
+    ring->sq_head = (unsigned int *)(base + params.sq_off.head);
+    ring->sq_tail = (unsigned int *)(base + params.sq_off.tail);
+    ring->sq_mask = *(unsigned int *)(base + params.sq_off.ring_mask);
+    ring->sq_entries = params.sq_entries;
+    ring->cq_head = (unsigned int *)(base + params.cq_off.head);
+    ring->cq_tail = (unsigned int *)(base + params.cq_off.tail);
+    ring->cq_mask = *(unsigned int *)(base + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(base + params.cq_off.cqes);
+    unsigned int *sq_array = (unsigned int *)(base + params.sq_off.array);
+    for (unsigned int i = 0; i < params.sq_entries; i++) {
+        sq_array[i] = i; /**< SQEs are always used in order */
+    }
+
+    struct io_uring_buf_reg registration;
+    memset(&registration, 0, sizeof(registration));
+    registration.ring_addr = (uint64_t)(uintptr_t)ring->buffers;
+    registration.ring_entries = URING_SLOTS;
+    registration.bgid = URING_BUFFER_GROUP;
+    if (syscall(__NR_io_uring_register, ring->ring_fd, IORING_REGISTER_PBUF_RING, &registration, 1) < 0) {
+        uring_close(ring);
+        return false;
+    }
+
+    ring->socket = socket;
+    ring->pool = pool;
+    for (unsigned int i = 0; i < URING_SLOTS; i++) {
+        provide_slot(ring, &pool->slots[i]);
+    }
+    ring->receive_header.msg_namelen = sizeof(struct sockaddr_in6); /**< Large enough for both families */
+    ring->receive_header.msg_controllen = URING_CONTROL_SIZE;
+
+    arm_receive(ring);
+    if (!ring->receiving || !enter_ring(ring) || ring->queued > 0) {
+        uring_close(ring);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Moves the datagram of a receive completion into place in its slot.
+ * @details The buffer holds the recvmsg_out header, the address, the ancillary data and the
+ *          payload, each at the offset reserved by the template header.
+ */
+static Slot *take_datagram(Uring *ring, const struct io_uring_cqe *cqe) {
+    Slot *slot = &ring->pool->slots[cqe->flags >> IORING_CQE_BUFFER_SHIFT];
+    const struct io_uring_recvmsg_out *header = (const struct io_uring_recvmsg_out *)slot;
+    size_t control_offset = sizeof(*header) + ring->receive_header.msg_namelen;
+    size_t offset = control_offset + ring->receive_header.msg_controllen;
+
+    ring->kernel_time_ns = 0;
+    if (header->controllen != 0) {
+        union {
+            struct cmsghdr header;              /**< The copy is aligned, unlike the slot bytes */
+            uint8_t bytes[URING_CONTROL_SIZE];
+        } control;
+        struct msghdr message;
+        uint16_t segment_size = 0;
+        memset(&message, 0, sizeof(message));
+        memcpy(control.bytes, (const uint8_t *)slot + control_offset, sizeof(control.bytes));
+        message.msg_control = control.bytes;
+        message.msg_controllen = header->controllen < sizeof(control.bytes) ? header->controllen : sizeof(control.bytes);
+        read_receive_control(&message, &ring->queue_drops, &segment_size, &ring->kernel_time_ns);
+    }
+
+    size_t payload_size = header->payloadlen;
+    if (payload_size > URING_BUFFER_SIZE - offset) {
+        payload_size = URING_BUFFER_SIZE - offset; /**< Truncated, like the slot of the other paths */
+    }
+    if (payload_size > SLOT_REQUEST_SIZE) {
+        payload_size = SLOT_REQUEST_SIZE;
+    }
+
+    memset(&slot->client_address, 0, sizeof(slot->client_address));
+    memcpy(&slot->client_address, (const uint8_t *)slot + sizeof(*header),
+           header->namelen < ring->receive_header.msg_namelen ? header->namelen : ring->receive_header.msg_namelen);
+    memmove(slot->request, (const uint8_t *)slot + offset, payload_size);
+    slot->request_size = (uint32_t)payload_size;
+    return slot;
+}
+
+/**
+ * @brief Takes the next received datagram from the completion queue.
+ */
+IoResult uring_receive(Uring *ring, Slot **slot) {
+    unsigned int head = *ring->cq_head;
+    IoResult result = IO_AGAIN;
+
+    while (result == IO_AGAIN && head != __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+        const struct io_uring_cqe *cqe = &ring->cqes[head & ring->cq_mask];
+        head++;
+
+        if (cqe->user_data != URING_RECEIVE_TAG) {
+            Slot *sent = &ring->pool->slots[cqe->user_data - 1];
+            if (cqe->res < 0) {
+                ring->failed_sends++;
+                ring->transient_errors += socket_error_result(-cqe->res) == IO_TRANSIENT;
+            } else {
+                ring->sent_bytes += (uint64_t)cqe->res;
+            }
+            provide_slot(ring, sent);
+            continue;
+        }
+
+        if (!(cqe->flags & IORING_CQE_F_MORE)) {
+            ring->receiving = false; /**< Re-armed by the next submit */
+        }
+        if (cqe->res >= 0 && (cqe->flags & IORING_CQE_F_BUFFER)) {
+            *slot = take_datagram(ring, cqe);
+            result = IO_DONE;
+        } else if (cqe->res < 0 && cqe->res != -ENOBUFS && cqe->res != -EINTR) {
+            if (socket_error_result(-cqe->res) == IO_TRANSIENT) {
+                ring->transient_errors++; /**< e.g. ECONNREFUSED left by an earlier response */
+            } else {
+                result = IO_ERROR;
+            }
+        }
+    }
+
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+    return result;
+}
+
+/**
+ * @brief Queues the response of a slot; the slot is released when the send completes.
+ */
+void uring_send(Uring *ring, Slot *slot) {
+    unsigned int index = (unsigned int)(slot - ring->pool->slots);
+    queue_slot_response(ring->pool, slot, index);
+
+    struct io_uring_sqe *sqe = next_sqe(ring);
+    if (sqe == NULL) {
+        ring->failed_sends++;
+        provide_slot(ring, slot);
+        return;
+    }
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = ring->socket;
+    sqe->addr = (uint64_t)(uintptr_t)&ring->pool->tx_messages[index].msg_hdr;
+    sqe->len = 1;
+    sqe->user_data = (uint64_t)index + 1;
+    push_sqe(ring);
+}
+
+/**
+ * @brief Gives a slot that needs no response back to the kernel.
+ */
+void uring_release(Uring *ring, Slot *slot) {
+    provide_slot(ring, slot);
+}
+
+/**
+ * @brief Re-arms the receive if it stopped and submits every queued SQE in one call.
+ */
+bool uring_submit(Uring *ring) {
+    if (!ring->receiving) {
+        arm_receive(ring);
+    }
+    return enter_ring(ring);
+}
+
+/**
+ * @brief Unmaps and closes a ring.
+ */
+void uring_close(Uring *ring) {
+    if (ring->buffers != NULL && ring->buffers != MAP_FAILED) {
+        munmap(ring->buffers, URING_SLOTS * sizeof(struct io_uring_buf));
+    }
+    if (ring->sqes != NULL && ring->sqes != MAP_FAILED) {
+        munmap(ring->sqes, ring->sqes_size);
+    }
+    if (ring->ring_memory != NULL && ring->ring_memory != MAP_FAILED) {
+        munmap(ring->ring_memory, ring->ring_size);
+    }
+    if (ring->ring_fd >= 0) {
+        close(ring->ring_fd);
+    }
+    memset(ring, 0, sizeof(*ring));
+    ring->ring_fd = -1;
+}
+
+/* - - - - - - - - - - - - - - - - - - - END URING - - - - - - - - - - - - - - - - - - - */
+
+#endif /* __linux__ */
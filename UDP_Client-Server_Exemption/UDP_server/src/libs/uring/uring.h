@@ -0,0 +1,135 @@
+/**
+ * @file uring.h
+ * @brief Header file declaring the io_uring data path of the Linux server.
+ *
+ * One ring per worker keeps a multishot `recvmsg` armed on the data socket, so a single
+ * submission yields a completion for every datagram received. The kernel picks the receive
+ * buffers from a provided-buffer ring whose entries are the slots of the worker's SlotPool:
+ * a datagram lands directly in a slot, the response is built in the same slot, and the slot
+ * goes back to the buffer ring once its `sendmsg` has completed. Sends are queued as SQEs and
+ * submitted together, so a burst of requests costs one `io_uring_enter`.
+ *
+ * The ring descriptor becomes readable whenever completions are pending, so it is driven by
+ * the worker's event loop like any other socket. `uring_init` fails on kernels without the
+ * needed features (Linux 6.0 or later), and the caller then falls back to the classic path.
+ *
+ * @version 1.0.0
+ * @date 2026-10-14
+ * @author Michele Camassa
+ */
+
+#ifndef URING_H_
+#define URING_H_
+
+#if defined __linux__
+
+#include <linux/io_uring.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "../event/event.h"
+#include "../slots/slots.h"
+
+/* - - - - - - - - - - - - - - - - - - - - URING - - - - - - - - - - - - - - - - - - - - */
+
+#define URING_SLOTS 256     /**< Slots of a ring: datagrams received or answered at once (power of two) */
+
+/**
+ * @struct Uring
+ * @brief Mapped queues, provided buffers and counters of one ring.
+ */
+typedef struct {
+    int ring_fd;                        /**< io_uring descriptor, -1 if closed */
+    int socket;                         /**< Data socket served by the ring */
+    SlotPool *pool;                     /**< Slots lent to the kernel as receive buffers */
+
+    unsigned int *sq_head;              /**< Submission queue head, advanced by the kernel */
+    unsigned int *sq_tail;              /**< Submission queue tail, advanced by the server */
+    unsigned int sq_mask;               /**< Submission queue index mask */
+    unsigned int sq_entries;            /**< Submission queue size */
+    struct io_uring_sqe *sqes;          /**< Submission queue entries */
+    unsigned int *cq_head;              /**< Completion queue head, advanced by the server */
+    unsigned int *cq_tail;              /**< Completion queue tail, advanced by the kernel */
+    unsigned int cq_mask;               /**< Completion queue index mask */
+    struct io_uring_cqe *cqes;          /**< Completion queue entries */
+
+    void *ring_memory;                  /**< Mapping of both queues */
+    size_t ring_size;                   /**< Size of `ring_memory` */
+    size_t sqes_size;                   /**< Size of the `sqes` mapping */
+    struct io_uring_buf_ring *buffers;  /**< Provided-buffer ring, one entry per free slot */
+    uint16_t buffer_tail;               /**< Next entry of `buffers` to fill */
+
+    struct msghdr receive_header;       /**< Template of the multishot `recvmsg` */
+    unsigned int queued;                /**< SQEs written but not submitted yet */
+    bool receiving;                     /**< Whether the multishot `recvmsg` is armed */
+    uint64_t sent_bytes;                /**< Bytes of the completed sends, reset by the caller */
+    uint64_t failed_sends;              /**< Sends completed with an error, reset by the caller */
+    uint64_t transient_errors;          /**< Errors tied to one datagram or peer, reset by the caller */
+    uint32_t queue_drops;               /**< Latest receive queue overflow counter (`SO_RXQ_OVFL`) */
+    int64_t kernel_time_ns;             /**< Kernel receive time of the latest datagram (`SO_TIMESTAMPING`), 0 if none */
+} Uring;
+
+/**
+ * @brief Creates a ring serving `socket` with the slots of `pool`, and arms the receive.
+ *
+ * @param[out] ring The ring to initialize.
+ * @param[in] socket The bound data socket.
+ * @param[in] pool A pool of `URING_SLOTS` slots, owned by the caller for the life of the ring.
+ *
+ * @return `false` if io_uring or one of its needed features is not available.
+ */
+bool uring_init(Uring *ring, int socket, SlotPool *pool);
+
+/**
+ * @brief Takes the next received datagram from the completion queue.
+ *
+ * Send completions found on the way give their slot back to the kernel. The received bytes
+ * are moved to `request` and the sender to `client_address`, so the slot reads exactly as in
+ * the other data paths; it belongs to the caller until `uring_send` or `uring_release`.
+ *
+ * @param[in,out] ring The ring.
+ * @param[out] slot The slot holding the datagram.
+ *
+ * @return `IO_DONE` if a datagram was taken, `IO_AGAIN` if no completion is pending,
+ *         `IO_ERROR` if the receive failed; errors tied to one datagram or peer are
+ *         counted in `transient_errors` and skipped.
+ */
+IoResult uring_receive(Uring *ring, Slot **slot);
+
+/**
+ * @brief Queues the response of a slot; the slot is released when the send completes.
+ *
+ * @param[in,out] ring The ring.
+ * @param[in] slot A slot returned by `uring_receive`, with `response_size` set.
+ */
+void uring_send(Uring *ring, Slot *slot);
+
+/**
+ * @brief Gives a slot that needs no response back to the kernel.
+ *
+ * @param[in,out] ring The ring.
+ * @param[in] slot A slot returned by `uring_receive`.
+ */
+void uring_release(Uring *ring, Slot *slot);
+
+/**
+ * @brief Re-arms the receive if it stopped and submits every queued SQE in one call.
+ *
+ * @param[in,out] ring The ring.
+ *
+ * @return `false` if the submission failed.
+ */
+bool uring_submit(Uring *ring);
+
+/**
+ * @brief Unmaps and closes a ring (the socket and the pool are not released).
+ *
+ * @param[in,out] ring The ring.
+ */
+void uring_close(Uring *ring);
+
+/* - - - - - - - - - - - - - - - - - - - END URING - - - - - - - - - - - - - - - - - - - */
+
+#endif /* __linux__ */
+
+#endif /* URING_H_ */